@@ -0,0 +1,105 @@
+# ----------------------------------------------------------------------------------------
+# 					SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# String filters of particle diagnostics: each filter expression, exercising the
+# parsing and the priority of operators, is compared to the same condition written
+# as a python deposited_quantity. The validation also checks the error messages
+# of malformed filters.
+
+import math
+
+dx = 0.25
+Lx = 16.
+
+Main(
+    geometry = "1Dcartesian",
+
+    interpolation_order = 2,
+
+    cell_length = [dx],
+    grid_length  = [Lx],
+
+    number_of_patches = [ 4 ],
+
+    timestep = 0.9*dx,
+    simulation_time = 2.,
+
+    EM_boundary_conditions = [ ['periodic'] ],
+
+    random_seed = 0
+)
+
+Species(
+    name = "electron",
+    position_initialization = "random",
+    momentum_initialization = "maxwell-juettner",
+    particles_per_cell = 200,
+    mass = 1.0,
+    charge = -1.0,
+    number_density = 1.,
+    temperature = [0.02],
+    mean_velocity = [0.05, 0., 0.],
+    boundary_conditions = [
+        ["periodic", "periodic"],
+    ],
+)
+
+# Pairs of equivalent conditions: string filter, python function of the particles
+filters = [
+    ["px > 0 | py > 0 & pz > 0"     , lambda p: (p.px>0) | ((p.py>0) & (p.pz>0))       ],
+    ["(px > 0 | py > 0) & pz > 0"   , lambda p: ((p.px>0) | (p.py>0)) & (p.pz>0)       ],
+    ["-0.1 < px <= 0.2"             , lambda p: (p.px>-0.1) & (p.px<=0.2)              ],
+    ["0 < px < py + 0.1 < 0.3"      , lambda p: (p.px>0) & (p.px<p.py+0.1) & (p.py+0.1<0.3)],
+    ["px + 2*py > 0.1"              , lambda p: p.px + 2.*p.py > 0.1                   ],
+    ["px - py - pz > 0"             , lambda p: p.px - p.py - p.pz > 0                 ],
+    ["px / 2 / 0.5 < 0.05"          , lambda p: p.px < 0.05                            ],
+    ["-px - -py > 0"                , lambda p: -p.px + p.py > 0                       ],
+    ["~ px > 0 & py < 0"            , lambda p: (p.px<=0) & (p.py<0)                   ],
+    ["not (px > 0 or py > 0)"       , lambda p: (p.px<=0) & (p.py<=0)                  ],
+    ["x/2 < 2 and q == -1"          , lambda p: p.x < 4.                               ],
+    ["gamma > 1.001 & w != 0"       , lambda p: p.px**2 + p.py**2 + p.pz**2 > 1.001**2 - 1.],
+    ["p*p > 2*px*px"                , lambda p: p.py**2 + p.pz**2 > p.px**2            ],
+]
+
+# Deposited quantity: the weight of the particles satisfying the condition
+def weight_if(condition):
+    return lambda p: p.weight * condition(p)
+
+for expression, condition in filters:
+    DiagParticleBinning(
+        deposited_quantity = "weight",
+        every = 1000,
+        species = ["electron"],
+        axes = [ ["x", 0., Lx, 16] ],
+        filter = expression
+    )
+    DiagParticleBinning(
+        deposited_quantity = weight_if(condition),
+        every = 1000,
+        species = ["electron"],
+        axes = [ ["x", 0., Lx, 16] ]
+    )
+
+# Automatic limits only account for the particles that pass the filter
+DiagParticleBinning(
+    deposited_quantity = "weight",
+    every = 1000,
+    species = ["electron"],
+    axes = [ ["px", "auto", "auto", 20] ],
+    filter = "-0.1 < px < 0.1"
+)
+DiagParticleBinning(
+    deposited_quantity = "weight",
+    every = 1000,
+    species = ["electron"],
+    axes = [ ["px", -0.5, "auto", 20] ],
+    filter = "px < 0.2"
+)
+
+DiagTrackParticles(
+    species = "electron",
+    every = 1000,
+    filter = "(-0.1 < px < 0.1) & (x < 8)",
+    attributes = ["x", "px"]
+)
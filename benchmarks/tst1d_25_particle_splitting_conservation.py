@@ -0,0 +1,73 @@
+# ----------------------------------------------------------------------------------------
+# 					SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Conservation by the particle splitting: two test species (no field) are initialized
+# with the same particles, and only the first one is split. Their total charge, momentum
+# and kinetic energy must remain identical while the number of macro-particles increases.
+
+import math
+import numpy as np
+
+dx = 0.5
+Lx = 32.
+dt = 0.9*dx
+
+Main(
+    geometry = "1Dcartesian",
+
+    interpolation_order = 2,
+
+    cell_length = [dx],
+    grid_length  = [Lx],
+
+    number_of_patches = [ 4 ],
+
+    timestep = dt,
+    simulation_time = 20*dt,
+
+    EM_boundary_conditions = [ ['periodic'] ],
+
+    random_seed = 0
+)
+
+Vectorization(
+    mode = "on",
+)
+
+# Same particles for both species: 4 per cell, with various weights and momenta
+np.random.seed(0)
+npart = 4 * int(Lx/dx)
+positions = np.empty((2, npart))
+positions[0] = np.random.uniform(0., Lx, npart)
+positions[1] = np.random.uniform(0.5, 1.5, npart)
+momenta = np.random.normal(0., 0.3, (3, npart))
+momenta[0] += 0.1
+
+for name, splitting_method in [["split", "symmetric"], ["reference", "none"]]:
+    Species(
+        name = name,
+        position_initialization = positions,
+        momentum_initialization = momenta,
+        mass = 1.0,
+        charge = -1.0,
+        is_test = True,
+        boundary_conditions = [
+            ["periodic", "periodic"],
+        ],
+        splitting_method = splitting_method,
+        split_every = 5,
+        split_min_particles_per_cell = 16,
+        split_number = 3,
+    )
+
+quantities = ["weight", "weight_charge", "weight_px", "weight_py", "weight_pz", "weight_ekin"]
+
+for name in ["split", "reference"]:
+    for quantity in quantities + [lambda p: p.weight*0.+1.]:
+        DiagParticleBinning(
+            deposited_quantity = quantity,
+            every = 1,
+            species = [name],
+            axes = [ ["x", 0., Lx, 1] ]
+        )
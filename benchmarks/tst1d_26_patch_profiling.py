@@ -0,0 +1,55 @@
+# ----------------------------------------------------------------------------------------
+# 					SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Patch profilers of DiagPerformances: the times per operator and species, and the trace
+# of the events, must be written in the format read by happi.
+
+import math
+
+dx = 0.25
+Lx = 32.
+
+Main(
+    geometry = "1Dcartesian",
+
+    interpolation_order = 2,
+
+    cell_length = [dx],
+    grid_length  = [Lx],
+
+    number_of_patches = [ 8 ],
+
+    timestep = 0.9*dx,
+    simulation_time = 40*0.9*dx,
+
+    EM_boundary_conditions = [ ['periodic'] ],
+
+    random_seed = 0
+)
+
+for name, mass, charge in [["electron", 1., -1.], ["ion", 1836., 1.]]:
+    Species(
+        name = name,
+        position_initialization = "random",
+        momentum_initialization = "maxwell-juettner",
+        particles_per_cell = 32,
+        mass = mass,
+        charge = charge,
+        number_density = 1.,
+        temperature = [0.01],
+        boundary_conditions = [
+            ["periodic", "periodic"],
+        ],
+    )
+
+DiagScalar(
+    every = 10,
+    vars = ["Ntot_electron", "Ntot_ion"]
+)
+
+DiagPerformances(
+    every = 10,
+    patch_profiling = True,
+    profiling_trace = True,
+)
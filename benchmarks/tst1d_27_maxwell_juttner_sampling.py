@@ -0,0 +1,66 @@
+# ----------------------------------------------------------------------------------------
+# 					SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Sampling of the Maxwell-Juttner distribution, in the classical (T < 0.1, Maxwell-Boltzmann
+# energies) and relativistic cases: the moments of the initial momenta are compared to the
+# analytical ones.
+
+import math
+
+dx = 0.5
+Lx = 32.
+
+Main(
+    geometry = "1Dcartesian",
+
+    interpolation_order = 2,
+
+    cell_length = [dx],
+    grid_length  = [Lx],
+
+    number_of_patches = [ 8 ],
+
+    timestep = 0.9*dx,
+    simulation_time = 0.9*dx,
+
+    EM_boundary_conditions = [ ['periodic'] ],
+
+    random_seed = 0
+)
+
+temperatures = [0.01, 0.05, 0.3, 3., 30.]
+
+for i, T in enumerate(temperatures):
+    Species(
+        name = "electron%d" % i,
+        position_initialization = "random",
+        momentum_initialization = "maxwell-juettner",
+        particles_per_cell = 2000,
+        mass = 1.0,
+        charge = -1.0,
+        number_density = 1.,
+        temperature = [T],
+        is_test = True,
+        boundary_conditions = [
+            ["periodic", "periodic"],
+        ],
+    )
+
+# Moments of the distributions: weight, gamma-1, p^2, px^2, px
+moments = [
+    "weight",
+    "weight_ekin",
+    lambda p: p.weight*(p.px**2 + p.py**2 + p.pz**2),
+    lambda p: p.weight*p.px**2,
+    "weight_px",
+]
+
+for i in range(len(temperatures)):
+    for moment in moments:
+        DiagParticleBinning(
+            deposited_quantity = moment,
+            every = 1000,
+            species = ["electron%d" % i],
+            axes = [ ["x", 0., Lx, 1] ]
+        )
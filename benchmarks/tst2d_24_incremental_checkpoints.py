@@ -0,0 +1,87 @@
+# ----------------------------------------------------------------------------------------
+#                     SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Incremental checkpoints (full_dump_every > 1): a hot plasma slab in a large vacuum box,
+# so that the fields of most patches stay unchanged and are linked to the previous dumps.
+#
+# Run with restarts (validation.py -r 1): the first run continues after its dumps, and the
+# second run restarts from its last dump, which is incremental (it links to the earlier dump
+# files). The results must match those of an uninterrupted run.
+
+import math
+
+dx = 0.25
+Lx = 128.
+Ly = 8.
+tsim = 24.
+
+Main(
+    geometry = "2Dcartesian",
+
+    interpolation_order = 2,
+
+    timestep = 0.9*dx/math.sqrt(2.),
+    simulation_time = tsim,
+
+    cell_length = [dx, dx],
+    grid_length  = [Lx, Ly],
+
+    number_of_patches = [ 32, 2 ],
+
+    EM_boundary_conditions = [ ['silver-muller'], ['periodic'] ],
+
+    random_seed = 0
+)
+
+Te = 0.01
+# Dumps at steps 24 (full), 48, 72, 96 (full), 120, 144: the last one is incremental
+dump_step = 24
+slab = trapezoidal(1., xvacuum=Lx/2.-2., xplateau=4.)
+
+Species(
+    name = 'ion',
+    position_initialization = 'regular',
+    momentum_initialization = 'cold',
+    particles_per_cell = 4,
+    mass = 100.,
+    charge = 1.0,
+    number_density = slab,
+    boundary_conditions = [ ["remove"], ["periodic"] ],
+)
+Species(
+    name = 'eon',
+    position_initialization = 'regular',
+    momentum_initialization = 'maxwell-juettner',
+    particles_per_cell = 16,
+    mass = 1.0,
+    charge = -1.0,
+    number_density = slab,
+    temperature = [Te],
+    boundary_conditions = [ ["remove"], ["periodic"] ],
+)
+
+Checkpoints(
+    dump_step = dump_step,
+    keep_n_dumps = 4,
+    full_dump_every = 3,
+    exit_after_dump = False,
+)
+
+# The validation restarts set a single dump per run (exit_after_dump): keep the dumps above,
+# so that the restarted run reads an incremental dump
+def preprocess():
+    if Checkpoints.exit_after_dump:
+        Checkpoints.dump_step = dump_step
+        Checkpoints.keep_n_dumps = 4
+        Checkpoints.exit_after_dump = False
+
+DiagScalar(
+    every = 10,
+    vars = ['Utot', 'Uelm', 'Ukin_eon', 'Ukin_ion', 'Ntot_eon', 'Ntot_ion']
+)
+
+DiagFields(
+    every = 40,
+    fields = ['Ex', 'Ey', 'Bz', 'Rho_eon']
+)
@@ -0,0 +1,63 @@
+# ----------------------------------------------------------------------------------------
+#                     SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Initial Poisson solver with the multigrid preconditioner, on strongly anisotropic cells
+# (dx = 4 dy): x is weakly coupled. Following every node along x, the coarse problem would
+# have 2049 x 31 unknowns, above the limit, so that x is coarsened between patch corners too.
+#
+# The initial fields of an electron ellipse must verify Gauss's law at every node.
+
+import math
+
+dx = 1.
+dy = 0.25
+Lx = 2048.
+Ly = 256.
+
+Main(
+    geometry = "2Dcartesian",
+
+    interpolation_order = 2,
+
+    timestep = 0.9/math.sqrt(1./dx**2+1./dy**2),
+    number_of_timesteps = 1,
+
+    cell_length = [dx, dy],
+    grid_length  = [Lx, Ly],
+
+    number_of_patches = [ 64, 32 ],
+
+    EM_boundary_conditions = [ ['silver-muller'], ['silver-muller'] ],
+
+    solve_poisson = True,
+    poisson_max_iteration = 50000,
+    poisson_preconditioner = "multigrid",
+
+    random_seed = 0
+)
+
+# Uniform ellipse, elongated along x
+a = 512.
+b = 64.
+def ellipse(x, y):
+    return 1. if ((x-Lx/2.)/a)**2 + ((y-Ly/2.)/b)**2 < 1. else 0.
+
+Species(
+    name = "electron",
+    position_initialization = "regular",
+    momentum_initialization = "cold",
+    particles_per_cell = 1,
+    mass = 1.0,
+    charge = -1.0,
+    charge_density = ellipse,
+    boundary_conditions = [ ["remove"], ["remove"] ],
+    time_frozen = 10.,
+)
+
+# Around the tip of the ellipse
+DiagFields(
+    every = 1,
+    fields = ['Ex', 'Ey', 'Rho'],
+    subgrid = [ slice(384, 641), None ]
+)
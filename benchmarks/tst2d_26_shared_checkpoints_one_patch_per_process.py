@@ -0,0 +1,69 @@
+# ----------------------------------------------------------------------------------------
+#                     SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Single shared-file checkpoints with tracked particles, with only 4 patches:
+# meant to be run with as many MPI processes as patches (validation.py -m 4 -r 1), the
+# most processes allowed, so that restarts work with one patch per process.
+# The tracked particles keep unique IDs across the restart.
+
+import math
+
+dx = 0.25
+Lx = 16.
+Ly = 4.
+
+Main(
+    geometry = "2Dcartesian",
+
+    interpolation_order = 2,
+
+    timestep = 0.9*dx/math.sqrt(2.),
+    simulation_time = 10.,
+
+    cell_length = [dx, dx],
+    grid_length  = [Lx, Ly],
+
+    number_of_patches = [ 4, 1 ],
+
+    EM_boundary_conditions = [ ['periodic'], ['periodic'] ],
+
+    random_seed = 0
+)
+
+Species(
+    name = 'ion',
+    position_initialization = 'regular',
+    momentum_initialization = 'cold',
+    particles_per_cell = 4,
+    mass = 100.,
+    charge = 1.0,
+    number_density = 1.,
+    boundary_conditions = [ ["periodic"], ["periodic"] ],
+)
+Species(
+    name = 'eon',
+    position_initialization = 'random',
+    momentum_initialization = 'maxwell-juettner',
+    particles_per_cell = 4,
+    mass = 1.0,
+    charge = -1.0,
+    number_density = 1.,
+    temperature = [0.01],
+    boundary_conditions = [ ["periodic"], ["periodic"] ],
+)
+
+Checkpoints(
+    shared_file = True,
+)
+
+DiagScalar(
+    every = 5,
+    vars = ['Utot', 'Ntot_eon', 'Ntot_ion']
+)
+
+DiagTrackParticles(
+    species = "eon",
+    every = 10,
+    attributes = ["x", "y", "px"]
+)
@@ -0,0 +1,52 @@
+# ----------------------------------------------------------------------------------------
+#                     SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Tabulated time-dependent python profile of a prescribed field, with a moving window:
+# in vacuum, the field written by the diagnostic is the prescribed one, which must match
+# the python function evaluated directly at the same points.
+
+import math
+
+dx = 0.5
+Lx = 32.
+Ly = 16.
+
+Main(
+    geometry = "2Dcartesian",
+
+    interpolation_order = 2,
+
+    timestep = 0.9*dx/math.sqrt(2.),
+    simulation_time = 20.,
+
+    cell_length = [dx, dx],
+    grid_length  = [Lx, Ly],
+
+    number_of_patches = [ 8, 4 ],
+
+    EM_boundary_conditions = [ ['silver-muller'], ['periodic'] ],
+
+    profile_tabulation = 1000000,
+    profile_tabulation_tolerance = 0.01,
+
+    random_seed = 0
+)
+
+MovingWindow(
+    time_start = 0.,
+    velocity_x = 1.
+)
+
+def Ex_profile(x, y, t):
+    return 0.1 * math.cos(0.3*x) * math.cos(0.4*y) * math.sin(0.2*t)
+
+PrescribedField(
+    field = "Ex",
+    profile = Ex_profile
+)
+
+DiagFields(
+    every = 20,
+    fields = ['Ex']
+)
@@ -0,0 +1,72 @@
+# ----------------------------------------------------------------------------------------
+#                     SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Initial Poisson solver with the multigrid preconditioner, with more patches than the
+# limit of the coarse problem: 184 x 184 periodic patches give 33856 patch corners, above
+# 32768, so that the coarse problem is solved by V-cycles on a coarser level.
+#
+# The initial fields of an electron disk must verify Gauss's law at every node.
+
+import math
+
+dx = 1.
+dy = 1.
+Lx = 736.
+Ly = 736.
+
+Main(
+    geometry = "2Dcartesian",
+
+    interpolation_order = 2,
+
+    timestep = 0.9/math.sqrt(1./dx**2+1./dy**2),
+    number_of_timesteps = 1,
+
+    cell_length = [dx, dy],
+    grid_length  = [Lx, Ly],
+
+    number_of_patches = [ 184, 184 ],
+
+    EM_boundary_conditions = [ ['periodic'], ['periodic'] ],
+
+    solve_poisson = True,
+    poisson_max_iteration = 50000,
+    poisson_preconditioner = "multigrid",
+
+    random_seed = 0
+)
+
+# Uniform disk, neutralized by a uniform background
+R = 128.
+def disk(x, y):
+    return 1. if (x-Lx/2.)**2 + (y-Ly/2.)**2 < R**2 else 0.
+
+Species(
+    name = "electron",
+    position_initialization = "regular",
+    momentum_initialization = "cold",
+    particles_per_cell = 1,
+    mass = 1.0,
+    charge = -1.0,
+    charge_density = disk,
+    boundary_conditions = [ ["periodic"], ["periodic"] ],
+    time_frozen = 10.,
+)
+
+Species(
+    name = "ion",
+    position_initialization = "regular",
+    momentum_initialization = "cold",
+    particles_per_cell = 1,
+    mass = 1836.0,
+    charge = 1.0,
+    charge_density = math.pi*R**2/(Lx*Ly),
+    boundary_conditions = [ ["periodic"], ["periodic"] ],
+    time_frozen = 10.,
+)
+
+DiagFields(
+    every = 1,
+    fields = ['Ex', 'Ey', 'Rho'],
+)
@@ -0,0 +1,77 @@
+# ----------------------------------------------------------------------------------------
+#                     SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Compressed checkpoints (dump_deflate > 0): fields and particles are shuffled and deflated,
+# and particle positions are stored as the XOR of consecutive values.
+#
+# The validation also runs this namelist a second time, stopping after the first dump and
+# restarting from it: the restarted run must match the uninterrupted one exactly.
+# With validation restarts (validation.py -r 1), the benchmark itself restarts from a
+# compressed dump too.
+
+import math
+
+dx = 0.25
+Lx = 16.
+Ly = 16.
+tsim = 24.
+
+Main(
+    geometry = "2Dcartesian",
+
+    interpolation_order = 2,
+
+    timestep = 0.9*dx/math.sqrt(2.),
+    simulation_time = tsim,
+
+    cell_length = [dx, dx],
+    grid_length  = [Lx, Ly],
+
+    number_of_patches = [ 4, 4 ],
+
+    EM_boundary_conditions = [ ['periodic'], ['periodic'] ],
+
+    random_seed = 0
+)
+
+# Two counter-streaming electron beams on an ion background
+Species(
+    name = 'ion',
+    position_initialization = 'regular',
+    momentum_initialization = 'cold',
+    particles_per_cell = 4,
+    mass = 1836.,
+    charge = 1.0,
+    number_density = 1.,
+    boundary_conditions = [ ["periodic"], ["periodic"] ],
+)
+Species(
+    name = 'eon',
+    position_initialization = 'random',
+    momentum_initialization = 'maxwell-juettner',
+    particles_per_cell = 8,
+    mass = 1.0,
+    charge = -1.0,
+    number_density = 1.,
+    mean_velocity = [lambda x,y: 0.2 if y < Ly/2. else -0.2, 0., 0.],
+    temperature = [0.01],
+    boundary_conditions = [ ["periodic"], ["periodic"] ],
+)
+
+Checkpoints(
+    dump_step = 48,
+    keep_n_dumps = 2,
+    dump_deflate = 2,
+    exit_after_dump = False,
+)
+
+DiagScalar(
+    every = 10,
+    vars = ['Utot', 'Uelm', 'Ukin_eon', 'Ukin_ion', 'Ntot_eon']
+)
+
+DiagFields(
+    every = 48,
+    fields = ['Ex', 'Ey', 'Bz', 'Rho_eon', 'Jx_eon']
+)
@@ -0,0 +1,77 @@
+# ----------------------------------------------------------------------------------------
+#                     SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Fields written by a background thread (staging_buffers > 0): the same fields are
+# written synchronously and through one or several staging buffers, with and without
+# time-averaging and subgrid. The validation requires identical datasets.
+# Without MPI_THREAD_MULTIPLE, staged diagnostics fall back to synchronous writing.
+
+import math
+
+dx = 0.25
+Lx = 16.
+Ly = 16.
+tsim = 24.
+
+Main(
+    geometry = "2Dcartesian",
+
+    interpolation_order = 2,
+
+    timestep = 0.9*dx/math.sqrt(2.),
+    simulation_time = tsim,
+
+    cell_length = [dx, dx],
+    grid_length  = [Lx, Ly],
+
+    number_of_patches = [ 4, 4 ],
+
+    EM_boundary_conditions = [ ['periodic'], ['periodic'] ],
+
+    random_seed = 0
+)
+
+# Two counter-streaming electron beams on an ion background
+Species(
+    name = 'ion',
+    position_initialization = 'regular',
+    momentum_initialization = 'cold',
+    particles_per_cell = 4,
+    mass = 1836.,
+    charge = 1.0,
+    number_density = 1.,
+    boundary_conditions = [ ["periodic"], ["periodic"] ],
+)
+Species(
+    name = 'eon',
+    position_initialization = 'random',
+    momentum_initialization = 'maxwell-juettner',
+    particles_per_cell = 8,
+    mass = 1.0,
+    charge = -1.0,
+    number_density = 1.,
+    mean_velocity = [lambda x,y: 0.2 if y < Ly/2. else -0.2, 0., 0.],
+    temperature = [0.01],
+    boundary_conditions = [ ["periodic"], ["periodic"] ],
+)
+
+fields = ['Ex', 'Ey', 'Bz', 'Rho_eon', 'Jx_eon']
+
+# Fields0, Fields1, Fields2: synchronous, one buffer (each write waits for the previous one), three buffers
+for staging_buffers in [0, 1, 3]:
+    DiagFields(
+        every = 5,
+        fields = fields,
+        staging_buffers = staging_buffers,
+    )
+
+# Fields3, Fields4: time-averaged on a subgrid, synchronous and staged
+for staging_buffers in [0, 2]:
+    DiagFields(
+        every = 20,
+        time_average = 4,
+        subgrid = s_[3:60:2, 10:50],
+        fields = fields,
+        staging_buffers = staging_buffers,
+    )
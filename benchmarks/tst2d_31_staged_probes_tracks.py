@@ -0,0 +1,88 @@
+# ----------------------------------------------------------------------------------------
+#                     SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ----------------------------------------------------------------------------------------
+#
+# Probes and tracked particles written by a background thread (staging_buffers > 0).
+# The same probes are written synchronously and through staging buffers in this run.
+# The validation also runs this namelist twice without MPI, with and without staging
+# of the tracked particles, and requires identical outputs.
+# Without MPI_THREAD_MULTIPLE, staged diagnostics fall back to synchronous writing.
+
+import math
+
+dx = 0.25
+Lx = 16.
+Ly = 16.
+tsim = 24.
+
+Main(
+    geometry = "2Dcartesian",
+
+    interpolation_order = 2,
+
+    timestep = 0.9*dx/math.sqrt(2.),
+    simulation_time = tsim,
+
+    cell_length = [dx, dx],
+    grid_length  = [Lx, Ly],
+
+    number_of_patches = [ 4, 4 ],
+
+    EM_boundary_conditions = [ ['periodic'], ['periodic'] ],
+
+    random_seed = 0
+)
+
+# Two counter-streaming electron beams on an ion background
+Species(
+    name = 'ion',
+    position_initialization = 'regular',
+    momentum_initialization = 'cold',
+    particles_per_cell = 4,
+    mass = 1836.,
+    charge = 1.0,
+    number_density = 1.,
+    boundary_conditions = [ ["periodic"], ["periodic"] ],
+)
+Species(
+    name = 'eon',
+    position_initialization = 'random',
+    momentum_initialization = 'maxwell-juettner',
+    particles_per_cell = 8,
+    mass = 1.0,
+    charge = -1.0,
+    number_density = 1.,
+    mean_velocity = [lambda x,y: 0.2 if y < Ly/2. else -0.2, 0., 0.],
+    temperature = [0.01],
+    boundary_conditions = [ ["periodic"], ["periodic"] ],
+)
+
+# Probes0, Probes1: line probe, synchronous and staged with one buffer
+for staging_buffers in [0, 1]:
+    DiagProbe(
+        every = 5,
+        origin = [0., Ly/4.],
+        corners = [[Lx, 3.*Ly/4.]],
+        number = [100],
+        fields = ['Ex', 'Ey', 'Bz', 'Rho_eon', 'Jx_eon'],
+        staging_buffers = staging_buffers,
+    )
+
+# Probes2, Probes3: time-integrated 2D probe, synchronous and staged with three buffers
+for staging_buffers in [0, 3]:
+    DiagProbe(
+        every = 10,
+        origin = [0., 0.],
+        corners = [[Lx, 0.], [0., Ly]],
+        number = [32, 32],
+        fields = ['Ex', 'Ey', 'Bz'],
+        time_integral = True,
+        staging_buffers = staging_buffers,
+    )
+
+DiagTrackParticles(
+    species = "eon",
+    every = 4,
+    attributes = ["x", "y", "px", "py", "w", "Ex", "Bz"],
+    staging_buffers = 2,
+)
@@ -0,0 +1,74 @@
+# ----------------------------------------------------------------------------------------
+# 					SIMULATION PARAMETERS
+# ----------------------------------------------------------------------------------------
+# The same fields are written contiguously and in compressed chunks,
+# on a subgrid that starts inside a patch
+import math
+
+l0 = 2.0*math.pi
+dx = l0/16.
+
+Main(
+    geometry = "3Dcartesian",
+    interpolation_order = 2,
+    cell_length = [dx, dx, dx],
+    grid_length  = [32*dx, 32*dx, 32*dx],
+    number_of_patches = [4, 4, 4],
+    timestep = 0.9*dx/math.sqrt(3.),
+    simulation_time = 40*0.9*dx/math.sqrt(3.),
+    EM_boundary_conditions = [ ['periodic'] ],
+    print_every = 10,
+)
+
+Species(
+    name = "electron",
+    position_initialization = "random",
+    momentum_initialization = "maxwell-juettner",
+    particles_per_cell = 4,
+    mass = 1.0,
+    charge = -1.0,
+    number_density = 1.,
+    temperature = [0.01],
+    boundary_conditions = [ ["periodic"] ],
+)
+
+Species(
+    name = "ion",
+    position_initialization = "electron",
+    momentum_initialization = "cold",
+    particles_per_cell = 4,
+    mass = 1836.0,
+    charge = 1.0,
+    number_density = 1.,
+    boundary_conditions = [ ["periodic"] ],
+)
+
+fields = ['Ex','Ey','Ez','Bz','Rho_electron']
+subgrid = s_[4:30:1, 5:32:2, 8:29:3]
+
+# Contiguous reference
+DiagFields(
+    every = 20,
+    fields = fields,
+    subgrid = subgrid,
+)
+
+# One patch per chunk, compressed
+DiagFields(
+    every = 20,
+    fields = fields,
+    subgrid = subgrid,
+    chunk_patches = 1,
+    deflate = 4,
+)
+
+# Two patches per chunk, uncompressed, on the full grid
+DiagFields(
+    every = 20,
+    fields = fields,
+)
+DiagFields(
+    every = 20,
+    fields = fields,
+    chunk_patches = 2,
+)
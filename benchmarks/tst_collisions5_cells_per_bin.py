@@ -0,0 +1,87 @@
+# ---------------------------------------------
+# SIMULATION PARAMETERS FOR THE PIC-CODE SMILEI
+# ---------------------------------------------
+#
+# Electron-ion thermalization with coarse collision bins (cells_per_bin = 3), compared to
+# the same plasma with bins of one cell. Patches have 25 cells (26 nodes), which are not
+# divisible by 3, so that the last bin of each patch is truncated.
+# The Coulomb logarithm is either fixed or computed from the Debye length (averaged over the bin).
+
+import math
+L0 = 2.*math.pi # conversion from normalization length to wavelength
+
+
+Main(
+	geometry = "1Dcartesian",
+	
+	number_of_patches = [ 4 ],
+	
+	interpolation_order = 2,
+	
+	timestep = 0.2 * L0,
+	simulation_time = 20 * L0,
+	
+	time_fields_frozen = 100000000000.,
+	
+	cell_length = [10.*L0],
+	grid_length = [1000.*L0],
+	
+	EM_boundary_conditions = [ ["periodic"] ],
+	
+	reference_angular_frequency_SI = L0 * 3e8 /1.e-6,
+	print_every = 10,
+)
+
+Te = 0.0002
+Ti = 0.0001
+
+# (cells_per_bin, coulomb_log) of each electron-ion pair of species
+cases = [ [1, 5.], [3, 5.], [1, 0.], [3, 0.] ]
+
+for i, (cells_per_bin, coulomb_log) in enumerate(cases):
+	ion = "ion"+str(i)
+	eon = "eon"+str(i)
+	
+	Species(
+		name = ion,
+		position_initialization = "random",
+		momentum_initialization = "maxwell-juettner",
+		particles_per_cell = 100,
+		mass = 10.,
+		charge = 1.0,
+		charge_density = 10.,
+		mean_velocity = [0., 0., 0.],
+		temperature = [Ti],
+		time_frozen = 100000000.0,
+		boundary_conditions = [
+			["periodic", "periodic"],
+		],
+	)
+	
+	Species(
+		name = eon,
+		position_initialization = "random",
+		momentum_initialization = "maxwell-juettner",
+		particles_per_cell = 100,
+		mass = 1.0,
+		charge = -1.0,
+		charge_density = 10.,
+		mean_velocity = [0., 0., 0.],
+		temperature = [Te],
+		time_frozen = 100000000.0,
+		boundary_conditions = [
+			["periodic", "periodic"],
+		],
+	)
+	
+	Collisions(
+		species1 = [eon],
+		species2 = [ion],
+		coulomb_log = coulomb_log,
+		cells_per_bin = cells_per_bin,
+	)
+
+DiagScalar(
+	every = 5,
+	vars = ["Ukin_eon"+str(i) for i in range(len(cases))] + ["Ukin_ion"+str(i) for i in range(len(cases))]
+)
@@ -32,7 +32,11 @@ class Field(Diagnostic):
 		for path in self._results_path:
 			file = path+self._os.sep+'Fields'+str(self.diagNumber)+'.h5'
 			try:
-				f = self._h5py.File(file, 'r')
+				try:
+					# Large chunk cache so that chunked fields are not decompressed several times per read
+					f = self._h5py.File(file, 'r', rdcc_nbytes=64*1024**2)
+				except TypeError:
+					f = self._h5py.File(file, 'r')
 			except Exception as e:
 				continue
 			self._h5items.update( dict(f["data"]) )
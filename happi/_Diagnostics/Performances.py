@@ -71,6 +71,12 @@ def PartitionMatrix( matrix, listOfValues, oversize=0 ):
 class Performances(Diagnostic):
 	"""Class for loading a Performances diagnostic"""
 
+	# Quantities of the patch profilers, for each species in each patch
+	_profilerQuantities = ["time_interpolation", "time_push", "time_boundaries", "time_projection", "time_sorting", "exchanged_bytes", "macro_particles"]
+
+	# Quantities accumulated since the beginning of the simulation (see the `cumulative` argument)
+	_cumulativeQuantities = ("timer", "instructions_", "cycles_", "cache_misses_")
+
 	def _init(self, raw=None, map=None, histogram=None, timesteps=None, data_log=False, data_transform=None, species=None, cumulative=True, **kwargs):
 
 		info = self.simulation.performanceInfo()
@@ -168,7 +174,7 @@ class Performances(Diagnostic):
 		for index_in_file, q in enumerate(self._availableQuantities_double):
 			if self._re.search(r"\b%s\b"%q,self._operation):
 				self._operation = self._re.sub(r"\b%s\b"%q,"C["+str(index_in_output)+"]",self._operation)
-				units = "seconds" if q.startswith("timer") else "1"
+				units = "seconds" if q.startswith("timer") else "bytes/s" if q.startswith("memory_bandwidth") else "1"
 				self._operationunits = self._operationunits.replace(q, units)
 				self._quantities_double.append([index_in_file, q])
 				used_quantities.append( q )
@@ -180,9 +186,11 @@ class Performances(Diagnostic):
 		self._cumulative = cumulative
 		
 		# In case of "vecto" quantity, get the species
+		# (optional for profiler quantities, which are otherwise summed over all species)
+		self._species = None
 		if species is not None:
-			if self.operation != "vecto":
-				raise Exception("Argument `species` only valid with quantity 'vecto'")
+			if self.operation != "vecto" and self.operation not in self._profilerQuantities:
+				raise Exception("Argument `species` only valid with quantity 'vecto' or the patch profiler quantities")
 			self._species = str(species)
 		
 		# 2 - Manage timesteps
@@ -240,7 +248,7 @@ class Performances(Diagnostic):
 			self._units  .append("")
 			self._log    .append(False)
 			self._vunits = "1"
-			self._title  = "number of processes"
+			self._title  = "number of patches" if self.operation in self._profilerQuantities else "number of processes"
 
 		# Set the directory in case of exporting
 		self._exportPrefix = "Performances"
@@ -286,7 +294,7 @@ class Performances(Diagnostic):
 				B = self._np.empty((self._nprocs,), dtype=dtype)
 				h5item.read_direct( B, source_sel=self._np.s_[index_in_file,:] )
 				# If not cumulative, make the difference with the previous time
-				if not self._cumulative and quantity.startswith("timer") and index > 0:
+				if not self._cumulative and quantity.startswith(self._cumulativeQuantities) and index > 0:
 					prevh5item = self._h5items[index-1]["quantities_"+dtype]
 					prevB = self._np.empty((self._nprocs,), dtype=dtype)
 					prevh5item.read_direct( prevB, source_sel=self._np.s_[index_in_file,:] )
@@ -295,8 +303,12 @@ class Performances(Diagnostic):
 		
 		# Calculate the operation
 		# First patch performance information
-		if  self.operation in ["vecto", "mpi_rank"]:
-			if self._mode != "raw":
+		if  self.operation in ["vecto", "mpi_rank"] + self._profilerQuantities:
+			if self.operation in self._profilerQuantities:
+				if self._mode == "map":
+					print("With patch profiler quantities, only modes `raw` and `histogram` are supported")
+					return []
+			elif self._mode != "raw":
 				print("With quantities `vecto` or `mpi_rank`, only mode `raw` is supported")
 				return []
 			
@@ -319,6 +331,17 @@ class Performances(Diagnostic):
 
 				patches_buffer = self._np.array(self._h5items[index]["patches"]["mpi_rank"])
 
+			else:
+
+				# Sum the requested species, or all of them
+				patches = self._h5items[index]["patches"]
+				groups = [patches[k] for k in patches.keys() if isinstance(patches[k], self._h5py.Group) and (self._species is None or k == self._species)]
+				groups = [g for g in groups if self.operation in g]
+				if not groups:
+					print("Quantity {} not found (requires `patch_profiling` in the namelist)".format(self.operation))
+					return []
+				patches_buffer = sum(self._np.array(g[self.operation], dtype="double") for g in groups)
+
 			# Get the position of the patches
 			x_patches = self._np.array(self._h5items[index]["patches"]["x"][:])
 			y_patches = self._np.array(self._h5items[index]["patches"]["y"][:])
@@ -332,7 +355,7 @@ class Performances(Diagnostic):
 			)
 			
 			# Matrix of patches reconstituted
-			A = self._np.empty_like(i_patch)
+			A = self._np.empty(i_patch.shape, dtype=patches_buffer.dtype)
 			A[i_patch] = patches_buffer
 			A = self._np.squeeze(A.reshape([x_patches.max()+1, y_patches.max()+1, z_patches.max()+1]))
 
@@ -9,6 +9,8 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
+#include <cstring>
+#include <complex>
 
 #include <mpi.h>
 
@@ -49,7 +51,12 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
     keep_n_dumps_max( 10000 ),
     dump_deflate( 0 ),
     dump_request( smpi->getSize() ),
-    file_grouping( 0 )
+    file_grouping( 0 ),
+    shared_file( false ),
+    aggregators_per_node( 0 ),
+    restart_shared_file( false ),
+    full_dump_every( 1 ),
+    dump_chain_length( 0 )
 {
 
     if( PyTools::nComponents( "Checkpoints" ) > 0 ) {
@@ -86,6 +93,36 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
             MESSAGE( 1, "Code will group checkpoint files by "<< file_grouping );
         }
 
+        PyTools::extract( "shared_file", shared_file, "Checkpoints"  );
+        PyTools::extract( "aggregators_per_node", aggregators_per_node, "Checkpoints"  );
+        if( shared_file ) {
+            if( params.multiple_decomposition ) {
+                ERROR_NAMELIST( "Checkpoints.shared_file is not compatible with MultipleDecomposition",
+                "https://smileipic.github.io/Smilei/namelist.html#checkpoints" );
+            }
+            MESSAGE( 1, "Code will dump all processes in a single shared file" );
+        }
+
+        PyTools::extract( "full_dump_every", full_dump_every, "Checkpoints"  );
+        if( full_dump_every < 1 ) {
+            full_dump_every = 1;
+        }
+        if( full_dump_every > 1 && shared_file ) {
+            WARNING( "Incremental dumps are not available with shared_file: all dumps will be full" );
+            full_dump_every = 1;
+        }
+        if( full_dump_every > 1 ) {
+            if( full_dump_every >= keep_n_dumps_max ) {
+                full_dump_every = keep_n_dumps_max - 1;
+            }
+            // All dumps since the last full dump must be kept, plus one in case of a crash during the next dump
+            if( keep_n_dumps < full_dump_every+1 ) {
+                WARNING( "Incremental dumps require keep_n_dumps > full_dump_every. keep_n_dumps set to " << full_dump_every+1 );
+                keep_n_dumps = full_dump_every+1;
+            }
+            MESSAGE( 1, "Code will do a full dump every " << full_dump_every << " dumps, the others being incremental" );
+        }
+
         smpi->barrier();
 
         if( params.restart ) {
@@ -115,6 +152,19 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
                 ERROR( "Cannot find a valid restart file for rank "<<smpi->getRank() );
             }
 
+            // An incremental dump refers to data stored in previous dumps: they must still exist
+            H5Read f( restart_file );
+            if( f.hasAttr( "linked_dump_files" ) ) {
+                vector<string> linked_files;
+                f.attr( "linked_dump_files", linked_files );
+                string dir = restart_file.substr( 0, restart_file.find_last_of( PATH_SEPARATOR ) + 1 );
+                for( unsigned int i=0; i<linked_files.size(); i++ ) {
+                    if( ! Tools::fileExists( dir + linked_files[i] ) ) {
+                        ERROR( "Restart file " << restart_file << " is incremental and requires missing file " << dir + linked_files[i] );
+                    }
+                }
+            }
+
             // Make sure all ranks have the same dump number
             // Different numbers can be due to corrupted restart files
             if( ! smpi->test_mode ) {
@@ -221,6 +271,11 @@ void Checkpoint::dump( VectorPatch &vecPatches, Region &region, unsigned int iti
 
 void Checkpoint::dumpAll( VectorPatch &vecPatches, Region &region, unsigned int itime,  SmileiMPI *smpi, SimWindow *simWin,  Params &params )
 {
+    if( shared_file ) {
+        dumpAllShared( vecPatches, itime, smpi, simWin, params );
+        return;
+    }
+
     unsigned int num_dump=dump_number % keep_n_dumps;
 
     ostringstream nameDumpTmp( "" );
@@ -233,7 +288,19 @@ void Checkpoint::dumpAll( VectorPatch &vecPatches, Region &region, unsigned int
     std::string dumpName=nameDumpTmp.str();
 
 
+    // Incremental dumps only write the data that was not found in the dumps since the last full one
+    if( full_dump_every <= 1 || dump_chain_length == 0 || dump_chain_length >= full_dump_every ) {
+        dumped_data.clear();
+        dump_chain_length = 0;
+    }
+    dump_chain_length++;
+    current_dump_file = dumpName.substr( dumpName.find_last_of( PATH_SEPARATOR ) + 1 );
+    linked_dump_files.clear();
+
     H5Write f( dumpName );
+    if( dump_deflate > 0 ) {
+        f.latestFormat();
+    }
     dump_number++;
 
 #ifdef  __DEBUG
@@ -299,10 +366,6 @@ void Checkpoint::dumpAll( VectorPatch &vecPatches, Region &region, unsigned int
         H5Write g = f.group( patchName.c_str() );
 
         dumpPatch( vecPatches( ipatch ), params, g );
-
-        // Random number generator state
-        g.attr( "xorshift32_state", vecPatches( ipatch )->rand_->xorshift32_state );
-
     }
 
     if (params.multiple_decomposition) {
@@ -328,6 +391,12 @@ void Checkpoint::dumpAll( VectorPatch &vecPatches, Region &region, unsigned int
         dumpMovingWindow( f, simWin );
     }
 
+    // List the previous dumps required to restart from this one
+    if( ! linked_dump_files.empty() ) {
+        vector<string> linked_files( linked_dump_files.begin(), linked_dump_files.end() );
+        f.attr( "linked_dump_files", linked_files );
+    }
+
 }
 
 
@@ -485,25 +554,25 @@ void Checkpoint::dumpPatch( Patch *patch, Params &params, H5Write &g )
             for( unsigned int i=0; i<spec->particles->Position.size(); i++ ) {
                 ostringstream my_name( "" );
                 my_name << "Position-" << i;
-                s.vect( my_name.str(), spec->particles->Position[i] );//, dump_deflate );
+                dumpPositions( s, my_name.str(), spec->particles->Position[i] );
             }
 
             for( unsigned int i=0; i<spec->particles->Momentum.size(); i++ ) {
                 ostringstream my_name( "" );
                 my_name << "Momentum-" << i;
-                s.vect( my_name.str(),spec->particles->Momentum[i] );//, dump_deflate );
+                dumpParticleProperty( s, my_name.str(), spec->particles->Momentum[i], H5T_NATIVE_DOUBLE );
             }
 
-            s.vect( "Weight", spec->particles->Weight );//, dump_deflate );
-            s.vect( "Charge", spec->particles->Charge );//, dump_deflate );
+            dumpParticleProperty( s, "Weight", spec->particles->Weight, H5T_NATIVE_DOUBLE );
+            dumpParticleProperty( s, "Charge", spec->particles->Charge, H5T_NATIVE_SHORT );
 
             if( spec->particles->tracked ) {
-                s.vect( "Id", spec->particles->Id, H5T_NATIVE_UINT64 );//, dump_deflate );
+                dumpParticleProperty( s, "Id", spec->particles->Id, H5T_NATIVE_UINT64 );
             }
 
             // Monte-Carlo process
             if (spec->particles->isMonteCarlo) {
-                s.vect( "Tau", spec->particles->Tau );//, dump_deflate );
+                dumpParticleProperty( s, "Tau", spec->particles->Tau, H5T_NATIVE_DOUBLE );
             }
 
             s.vect( "first_index", spec->particles->first_index );
@@ -557,6 +626,160 @@ void Checkpoint::dumpPatch( Patch *patch, Params &params, H5Write &g )
 };
 
 
+void Checkpoint::dumpAllShared( VectorPatch &vecPatches, unsigned int itime, SmileiMPI *smpi, SimWindow *simWin, Params &params )
+{
+    unsigned int num_dump=dump_number % keep_n_dumps;
+
+    ostringstream nameDumpTmp( "" );
+    nameDumpTmp << "checkpoints" << PATH_SEPARATOR << "dump-" << setfill( '0' ) << setw( 5 ) << num_dump << ".h5" ;
+    std::string dumpName=nameDumpTmp.str();
+
+    // Each patch is first dumped in a separate HDF5 file in memory (image),
+    // so that it may be restarted by any process, whatever the number of processes
+    unsigned int npatches = vecPatches.size();
+    vector<char> images;
+    vector<uint64_t> image_offset( npatches ), image_size( npatches );
+    for( unsigned int ipatch=0 ; ipatch<npatches; ipatch++ ) {
+        ostringstream patch_name( "" );
+        patch_name << setfill( '0' ) << setw( 6 ) << vecPatches( ipatch )->Hindex();
+        string patchName=Tools::merge( "patch-", patch_name.str() );
+        image_offset[ipatch] = images.size();
+        {
+            H5Write g( patchName, &images );
+            if( dump_deflate > 0 ) {
+                g.latestFormat();
+            }
+            dumpPatch( vecPatches( ipatch ), params, g );
+        }
+        image_size[ipatch] = images.size() - image_offset[ipatch];
+    }
+
+    // Location of the images of this process in the shared file (ordered by patch index)
+    uint64_t local_size = images.size(), global_offset = 0, global_size = 0;
+    MPI_Exscan( &local_size, &global_offset, 1, MPI_UINT64_T, MPI_SUM, smpi->world() );
+    if( smpi->isMaster() ) {
+        global_offset = 0;
+    }
+    MPI_Allreduce( &local_size, &global_size, 1, MPI_UINT64_T, MPI_SUM, smpi->world() );
+    for( unsigned int ipatch=0 ; ipatch<npatches; ipatch++ ) {
+        image_offset[ipatch] += global_offset;
+    }
+
+    // Attributes must be identical on all processes
+    DiagnosticScalar *scalars = static_cast<DiagnosticScalar *>( vecPatches.globalDiags[0] );
+    double energy[2] = { scalars->Energy_time_zero, scalars->EnergyUsedForNorm };
+    MPI_Bcast( energy, 2, MPI_DOUBLE, 0, smpi->world() );
+
+    MPI_Comm comm = smpi->world();
+    MPI_Info info = sharedFileHints();
+    H5Write f( dumpName, &comm, true, info );
+    MPI_Info_free( &info );
+    dump_number++;
+
+    MESSAGE( " Checkpoint #" << num_dump << "at iteration " << itime << " dumped" );
+
+    // Write basic attributes
+    f.attr( "Version", string( __VERSION ) );
+
+    f.attr( "dump_step", itime );
+    f.attr( "dump_number", dump_number );
+    f.attr( "number_of_processes", smpi->getSize() );
+
+    f.attr( "latest_timestep",   scalars->latest_timestep );
+    f.attr( "Energy_time_zero",  energy[0] );
+    f.attr( "EnergyUsedForNorm", energy[1] );
+
+    // Small per-process arrays are gathered and written by the master only: collective writes
+    // of a few bytes per process are not reliable with all MPI-IO implementations
+    int nprocs = smpi->getSize();
+    H5Space rank_space( nprocs, 0, smpi->isMaster() ? nprocs : 0 );
+    H5Space rank_mem( smpi->isMaster() ? nprocs : 0 );
+    int patch_count = npatches;
+    vector<int> patch_counts( nprocs );
+    MPI_Gather( &patch_count, 1, MPI_INT, &patch_counts[0], 1, MPI_INT, 0, smpi->world() );
+    f.array( "patch_count", patch_counts[0], H5T_NATIVE_INT, &rank_space, &rank_mem );
+
+    // Poynting scalars, summed over all processes
+    unsigned int k=0;
+    for( unsigned int j=0; j<2; j++ ) { //directions (xmin/xmax, ymin/ymax, zmin/zmax)
+        for( unsigned int i=0; i<params.nDim_field; i++ ) { //axis 0=x, 1=y, 2=z
+            if( scalars->necessary_poy[k] ) {
+                string poy_name = Tools::merge( "Poy", Tools::xyz[i], j==0?"min":"max" );
+                double poy_val = 0., poy_sum = 0.;
+                for( unsigned ipatch=0; ipatch<npatches; ipatch++ ) {
+                    poy_val += vecPatches( ipatch )->EMfields->poynting[j][i];
+                }
+                MPI_Allreduce( &poy_val, &poy_sum, 1, MPI_DOUBLE, MPI_SUM, smpi->world() );
+                f.attr( poy_name, poy_sum );
+                k++;
+            }
+        }
+    }
+
+    // Write the diags screen data (written by the master)
+    unsigned int iscreen = 0;
+    for( unsigned int idiag=0; idiag<vecPatches.globalDiags.size(); idiag++ ) {
+        if( DiagnosticScreen *screen = dynamic_cast<DiagnosticScreen *>( vecPatches.globalDiags[idiag] ) ) {
+            ostringstream diagName( "" );
+            diagName << "DiagScreen" << iscreen;
+            vector<double> *data = screen->getData();
+            hsize_t n = data->size();
+            if( n > 0 ) {
+                H5Space filespace( n, 0, smpi->isMaster() ? n : 0 );
+                H5Space memspace( smpi->isMaster() ? n : 0 );
+                f.array( diagName.str(), ( *data )[0], &filespace, &memspace );
+            }
+            iscreen++;
+        }
+    }
+
+    // Write the patch images and their index (collective: processes without patches select nothing)
+    unsigned int first_hindex = npatches > 0 ? vecPatches( 0 )->Hindex() : 0;
+    image_offset.resize( max( npatches, 1u ), 0 );
+    image_size.resize( max( npatches, 1u ), 0 );
+    images.resize( max( local_size, ( uint64_t ) 1 ) );
+    H5Space index_space( params.tot_number_of_patches, first_hindex, npatches );
+    H5Space index_mem( npatches );
+    f.array( "patch_offset", image_offset[0], H5T_NATIVE_UINT64, &index_space, &index_mem );
+    f.array( "patch_size", image_size[0], H5T_NATIVE_UINT64, &index_space, &index_mem );
+    H5Space images_space( global_size, global_offset, local_size );
+    H5Space images_mem( local_size );
+    f.array( "patches", images[0], H5T_NATIVE_CHAR, &images_space, &images_mem );
+
+    // Write the latest Id that the MPI processes have given to each species
+    for( unsigned int idiag=0; idiag<vecPatches.localDiags.size(); idiag++ ) {
+        if( DiagnosticTrack *track = dynamic_cast<DiagnosticTrack *>( vecPatches.localDiags[idiag] ) ) {
+            ostringstream n( "" );
+            n<< "latest_ID_" << track->species_name_;
+            vector<uint64_t> latest_IDs( nprocs );
+            MPI_Gather( &track->latest_Id, 1, MPI_UINT64_T, &latest_IDs[0], 1, MPI_UINT64_T, 0, smpi->world() );
+            f.array( n.str(), latest_IDs[0], H5T_NATIVE_UINT64, &rank_space, &rank_mem );
+        }
+    }
+
+    // Write the moving window status
+    if( simWin!=NULL ) {
+        dumpMovingWindow( f, simWin );
+    }
+}
+
+
+MPI_Info Checkpoint::sharedFileHints()
+{
+    // Collective buffering: only a few aggregators per node actually access the file
+    MPI_Info info;
+    MPI_Info_create( &info );
+    MPI_Info_set( info, ( char * )"romio_cb_write", ( char * )"enable" );
+    MPI_Info_set( info, ( char * )"romio_cb_read", ( char * )"enable" );
+    if( aggregators_per_node > 0 ) {
+        ostringstream t( "" );
+        t << "*:" << aggregators_per_node;
+        MPI_Info_set( info, ( char * )"cb_config_list", const_cast<char *>( t.str().c_str() ) );
+    }
+    return info;
+}
+
+
 void Checkpoint::readPatchDistribution( SmileiMPI *smpi, SimWindow *simWin )
 {
     H5Read f( restart_file );
@@ -571,7 +794,21 @@ void Checkpoint::readPatchDistribution( SmileiMPI *smpi, SimWindow *simWin )
     }
 
     vector<int> patch_count( smpi->getSize() );
-    f.vect( "patch_count", patch_count );
+    restart_shared_file = f.hasAttr( "number_of_processes" );
+    int dump_nprocs = smpi->getSize();
+    if( restart_shared_file ) {
+        f.attr( "number_of_processes", dump_nprocs );
+    }
+    if( dump_nprocs == smpi->getSize() ) {
+        f.vect( "patch_count", patch_count );
+    } else {
+        // A shared file may be restarted with a different number of processes: patches are distributed evenly
+        int npatches = f.vectSize( "patch_offset" );
+        MESSAGE( 1, "Restarting on " << smpi->getSize() << " processes a dump made by " << dump_nprocs << " processes" );
+        for( int rk=0 ; rk<smpi->getSize() ; rk++ ) {
+            patch_count[rk] = npatches / smpi->getSize() + ( rk < npatches % smpi->getSize() ? 1 : 0 );
+        }
+    }
     smpi->patch_count = patch_count;
 
     smpi->patch_refHindexes.resize( smpi->patch_count.size(), 0 );
@@ -589,6 +826,14 @@ void Checkpoint::restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI
 {
     MESSAGE( 1, "READING fields and particles for restart" );
 
+    if( restart_shared_file ) {
+        if( params.multiple_decomposition ) {
+            ERROR( "Cannot restart MultipleDecomposition from a shared checkpoint file" );
+        }
+        restartAllShared( vecPatches, smpi, params );
+        return;
+    }
+
     H5Read f( restart_file );
 
     // Write diags scalar data
@@ -639,10 +884,6 @@ void Checkpoint::restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI
         H5Read g = f.group( patchName );
 
         restartPatch( vecPatches( ipatch ), params, g );
-
-        // Random number generator state
-        g.attr( "xorshift32_state", vecPatches( ipatch )->rand_->xorshift32_state );
-
     }
 
     if (params.multiple_decomposition) {
@@ -669,6 +910,99 @@ void Checkpoint::restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI
 }
 
 
+void Checkpoint::restartAllShared( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params )
+{
+    MPI_Comm comm = smpi->world();
+    MPI_Info info = sharedFileHints();
+    H5Read f( restart_file, &comm, true, info );
+    MPI_Info_free( &info );
+
+    DiagnosticScalar *scalars = static_cast<DiagnosticScalar *>( vecPatches.globalDiags[0] );
+    f.attr( "latest_timestep", scalars->latest_timestep );
+    // Scalars and global Poynting values only by master
+    if( smpi->isMaster() ) {
+        f.attr( "Energy_time_zero",  scalars->Energy_time_zero );
+        f.attr( "EnergyUsedForNorm", scalars->EnergyUsedForNorm );
+        for( unsigned int j=0; j<2; j++ ) { //directions (xmin/xmax, ymin/ymax, zmin/zmax)
+            for( unsigned int i=0; i<params.nDim_field; i++ ) { //axis 0=x, 1=y, 2=z
+                string poy_name = Tools::merge( "Poy", Tools::xyz[i], j==0?"min":"max" );
+                if( f.hasAttr( poy_name ) ) {
+                    f.attr( poy_name, vecPatches( 0 )->EMfields->poynting[j][i] );
+                }
+            }
+        }
+    }
+
+    // Read the diags screen data (collective read, kept by master)
+    unsigned int iscreen = 0;
+    for( unsigned int idiag=0; idiag<vecPatches.globalDiags.size(); idiag++ ) {
+        if( DiagnosticScreen *screen = dynamic_cast<DiagnosticScreen *>( vecPatches.globalDiags[idiag] ) ) {
+            ostringstream diagName( "" );
+            diagName << "DiagScreen" << iscreen;
+            int target_size = screen->getData()->size();
+            int vect_size = f.vectSize( diagName.str() );
+            if( vect_size == target_size && vect_size > 0 ) {
+                vector<double> data;
+                f.vect( diagName.str(), data, true );
+                if( smpi->isMaster() ) {
+                    *( screen->getData() ) = data;
+                }
+            } else {
+                WARNING( "Restart: DiagScreen[" << iscreen << "] size mismatch. Previous data discarded" );
+            }
+            iscreen++;
+        }
+    }
+
+    // The images of the local patches are contiguous in the file
+    // (collective reads: processes without patches select nothing)
+    unsigned int npatches = vecPatches.size();
+    unsigned int first_hindex = npatches > 0 ? vecPatches( 0 )->Hindex() : 0;
+    vector<uint64_t> image_offset( max( npatches, 1u ), 0 ), image_size( max( npatches, 1u ), 0 );
+    H5Space index_space( f.shape( "patch_offset" )[0], first_hindex, npatches );
+    H5Space index_mem( npatches );
+    f.array( "patch_offset", image_offset[0], H5T_NATIVE_UINT64, &index_space, &index_mem );
+    f.array( "patch_size", image_size[0], H5T_NATIVE_UINT64, &index_space, &index_mem );
+    uint64_t start = image_offset[0];
+    uint64_t end = npatches > 0 ? image_offset[npatches-1] + image_size[npatches-1] : start;
+    vector<char> images( max( end - start, ( uint64_t ) 1 ) );
+    H5Space images_space( f.shape( "patches" )[0], start, end - start );
+    H5Space images_mem( end - start );
+    f.array( "patches", images[0], H5T_NATIVE_CHAR, &images_space, &images_mem );
+
+    // Read all the patch data from their images
+    for( unsigned int ipatch=0 ; ipatch<npatches; ipatch++ ) {
+        ostringstream patch_name( "" );
+        patch_name << setfill( '0' ) << setw( 6 ) << vecPatches( ipatch )->Hindex();
+        string patchName = Tools::merge( "patch-", patch_name.str() );
+        H5Read g( patchName, &images[image_offset[ipatch] - start], image_size[ipatch] );
+
+        restartPatch( vecPatches( ipatch ), params, g );
+    }
+
+    // Read the latest Id that the MPI processes have given to each species
+    for( unsigned int idiag=0; idiag<vecPatches.localDiags.size(); idiag++ ) {
+        if( DiagnosticTrack *track = dynamic_cast<DiagnosticTrack *>( vecPatches.localDiags[idiag] ) ) {
+            ostringstream n( "" );
+            n<< "latest_ID_" << track->species_name_;
+            if( f.has( n.str() ) ) {
+                vector<uint64_t> latest_IDs;
+                f.vect( n.str(), latest_IDs, H5T_NATIVE_UINT64, true );
+                if( smpi->getRank() < ( int ) latest_IDs.size() ) {
+                    track->latest_Id = latest_IDs[smpi->getRank()];
+                } else {
+                    // This process did not exist in the previous run: new range of IDs
+                    track->latest_Id = smpi->getRank() * 4294967296;
+                }
+            } else {
+                track->IDs_done=false;
+            }
+        }
+    }
+
+}
+
+
 void Checkpoint::readRegionDistribution( Region &region )
 {
     int read_hindex( -1 );
@@ -876,7 +1210,7 @@ void Checkpoint::restartPatch( Patch *patch, Params &params, H5Read &g )
             for( unsigned int i=0; i<spec->particles->Position.size(); i++ ) {
                 ostringstream namePos( "" );
                 namePos << "Position-" << i;
-                s.vect( namePos.str(), spec->particles->Position[i] );
+                restartPositions( s, namePos.str(), spec->particles->Position[i] );
             }
 
             for( unsigned int i=0; i<spec->particles->Momentum.size(); i++ ) {
@@ -956,13 +1290,156 @@ void Checkpoint::restartPatch( Patch *patch, Params &params, H5Read &g )
 
 void Checkpoint::dumpFieldsPerProc( H5Write &g, Field *field )
 {
-    g.vect( field->name, *field->data_, field->globalDims_, H5T_NATIVE_DOUBLE );
+    if( ! linkToDumpedData( g, field->name, field->data_, field->globalDims_ ) ) {
+        g.vect( field->name, *field->data_, field->globalDims_, H5T_NATIVE_DOUBLE, 0, 0, dump_deflate );
+    }
 }
 
 void Checkpoint::dump_cFieldsPerProc( H5Write &g, Field *field )
 {
     cField *cfield = static_cast<cField *>( field );
-    g.vect( field->name, *cfield->cdata_, 2*field->globalDims_, H5T_NATIVE_DOUBLE );
+    if( ! linkToDumpedData( g, field->name, reinterpret_cast<double *>( cfield->cdata_ ), 2*field->globalDims_ ) ) {
+        g.vect( field->name, *cfield->cdata_, 2*field->globalDims_, H5T_NATIVE_DOUBLE, 0, 0, dump_deflate );
+    }
+}
+
+static inline uint64_t rotl64( uint64_t x, int r )
+{
+    return ( x << r ) | ( x >> ( 64 - r ) );
+}
+
+static inline uint64_t fmix64( uint64_t k )
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+// 128-bit MurmurHash3 (x64 variant): every input bit affects all the output bits.
+// Only used to find candidates: the data is compared with the candidate before linking.
+static pair<uint64_t, uint64_t> hashDumpedData( const void *data, size_t nbytes )
+{
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+    uint64_t h1 = 0, h2 = 0;
+    const unsigned char *bytes = static_cast<const unsigned char *>( data );
+    size_t nblocks = nbytes / 16;
+    for( size_t i=0; i<nblocks; i++ ) {
+        uint64_t k1, k2;
+        memcpy( &k1, bytes + 16*i, 8 );
+        memcpy( &k2, bytes + 16*i + 8, 8 );
+        k1 *= c1; k1 = rotl64( k1, 31 ); k1 *= c2; h1 ^= k1;
+        h1 = rotl64( h1, 27 ); h1 += h2; h1 = h1*5 + 0x52dce729;
+        k2 *= c2; k2 = rotl64( k2, 33 ); k2 *= c1; h2 ^= k2;
+        h2 = rotl64( h2, 31 ); h2 += h1; h2 = h2*5 + 0x38495ab5;
+    }
+    // Remaining bytes
+    uint64_t k1 = 0, k2 = 0;
+    size_t tail = nbytes - 16*nblocks;
+    const unsigned char *t = bytes + 16*nblocks;
+    for( size_t i=tail; i>8; i-- ) {
+        k2 ^= ( uint64_t ) t[i-1] << ( 8*( i-9 ) );
+    }
+    for( size_t i=min( tail, ( size_t ) 8 ); i>0; i-- ) {
+        k1 ^= ( uint64_t ) t[i-1] << ( 8*( i-1 ) );
+    }
+    if( tail > 8 ) {
+        k2 *= c2; k2 = rotl64( k2, 33 ); k2 *= c1; h2 ^= k2;
+    }
+    if( tail > 0 ) {
+        k1 *= c1; k1 = rotl64( k1, 31 ); k1 *= c2; h1 ^= k1;
+    }
+    // Finalization
+    h1 ^= ( uint64_t ) nbytes;
+    h2 ^= ( uint64_t ) nbytes;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64( h1 );
+    h2 = fmix64( h2 );
+    h1 += h2;
+    h2 += h1;
+    return make_pair( h1, h2 );
+}
+
+bool Checkpoint::linkToDumpedData( H5Write &g, string name, double *data, size_t ndoubles )
+{
+    if( full_dump_every <= 1 || ndoubles == 0 ) {
+        return false;
+    }
+
+    size_t nbytes = ndoubles * sizeof( double );
+    pair<pair<uint64_t, uint64_t>, size_t> key( hashDumpedData( data, nbytes ), nbytes );
+    map<pair<pair<uint64_t, uint64_t>, size_t>, pair<string, string> >::iterator found = dumped_data.find( key );
+
+    // New data: remember where it is going to be written
+    if( found == dumped_data.end() ) {
+        dumped_data[key] = make_pair( current_dump_file, g.path() + "/" + name );
+        return false;
+    }
+
+    // Same hash as data already written in this dump or in a previous one of the chain
+    bool external = found->second.first != current_dump_file;
+    if( external ) {
+        g.externalLink( name, found->second.first, found->second.second );
+    } else {
+        g.hardLink( name, found->second.second );
+    }
+
+    // The link is kept only if it points to exactly the same bytes
+    link_check_buffer.resize( ndoubles );
+    if( ! g.readDoubles( name, &link_check_buffer[0], ndoubles )
+        || memcmp( &link_check_buffer[0], data, nbytes ) != 0 ) {
+        g.unlink( name );
+        return false;
+    }
+    if( external ) {
+        linked_dump_files.insert( found->second.first );
+    }
+    return true;
+}
+
+template<typename T>
+void Checkpoint::dumpParticleProperty( H5Write &g, string name, vector<T> &v, hid_t type )
+{
+    g.vect( name, v[0], v.size(), type, 0, 0, dump_deflate );
+}
+
+// When compressed, positions (sorted by cell) are written as the XOR of consecutive values:
+// the sign, exponent and leading mantissa bits mostly cancel out, leaving bytes of zeros
+// which the shuffle + deflate filters compress much better than raw floating-point values
+void Checkpoint::dumpPositions( H5Write &g, string name, vector<double> &x )
+{
+    if( dump_deflate <= 0 ) {
+        dumpParticleProperty( g, name, x, H5T_NATIVE_DOUBLE );
+        return;
+    }
+    size_t n = x.size();
+    predicted_buffer.resize( n );
+    const uint64_t *bits = reinterpret_cast<const uint64_t *>( &x[0] );
+    predicted_buffer[0] = bits[0];
+    for( size_t i=1; i<n; i++ ) {
+        predicted_buffer[i] = bits[i] ^ bits[i-1];
+    }
+    H5Write d = g.vect( name, predicted_buffer[0], n, H5T_NATIVE_UINT64, 0, 0, dump_deflate );
+    d.attr( "predictor", "xor" );
+}
+
+void Checkpoint::restartPositions( H5Read &g, string name, vector<double> &x )
+{
+    bool predicted = g.dataset( name ).hasAttr( "predictor" );
+    if( ! predicted ) {
+        g.vect( name, x );
+        return;
+    }
+    // Raw bits are read in place, then decoded
+    g.vect( name, x, H5T_NATIVE_UINT64 );
+    uint64_t *bits = reinterpret_cast<uint64_t *>( &x[0] );
+    for( size_t i=1; i<x.size(); i++ ) {
+        bits[i] ^= bits[i-1];
+    }
 }
 
 void Checkpoint::restartFieldsPerProc( H5Read &g, Field *field )
@@ -9,6 +9,9 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
 
 #include <hdf5.h>
 #include <Tools.h>
@@ -113,6 +116,14 @@ private:
     //! dump moving window parameters
     void dumpMovingWindow( H5Write &f, SimWindow *simWindow );
     
+    //! dump a particle property, compressed if requested
+    template<typename T>
+    void dumpParticleProperty( H5Write &g, std::string name, std::vector<T> &v, hid_t type );
+    
+    //! dump particle positions, with a lossless predictor when compressed
+    void dumpPositions( H5Write &g, std::string name, std::vector<double> &x );
+    void restartPositions( H5Read &g, std::string name, std::vector<double> &x );
+    
     //! function that returns elapsed time from creator (uses private var time_reference)
     //double time_seconds();
     
@@ -133,9 +144,12 @@ private:
     //! write dump drectory
     std::string dump_dir;
     
-    //! int deflate dump value
+    //! compression level (0 to 9) of the dumped arrays
     int dump_deflate;
     
+    //! buffer for the predicted positions
+    std::vector<uint64_t> predicted_buffer;
+    
     std::vector<MPI_Request> dump_request;
     MPI_Status dump_status_prob;
     MPI_Status dump_status_recv;
@@ -146,6 +160,45 @@ private:
     //! restart file
     std::string restart_file;
     
+    //! all processes dump in a single shared file
+    bool shared_file;
+    
+    //! number of MPI-IO aggregators per node when writing the shared file (0 for the MPI-IO default)
+    unsigned int aggregators_per_node;
+    
+    //! whether the restart file is a shared file
+    bool restart_shared_file;
+    
+    //! dump everything to a single file shared by all processes
+    void dumpAllShared( VectorPatch &vecPatches, unsigned int itime, SmileiMPI *smpi, SimWindow *simWin, Params &params );
+    
+    //! restart everything from a single file shared by all processes
+    void restartAllShared( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params );
+    
+    //! MPI-IO hints for the shared file
+    MPI_Info sharedFileHints();
+    
+    //! number of dumps between two full dumps (the dumps in between are incremental)
+    unsigned int full_dump_every;
+    
+    //! number of dumps written since the last full dump (included)
+    unsigned int dump_chain_length;
+    
+    //! name (without directory) of the file being dumped
+    std::string current_dump_file;
+    
+    //! files of previous dumps referenced by the current dump
+    std::set<std::string> linked_dump_files;
+    
+    //! location (file, path) of the data already written since the last full dump, indexed by (128-bit hash, size)
+    std::map<std::pair<std::pair<uint64_t, uint64_t>, size_t>, std::pair<std::string, std::string> > dumped_data;
+    
+    //! links the dataset `name` to identical data already dumped, if any. Returns false when it must be written
+    bool linkToDumpedData( H5Write &g, std::string name, double *data, size_t ndoubles );
+    
+    //! buffer to compare the data with the linked dataset
+    std::vector<double> link_check_buffer;
+    
 };
 
 #endif /* CHECKPOINT_H_ */
@@ -17,6 +17,8 @@ public:
     
     virtual void prepare() = 0;
     virtual void apply( Random *random, BinaryProcessData &D ) = 0;
+    //! Adds the results accumulated by another copy of this process (which treated other bins of the same patch)
+    virtual void merge( BinaryProcess * ) = 0;
     virtual void finish( Params &, Patch *, std::vector<Diagnostic *> &, bool intra, std::vector<unsigned int> sg1, std::vector<unsigned int> sg2, int itime ) = 0;
     virtual std::string name() = 0;
 };
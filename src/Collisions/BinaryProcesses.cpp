@@ -28,6 +28,8 @@ BinaryProcesses::BinaryProcesses(
     int every,
     int debug_every,
     double time_frozen,
+    vector<unsigned int> cells_per_bin,
+    bool debye_length_required,
     string filename
 ) :
     processes_( processes ),
@@ -36,7 +38,9 @@ BinaryProcesses::BinaryProcesses(
     intra_( intra ),
     every_( every ),
     debug_every_( debug_every ),
-    filename_( filename )
+    filename_( filename ),
+    cells_per_bin_( cells_per_bin ),
+    debye_length_required_block_( debye_length_required )
 {
     timesteps_frozen_ = time_frozen / params.timestep;
     // Open the HDF5 file
@@ -59,6 +63,9 @@ BinaryProcesses::BinaryProcesses( BinaryProcesses *BPs )
     timesteps_frozen_   = BPs->timesteps_frozen_  ;
     filename_           = BPs->filename_          ;
     debug_file_         = BPs->debug_file_        ;
+    cells_per_bin_      = BPs->cells_per_bin_     ;
+    debye_length_required_block_ = BPs->debye_length_required_block_;
+    debye_length_squared_ = BPs->debye_length_squared_;
     
     processes_.clear();
     for( unsigned int i=0; i<BPs->processes_.size(); i++ ) {
@@ -85,60 +92,239 @@ BinaryProcesses::~BinaryProcesses()
 }
 
 // Declare other static variables here
-bool BinaryProcesses::debye_length_required_;
 
 
-// Calculates the debye length squared in each bin
+// Make the pairing and launch the processes
+void BinaryProcesses::apply( Params &params, Patch *patch, int itime, vector<Diagnostic *> &localDiags )
+{
+    if( ! isActive( itime ) ) {
+        return;
+    }
+    
+    for( unsigned int i=0; i<processes_.size(); i++ ) {
+        processes_[i]->prepare();
+    }
+    
+    vector<unsigned int> nfine, ncoarse;
+    unsigned int nbin = bins( params, patch, nfine, ncoarse );
+    
+    if( debye_length_required_block_ ) {
+        calculateDebyeLength( params, patch, nbin, nfine, ncoarse );
+    }
+    
+    // Count the macro-particles involved
+    vector<unsigned int> species( species_group1_ );
+    if( ! intra_ ) {
+        species.insert( species.end(), species_group2_.begin(), species_group2_.end() );
+    }
+    unsigned int npart = 0;
+    for( unsigned int i=0; i<species.size(); i++ ) {
+        npart += patch->vecSpecies[species[i]]->getNbrOfParticles();
+    }
+    
+    // Split the bins in chunks of about SMILEI_BINARYPROCESS_TASKSIZE macro-particles.
+    // The splitting does not depend on the number of threads, so that results are reproducible.
+    vector<unsigned int> chunk_start( 1, 0 );
+    if( npart > SMILEI_BINARYPROCESS_TASKSIZE && nbin > 1 ) {
+        vector<unsigned int> count( nbin, 0 );
+        unsigned int nfirst = patch->vecSpecies[0]->particles->first_index.size();
+        for( unsigned int ifine = 0; ifine < nfirst; ifine++ ) {
+            // index of the bin that contains this cell
+            unsigned int ibin = 0, stride = 1, r = ifine;
+            for( int d=( int )nfine.size()-1; d>=0; d-- ) {
+                ibin += ( ( r % nfine[d] ) / cells_per_bin_[d] ) * stride;
+                stride *= ncoarse[d];
+                r /= nfine[d];
+            }
+            if( nfine.empty() ) {
+                ibin = ifine;
+            }
+            for( unsigned int i=0; i<species.size(); i++ ) {
+                Particles *p = patch->vecSpecies[species[i]]->particles;
+                count[ibin] += p->last_index[ifine] - p->first_index[ifine];
+            }
+        }
+        unsigned int n = 0;
+        for( unsigned int ibin = 0; ibin < nbin-1; ibin++ ) {
+            n += count[ibin];
+            if( n >= SMILEI_BINARYPROCESS_TASKSIZE ) {
+                chunk_start.push_back( ibin+1 );
+                n = 0;
+            }
+        }
+    }
+    chunk_start.push_back( nbin );
+    unsigned int nchunk = chunk_start.size() - 1;
+    
+    if( nchunk == 1 ) {
+        applyBins( params, patch, 0, nbin, nfine, ncoarse, patch->rand_ );
+    } else {
+        // Each chunk (other than the first) is treated by a copy of the processes, in a separate task,
+        // with its own sub-stream of the patch random numbers
+        vector<BinaryProcesses *> workers( nchunk, this );
+        vector<Random *> randoms( nchunk, patch->rand_ );
+        for( unsigned int ichunk = 1; ichunk < nchunk; ichunk++ ) {
+            workers[ichunk] = new BinaryProcesses( this );
+            for( unsigned int i=0; i<processes_.size(); i++ ) {
+                workers[ichunk]->processes_[i]->prepare();
+            }
+            randoms[ichunk] = new Random( *patch->rand_ );
+            randoms[ichunk]->substream( ichunk );
+        }
+        for( unsigned int ichunk = 1; ichunk < nchunk; ichunk++ ) {
+            #pragma omp task default(shared) firstprivate(ichunk)
+            workers[ichunk]->applyBins( params, patch, chunk_start[ichunk], chunk_start[ichunk+1], nfine, ncoarse, randoms[ichunk] );
+        }
+        applyBins( params, patch, chunk_start[0], chunk_start[1], nfine, ncoarse, patch->rand_ );
+        #pragma omp taskwait
+        
+        // Gather the results of all chunks
+        for( unsigned int ichunk = 1; ichunk < nchunk; ichunk++ ) {
+            for( unsigned int i=0; i<processes_.size(); i++ ) {
+                processes_[i]->merge( workers[ichunk]->processes_[i] );
+            }
+            delete workers[ichunk];
+            delete randoms[ichunk];
+        }
+    }
+    
+    for( unsigned int i=0; i<processes_.size(); i++ ) {
+        processes_[i]->finish( params, patch, localDiags, intra_, species_group1_, species_group2_, itime );
+    }
+}
+
+
+// Numbers of cells (primal nodes) in each dimension, and of bins made of cells_per_bin_ cells.
+// If particles are not sorted by cell, the bins of the species are used as they are (nfine and ncoarse are empty)
+unsigned int BinaryProcesses::bins( Params &params, Patch *patch, vector<unsigned int> &nfine, vector<unsigned int> &ncoarse )
+{
+    unsigned int ndim = cells_per_bin_.size();
+    nfine.resize( ndim );
+    ncoarse.resize( ndim );
+    unsigned int ncells = 1, nbin = 1;
+    for( unsigned int d=0; d<ndim; d++ ) {
+        nfine[d] = params.n_space[d] + 1;
+        ncoarse[d] = ( nfine[d] + cells_per_bin_[d] - 1 ) / cells_per_bin_[d];
+        ncells *= nfine[d];
+        nbin *= ncoarse[d];
+    }
+    if( ncells != patch->vecSpecies[0]->particles->first_index.size() ) {
+        if( nbin != ncells ) {
+            ERROR( "Collisions: cells_per_bin requires the particles to be sorted by cell" );
+        }
+        nbin = patch->vecSpecies[0]->particles->first_index.size();
+        nfine.clear();
+        ncoarse.clear();
+    }
+    return nbin;
+}
+
+
+// List of the cells in one bin, and volume of the bin
+double BinaryProcesses::binCells( Params &params, Patch *patch, unsigned int ibin, vector<unsigned int> &nfine,
+                                  vector<unsigned int> &ncoarse, vector<unsigned int> &cells, vector<unsigned int> &cells_tmp )
+{
+    double volume = 1.;
+    if( nfine.empty() ) {
+        cells.assign( 1, ibin );
+        for( unsigned int is=0 ; is<patch->vecSpecies.size() ; is++ ) {
+            Particles *p = patch->vecSpecies[is]->particles;
+            if( p->last_index[ibin] > p->first_index[ibin] ) {
+                volume = patch->getPrimalCellVolume( p, p->first_index[ibin], params );
+                break;
+            }
+        }
+    } else {
+        // range of cells [lo, hi[ in each dimension
+        unsigned int lo[3], hi[3], r = ibin;
+        for( int d=( int )nfine.size()-1; d>=0; d-- ) {
+            lo[d] = ( r % ncoarse[d] ) * cells_per_bin_[d];
+            hi[d] = min( lo[d] + cells_per_bin_[d], nfine[d] );
+            r /= ncoarse[d];
+        }
+        cells.assign( 1, 0 );
+        volume = params.cell_volume;
+        for( unsigned int d=0; d<nfine.size(); d++ ) {
+            cells_tmp.resize( 0 );
+            for( unsigned int j=0; j<cells.size(); j++ ) {
+                for( unsigned int i=lo[d]; i<hi[d]; i++ ) {
+                    cells_tmp.push_back( cells[j] * nfine[d] + i );
+                }
+            }
+            cells.swap( cells_tmp );
+            // primal cells at the patch border have half the volume
+            double n = hi[d] - lo[d];
+            if( lo[d] == 0 ) {
+                n -= 0.5;
+            }
+            if( hi[d] == nfine[d] ) {
+                n -= 0.5;
+            }
+            volume *= n;
+        }
+    }
+    return volume;
+}
+
+
+// Calculates, in each cell and for each species, the sums of the weights, of the weights times the charges
+// and of the weights times <v*p> required by the debye length.
+// Called once per patch, before any BinaryProcesses of the patch is applied,
+// so that all use the plasma state of the beginning of the timestep
+void BinaryProcesses::calculateDebyeMoments( Patch *patch )
+{
+    unsigned int nspec = patch->vecSpecies.size();
+    unsigned int ncells = patch->vecSpecies[0]->particles->first_index.size();
+    patch->debye_moments.resize( 3*nspec*ncells );
+    
+    for( unsigned int is=0 ; is<nspec ; is++ ) {
+        Particles *p = patch->vecSpecies[is]->particles;
+        for( unsigned int ic=0; ic<ncells; ic++ ) {
+            double density = 0., charge = 0., temperature = 0.;
+            for( int i=p->first_index[ic]; i<p->last_index[ic]; i++ ) {
+                double p2 = p->momentum( 0, i ) * p->momentum( 0, i )
+                          + p->momentum( 1, i ) * p->momentum( 1, i )
+                          + p->momentum( 2, i ) * p->momentum( 2, i );
+                density     += p->weight( i );
+                charge      += p->weight( i ) * p->charge( i );
+                temperature += p->weight( i ) * p2/sqrt( 1.+p2 );
+            }
+            double *m = &patch->debye_moments[3*( ic*nspec + is )];
+            m[0] = density;
+            m[1] = charge;
+            m[2] = temperature;
+        }
+    }
+}
+
+
+// Calculates the debye length squared in each bin, from the moments of all species in the cells of the bin
 // The formula for the inverse debye length squared is sumOverSpecies(density*charge^2/temperature)
-void BinaryProcesses::calculate_debye_length( Params &params, Patch *patch )
+void BinaryProcesses::calculateDebyeLength( Params &params, Patch *patch, unsigned int nbin,
+                                            vector<unsigned int> &nfine, vector<unsigned int> &ncoarse )
 {
-    Species    *s;
-    Particles *p;
     double coeff = 299792458./( 3.*params.reference_angular_frequency_SI*2.8179403267e-15 ); // c / (3 omega re)
+    unsigned int nspec = patch->vecSpecies.size();
     
-    unsigned int nspec = patch->vecSpecies.size(); // number of species
-    if( nspec==0 ) {
-        return;
-    }
-    unsigned int nbin = patch->vecSpecies[0]->particles->first_index.size();
+    vector<unsigned int> cells, cells_tmp;
+    debye_length_squared_.resize( nbin );
     
-    patch->debye_length_squared.resize( nbin );
-    double mean_debye_length = 0.;
     for( unsigned int ibin = 0 ; ibin < nbin ; ibin++ ) {
-        double density_max = 0.;
-        double inv_D2 = 0.;
-        double inv_cell_volume = 0.;
+        double volume = binCells( params, patch, ibin, nfine, ncoarse, cells, cells_tmp );
         
-        for( unsigned int ispec=0 ; ispec<nspec ; ispec++ ) { // loop all species
-            s  = patch->vecSpecies[ispec];
-            p  = s->particles;
-            
-            // Skip when no particles
-            if( p->last_index[ibin] <= p->first_index[ibin] ) continue;
-            
-            if( inv_cell_volume == 0. ) {
-                inv_cell_volume = 1. / patch->getPrimalCellVolume( p, p->first_index[ibin], params );
-            }
-            
-            // Calculation of particles density, mean charge, and temperature
-            // Density is the sum of weights
-            // Temperature definition is the average <v*p> divided by 3
-            double density     = 0.;
-            double charge      = 0.;
-            double temperature = 0.;
-            // loop particles to calculate average quantities
-            for( unsigned int iPart=p->first_index[ibin]; iPart<( unsigned int )p->last_index[ibin] ; iPart++ ) {
-                double p2 = p->momentum( 0, iPart ) * p->momentum( 0, iPart )
-                     +p->momentum( 1, iPart ) * p->momentum( 1, iPart )
-                     +p->momentum( 2, iPart ) * p->momentum( 2, iPart );
-                density     += p->weight( iPart );
-                charge      += p->weight( iPart ) * p->charge( iPart );
-                temperature += p->weight( iPart ) * p2/sqrt( 1.+p2 );
+        double density_max = 0., inv_D2 = 0.;
+        for( unsigned int is=0 ; is<nspec ; is++ ) {
+            double density = 0., charge = 0., temperature = 0.;
+            for( unsigned int ic=0; ic<cells.size(); ic++ ) {
+                double *m = &patch->debye_moments[3*( cells[ic]*nspec + is )];
+                density     += m[0];
+                charge      += m[1];
+                temperature += m[2];
             }
             if( density > 0. ) {
                 charge /= density; // average charge
-                temperature *= s->mass_ / ( 3.*density ); // Te in units of me*c^2
-                density *= inv_cell_volume; // density in units of critical density
+                temperature *= patch->vecSpecies[is]->mass_ / ( 3.*density ); // Te in units of me*c^2
+                density /= volume; // density in units of critical density
                 // compute inverse debye length squared
                 if( temperature == 0. ) {
                     inv_D2 += 1e100; // infinite
@@ -155,80 +341,106 @@ void BinaryProcesses::calculate_debye_length( Params &params, Patch *patch )
         // if there were particles,
         if( inv_D2 > 0. ) {
             // compute debye length squared in code units
-            patch->debye_length_squared[ibin] = 1./inv_D2;
+            debye_length_squared_[ibin] = 1./inv_D2;
             // apply lower limit to the debye length (minimum interatomic distance)
             double rmin2 = pow( coeff*density_max, -2./3. );
-            if( patch->debye_length_squared[ibin] < rmin2 ) {
-                patch->debye_length_squared[ibin] = rmin2;
+            if( debye_length_squared_[ibin] < rmin2 ) {
+                debye_length_squared_[ibin] = rmin2;
             }
         } else {
-            patch->debye_length_squared[ibin] = 0.;
+            debye_length_squared_[ibin] = 0.;
         }
-        
-        mean_debye_length += sqrt( patch->debye_length_squared[ibin] );
     }
-    
-    mean_debye_length /= nbin;
-    DEBUG( "Mean Debye length in code length units = " << scientific << setprecision( 3 ) << mean_debye_length );
-    mean_debye_length *= 299792458./params.reference_angular_frequency_SI; // switch to SI
-    DEBUG( "Mean Debye length in meters = " << scientific << setprecision( 3 ) << mean_debye_length );
 }
 
 
-// Make the pairing and launch the processes
-void BinaryProcesses::apply( Params &params, Patch *patch, int itime, vector<Diagnostic *> &localDiags )
+// Pairing and processes in a range of bins.
+// For each bin, a single pass over the particles of both groups gathers the lists of particles
+// to be paired and their total weights.
+void BinaryProcesses::applyBins( Params &params, Patch *patch, unsigned int bin_start, unsigned int bin_end,
+                                 vector<unsigned int> &nfine, vector<unsigned int> &ncoarse, Random *random )
 {
-    if( itime < timesteps_frozen_ || itime % every_ != 0 ) {
-        return;
-    }
-    
-    vector<unsigned int> *sg1, *sg2, index1, index2;
-    unsigned int nspec1, nspec2; // numbers of species in each group
-    unsigned int npart1, npart2; // numbers of macro-particles in each group
-    unsigned int npairs; // number of pairs of macro-particles
-    vector<unsigned int> np1, np2; // numbers of macro-particles in each species, in each group
-    unsigned int ispec1, ispec2, N2max;
-    Species   *s1, *s2;
-    Particles *p1=NULL, *p2;
+    unsigned int nspec = patch->vecSpecies.size();
     
-    sg1 = &species_group1_;
-    sg2 = &species_group2_;
-    
-    for( unsigned int i=0; i<processes_.size(); i++ ) {
-        processes_[i]->prepare();
+    // Role of each species: 1 for group 1, 2 for group 2 (3 for both, when intra)
+    vector<unsigned int> role( nspec, 0 );
+    for( unsigned int i=0; i<species_group1_.size(); i++ ) {
+        role[species_group1_[i]] |= 1;
+    }
+    for( unsigned int i=0; i<species_group2_.size(); i++ ) {
+        role[species_group2_[i]] |= 2;
     }
     
-    // Loop bins of particles (typically, cells, but may also be clusters)
-    unsigned int nbin = patch->vecSpecies[0]->particles->first_index.size();
-    for( unsigned int ibin = 0 ; ibin < nbin ; ibin++ ) {
+    vector<unsigned int> cells, cells_tmp, index1, index2;
+    // For both groups, the particles indices, their species, and the sum of their weights
+    vector<unsigned int> ipart[2], ispec[2];
+    double wsum[2];
+    // Whether the groups are swapped so that group 1 has more macro-particles
+    bool swapped = false;
+    unsigned int npairs, N2max;
+    
+    BinaryProcessData D;
+    for( unsigned int ibin = bin_start ; ibin < bin_end ; ibin++ ) {
         
-        BinaryProcessData D;
+        // Make the list of cells in this bin, and its volume
+        double volume = binCells( params, patch, ibin, nfine, ncoarse, cells, cells_tmp );
         
-        // get number of particles for all necessary species
-        for( unsigned int i=0; i<2; i++ ) { // try twice to ensure group 1 has more macro-particles
-            nspec1 = sg1->size();
-            nspec2 = sg2->size();
-            np1.resize( nspec1 ); // number of particles in each species of group 1
-            np2.resize( nspec2 ); // number of particles in each species of group 2
-            npart1 = 0;
-            npart2 = 0;
-            for( ispec1=0 ; ispec1<nspec1 ; ispec1++ ) {
-                s1 = patch->vecSpecies[( *sg1 )[ispec1]];
-                np1[ispec1] = s1->particles->last_index[ibin] - s1->particles->first_index[ibin];
-                npart1 += np1[ispec1];
+        // Single pass over the particles: lists of particles of both groups and their total weights
+        unsigned int n[2] = { 0, 0 };
+        for( unsigned int is=0 ; is<nspec ; is++ ) {
+            Particles *p = patch->vecSpecies[is]->particles;
+            for( unsigned int g=0; g<2; g++ ) {
+                if( ( role[is] & ( 1<<g ) ) && ( g==0 || ! intra_ ) ) {
+                    for( unsigned int ic=0; ic<cells.size(); ic++ ) {
+                        n[g] += p->last_index[cells[ic]] - p->first_index[cells[ic]];
+                    }
+                }
             }
-            for( ispec2=0 ; ispec2<nspec2 ; ispec2++ ) {
-                s2 = patch->vecSpecies[( *sg2 )[ispec2]];
-                np2[ispec2] = s2->particles->last_index[ibin] - s2->particles->first_index[ibin];
-                npart2 += np2[ispec2];
+        }
+        for( unsigned int g=0; g<2; g++ ) {
+            ipart[g].resize( n[g] );
+            ispec[g].resize( n[g] );
+            wsum[g] = 0.;
+            n[g] = 0;
+        }
+        for( unsigned int is=0 ; is<nspec ; is++ ) {
+            if( role[is] == 0 ) {
+                continue;
             }
-            if( npart2 <= npart1 ) {
-                break;    // ok if group1 has more macro-particles
-            } else { // otherwise, we exchange groups and try again
-                swap( sg1, sg2 );
+            Particles *p = patch->vecSpecies[is]->particles;
+            for( unsigned int ic=0; ic<cells.size(); ic++ ) {
+                unsigned int first = p->first_index[cells[ic]], last = p->last_index[cells[ic]];
+                for( unsigned int g=0; g<2; g++ ) {
+                    if( ( role[is] & ( 1<<g ) ) && ( g==0 || ! intra_ ) ) {
+                        for( unsigned int i=first; i<last; i++ ) {
+                            ipart[g][n[g]+i-first] = i;
+                            ispec[g][n[g]+i-first] = is;
+                        }
+                        for( unsigned int i=first; i<last; i++ ) {
+                            wsum[g] += p->weight( i );
+                        }
+                        n[g] += last - first;
+                    }
+                }
             }
         }
-        // now group1 has more macro-particles than group2
+        if( intra_ ) {
+            wsum[1] = wsum[0];
+        }
+        
+        if( debye_length_required_block_ ) {
+            D.debye2 = debye_length_squared_[ibin];
+        }
+        
+        // Ensure group 1 has more macro-particles than group 2
+        unsigned int g1 = intra_ ? 0 : ( swapped ? 1 : 0 );
+        unsigned int g2 = intra_ ? 0 : 1 - g1;
+        if( ipart[g2].size() > ipart[g1].size() ) {
+            swapped = ! swapped;
+            swap( g1, g2 );
+        }
+        unsigned int npart1 = ipart[g1].size();
+        unsigned int npart2 = ipart[g2].size();
         
         // skip to next bin if no particles
         if( npart1==0 || npart2==0 ) {
@@ -243,7 +455,7 @@ void BinaryProcesses::apply( Params &params, Patch *patch, int itime, vector<Dia
         }
         // shuffle the index array
         for( unsigned int i=npart1; i>1; i-- ) {
-            unsigned int p = patch->rand_->integer() % i;
+            unsigned int p = random->integer() % i;
             swap( index1[i-1], index1[p] );
         }
         if( intra_ ) { // In the case of pairing within one species
@@ -267,145 +479,120 @@ void BinaryProcesses::apply( Params &params, Patch *patch, int itime, vector<Dia
         }
         
         // Data for ionization
-        D.electronFirst = patch->vecSpecies[( *sg1 )[0]]->atomic_number_==0 ? true : false;
-        
-        // Calculate the densities
-        double n1  = 0.; // density of group 1
-        for( ispec1=0 ; ispec1<nspec1 ; ispec1++ ) {
-            s1 = patch->vecSpecies[( *sg1 )[ispec1]];
-            p1 = s1->particles;
-            for( int i = p1->first_index[ibin]; i < p1->last_index[ibin]; i++ ) {
-                n1 += p1->weight( i );
-            }
-        }
-        double n2  = 0.; // density of group 2
-        for( ispec2=0 ; ispec2<nspec2 ; ispec2++ ) {
-            s2 = patch->vecSpecies[( *sg2 )[ispec2]];
-            p2 = s2->particles;
-            for( int i = p2->first_index[ibin]; i < p2->last_index[ibin]; i++ ) {
-                n2 += p2->weight( i );
-            }
-        }
-        
-        // Get cell volume
-        ispec1 = -1;
-        do {
-            ispec1++;
-            p1 = patch->vecSpecies[( *sg1 )[ispec1]]->particles;
-        } while( ispec1<nspec1 && p1->first_index[ibin] == p1->last_index[ibin] );
-        double inv_cell_volume = 1./patch->getPrimalCellVolume( p1, p1->first_index[ibin], params );
-        
-        // Set the debye length
-        if( BinaryProcesses::debye_length_required_ ) {
-            D.debye2 = patch->debye_length_squared[ibin];
-        }
+        D.electronFirst = patch->vecSpecies[ispec[g1][0]]->atomic_number_==0 ? true : false;
         
         // Pre-calculate some numbers before the big loop
+        double inv_cell_volume = 1./volume;
         unsigned int ncorr = intra_ ? 2*npairs-1 : npairs;
         double dt_corr = every_ * params.timestep * ((double)ncorr) * inv_cell_volume;
         double weight_correction_1 = 1. / (double)( (npairs-1) / N2max );
         double weight_correction_2 = 1. / (double)( (npairs-1) / N2max + 1 );
-        n1  *= inv_cell_volume;
-        n2  *= inv_cell_volume;
+        double n1 = wsum[g1] * inv_cell_volume;
+        double n2 = wsum[g2] * inv_cell_volume;
         D.n123 = pow( n1, 2./3. );
         D.n223 = pow( n2, 2./3. );
         
-        // Now start the real loop on pairs of particles
+        // Now start the real loop on pairs of particles, by batches
+        // Within a batch, each macro-particle appears only once, so that the pairs are independent
         // See equations in http://dx.doi.org/10.1063/1.4742167
         // ----------------------------------------------------
-        for( unsigned int i = 0; i<npairs; i++ ) {
-            
-            // find species and index i1 of particle "1"
-            D.i1 = index1[i];
-            for( ispec1=0 ; D.i1>=np1[ispec1]; ispec1++ ) {
-                D.i1 -= np1[ispec1];
-            }
-            // find species and index i2 of particle "2"
-            D.i2 = index2[i];
-            for( ispec2=0 ; D.i2>=np2[ispec2]; ispec2++ ) {
-                D.i2 -= np2[ispec2];
-            }
-            
-            s1 = patch->vecSpecies[( *sg1 )[ispec1]];
-            s2 = patch->vecSpecies[( *sg2 )[ispec2]];
-            D.i1 += s1->particles->first_index[ibin];
-            D.i2 += s2->particles->first_index[ibin];
-            D.p1 = s1->particles;
-            D.p2 = s2->particles;
+        unsigned int batch_size = min( N2max, ( unsigned int ) SMILEI_BINARYPROCESS_BUFFERSIZE );
+        for( unsigned int ipair_start = 0; ipair_start < npairs; ipair_start += batch_size ) {
+            unsigned int ipair_end = min( ipair_start + batch_size, npairs );
             
-            D.m1 = s1->mass_;
-            D.m2 = s2->mass_;
-            D.m12 = s1->mass_ / s2->mass_;
-            
-            D.minW = D.p1->weight(D.i1);
-            D.maxW = D.p2->weight(D.i2);
-            if( D.minW > D.maxW ) {
-                swap( D.minW, D.maxW );
+            // Gather the pairs data
+            D.n = 0;
+            for( unsigned int i = ipair_start; i<ipair_end; i++ ) {
+                unsigned int k = D.n;
+                
+                // find species and index of particles "1" and "2"
+                Species *s1 = patch->vecSpecies[ispec[g1][index1[i]]];
+                Species *s2 = patch->vecSpecies[ispec[g2][index2[i]]];
+                D.i1[k] = ipart[g1][index1[i]];
+                D.i2[k] = ipart[g2][index2[i]];
+                D.p1[k] = s1->particles;
+                D.p2[k] = s2->particles;
+                
+                D.W1[k] = D.p1[k]->weight( D.i1[k] );
+                D.W2[k] = D.p2[k]->weight( D.i2[k] );
+                
+                // If one weight is zero, then skip. Can happen after nuclear reaction
+                if( D.W1[k] <= 0. || D.W2[k] <= 0. ) continue;
+                
+                D.m1[k] = s1->mass_;
+                D.m2[k] = s2->mass_;
+                D.m12[k] = s1->mass_ / s2->mass_;
+                
+                // Weight correction only: the full correction is computed below, once maxW is known
+                D.dt_correction[k] = i % N2max <= (npairs-1) % N2max ? weight_correction_2 : weight_correction_1;
+                
+                D.px1[k] = D.p1[k]->momentum( 0, D.i1[k] );
+                D.py1[k] = D.p1[k]->momentum( 1, D.i1[k] );
+                D.pz1[k] = D.p1[k]->momentum( 2, D.i1[k] );
+                D.px2[k] = D.p2[k]->momentum( 0, D.i2[k] );
+                D.py2[k] = D.p2[k]->momentum( 1, D.i2[k] );
+                D.pz2[k] = D.p2[k]->momentum( 2, D.i2[k] );
+                
+                D.n++;
             }
-            
-            // If one weight is zero, then skip. Can happen after nuclear reaction
-            if( D.minW <= 0. ) continue;
-            
-            D.dt_correction = D.maxW * dt_corr;
-            if( i % N2max <= (npairs-1) % N2max ) {
-                D.dt_correction *= weight_correction_2 ;
-            } else {
-                D.dt_correction *= weight_correction_1;
-            }
-            
-            // Get momenta and calculate gammas
-            
-            D.gamma1 = D.p1->LorentzFactor( D.i1 );
-            D.gamma2 = D.p2->LorentzFactor( D.i2 );
-            double gamma12 = D.m12 * D.gamma1 + D.gamma2;
-            double gamma12_inv = 1./gamma12;
-            
-            // Calculate the center-of-mass (COM) frame
-            // Quantities starting with "COM" are those of the COM itself, expressed in the lab frame.
-            // They are NOT quantities relative to the COM.
-            D.COM_vx = ( D.m12 * ( D.p1->momentum( 0, D.i1 ) ) + D.p2->momentum( 0, D.i2 ) ) * gamma12_inv;
-            D.COM_vy = ( D.m12 * ( D.p1->momentum( 1, D.i1 ) ) + D.p2->momentum( 1, D.i2 ) ) * gamma12_inv;
-            D.COM_vz = ( D.m12 * ( D.p1->momentum( 2, D.i1 ) ) + D.p2->momentum( 2, D.i2 ) ) * gamma12_inv;
-            double COM_vsquare = D.COM_vx*D.COM_vx + D.COM_vy*D.COM_vy + D.COM_vz*D.COM_vz;
-            
-            // Change the momentum to the COM frame (we work only on particle 1)
-            // Quantities ending with "COM" are quantities of the particle expressed in the COM frame.
-            if( COM_vsquare < 1e-6 ) {
-                D.COM_gamma = 1. +0.5 * COM_vsquare;
-                D.term1 = 0.5;
-            } else {
-                D.COM_gamma = 1./sqrt( 1.-COM_vsquare );
-                D.term1 = ( D.COM_gamma - 1. ) / COM_vsquare;
+
+            // Calculate the kinematics of all pairs
+            #pragma omp simd
+            for( unsigned int k = 0; k<D.n; k++ ) {
+                
+                D.minW[k] = min( D.W1[k], D.W2[k] );
+                D.maxW[k] = max( D.W1[k], D.W2[k] );
+                D.dt_correction[k] = D.maxW[k] * dt_corr * D.dt_correction[k];
+                
+                // Calculate gammas
+                D.gamma1[k] = sqrt( 1. + D.px1[k]*D.px1[k] + D.py1[k]*D.py1[k] + D.pz1[k]*D.pz1[k] );
+                D.gamma2[k] = sqrt( 1. + D.px2[k]*D.px2[k] + D.py2[k]*D.py2[k] + D.pz2[k]*D.pz2[k] );
+                double gamma12 = D.m12[k] * D.gamma1[k] + D.gamma2[k];
+                double gamma12_inv = 1./gamma12;
+                
+                // Calculate the center-of-mass (COM) frame
+                // Quantities starting with "COM" are those of the COM itself, expressed in the lab frame.
+                // They are NOT quantities relative to the COM.
+                D.COM_vx[k] = ( D.m12[k] * D.px1[k] + D.px2[k] ) * gamma12_inv;
+                D.COM_vy[k] = ( D.m12[k] * D.py1[k] + D.py2[k] ) * gamma12_inv;
+                D.COM_vz[k] = ( D.m12[k] * D.pz1[k] + D.pz2[k] ) * gamma12_inv;
+                double COM_vsquare = D.COM_vx[k]*D.COM_vx[k] + D.COM_vy[k]*D.COM_vy[k] + D.COM_vz[k]*D.COM_vz[k];
+                
+                // Change the momentum to the COM frame (we work only on particle 1)
+                // Quantities ending with "COM" are quantities of the particle expressed in the COM frame.
+                if( COM_vsquare < 1e-6 ) {
+                    D.COM_gamma[k] = 1. +0.5 * COM_vsquare;
+                    D.term1[k] = 0.5;
+                } else {
+                    D.COM_gamma[k] = 1./sqrt( 1.-COM_vsquare );
+                    D.term1[k] = ( D.COM_gamma[k] - 1. ) / COM_vsquare;
+                }
+                double vcv1g1  = D.COM_vx[k]*D.px1[k] + D.COM_vy[k]*D.py1[k] + D.COM_vz[k]*D.pz1[k];
+                double vcv2g2  = D.COM_vx[k]*D.px2[k] + D.COM_vy[k]*D.py2[k] + D.COM_vz[k]*D.pz2[k];
+                D.gamma1_COM[k] = ( D.gamma1[k]-vcv1g1 )*D.COM_gamma[k];
+                D.gamma2_COM[k] = ( D.gamma2[k]-vcv2g2 )*D.COM_gamma[k];
+                double term2 = D.term1[k]*vcv1g1 - D.COM_gamma[k] * D.gamma1[k];
+                D.px_COM[k] = D.px1[k] + term2*D.COM_vx[k];
+                D.py_COM[k] = D.py1[k] + term2*D.COM_vy[k];
+                D.pz_COM[k] = D.pz1[k] + term2*D.COM_vz[k];
+                double p2_COM = D.px_COM[k]*D.px_COM[k] + D.py_COM[k]*D.py_COM[k] + D.pz_COM[k]*D.pz_COM[k];
+                D.p_COM[k]  = sqrt( p2_COM );
+                
+                // Calculate some intermediate quantities
+                D.term3[k] = D.COM_gamma[k] * gamma12_inv;
+                double term4 = D.gamma1_COM[k] * D.gamma2_COM[k];
+                D.term5[k] = term4/p2_COM + D.m12[k];
+                D.vrel[k] = D.p_COM[k] / ( D.term3[k] * term4 ); // | v2_COM - v1_COM |
+                D.vrel_corr[k] = D.p_COM[k] / ( D.term3[k] * D.gamma1[k] * D.gamma2[k] );
             }
-            double vcv1g1  = D.COM_vx*( D.p1->momentum( 0, D.i1 ) ) + D.COM_vy*( D.p1->momentum( 1, D.i1 ) ) + D.COM_vz*( D.p1->momentum( 2, D.i1 ) );
-            double vcv2g2  = D.COM_vx*( D.p2->momentum( 0, D.i2 ) ) + D.COM_vy*( D.p2->momentum( 1, D.i2 ) ) + D.COM_vz*( D.p2->momentum( 2, D.i2 ) );
-            D.gamma1_COM = ( D.gamma1-vcv1g1 )*D.COM_gamma;
-            D.gamma2_COM = ( D.gamma2-vcv2g2 )*D.COM_gamma;
-            double term2 = D.term1*vcv1g1 - D.COM_gamma * D.gamma1;
-            D.px_COM = D.p1->momentum( 0, D.i1 ) + term2*D.COM_vx;
-            D.py_COM = D.p1->momentum( 1, D.i1 ) + term2*D.COM_vy;
-            D.pz_COM = D.p1->momentum( 2, D.i1 ) + term2*D.COM_vz;
-            double p2_COM = D.px_COM*D.px_COM + D.py_COM*D.py_COM + D.pz_COM*D.pz_COM;
-            D.p_COM  = sqrt( p2_COM );
-            
-            // Calculate some intermediate quantities
-            D.term3 = D.COM_gamma * gamma12_inv;
-            double term4 = D.gamma1_COM * D.gamma2_COM;
-            D.term5 = term4/p2_COM + D.m12;
-            D.vrel = D.p_COM / ( D.term3 * term4 ); // | v2_COM - v1_COM |
-            D.vrel_corr = D.p_COM / ( D.term3 * D.gamma1 * D.gamma2 );
             
             for( unsigned int i=0; i<processes_.size(); i++ ) {
-                processes_[i]->apply( patch->rand_, D );
+                processes_[i]->apply( random, D );
             }
             
         } // end loop on pairs of particles
         
     } // end loop on bins
-    
-    for( unsigned int i=0; i<processes_.size(); i++ ) {
-        processes_[i]->finish( params, patch, localDiags, intra_, species_group1_, species_group2_, itime );
-    }
 }
 
 
@@ -426,11 +613,14 @@ void BinaryProcesses::debug( Params &params, int itime, unsigned int icoll, Vect
         for( unsigned int ipatch=0; ipatch<npatch; ipatch++ ) {
             
             // debye length
-            unsigned int nbin = vecPatches( ipatch )->debye_length_squared.size();
+            vector<double> &debye_length_squared = vecPatches( ipatch )->vecBPs[icoll]->debye_length_squared_;
+            unsigned int nbin = debye_length_squared.size();
             for( unsigned int ibin=0; ibin<nbin; ibin++ ) {
-                debye_length[ipatch] += vecPatches( ipatch )->debye_length_squared[ibin];
+                debye_length[ipatch] += debye_length_squared[ibin];
+            }
+            if( nbin > 0 ) {
+                debye_length[ipatch] = sqrt( debye_length[ipatch] / nbin );
             }
-            debye_length[ipatch] = sqrt( debye_length[ipatch] / nbin );
             
             // Data from processes
             vector<BinaryProcess*> vBP = vecPatches( ipatch )->vecBPs[icoll]->processes_;
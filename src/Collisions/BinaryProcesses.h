@@ -6,6 +6,9 @@
 #include "H5.h"
 #include "BinaryProcess.h"
 
+//! Approximate number of macro-particles above which the bins of a patch are split in several tasks
+#define SMILEI_BINARYPROCESS_TASKSIZE 20000
+
 class BinaryProcesses
 {
 
@@ -19,6 +22,8 @@ public:
         int every,
         int debug_every,
         double time_frozen,
+        std::vector<unsigned int> cells_per_bin,
+        bool debye_length_required,
         std::string filename
     );
     
@@ -26,11 +31,21 @@ public:
     
     ~BinaryProcesses();
     
-    //! Method to calculate the Debye length in each bin
-    static void calculate_debye_length( Params &, Patch * );
+    //! Whether the processes are applied at this timestep
+    bool isActive( int itime )
+    {
+        return itime >= timesteps_frozen_ && itime % every_ == 0;
+    }
+    
+    //! Whether the processes are applied at this timestep and need the debye length
+    bool needsDebyeLength( int itime )
+    {
+        return debye_length_required_block_ && isActive( itime );
+    }
     
-    //! True if any of the BinaryProcesses objects need automatically-computed coulomb log
-    static bool debye_length_required_;
+    //! Calculate the moments of the species in each cell required by the debye length, once per patch
+    //! before any BinaryProcesses of the patch is applied
+    static void calculateDebyeMoments( Patch * );
     
     //! Apply processes at each timestep
     void apply( Params &, Patch *, int, std::vector<Diagnostic *> & );
@@ -66,6 +81,31 @@ private:
     //! Debugging file name
     std::string filename_;
     
+    //! Number of cells, in each dimension, gathered in one bin
+    std::vector<unsigned int> cells_per_bin_;
+    
+    //! Whether these processes need the debye length (automatic coulomb log)
+    bool debye_length_required_block_;
+    
+    //! Debye length squared in each bin
+    std::vector<double> debye_length_squared_;
+    
+    //! Calculate the debye length in each bin, from the moments of the species in the patch
+    void calculateDebyeLength( Params &, Patch *, unsigned int nbin, std::vector<unsigned int> &nfine, std::vector<unsigned int> &ncoarse );
+    
+    //! Number of bins, and numbers of cells and bins in each dimension (empty if particles are not sorted by cell)
+    unsigned int bins( Params &, Patch *, std::vector<unsigned int> &nfine, std::vector<unsigned int> &ncoarse );
+    
+    //! List of the cells in one bin. Returns the volume of the bin
+    double binCells( Params &, Patch *, unsigned int ibin, std::vector<unsigned int> &nfine, std::vector<unsigned int> &ncoarse,
+                     std::vector<unsigned int> &cells, std::vector<unsigned int> &cells_tmp );
+    
+    //! Make the pairing and apply processes in bins [bin_start, bin_end[
+    //! nfine: number of cell bins of the species, in each dimension
+    //! ncoarse: number of collision bins, in each dimension
+    void applyBins( Params &, Patch *, unsigned int bin_start, unsigned int bin_end,
+                    std::vector<unsigned int> &nfine, std::vector<unsigned int> &ncoarse, Random *random );
+    
 };
 
 #endif
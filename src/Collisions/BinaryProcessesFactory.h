@@ -1,6 +1,8 @@
 #ifndef BINARYPROCESSESFACTORY_H
 #define BINARYPROCESSESFACTORY_H
 
+#include <algorithm>
+
 #include "BinaryProcesses.h"
 #include "BinaryProcess.h"
 #include "Collisions.h"
@@ -14,7 +16,7 @@ class BinaryProcessesFactory
 public:
 
     //! Create one BinaryProcesses object from the input file
-    static BinaryProcesses *create( Params &params, std::vector<Species *> vecSpecies, unsigned int n_binary_processes, bool &debye_length_required )
+    static BinaryProcesses *create( Params &params, std::vector<Species *> vecSpecies, unsigned int n_binary_processes )
     {
         
         // Read the input file by searching for the keywords "species1" and "species2"
@@ -63,6 +65,28 @@ public:
         double time_frozen = 0.; // default
         PyTools::extract( "time_frozen", time_frozen, "Collisions", n_binary_processes );
         
+        // Number of cells, in each dimension, gathered in one collision bin
+        std::vector<unsigned int> cells_per_bin( params.nDim_field, 1 );
+        PyObject * py_cells_per_bin = PyTools::extract_py( "cells_per_bin", "Collisions", n_binary_processes );
+        int c = 1;
+        if( PyTools::py2scalar( py_cells_per_bin, c ) ) {
+            std::vector<int> v( params.nDim_field, c );
+            cells_per_bin.assign( v.begin(), v.end() );
+        } else {
+            std::vector<int> v;
+            if( ! PyTools::py2vector( py_cells_per_bin, v ) || v.size() != params.nDim_field ) {
+                ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": cells_per_bin must be an integer or a list of "
+                    << params.nDim_field << " integers", LINK_NAMELIST + std::string("#collisions-reactions") );
+            }
+            cells_per_bin.assign( v.begin(), v.end() );
+            c = *std::min_element( v.begin(), v.end() );
+        }
+        Py_DECREF( py_cells_per_bin );
+        if( c < 1 ) {
+            ERROR_NAMELIST( "In collisions #" << n_binary_processes << ": cells_per_bin must be strictly positive",
+                LINK_NAMELIST + std::string("#collisions-reactions") );
+        }
+        
         // Now make all the binary processes
         std::vector<BinaryProcess*> processes;
         
@@ -142,10 +166,6 @@ public:
         double clog = -1., clog_factor = 1.; // default
         PyTools::extract( "coulomb_log", clog, "Collisions", n_binary_processes );
         if( clog >= 0. ) {
-                
-            if( clog == 0. ) {
-                debye_length_required = true;    // auto coulomb log requires debye length
-            }
         
             // possibility to multiply the Coulomb by a factor
             PyTools::extract( "coulomb_log_factor", clog_factor, "Collisions", n_binary_processes );
@@ -272,6 +292,15 @@ public:
             MESSAGE( 2, (iBP+1)<<". "<<processes[iBP]->name() );
         }
         
+        if( cells_per_bin != std::vector<unsigned int>( params.nDim_field, 1 ) ) {
+            t.str( "" );
+            t << cells_per_bin[0];
+            for( unsigned int i=1; i<cells_per_bin.size(); i++ ) {
+                t << "x" << cells_per_bin[i];
+            }
+            MESSAGE( 2, "Bins of " << t.str() << " cells" );
+        }
+        
         if( debug_every>0 ) {
             MESSAGE( 2, "Debug every " << debug_every << " timesteps" );
         }
@@ -317,6 +346,8 @@ public:
             every,
             debug_every,
             time_frozen,
+            cells_per_bin,
+            clog == 0., // auto coulomb log requires debye length
             filename
         );
     }
@@ -326,7 +357,6 @@ public:
     static std::vector<BinaryProcesses *> createVector( Params &params, std::vector<Species *> vecSpecies )
     {
         std::vector<BinaryProcesses *> vecBPs;
-        bool debye_length_required = false;
         
         // Needs reference_angular_frequency_SI to be defined
         unsigned int numcollisions = PyTools::nComponents( "Collisions" );
@@ -339,12 +369,9 @@ public:
         
         // Loop over each binary processes group and parse info
         for( unsigned int n_binary_processes = 0; n_binary_processes < numcollisions; n_binary_processes++ ) {
-            vecBPs.push_back( create( params, vecSpecies, n_binary_processes, debye_length_required ) );
+            vecBPs.push_back( create( params, vecSpecies, n_binary_processes ) );
         }
         
-        // pass the variable "debye_length_required" into the Collision class
-        BinaryProcesses::debye_length_required_ = debye_length_required;
-        
         return vecBPs;
     }
     
@@ -136,21 +136,24 @@ unsigned int CollisionalIonization::createDatabase( double reference_angular_fre
 // Method to apply the ionization
 void CollisionalIonization::apply( Random *random, BinaryProcessData &D )
 {
-    D.gamma1 = D.p1->LorentzFactor( D.i1 );
-    D.gamma2 = D.p2->LorentzFactor( D.i2 );
-    // Calculate lorentz factor in the frame of ion
-    double gamma_s = D.gamma1*D.gamma2
-        - D.p1->momentum( 0, D.i1 )*D.p2->momentum( 0, D.i2 )
-        - D.p1->momentum( 1, D.i1 )*D.p2->momentum( 1, D.i2 )
-        - D.p1->momentum( 2, D.i1 )*D.p2->momentum( 2, D.i2 );
-    // Random numbers
-    double U1 = random->uniform();
-    double U2 = random->uniform();
-    // Calculate the rest of the stuff
-    if( D.electronFirst ) {
-        calculate( gamma_s, D.gamma1, D.gamma2, D.p1, D.i1, D.p2, D.i2, U1, U2, D.dt_correction );
-    } else {
-        calculate( gamma_s, D.gamma2, D.gamma1, D.p2, D.i2, D.p1, D.i1, U1, U2, D.dt_correction );
+    for( unsigned int k = 0; k<D.n; k++ ) {
+        // The momenta may have been modified by previous processes
+        D.gamma1[k] = D.p1[k]->LorentzFactor( D.i1[k] );
+        D.gamma2[k] = D.p2[k]->LorentzFactor( D.i2[k] );
+        // Calculate lorentz factor in the frame of ion
+        double gamma_s = D.gamma1[k]*D.gamma2[k]
+            - D.p1[k]->momentum( 0, D.i1[k] )*D.p2[k]->momentum( 0, D.i2[k] )
+            - D.p1[k]->momentum( 1, D.i1[k] )*D.p2[k]->momentum( 1, D.i2[k] )
+            - D.p1[k]->momentum( 2, D.i1[k] )*D.p2[k]->momentum( 2, D.i2[k] );
+        // Random numbers
+        double U1 = random->uniform();
+        double U2 = random->uniform();
+        // Calculate the rest of the stuff
+        if( D.electronFirst ) {
+            calculate( gamma_s, D.gamma1[k], D.gamma2[k], D.p1[k], D.i1[k], D.p2[k], D.i2[k], U1, U2, D.dt_correction[k] );
+        } else {
+            calculate( gamma_s, D.gamma2[k], D.gamma1[k], D.p2[k], D.i2[k], D.p1[k], D.i1[k], U1, U2, D.dt_correction[k] );
+        }
     }
 }
 
@@ -283,6 +286,14 @@ void CollisionalIonization::calculate( double gamma_s, double gammae, double gam
 }
 
 
+// Gather the electrons created by another copy of this process
+void CollisionalIonization::merge( BinaryProcess *BP )
+{
+    CollisionalIonization *CI = static_cast<CollisionalIonization *>( BP );
+    CI->new_electrons.copyParticles( 0, CI->new_electrons.size(), new_electrons, new_electrons.size() );
+    CI->new_electrons.clear();
+}
+
 // Finish the ionization (moves new electrons in place)
 void CollisionalIonization::finish( Params &params, Patch *patch, std::vector<Diagnostic *> &localDiags, bool intra, std::vector<unsigned int> sg1, std::vector<unsigned int> sg2, int itime )
 {
@@ -63,80 +63,88 @@ CollisionalNuclearReaction::~CollisionalNuclearReaction()
 
 void CollisionalNuclearReaction::apply( Random *random, BinaryProcessData &D )
 {
-    double ekin = D.m1 * (D.gamma1_COM-1.) + D.m2 * (D.gamma2_COM-1.);
+    for( unsigned int k = 0; k<D.n; k++ ) {
+        applyPair( random, D, k );
+    }
+}
+
+void CollisionalNuclearReaction::applyPair( Random *random, BinaryProcessData &D, unsigned int k )
+{
+    double ekin = D.m1[k] * (D.gamma1_COM[k]-1.) + D.m2[k] * (D.gamma2_COM[k]-1.);
     double log_ekin = log( ekin );
     
     // Interpolate the total cross-section at some value of ekin = m1(g1-1) + m2(g2-1)
     double cs = crossSection( log_ekin );
     
     // Calculate probability for reaction
-    double prob = coeff2_ * D.vrel_corr * D.dt_correction * cs * rate_multiplier_;
+    double prob = coeff2_ * D.vrel_corr[k] * D.dt_correction[k] * cs * rate_multiplier_;
     tot_probability_ += prob;
     npairs_tot_ ++;
     if( random->uniform() > exp( -prob ) ) {
         
         // Reaction occurs
         
-        double W = D.minW / rate_multiplier_;
+        double W = D.minW[k] / rate_multiplier_;
         
         // Reduce the weight of both reactants
         // If becomes zero, then the particle will be discarded later
-        D.p1->weight( D.i1 ) -= W;
-        D.p2->weight( D.i2 ) -= W;
-        D.minW -= 0.;
-        D.maxW -= 0.;
+        D.p1[k]->weight( D.i1[k] ) -= W;
+        D.p2[k]->weight( D.i2[k] ) -= W;
+        // The following processes of the batch must see the reduced weights
+        D.W1[k] = D.p1[k]->weight( D.i1[k] );
+        D.W2[k] = D.p2[k]->weight( D.i2[k] );
         
         // Get the magnitude and the angle of the outgoing products in the COM frame
         NuclearReactionProducts products;
-        double tot_charge = D.p1->charge( D.i1 ) + D.p2->charge( D.i2 );
+        double tot_charge = D.p1[k]->charge( D.i1[k] ) + D.p2[k]->charge( D.i2[k] );
         makeProducts( random, ekin, log_ekin, tot_charge, products );
         
         // Calculate new weights
         double newW1, newW2;
         if( tot_charge != 0. ) {
             double weight_factor = W / tot_charge;
-            newW1 = D.p1->charge( D.i1 ) * weight_factor;
-            newW2 = D.p2->charge( D.i2 ) * weight_factor;
+            newW1 = D.p1[k]->charge( D.i1[k] ) * weight_factor;
+            newW2 = D.p2[k]->charge( D.i2[k] ) * weight_factor;
         } else {
             newW1 = W;
             newW2 = 0.;
         }
         
         // For each product
-        double p_perp = sqrt( D.px_COM*D.px_COM + D.py_COM*D.py_COM );
+        double p_perp = sqrt( D.px_COM[k]*D.px_COM[k] + D.py_COM[k]*D.py_COM[k] );
         double newpx_COM=0, newpy_COM=0, newpz_COM=0;
         for( unsigned int iproduct=0; iproduct<products.particles.size(); iproduct++ ){
             // Calculate the deflection in the COM frame
             if( iproduct < products.cosPhi.size() ) { // do not recalculate if all products have same axis
-                if( p_perp > 1.e-10*D.p_COM ) { // make sure p_perp is not too small
+                if( p_perp > 1.e-10*D.p_COM[k] ) { // make sure p_perp is not too small
                     double inv_p_perp = 1./p_perp;
-                    newpx_COM = ( D.px_COM * D.pz_COM * products.cosPhi[iproduct] - D.py_COM * D.p_COM * products.sinPhi[iproduct] ) * inv_p_perp;
-                    newpy_COM = ( D.py_COM * D.pz_COM * products.cosPhi[iproduct] + D.px_COM * D.p_COM * products.sinPhi[iproduct] ) * inv_p_perp;
+                    newpx_COM = ( D.px_COM[k] * D.pz_COM[k] * products.cosPhi[iproduct] - D.py_COM[k] * D.p_COM[k] * products.sinPhi[iproduct] ) * inv_p_perp;
+                    newpy_COM = ( D.py_COM[k] * D.pz_COM[k] * products.cosPhi[iproduct] + D.px_COM[k] * D.p_COM[k] * products.sinPhi[iproduct] ) * inv_p_perp;
                     newpz_COM = -p_perp * products.cosPhi[iproduct];
                 } else { // if p_perp is too small, we use the limit px->0, py=0
-                    newpx_COM = D.p_COM * products.cosPhi[iproduct];
-                    newpy_COM = D.p_COM * products.sinPhi[iproduct];
+                    newpx_COM = D.p_COM[k] * products.cosPhi[iproduct];
+                    newpy_COM = D.p_COM[k] * products.sinPhi[iproduct];
                     newpz_COM = 0.;
                 }
                 // Calculate the deflection in the COM frame
-                newpx_COM = newpx_COM * products.sinX[iproduct] + D.px_COM *products.cosX[iproduct];
-                newpy_COM = newpy_COM * products.sinX[iproduct] + D.py_COM *products.cosX[iproduct];
-                newpz_COM = newpz_COM * products.sinX[iproduct] + D.pz_COM *products.cosX[iproduct];
+                newpx_COM = newpx_COM * products.sinX[iproduct] + D.px_COM[k] *products.cosX[iproduct];
+                newpy_COM = newpy_COM * products.sinX[iproduct] + D.py_COM[k] *products.cosX[iproduct];
+                newpz_COM = newpz_COM * products.sinX[iproduct] + D.pz_COM[k] *products.cosX[iproduct];
             }
             // Go back to the lab frame and store the results in the particle array
-            double vcp = D.COM_vx * newpx_COM + D.COM_vy * newpy_COM + D.COM_vz * newpz_COM;
-            double momentum_ratio = products.new_p_COM[iproduct] / D.p_COM;
-            double term6 = momentum_ratio*D.term1*vcp + sqrt( products.new_p_COM[iproduct]*products.new_p_COM[iproduct] + 1. ) * D.COM_gamma;
-            double newpx = momentum_ratio * newpx_COM + D.COM_vx * term6;
-            double newpy = momentum_ratio * newpy_COM + D.COM_vy * term6;
-            double newpz = momentum_ratio * newpz_COM + D.COM_vz * term6;
+            double vcp = D.COM_vx[k] * newpx_COM + D.COM_vy[k] * newpy_COM + D.COM_vz[k] * newpz_COM;
+            double momentum_ratio = products.new_p_COM[iproduct] / D.p_COM[k];
+            double term6 = momentum_ratio*D.term1[k]*vcp + sqrt( products.new_p_COM[iproduct]*products.new_p_COM[iproduct] + 1. ) * D.COM_gamma[k];
+            double newpx = momentum_ratio * newpx_COM + D.COM_vx[k] * term6;
+            double newpy = momentum_ratio * newpy_COM + D.COM_vy[k] * term6;
+            double newpz = momentum_ratio * newpz_COM + D.COM_vz[k] * term6;
             // Make new particle at position of particle 1
             if( newW1 > 0. ) {
-                products.particles[iproduct]->makeParticleAt( *D.p1, D.i1, newW1, products.q[iproduct], newpx, newpy, newpz );
+                products.particles[iproduct]->makeParticleAt( *D.p1[k], D.i1[k], newW1, products.q[iproduct], newpx, newpy, newpz );
             }
             // Make new particle at position of particle 2
             if( newW2 > 0. ) {
-                products.particles[iproduct]->makeParticleAt( *D.p2, D.i2, newW2, products.q[iproduct], newpx, newpy, newpz );
+                products.particles[iproduct]->makeParticleAt( *D.p2[k], D.i2[k], newW2, products.q[iproduct], newpx, newpy, newpz );
             }
         }
         
@@ -145,6 +153,19 @@ void CollisionalNuclearReaction::apply( Random *random, BinaryProcessData &D )
 }
 
 
+// Gather the products and probabilities of another copy of this process
+void CollisionalNuclearReaction::merge( BinaryProcess *BP )
+{
+    CollisionalNuclearReaction *NR = static_cast<CollisionalNuclearReaction *>( BP );
+    tot_probability_ += NR->tot_probability_;
+    npairs_tot_ += NR->npairs_tot_;
+    for( unsigned int i=0; i<product_particles_.size(); i++ ) {
+        Particles *p = NR->product_particles_[i];
+        p->copyParticles( 0, p->size(), *product_particles_[i], product_particles_[i]->size() );
+        p->clear();
+    }
+}
+
 // Finish the reaction
 void CollisionalNuclearReaction::finish(
     Params &params, Patch *patch, std::vector<Diagnostic *> &localDiags,
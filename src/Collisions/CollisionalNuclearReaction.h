@@ -29,6 +29,9 @@ public:
         npairs_tot_ = 0;
     };
     void apply( Random *random, BinaryProcessData &D );
+    //! Apply the reaction to the pair k of the buffers
+    void applyPair( Random *random, BinaryProcessData &D, unsigned int k );
+    void merge( BinaryProcess * );
     void finish( Params &, Patch *, std::vector<Diagnostic *> &, bool intra, std::vector<unsigned int> sg1, std::vector<unsigned int> sg2, int itime );
     virtual std::string name() = 0;
     
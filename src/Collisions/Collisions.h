@@ -30,6 +30,7 @@ public:
     
     void prepare();
     void apply( Random *random, BinaryProcessData &D );
+    void merge( BinaryProcess * );
     void finish( Params &, Patch *, std::vector<Diagnostic *> &, bool intra, std::vector<unsigned int> sg1, std::vector<unsigned int> sg2, int itime );
     std::string name() {
         std::ostringstream t;
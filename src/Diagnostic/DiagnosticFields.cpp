@@ -3,6 +3,7 @@
 
 #include "DiagnosticFields.h"
 #include "VectorPatch.h"
+#include "StagedWriter.h"
 
 using namespace std;
 
@@ -14,6 +15,7 @@ DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch
     
     filespace = NULL;
     memspace = NULL;
+    staged_writer_ = NULL;
     
     // Extract the time_average parameter
     time_average = 1;
@@ -173,6 +175,35 @@ DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch
     // Extract the flush time selection
     flush_timeSelection = new TimeSelection( PyTools::extract_py( "flush_every", "DiagFields", ndiag ), "DiagFields flush_every" );
     
+    // Extract the number of buffers for writing in the background
+    staging_buffers = 0;
+    PyTools::extract( "staging_buffers", staging_buffers, "DiagFields", ndiag );
+    if( staging_buffers > 0 ) {
+#ifdef _NO_MPI_TM
+        WARNING( "Diagnostic Fields #"<<ndiag<<": `staging_buffers` requires MPI_THREAD_MULTIPLE. Fields will be written synchronously" );
+        staging_buffers = 0;
+#endif
+        if( params.geometry == "AMcylindrical" ) {
+            WARNING( "Diagnostic Fields #"<<ndiag<<": `staging_buffers` not available in AMcylindrical geometry. Fields will be written synchronously" );
+            staging_buffers = 0;
+        }
+    }
+    staged_npoints_ = 0;
+    
+    // Extract the chunking and compression of the datasets
+    chunk_patches = 0;
+    PyTools::extract( "chunk_patches", chunk_patches, "DiagFields", ndiag );
+    deflate = 0;
+    PyTools::extract( "deflate", deflate, "DiagFields", ndiag );
+    if( deflate < 0 || deflate > 9 ) {
+        ERROR_NAMELIST( "Diagnostic Fields #"<<ndiag<<": `deflate` must be between 0 and 9", LINK_NAMELIST + std::string("#diagfields") );
+    }
+    if( ( chunk_patches > 0 || deflate > 0 ) && params.geometry != "3Dcartesian" ) {
+        WARNING( "Diagnostic Fields #"<<ndiag<<": `chunk_patches` and `deflate` only available in 3Dcartesian geometry. They are ignored" );
+        chunk_patches = 0;
+        deflate = 0;
+    }
+    
     // Copy the total number of patches
     tot_number_of_patches = params.tot_number_of_patches;
     
@@ -217,6 +248,23 @@ void DiagnosticFields::openFile( Params &params, SmileiMPI *smpi )
     // Create file
     file_ = new H5Write( filename, &smpi->world() );
     
+    // Datasets written in the background must be contiguous and allocated by HDF5 beforehand
+    if( staging_buffers > 0 && filespace && ! filespace->chunk_.empty() ) {
+        WARNING( "Diagnostic Fields #"<<diag_n<<": `staging_buffers` not available for large (chunked) datasets. Fields will be written synchronously" );
+        staging_buffers = 0;
+    }
+    if( staging_buffers > 0 ) {
+        file_->allocateEarly();
+    }
+    
+    // Compressed datasets (the latest format has a smaller overhead for chunked datasets)
+    if( deflate > 0 ) {
+        file_->compress( deflate );
+    }
+    if( filespace && ! filespace->chunk_.empty() ) {
+        file_->latestFormat();
+    }
+    
     file_->attr( "name", diag_name_ );
     
     // Attributes for openPMD
@@ -226,10 +274,18 @@ void DiagnosticFields::openFile( Params &params, SmileiMPI *smpi )
     data_group_ = new H5Write( file_, "data" );
     
     file_->flush();
+    
+    if( staging_buffers > 0 ) {
+        staged_writer_ = new StagedWriter( filename, smpi->world(), staging_buffers );
+    }
 }
 
 void DiagnosticFields::closeFile()
 {
+    if( staged_writer_ ) {
+        delete staged_writer_;
+        staged_writer_ = NULL;
+    }
     if( data_group_ ) {
         delete data_group_;
         data_group_ = NULL;
@@ -285,6 +341,9 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         // Calculate the structure of the file depending on 1D, 2D, ...
         refHindex = ( unsigned int )( vecPatches.refHindex_ );
         setFileSplitting( smpi, vecPatches );
+        if( staged_writer_ ) {
+            setStagedRuns();
+        }
         
         // Create group for this iteration
         ostringstream name_t;
@@ -319,8 +378,8 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         
         #pragma omp master
         {
-            // Write
-            H5Write dset = writeField( iteration_group_, fields_names[ifield], itime );
+            // Write (or stage for writing in the background)
+            H5Write dset = staged_writer_ ? stageField( iteration_group_, fields_names[ifield] ) : writeField( iteration_group_, fields_names[ifield], itime );
             // Attributes for openPMD
             openPMD_->writeFieldAttributes( dset, subgrid_start_, subgrid_step_ );
             openPMD_->writeRecordAttributes( dset, field_type[ifield] );
@@ -338,12 +397,98 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         iteration_group_->attr( "x_moved", x_moved );
         delete iteration_group_;
         if( flush_timeSelection->theTimeIsNow( itime ) ) {
+            if( staged_writer_ ) {
+                staged_writer_->sync();
+            }
             file_->flush();
         }
     }
     #pragma omp barrier
 }
 
+H5Write DiagnosticFields::stageField( H5Write *loc, string name )
+{
+    // All processes create the dataset, which is allocated at a known address
+    H5Write dset = loc->dataset( name, H5T_NATIVE_DOUBLE, filespace );
+    MPI_Offset address = dset.address();
+    if( address == ( MPI_Offset ) HADDR_UNDEF ) {
+        ERROR( "Diagnostic Fields #"<<diag_n<<": dataset "<<name<<" could not be allocated for staged writing" );
+    }
+    vector<MPI_Offset> offsets( staged_offsets_.size() );
+    for( size_t i=0; i<offsets.size(); i++ ) {
+        offsets[i] = address + staged_offsets_[i];
+    }
+    // The data is handed over to the writer, which returns a free buffer
+    staged_writer_->write( data, offsets, staged_lengths_ );
+    data.resize( staged_npoints_ );
+    return dset;
+}
+
+// The "data" buffer is ordered like the points of the file selection (C order),
+// so that it maps to the runs of contiguous points along the last dimension
+void DiagnosticFields::setStagedRuns()
+{
+    staged_offsets_.resize( 0 );
+    staged_lengths_.resize( 0 );
+    staged_npoints_ = 0;
+    
+    hid_t sid = filespace->sid_;
+    int ndim = filespace->dims_.size();
+    vector<hsize_t> blocks;
+    if( H5Sget_select_type( sid ) == H5S_SEL_ALL ) {
+        blocks.resize( 2*ndim );
+        for( int idim=0; idim<ndim; idim++ ) {
+            blocks[idim] = 0;
+            blocks[ndim+idim] = filespace->dims_[idim] - 1;
+        }
+    } else if( H5Sget_select_type( sid ) == H5S_SEL_HYPERSLABS ) {
+        hssize_t nblocks = H5Sget_select_hyper_nblocks( sid );
+        blocks.resize( 2*ndim*nblocks );
+        if( nblocks > 0 ) {
+            H5Sget_select_hyper_blocklist( sid, 0, nblocks, &blocks[0] );
+        }
+    }
+    
+    // Split each block (given by its corners) in runs along the last dimension
+    vector<pair<hsize_t, hsize_t> > runs;
+    vector<hsize_t> index( ndim );
+    for( size_t b=0; b<blocks.size(); b += 2*ndim ) {
+        hsize_t *start = &blocks[b], *end = &blocks[b+ndim];
+        for( int idim=0; idim<ndim; idim++ ) {
+            index[idim] = start[idim];
+        }
+        while( true ) {
+            hsize_t linear = 0;
+            for( int idim=0; idim<ndim; idim++ ) {
+                linear = linear * filespace->dims_[idim] + index[idim];
+            }
+            runs.push_back( make_pair( linear, end[ndim-1] - start[ndim-1] + 1 ) );
+            // Next run
+            int idim = ndim-2;
+            while( idim >= 0 && index[idim] == end[idim] ) {
+                index[idim] = start[idim];
+                idim--;
+            }
+            if( idim < 0 ) {
+                break;
+            }
+            index[idim]++;
+        }
+    }
+    sort( runs.begin(), runs.end() );
+    
+    // Merge consecutive runs
+    for( size_t i=0; i<runs.size(); i++ ) {
+        if( ! staged_lengths_.empty() && ( hsize_t )( staged_offsets_.back() ) + staged_lengths_.back()*sizeof( double ) == runs[i].first*sizeof( double ) ) {
+            staged_lengths_.back() += runs[i].second;
+        } else {
+            staged_offsets_.push_back( runs[i].first*sizeof( double ) );
+            staged_lengths_.push_back( runs[i].second );
+        }
+        staged_npoints_ += runs[i].second;
+    }
+}
+
 bool DiagnosticFields::needsRhoJs( int itime )
 {
     
@@ -3,6 +3,8 @@
 
 #include "Diagnostic.h"
 
+class StagedWriter;
+
 class DiagnosticFields  : public Diagnostic
 {
 
@@ -25,6 +27,12 @@ public :
     
     virtual H5Write writeField( H5Write*, std::string, int ) = 0;
     
+    //! Create the dataset and stage the current "data" buffer for background writing
+    H5Write stageField( H5Write*, std::string );
+    
+    //! Calculate the runs of contiguous elements of the file selected by this process
+    void setStagedRuns();
+    
     virtual bool needsRhoJs( int itime ) override;
     
     void findSubgridIntersection( unsigned int subgrid_start,
@@ -98,6 +106,24 @@ protected :
     
     //! Save the field type (needed for OpenPMD units dimensionality)
     std::vector<unsigned int> field_type;
+    
+    //! Size of the chunks in the file, in number of patches (0 for contiguous datasets)
+    unsigned int chunk_patches;
+    
+    //! Compression level of the datasets (0 for no compression)
+    int deflate;
+    
+    //! Number of staging buffers for writing in the background (0 for synchronous writing)
+    unsigned int staging_buffers;
+    
+    //! Background writer
+    StagedWriter *staged_writer_;
+    
+    //! Runs of contiguous elements selected in the file by this process (offsets in bytes from the dataset start)
+    std::vector<MPI_Offset> staged_offsets_;
+    std::vector<int> staged_lengths_;
+    //! Total number of elements in the runs
+    size_t staged_npoints_;
 };
 
 #endif
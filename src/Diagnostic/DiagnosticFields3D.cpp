@@ -37,7 +37,24 @@ DiagnosticFields3D::DiagnosticFields3D( Params &params, SmileiMPI *smpi, VectorP
     const hsize_t max_size = 4294967295/2/sizeof( double );
     hsize_t final_size = final_array_size[0] * final_array_size[1] * final_array_size[2];
     vector<hsize_t> chunk_size;
-    if( final_size > max_size ) {
+    if( chunk_patches > 0 || deflate > 0 ) {
+        // Chunks of a few patches, so that a region of the file can be read without reading the rest
+        chunk_size.resize( 3 );
+        hsize_t npatches = max( chunk_patches, 1u );
+        for( unsigned int i=0; i<3; i++ ) {
+            hsize_t target = ( npatches * patch_size[i] + subgrid_step_[i] - 1 ) / subgrid_step_[i];
+            target = max( min( target, final_array_size[i] ), ( hsize_t ) 1 );
+            chunk_size[i] = alignedChunkSize( i, params.number_of_patches[i], npatches, target, final_array_size[i] );
+            // Patch boundaries only allow very small chunks: give up the alignment
+            if( 4 * chunk_size[i] < target ) {
+                WARNING( "Diagnostic Fields #"<<ndiag<<": the subgrid does not allow chunks aligned with patches along dimension "<<i<<". Reading a region of the file may require reading neighbouring patches" );
+                chunk_size[i] = target;
+            }
+        }
+        if( chunk_size[0] * chunk_size[1] * chunk_size[2] > max_size ) {
+            ERROR_NAMELIST( "Diagnostic Fields #"<<ndiag<<": `chunk_patches` is too large (chunks must be smaller than 2 GB)", LINK_NAMELIST + std::string("#diagfields") );
+        }
+    } else if( final_size > max_size ) {
         hsize_t n_chunks = 1 + ( final_size-1 ) / max_size;
         chunk_size.resize( 3 );
         chunk_size[0] = final_array_size[0] / n_chunks;
@@ -59,6 +76,34 @@ DiagnosticFields3D::~DiagnosticFields3D()
 {
 }
 
+// Largest chunk size, not above `target`, such that no chunk straddles the boundary between two groups
+// of `npatches` patches. The chunks start at the first output point, which is generally inside a patch
+// when the subgrid does not start at a patch boundary: the chunks are then smaller than a group of patches.
+// As patches own their upper node, a chunk may also end one point after the boundary.
+hsize_t DiagnosticFields3D::alignedChunkSize( unsigned int idim, unsigned int number_of_patches, hsize_t npatches, hsize_t target, hsize_t size )
+{
+    // First point, in the file, of each group of patches
+    vector<hsize_t> boundaries;
+    for( unsigned int ipatch = npatches; ipatch < number_of_patches; ipatch += npatches ) {
+        hsize_t offset = ipatch * patch_size[idim] + 1, npoints = patch_size[idim], start_in_patch;
+        findSubgridIntersection1( idim, offset, npoints, start_in_patch );
+        if( npoints > 0 && offset > 0 && offset < size ) {
+            boundaries.push_back( offset );
+        }
+    }
+    // Largest chunk dividing either the first point of each group or the one before
+    for( hsize_t chunk = target; chunk > 1; chunk-- ) {
+        bool aligned = true;
+        for( unsigned int i = 0; i < boundaries.size() && aligned; i++ ) {
+            aligned = boundaries[i] % chunk == 0 || ( boundaries[i]-1 ) % chunk == 0;
+        }
+        if( aligned ) {
+            return chunk;
+        }
+    }
+    return 1;
+}
+
 
 struct PatchIXYZ {
     unsigned int i;
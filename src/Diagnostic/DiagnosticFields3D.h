@@ -24,6 +24,9 @@ public:
 private:
 
     std::vector<unsigned int> buffer_skip_x, buffer_skip_y, buffer_skip_z;
+    
+    //! Chunk size along one dimension, aligned with groups of patches
+    hsize_t alignedChunkSize( unsigned int idim, unsigned int number_of_patches, hsize_t npatches, hsize_t target, hsize_t size );
 
 };
 
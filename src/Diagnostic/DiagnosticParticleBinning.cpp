@@ -14,6 +14,22 @@ DiagnosticParticleBinning::DiagnosticParticleBinning(
     int diagId
 ) : DiagnosticParticleBinningBase( params, smpi, patch, diagId, "ParticleBinning", false, nullptr, excludedAxes() )
 {
+    // get parameter "filter", an expression selecting the particles accounted for
+    string expression;
+    if( PyTools::extractOrNone( "filter", expression, "DiagParticleBinning", diagId ) ) {
+        string errorPrefix = "DiagParticleBinning #" + to_string( diagId );
+        filter_ = new ParticleFilter( expression, params.nDim_particle, errorPrefix );
+        if( filter_->needsChi() ) {
+            for( unsigned int ispec=0; ispec<species_indices.size(); ispec++ ) {
+                if( ! patch->vecSpecies[species_indices[ispec]]->particles->isQuantumParameter ) {
+                    ERROR( errorPrefix << ": filter uses `chi` but species " << patch->vecSpecies[species_indices[ispec]]->name_ << " has no quantum parameter" );
+                }
+            }
+        }
+        if( smpi->isMaster() ) {
+            MESSAGE( 2, "Filter: " << expression );
+        }
+    }
 }
 
 DiagnosticParticleBinning::~DiagnosticParticleBinning()
@@ -4,6 +4,10 @@
 #include "DiagnosticParticleBinningBase.h"
 #include "HistogramFactory.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace std;
 
@@ -22,6 +26,7 @@ DiagnosticParticleBinningBase::DiagnosticParticleBinningBase(
 {
     int idiag = diagId;
     time_accumulate = time_accumulate_;
+    filter_ = NULL;
     
     string pyDiag = Tools::merge( "Diag", diagName );
     string errorPrefix = Tools::merge( pyDiag, " #", to_string( idiag ) );
@@ -114,6 +119,19 @@ DiagnosticParticleBinningBase::DiagnosticParticleBinningBase(
     }
     output_size = ( unsigned int ) total_size;
     
+    // Per-thread arrays, allocated by each thread at first use
+#ifdef _OPENMP
+    unsigned int nthreads = omp_get_max_threads();
+#else
+    unsigned int nthreads = 1;
+#endif
+    sparse_ = output_size > SMILEI_BINNING_DENSE_SIZE;
+    thread_int_buffer_   .resize( nthreads );
+    thread_double_buffer_.resize( nthreads );
+    thread_data_         .resize( nthreads );
+    thread_sparse_data_  .resize( nthreads );
+    thread_sparse_compressed_size_.resize( nthreads, 0 );
+    
     // Output info on diagnostics
     if( smpi->isMaster() ) {
         ostringstream mystream( "" );
@@ -139,6 +157,7 @@ DiagnosticParticleBinningBase::DiagnosticParticleBinningBase(
 DiagnosticParticleBinningBase::~DiagnosticParticleBinningBase()
 {
     delete histogram;
+    delete filter_;
 
     delete timeSelection;
     delete flush_timeSelection;
@@ -157,6 +176,9 @@ void DiagnosticParticleBinningBase::openFile( Params &params, SmileiMPI *smpi )
     file_->attr( "Version", string( __VERSION ) );
     file_->attr( "name", diag_name_ );
     file_->attr( "deposited_quantity", histogram->deposited_quantity );
+    if( filter_ ) {
+        file_->attr( "filter", filter_->expression_ );
+    }
     if( ! time_accumulate ) {
         file_->attr( "time_average", time_average );
     }
@@ -246,8 +268,9 @@ void DiagnosticParticleBinningBase::calculate_auto_limits( Patch *patch, SimWind
         if( !std::isnan( axis->min ) && !std::isnan( axis->max ) ) {
             continue;
         }
-        double axis_min = numeric_limits<double>::max();
-        double axis_max = numeric_limits<double>::lowest();
+        // A limit that is not "auto" is kept as is
+        double axis_min = std::isnan( axis->min ) ? numeric_limits<double>::max() : axis->min;
+        double axis_max = std::isnan( axis->max ) ? numeric_limits<double>::lowest() : axis->max;
         for( unsigned int i_s=0; i_s<species_indices.size(); i_s++ ) {
             Species *s = patch->vecSpecies[species_indices[i_s]];
             unsigned int n = s->getNbrOfParticles();
@@ -257,11 +280,26 @@ void DiagnosticParticleBinningBase::calculate_auto_limits( Patch *patch, SimWind
             std::vector<double> double_buffer( n );
             std::vector<int> int_buffer( n, 0 );
             axis->calculate_locations( s, &double_buffer[0], &int_buffer[0], n, simWindow );
-            if( std::isnan( axis->min ) ) {
-                axis_min = min( axis_min, *min_element( double_buffer.begin(), double_buffer.end() ) );
-            }
-            if( std::isnan( axis->max ) ) {
-                axis_max = max( axis_max, *max_element( double_buffer.begin(), double_buffer.end() ) );
+            if( filter_ ) {
+                // Only the particles passing the filter determine the limits
+                filter_->discard( s, &int_buffer[0] );
+                for( unsigned int i=0; i<n; i++ ) {
+                    if( int_buffer[i] >= 0 ) {
+                        if( std::isnan( axis->min ) ) {
+                            axis_min = min( axis_min, double_buffer[i] );
+                        }
+                        if( std::isnan( axis->max ) ) {
+                            axis_max = max( axis_max, double_buffer[i] );
+                        }
+                    }
+                }
+            } else {
+                if( std::isnan( axis->min ) ) {
+                    axis_min = min( axis_min, *min_element( double_buffer.begin(), double_buffer.end() ) );
+                }
+                if( std::isnan( axis->max ) ) {
+                    axis_max = max( axis_max, *max_element( double_buffer.begin(), double_buffer.end() ) );
+                }
             }
         }
         if( axis_min > axis_max ) {
@@ -316,15 +354,146 @@ void DiagnosticParticleBinningBase::run( Patch *patch, int itime, SimWindow *sim
         species.push_back( s );
         npart += s->getNbrOfParticles();
     }
-    vector<int> int_buffer( npart, 0 );
-    vector<double> double_buffer( npart );
-    
-    histogram->digitize( species, double_buffer, int_buffer, simWindow );
-    histogram->valuate( species, double_buffer, int_buffer );
-    histogram->distribute( double_buffer, int_buffer, data_sum );
+    vector<int> *int_buffer;
+    vector<double> *double_buffer;
+    threadBuffers( npart, int_buffer, double_buffer );
+    
+    histogram->digitize( species, *double_buffer, *int_buffer, simWindow );
+    if( filter_ ) {
+        unsigned int istart = 0;
+        for( unsigned int ispec=0; ispec < species.size(); ispec++ ) {
+            filter_->discard( species[ispec], &( *int_buffer )[istart] );
+            istart += species[ispec]->getNbrOfParticles();
+        }
+    }
+    histogram->valuate( species, *double_buffer, *int_buffer );
+    distribute( *double_buffer, *int_buffer );
     
 } // END run
 
+// Scratch arrays of the current thread: no allocation once they are large enough
+void DiagnosticParticleBinningBase::threadBuffers( unsigned int npart, vector<int> *&int_buffer, vector<double> *&double_buffer )
+{
+#ifdef _OPENMP
+    int ithread = omp_get_thread_num();
+#else
+    int ithread = 0;
+#endif
+    int_buffer = &thread_int_buffer_[ithread];
+    double_buffer = &thread_double_buffer_[ithread];
+    int_buffer->assign( npart, 0 );
+    double_buffer->resize( npart );
+}
+
+// Add the contribution of each particle to the histogram of the current thread
+void DiagnosticParticleBinningBase::distribute( vector<double> &double_buffer, vector<int> &int_buffer )
+{
+#ifdef _OPENMP
+    int ithread = omp_get_thread_num();
+#else
+    int ithread = 0;
+#endif
+    if( sparse_ ) {
+        vector<pair<unsigned int, double> > &list = thread_sparse_data_[ithread];
+        histogram->distribute( double_buffer, int_buffer, list );
+        compressSparseIfGrown( ithread );
+    } else {
+        vector<double> &data = thread_data_[ithread];
+        if( data.size() != output_size ) {
+            data.assign( output_size, 0. );
+        }
+        histogram->distribute( double_buffer, int_buffer, data );
+    }
+}
+
+// Sort a sparse histogram by index and sum the contributions to the same index
+void DiagnosticParticleBinningBase::compressSparse( vector<pair<unsigned int, double> > &list )
+{
+    if( list.empty() ) {
+        return;
+    }
+    sort( list.begin(), list.end(), []( const pair<unsigned int, double> &a, const pair<unsigned int, double> &b ) {
+        return a.first < b.first;
+    } );
+    unsigned int n = 0;
+    for( unsigned int i=1; i<list.size(); i++ ) {
+        if( list[i].first == list[n].first ) {
+            list[n].second += list[i].second;
+        } else {
+            list[++n] = list[i];
+        }
+    }
+    list.resize( n+1 );
+}
+
+// Sum the duplicates when the list becomes large. A list with many distinct indices stays large
+// after compression, so it is only compressed again once it has doubled.
+void DiagnosticParticleBinningBase::compressSparseIfGrown( unsigned int ithread )
+{
+    vector<pair<unsigned int, double> > &list = thread_sparse_data_[ithread];
+    size_t &compressed_size = thread_sparse_compressed_size_[ithread];
+    if( list.size() > max( ( size_t ) SMILEI_BINNING_DENSE_SIZE, 2 * compressed_size ) ) {
+        compressSparse( list );
+        compressed_size = list.size();
+    }
+}
+
+// Sum the histograms of all threads into data_sum. Blocks of data_sum are shared among threads,
+// so that the reduction is parallel and does not need atomic operations.
+void DiagnosticParticleBinningBase::reduceThreads()
+{
+    unsigned int nthreads = thread_data_.size();
+    unsigned int nblocks = ( output_size + SMILEI_BINNING_REDUCTION_BLOCK - 1 ) / SMILEI_BINNING_REDUCTION_BLOCK;
+    
+    if( sparse_ ) {
+#ifdef _OPENMP
+        unsigned int ithread = omp_get_thread_num();
+#else
+        unsigned int ithread = 0;
+#endif
+        if( ithread < nthreads ) {
+            compressSparse( thread_sparse_data_[ithread] );
+        }
+        #pragma omp barrier
+        #pragma omp for schedule(static)
+        for( unsigned int iblock=0; iblock<nblocks; iblock++ ) {
+            unsigned int imin = iblock * SMILEI_BINNING_REDUCTION_BLOCK;
+            unsigned int imax = min( imin + SMILEI_BINNING_REDUCTION_BLOCK, output_size );
+            for( unsigned int i=0; i<nthreads; i++ ) {
+                vector<pair<unsigned int, double> > &list = thread_sparse_data_[i];
+                auto it = lower_bound( list.begin(), list.end(), imin, []( const pair<unsigned int, double> &a, unsigned int b ) {
+                    return a.first < b;
+                } );
+                for( ; it != list.end() && it->first < imax; ++it ) {
+                    data_sum[it->first] += it->second;
+                }
+            }
+        }
+        if( ithread < nthreads ) {
+            thread_sparse_data_[ithread].clear();
+            thread_sparse_compressed_size_[ithread] = 0;
+        }
+    } else {
+        #pragma omp for schedule(static)
+        for( unsigned int iblock=0; iblock<nblocks; iblock++ ) {
+            unsigned int imin = iblock * SMILEI_BINNING_REDUCTION_BLOCK;
+            unsigned int n = min( imin + SMILEI_BINNING_REDUCTION_BLOCK, output_size ) - imin;
+            double *sum = &data_sum[imin];
+            for( unsigned int i=0; i<nthreads; i++ ) {
+                if( thread_data_[i].size() != output_size ) {
+                    continue;
+                }
+                double *data = &thread_data_[i][imin];
+                #pragma omp simd
+                for( unsigned int j=0; j<n; j++ ) {
+                    sum[j] += data[j];
+                    data[j] = 0.;
+                }
+            }
+        }
+    }
+}
+
 bool DiagnosticParticleBinningBase::writeNow( int itime ) {
     return itime - timeSelection->previousTime() == time_average-1;
 }
@@ -4,6 +4,12 @@
 #include "Diagnostic.h"
 
 #include "Histogram.h"
+#include "ParticleFilter.h"
+
+//! Largest histogram that is duplicated in each thread; larger ones are accumulated as sparse lists
+#define SMILEI_BINNING_DENSE_SIZE 1048576
+//! Size of the blocks of the histogram summed by each thread during the reduction
+#define SMILEI_BINNING_REDUCTION_BLOCK 4096
 
 class DiagnosticParticleBinningBase : public Diagnostic
 {
@@ -45,10 +51,16 @@ public :
     //! Clear the array
     virtual void clear();
     
+    //! Sum the histograms of all threads into data_sum (called by all threads, after all patches have run)
+    void reduceThreads();
+    
     //! Get memory footprint of current diagnostic
     int getMemFootPrint() override
     {
         int size = output_size*sizeof( double );
+        for( unsigned int i=0; i<thread_data_.size(); i++ ) {
+            size += thread_data_[i].capacity()*sizeof( double );
+        }
         // + data_array + index_array +  axis_array
         // + nparts_max * (sizeof(double)+sizeof(int)+sizeof(double))
         return size;
@@ -76,6 +88,33 @@ protected:
     //! Histogram object
     Histogram *histogram;
     
+    //! Selection of the particles accounted for (NULL if all particles)
+    ParticleFilter *filter_;
+    
+    //! Scratch arrays of the current thread for npart particles (index in the histogram, and contribution)
+    void threadBuffers( unsigned int npart, std::vector<int> *&int_buffer, std::vector<double> *&double_buffer );
+    
+    //! Add the contribution of each particle in the histogram of the current thread
+    void distribute( std::vector<double> &double_buffer, std::vector<int> &int_buffer );
+    
+    //! Sort a sparse histogram by index, summing the contributions to the same index
+    static void compressSparse( std::vector<std::pair<unsigned int, double> > &list );
+    
+    //! Compress the sparse histogram of a thread when it has doubled since its last compression
+    void compressSparseIfGrown( unsigned int ithread );
+    
+    //! Per-thread scratch arrays, reused across patches and timesteps
+    std::vector<std::vector<int> > thread_int_buffer_;
+    std::vector<std::vector<double> > thread_double_buffer_;
+    
+    //! Per-thread histograms, summed in data_sum by reduceThreads(): dense copies of data_sum,
+    //! or sorted lists of (index, contribution) when the histogram has more than SMILEI_BINNING_DENSE_SIZE points
+    bool sparse_;
+    std::vector<std::vector<double> > thread_data_;
+    std::vector<std::vector<std::pair<unsigned int, double> > > thread_sparse_data_;
+    //! Size of each thread's sparse histogram after its last compression
+    std::vector<size_t> thread_sparse_compressed_size_;
+    
     unsigned int output_size;
     
     int total_axes;
@@ -1,21 +1,36 @@
 #include "PyTools.h"
 #include <iomanip>
+#include <limits>
 
 #include "DiagnosticPerformances.h"
+#include "HardwareCounters.h"
 
 
 using namespace std;
 
 const unsigned int n_quantities_double = 19;
 const unsigned int n_quantities_uint   = 4;
+//! Hardware counters: 5 quantities for each of the 4 regions
+const unsigned int n_quantities_hardware = 20;
+const char *hardware_regions[4] = { "particles", "maxwell", "densities", "sync" };
+
+//! Get the hardware counters flag (required before the HDF5 spaces are set)
+static bool extractHardwareCounters()
+{
+    bool hardware_counters = false;
+    PyTools::extract( "hardware_counters", hardware_counters, "DiagPerformances"  );
+    return hardware_counters;
+}
 
 // Constructor
 DiagnosticPerformances::DiagnosticPerformances( Params &params, SmileiMPI *smpi )
 : mpi_size_( smpi->getSize() ),
   mpi_rank_( smpi->getRank() ),
-  filespace_double( {n_quantities_double, mpi_size_}, {0, mpi_rank_}, {n_quantities_double, 1} ),
+  hardware_counters( extractHardwareCounters() ),
+  n_double_( n_quantities_double + ( hardware_counters ? n_quantities_hardware : 0 ) ),
+  filespace_double( {n_double_, mpi_size_}, {0, mpi_rank_}, {n_double_, 1} ),
   filespace_uint  ( {n_quantities_uint  , mpi_size_}, {0, mpi_rank_}, {n_quantities_uint  , 1} ),
-  memspace_double( { n_quantities_double, 1 }, {}, {} ),
+  memspace_double( { n_double_, 1 }, {}, {} ),
   memspace_uint  ( { n_quantities_uint  , 1 }, {}, {} )
 {
     timestep = params.timestep;
@@ -42,6 +57,21 @@ DiagnosticPerformances::DiagnosticPerformances( Params &params, SmileiMPI *smpi
     // Get patch information flag
     PyTools::extract( "patch_information", patch_information, "DiagPerformances"  );
     
+    // Get the patch profiling flags
+    PyTools::extract( "patch_profiling", patch_profiling, "DiagPerformances"  );
+    PyTools::extract( "profiling_trace", profiling_trace, "DiagPerformances"  );
+    if( profiling_trace && ! patch_profiling ) {
+        ERROR_NAMELIST( errorPrefix << ": `profiling_trace` requires `patch_profiling`", LINK_NAMELIST + std::string("#diagperformances") );
+    }
+    PatchProfiler::active = patch_profiling;
+    PatchProfiler::record_events = profiling_trace;
+    
+    // The hardware counters are opened with the timers
+    HardwareCounters::requested = hardware_counters;
+    trace_first_event_ = true;
+    trace_truncated_ = false;
+    trace_t0_ = 0.;
+    
     // Output info on diagnostics
     if( smpi->isMaster() ) {
         MESSAGE( 1, "Created performances diagnostic" );
@@ -87,7 +117,7 @@ void DiagnosticPerformances::openFile( Params &params, SmileiMPI *smpi )
     quantities_uint[3] = "number_of_frozen_particles";
     file_->attr( "quantities_uint", quantities_uint );
     
-    vector<string> quantities_double( n_quantities_double );
+    vector<string> quantities_double( n_double_ );
     quantities_double[ 0] = "total_load"      ;
     quantities_double[ 1] = "timer_global"    ;
     quantities_double[ 2] = "timer_particles" ;
@@ -107,9 +137,31 @@ void DiagnosticPerformances::openFile( Params &params, SmileiMPI *smpi )
     quantities_double[16] = "timer_envelope"     ;
     quantities_double[17] = "timer_syncSusceptibility"     ;
     quantities_double[18] = "timer_partMerging"     ;
+    if( hardware_counters ) {
+        for( unsigned int r=0; r<4; r++ ) {
+            string region = hardware_regions[r];
+            quantities_double[n_quantities_double+5*r  ] = "instructions_"     + region;
+            quantities_double[n_quantities_double+5*r+1] = "cycles_"           + region;
+            quantities_double[n_quantities_double+5*r+2] = "cache_misses_"     + region;
+            quantities_double[n_quantities_double+5*r+3] = "vector_fraction_"  + region;
+            quantities_double[n_quantities_double+5*r+4] = "memory_bandwidth_" + region;
+        }
+    }
     file_->attr( "quantities_double", quantities_double );
     
     file_->flush();
+    
+    // Each process writes its own trace file (JSON array of events)
+    if( profiling_trace && ! trace_.is_open() ) {
+        ostringstream trace_name( "" );
+        trace_name << "Performances_trace_" << setfill( '0' ) << setw( 5 ) << mpi_rank_ << ".json";
+        trace_.open( trace_name.str() );
+        trace_ << fixed << setprecision( 3 );
+        trace_ << "[" << endl << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << mpi_rank_
+               << ",\"args\":{\"name\":\"MPI process " << mpi_rank_ << "\"}}";
+        trace_first_event_ = false;
+        trace_t0_ = PatchProfiler::now();
+    }
 }
 
 
@@ -119,6 +171,10 @@ void DiagnosticPerformances::closeFile()
         delete file_;
         file_ = NULL;
     }
+    if( trace_.is_open() ) {
+        trace_ << endl << "]" << endl;
+        trace_.close();
+    }
 } // END closeFile
 
 
@@ -194,7 +250,7 @@ void DiagnosticPerformances::run( SmileiMPI *smpi, VectorPatch &vecPatches, int
         iteration_group.array( "quantities_uint", quantities_uint[0], &filespace_uint, &memspace_uint );
         
         // Fill the vector for double quantities
-        vector<double> quantities_double( n_quantities_double );
+        vector<double> quantities_double( n_double_ );
         quantities_double[ 0] = total_load                 ;
         quantities_double[ 1] = timers.global    .getTime();
         quantities_double[ 2] = timers.particles .getTime();
@@ -224,11 +280,45 @@ void DiagnosticPerformances::run( SmileiMPI *smpi, VectorPatch &vecPatches, int
         quantities_double[17] = timers.susceptibility   .getTime();
         quantities_double[18] = timers.particleMerging  .getTime();
         
+        // Hardware counters of the main regions, cumulated since the beginning (NaN when not available)
+        if( hardware_counters ) {
+            vector<Timer *> regions[4] = {
+                { &timers.particles }, { &timers.maxwell }, { &timers.densities },
+                { &timers.syncPart, &timers.syncField, &timers.syncDens }
+            };
+            const double nan = numeric_limits<double>::quiet_NaN();
+            for( unsigned int r=0; r<4; r++ ) {
+                double counters[HardwareCounters::n_events] = {};
+                double region_time = 0.;
+                for( Timer *timer : regions[r] ) {
+                    // The counters are enabled after the output at t = 0
+                    for( unsigned int e=0; e<timer->counters_.size(); e++ ) {
+                        counters[e] += timer->counters_[e];
+                    }
+                    region_time += timer->getTime();
+                }
+                for( unsigned int e=0; e<HardwareCounters::n_events; e++ ) {
+                    if( ! HardwareCounters::available( ( HardwareCounters::Event ) e ) ) {
+                        counters[e] = nan;
+                    }
+                }
+                double *q = &quantities_double[n_quantities_double+5*r];
+                q[0] = counters[HardwareCounters::instructions];
+                q[1] = counters[HardwareCounters::cycles];
+                q[2] = counters[HardwareCounters::cache_misses];
+                // Fraction of the floating-point instructions that are packed (SIMD)
+                double fp = counters[HardwareCounters::fp_scalar] + counters[HardwareCounters::fp_packed];
+                q[3] = fp > 0. ? counters[HardwareCounters::fp_packed] / fp : nan;
+                // Memory bandwidth estimated from the last-level cache misses (one 64-byte line each)
+                q[4] = region_time > 0. ? 64. * q[2] / region_time : nan;
+            }
+        }
+        
         // Write doubles to file
         iteration_group.array( "quantities_double", quantities_double[0], &filespace_double, &memspace_double );
         
         // Patch information
-        if( patch_information ) {
+        if( patch_information || patch_profiling ) {
         
             // Creation of the group
             H5Write patch_group = iteration_group.group( "patches" );
@@ -284,6 +374,26 @@ void DiagnosticPerformances::run( SmileiMPI *smpi, VectorPatch &vecPatches, int
                     // Write patch vectorization status  to file
                     species_group.vect( "vecto", buffer[0], size, H5T_NATIVE_UINT, offset, npoints );
                 }
+                
+                // Patch profilers: time spent in each operator since the last output
+                if( patch_profiling ) {
+                    vector<double> times( number_of_patches );
+                    for( unsigned int op = 0; op < PatchProfiler::n_operators; op++ ) {
+                        for( unsigned int ipatch=0; ipatch < number_of_patches; ipatch++ ) {
+                            times[ipatch] = vecPatches( ipatch )->profiler_.time( ispecies, ( PatchProfiler::Operator ) op );
+                        }
+                        species_group.vect( string( "time_" ) + PatchProfiler::operator_names[op], times[0], size, H5T_NATIVE_DOUBLE, offset, npoints );
+                    }
+                    vector<uint64_t> bytes( number_of_patches );
+                    for( unsigned int ipatch=0; ipatch < number_of_patches; ipatch++ ) {
+                        bytes[ipatch] = vecPatches( ipatch )->profiler_.exchangedBytes( ispecies );
+                    }
+                    species_group.vect( "exchanged_bytes", bytes[0], size, H5T_NATIVE_UINT64, offset, npoints );
+                    for( unsigned int ipatch=0; ipatch < number_of_patches; ipatch++ ) {
+                        buffer[ipatch] = vecPatches( ipatch )->vecSpecies[ispecies]->getNbrOfParticles();
+                    }
+                    species_group.vect( "macro_particles", buffer[0], size, H5T_NATIVE_UINT, offset, npoints );
+                }
             }
             
             // Write MPI process the owns the patch
@@ -296,12 +406,56 @@ void DiagnosticPerformances::run( SmileiMPI *smpi, VectorPatch &vecPatches, int
             
         }
         
+        // Append the events of the patch profilers to the trace (times in microseconds)
+        if( profiling_trace ) {
+            for( unsigned int ipatch=0; ipatch < number_of_patches; ipatch++ ) {
+                Patch *patch = vecPatches( ipatch );
+                for( unsigned int i=0; i<patch->profiler_.events_.size(); i++ ) {
+                    PatchProfiler::Event &e = patch->profiler_.events_[i];
+                    trace_ << ( trace_first_event_ ? "" : "," ) << endl
+                           << "{\"name\":\"" << PatchProfiler::operator_names[e.op]
+                           << "\",\"cat\":\"" << patch->vecSpecies[e.species]->name_
+                           << "\",\"ph\":\"X\",\"pid\":" << mpi_rank_ << ",\"tid\":" << e.thread
+                           << ",\"ts\":" << ( e.start - trace_t0_ )*1.e6 << ",\"dur\":" << e.duration*1.e6
+                           << ",\"args\":{\"patch\":" << patch->hindex << "}}";
+                    trace_first_event_ = false;
+                }
+                // Mark the events that were not recorded
+                if( patch->profiler_.dropped_events_ > 0 ) {
+                    trace_ << ( trace_first_event_ ? "" : "," ) << endl
+                           << "{\"name\":\"dropped_events\",\"ph\":\"i\",\"s\":\"p\",\"pid\":" << mpi_rank_
+                           << ",\"tid\":0,\"ts\":" << ( PatchProfiler::now() - trace_t0_ )*1.e6
+                           << ",\"args\":{\"patch\":" << patch->hindex << ",\"count\":" << patch->profiler_.dropped_events_ << "}}";
+                    trace_first_event_ = false;
+                    if( ! trace_truncated_ ) {
+                        WARNING( "DiagPerformances: more than " << PatchProfiler::max_events << " events per patch between two outputs, the trace is truncated" );
+                        trace_truncated_ = true;
+                    }
+                }
+            }
+            if( flush_timeSelection->theTimeIsNow( itime ) ) {
+                trace_.flush();
+            }
+        }
+        
+        // Restart the patch profilers for the next output
+        if( patch_profiling ) {
+            for( unsigned int ipatch=0; ipatch < number_of_patches; ipatch++ ) {
+                vecPatches( ipatch )->profiler_.reset();
+            }
+        }
+        
         // Close and flush
         if( flush_timeSelection->theTimeIsNow( itime ) ) {
             file_->flush();
         }
     }
     
+    // Other threads must not update the patch profilers while they are written
+    if( patch_profiling ) {
+        #pragma omp barrier
+    }
+    
 } // END run
 
 
@@ -323,7 +477,13 @@ uint64_t DiagnosticPerformances::getDiskFootPrint( int istart, int istop, Patch
     footprint += ndumps * 2 * 600;
     
     // Add size of each dump
-    footprint += ndumps * ( uint64_t )( mpi_size_ ) * ( uint64_t )( n_quantities_double * sizeof( double ) + n_quantities_uint * sizeof( unsigned int ) );
+    footprint += ndumps * ( uint64_t )( mpi_size_ ) * ( uint64_t )( n_double_ * sizeof( double ) + n_quantities_uint * sizeof( unsigned int ) );
+    
+    // Add size of the patch profilers
+    if( patch_profiling ) {
+        footprint += ndumps * ( uint64_t )( tot_number_of_patches ) * ( uint64_t )( patch->vecSpecies.size() )
+                     * ( uint64_t )( PatchProfiler::n_operators * sizeof( double ) + sizeof( uint64_t ) + sizeof( unsigned int ) );
+    }
     
     return footprint;
 }
@@ -1,6 +1,8 @@
 #ifndef DIAGNOSTICPERFORMANCES_H
 #define DIAGNOSTICPERFORMANCES_H
 
+#include <fstream>
+
 #include "Diagnostic.h"
 #include "VectorPatch.h"
 
@@ -45,6 +47,12 @@ private :
     //! MPI rank
     hsize_t mpi_rank_;
     
+    //! Whether to output the hardware counters of the main timers (see HardwareCounters)
+    bool hardware_counters;
+    
+    //! Number of double quantities (including the hardware counters)
+    hsize_t n_double_;
+    
     //! HDF5 link to the group corresponding to one iteration
     bool has_group;
     std::string group_name;
@@ -65,6 +73,24 @@ private :
     //! Whether to output patch information
     bool patch_information;
     
+    //! Whether to output the patch profilers (time per operator and species, see PatchProfiler)
+    bool patch_profiling;
+    
+    //! Whether to write the events of the patch profilers in a trace file (chrome://tracing or Perfetto)
+    bool profiling_trace;
+    
+    //! Trace file of this MPI process
+    std::ofstream trace_;
+    
+    //! Whether the next event is the first in the trace file
+    bool trace_first_event_;
+    
+    //! Whether some events were not recorded by the patch profilers
+    bool trace_truncated_;
+    
+    //! Time origin of the trace
+    double trace_t0_;
+    
     //! Number of cells per patch
     unsigned int ncells_per_patch;
     
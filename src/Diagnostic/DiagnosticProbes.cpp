@@ -3,10 +3,12 @@
 #include <sstream>
 #include <vector>
 #include <limits>
+#include <cstring>
 
 #include "DiagnosticProbes.h"
 
 #include "VectorPatch.h"
+#include "StagedWriter.h"
 
 
 using namespace std;
@@ -348,7 +350,30 @@ DiagnosticProbes::DiagnosticProbes( Params &params, SmileiMPI *smpi, VectorPatch
     for( unsigned int k=0; k<nDim_particle; k++ ) {
         patch_size[k] = params.n_space[k]*params.cell_length[k];
     }
+    
+    // The stencils of the momentum-conserving cartesian interpolators do not depend on the fields:
+    // they are computed once for all points and reused until the points are re-created
+    cached_stencils = geometry != "AMcylindrical"
+                      && params.interpolator_ == "momentum-conserving"
+                      && ( params.interpolation_order == 2 || params.interpolation_order == 4 );
+    stencil_size = params.interpolation_order + 1;
+    cell_length_inv.resize( nDim_field );
+    for( unsigned int k=0; k<nDim_field; k++ ) {
+        cell_length_inv[k] = 1. / params.cell_length[k];
+    }
 
+    // Extract the number of buffers for writing in the background
+    staging_buffers = 0;
+    PyTools::extract( "staging_buffers", staging_buffers, "DiagProbe", n_probe );
+#ifdef _NO_MPI_TM
+    if( staging_buffers > 0 ) {
+        WARNING( "Probe #"<<n_probe<<": `staging_buffers` requires MPI_THREAD_MULTIPLE. Probes will be written synchronously" );
+        staging_buffers = 0;
+    }
+#endif
+    staged_writer_ = NULL;
+    posArray = NULL;
+    
     // Create filename
     ostringstream mystream( "" );
     mystream << "Probes" << n_probe << ".h5";
@@ -404,6 +429,11 @@ void DiagnosticProbes::openFile( Params &params, SmileiMPI *smpi )
 {
     file_ = new H5Write( filename, &smpi->world() );
     
+    // Datasets written in the background must be allocated by HDF5 beforehand
+    if( staging_buffers > 0 ) {
+        file_->allocateEarly();
+    }
+    
     file_->attr( "name", diag_name_ );
     file_->attr( "Version", string( __VERSION ) );
     file_->attr( "dimension", dimProbe );
@@ -429,11 +459,20 @@ void DiagnosticProbes::openFile( Params &params, SmileiMPI *smpi )
     }
     file_->attr( "fields", fields.str() );
     
+    file_->flush();
+    
+    if( staging_buffers > 0 ) {
+        staged_writer_ = new StagedWriter( filename, smpi->world(), staging_buffers );
+    }
 }
 
 
 void DiagnosticProbes::closeFile()
 {
+    if( staged_writer_ ) {
+        delete staged_writer_;
+        staged_writer_ = NULL;
+    }
     if( file_ ) {
         delete file_;
         file_ = NULL;
@@ -543,6 +582,9 @@ void DiagnosticProbes::createPoints( SmileiMPI *smpi, VectorPatch &vecPatches, d
         // Initialize the list of "fake" particles (points) just as actual macro-particles
         Particles *particles = &( vecPatches( ipatch )->probes[probe_n]->particles );
         particles->initialize( ntot, nDim_particle, false );
+        // Invalidate the cached stencils
+        vecPatches( ipatch )->probes[probe_n]->stencil_index.clear();
+        vecPatches( ipatch )->probes[probe_n]->stencil_coeff.clear();
         // In AM, redefine patchmin as rmin and not -rmax anymore
         if( geometry == "AMcylindrical" ) {
             patchMin[1] = patchMax[1] - ( double )patch_size[1];
@@ -647,41 +689,12 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
             createPoints( smpi, vecPatches, x_moved );
             last_iteration_points_calculated = itime;
 
-            // Store the positions of all particles, unless done already
+            // The positions of all points are stored in the file once, filled with the data below
             if( !positions_written ) {
                 vector<unsigned int> posArraySize( 2 );
                 posArraySize[0] = nPart_MPI;
                 posArraySize[1] = nDim_particle;
-                Field2D *posArray;
-                if( nPart_MPI > 0 ) {
-                    posArray = new Field2D( posArraySize );
-                    unsigned int ipart = 0;
-                    for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
-                        if( ipart>=nPart_MPI ) {
-                            break;
-                        }
-                        Particles *particles = &( vecPatches( ipatch )->probes[probe_n]->particles );
-                        for( unsigned int ip=0 ; ip<particles->size() ; ip++ ) {
-                            for( unsigned int idim=0 ; idim<nDim_particle  ; idim++ ) {
-                                ( *posArray )( ipart, idim ) = particles->position( idim, ip );
-                            }
-                            ( *posArray )( ipart, 0 ) -= x_moved;
-                            ipart++;
-                        }
-                    }
-                } else {
-                    posArray = new Field2D();
-                }
-                
-                // Define spaces
-                H5Space memspace( {nPart_MPI, nDim_particle}, {}, {} );
-                H5Space filespace( {nPart_total_actual, nDim_particle}, {offset_in_file[0], 0}, {nPart_MPI, nDim_particle} );
-                // Create dataset
-                file_->array( "positions", *(posArray->data_), &filespace, &memspace );
-                file_->flush();
-                
-                delete posArray;
-                positions_written = true;
+                posArray = nPart_MPI > 0 ? new Field2D( posArraySize ) : new Field2D();
             }
         }
         
@@ -710,28 +723,55 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         // Interpolate all usual fields on probe ("fake") particles of current patch
         unsigned int iPart_MPI = offset_in_MPI[ipatch];
         unsigned int maxPart_MPI = offset_in_MPI[ipatch] + npart;
-        smpi->dynamics_resize( ithread, nDim_particle, npart, false );
-        for( unsigned int ipart=0; ipart<npart; ipart++ ) {
-            int iparticle( ipart ); // Compatibility
-            int false_idx( 0 );   // Use in classical interp for now, not for probes
-            patch->probesInterp->fieldsAndCurrents(
-                patch->EMfields,
-                patch->probes[probe_n]->particles, smpi,
-                &iparticle, &false_idx, ithread,
-                &Jloc_fields, &Rloc_fields
-            );
-            //! here we fill the probe data!!!
-            ( *probesArray )( fieldlocation[0], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+0*npart];
-            ( *probesArray )( fieldlocation[1], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+1*npart];
-            ( *probesArray )( fieldlocation[2], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+2*npart];
-            ( *probesArray )( fieldlocation[3], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+0*npart];
-            ( *probesArray )( fieldlocation[4], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+1*npart];
-            ( *probesArray )( fieldlocation[5], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+2*npart];
-            ( *probesArray )( fieldlocation[6], iPart_MPI )=Jloc_fields.x;
-            ( *probesArray )( fieldlocation[7], iPart_MPI )=Jloc_fields.y;
-            ( *probesArray )( fieldlocation[8], iPart_MPI )=Jloc_fields.z;
-            ( *probesArray )( fieldlocation[9], iPart_MPI )=Rloc_fields;
-            iPart_MPI++;
+        
+        // Positions of the points, if not written yet
+        if( posArray ) {
+            Particles *particles = &( patch->probes[probe_n]->particles );
+            for( unsigned int ip=0 ; ip<npart ; ip++ ) {
+                for( unsigned int idim=0 ; idim<nDim_particle  ; idim++ ) {
+                    ( *posArray )( iPart_MPI+ip, idim ) = particles->position( idim, ip );
+                }
+                ( *posArray )( iPart_MPI+ip, 0 ) -= x_moved;
+            }
+        }
+        
+        if( cached_stencils ) {
+            ProbeParticles *probe = patch->probes[probe_n];
+            if( npart > 0 && probe->stencil_index.empty() ) {
+                computeStencils( patch, probe );
+            }
+            ElectroMagn *EM = patch->EMfields;
+            Field *fields[10] = { EM->Ex_, EM->Ey_, EM->Ez_, EM->Bx_m, EM->By_m, EM->Bz_m, EM->Jx_, EM->Jy_, EM->Jz_, EM->rho_ };
+            for( unsigned int k=0; k<10; k++ ) {
+                // Fields that are neither requested nor needed for the Poynting flux go to the garbage buffer
+                if( npart > 0 && fieldlocation[k] != nFields ) {
+                    interpolateCached( fields[k], probe, &( ( *probesArray )( fieldlocation[k], iPart_MPI ) ) );
+                }
+            }
+        } else {
+            smpi->dynamics_resize( ithread, nDim_particle, npart, false );
+            for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+                int iparticle( ipart ); // Compatibility
+                int false_idx( 0 );   // Use in classical interp for now, not for probes
+                patch->probesInterp->fieldsAndCurrents(
+                    patch->EMfields,
+                    patch->probes[probe_n]->particles, smpi,
+                    &iparticle, &false_idx, ithread,
+                    &Jloc_fields, &Rloc_fields
+                );
+                //! here we fill the probe data!!!
+                ( *probesArray )( fieldlocation[0], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+0*npart];
+                ( *probesArray )( fieldlocation[1], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+1*npart];
+                ( *probesArray )( fieldlocation[2], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+2*npart];
+                ( *probesArray )( fieldlocation[3], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+0*npart];
+                ( *probesArray )( fieldlocation[4], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+1*npart];
+                ( *probesArray )( fieldlocation[5], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+2*npart];
+                ( *probesArray )( fieldlocation[6], iPart_MPI )=Jloc_fields.x;
+                ( *probesArray )( fieldlocation[7], iPart_MPI )=Jloc_fields.y;
+                ( *probesArray )( fieldlocation[8], iPart_MPI )=Jloc_fields.z;
+                ( *probesArray )( fieldlocation[9], iPart_MPI )=Rloc_fields;
+                iPart_MPI++;
+            }
         }
         
         // Calculate Poynting flux on each point if needed
@@ -786,6 +826,12 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
                 for( unsigned int j=0; j<species_field_index[ispec].size(); j++ ) {
                     unsigned int ifield = species_field_index[ispec][j];
                     unsigned int iloc = species_field_location[ispec][j];
+                    if( cached_stencils ) {
+                        if( npart > 0 ) {
+                            interpolateCached( patch->EMfields->allFields[start+ifield], patch->probes[probe_n], &( ( *probesArray )( iloc, offset_in_MPI[ipatch] ) ) );
+                        }
+                        continue;
+                    }
                     int istart( 0 ), iend( npart );
                     double *FieldLoc = &( ( *probesArray )( iloc, offset_in_MPI[ipatch] ) );
                     patch->probesInterp->oneField(
@@ -836,19 +882,41 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         
     } // END for ipatch
     
+    // Only the master issues the HDF5 calls (the data is only staged if written in the background)
     #pragma omp master
     {
+        // Store the positions of all points, unless done already
+        if( posArray ) {
+            // Define spaces
+            H5Space memspace( {nPart_MPI, nDim_particle}, {}, {} );
+            H5Space filespace( {nPart_total_actual, nDim_particle}, {offset_in_file[0], 0}, {nPart_MPI, nDim_particle} );
+            // Create dataset
+            file_->array( "positions", *(posArray->data_), &filespace, &memspace );
+            file_->flush();
+            
+            delete posArray;
+            posArray = NULL;
+            positions_written = true;
+        }
+        
         if( timeSelection->theTimeIsNow( itime ) ) {
             // Define spaces
             H5Space memspace( {(hsize_t)nFields, nPart_MPI}, {}, {} );
             H5Space filespace( {(hsize_t)nFields, nPart_total_actual}, {0, offset_in_file[0]}, {(hsize_t)nFields, nPart_MPI} );
-            // Create new dataset for this timestep
-            H5Write d = file_->array( dataset_name, *(probesArray->data_), &filespace, &memspace, true );
+            // Create new dataset for this timestep (only created when staged: all processes allocate it at a known address)
+            H5Write d = staged_writer_ ? file_->dataset( dataset_name, H5T_NATIVE_DOUBLE, &filespace )
+                                       : file_->array( dataset_name, *(probesArray->data_), &filespace, &memspace, true );
+            if( staged_writer_ ) {
+                stageData( d );
+            }
             // Write x_moved
             d.attr( "x_moved", x_moved );
             
             delete probesArray;
             if( flush_timeSelection->theTimeIsNow( itime ) ) {
+                if( staged_writer_ ) {
+                    staged_writer_->sync();
+                }
                 file_->flush();
             }
         }
@@ -856,6 +924,126 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
     #pragma omp barrier
 }
 
+// The rows of the requested fields are the first nFields rows of probesArray,
+// each one written in the file as a run of nPart_MPI points
+void DiagnosticProbes::stageData( H5Write &dset )
+{
+    MPI_Offset address = dset.address();
+    if( address == ( MPI_Offset ) HADDR_UNDEF ) {
+        ERROR( "Probe #"<<probe_n<<": dataset "<<dataset_name<<" could not be allocated for staged writing" );
+    }
+    vector<MPI_Offset> offsets( nFields );
+    vector<int> lengths( nFields, nPart_MPI );
+    for( unsigned int i=0; i<nFields; i++ ) {
+        offsets[i] = address + ( ( MPI_Offset )i * nPart_total_actual + offset_in_file[0] ) * sizeof( double );
+    }
+    staged_data.resize( nFields * nPart_MPI );
+    if( nPart_MPI > 0 ) {
+        memcpy( &staged_data[0], probesArray->data_, staged_data.size()*sizeof( double ) );
+    }
+    // The data is handed over to the writer, which returns a free buffer
+    staged_writer_->write( staged_data, offsets, lengths );
+}
+
+// Same indices and weights as the momentum-conserving interpolators of order 2 and 4.
+// Layout: for dimension idim and location dual (0=primal, 1=dual), the first node index of point ipart
+// is stencil_index[( 2*idim+dual )*npart + ipart] and the weight of its node inode is
+// stencil_coeff[( ( 2*idim+dual )*stencil_size + inode )*npart + ipart]
+void DiagnosticProbes::computeStencils( Patch *patch, ProbeParticles *probe )
+{
+    unsigned int npart = probe->particles.size();
+    int half = stencil_size / 2;
+    probe->stencil_index.resize( 2*nDim_field*npart );
+    probe->stencil_coeff.resize( 2*nDim_field*stencil_size*npart );
+    
+    for( unsigned int idim=0; idim<nDim_field; idim++ ) {
+        int domain_begin = patch->getCellStartingGlobalIndex( idim );
+        double *position = probe->particles.getPtrPosition( idim );
+        for( unsigned int dual=0; dual<2; dual++ ) {
+            int *index = &probe->stencil_index[( 2*idim+dual )*npart];
+            double *coeff = &probe->stencil_coeff[( 2*idim+dual )*stencil_size*npart];
+            double shift = 0.5 * dual;
+            for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+                double xpn = position[ipart] * cell_length_inv[idim];
+                int i = round( xpn + shift );
+                double delta = xpn - ( double )i + shift;
+                double delta2 = delta*delta;
+                if( stencil_size == 3 ) {
+                    coeff[0*npart+ipart] = 0.5 * ( delta2-delta+0.25 );
+                    coeff[1*npart+ipart] = 0.75 - delta2;
+                    coeff[2*npart+ipart] = 0.5 * ( delta2+delta+0.25 );
+                } else {
+                    double delta3 = delta2*delta;
+                    double delta4 = delta3*delta;
+                    coeff[0*npart+ipart] = 1./384.   - 1./48.  * delta + 1./16. * delta2 - 1./12. * delta3 + 1./24. * delta4;
+                    coeff[1*npart+ipart] = 19./96.   - 11./24. * delta + 1./4.  * delta2 + 1./6.  * delta3 - 1./6.  * delta4;
+                    coeff[2*npart+ipart] = 115./192. - 5./8.   * delta2 + 1./4.  * delta4;
+                    coeff[3*npart+ipart] = 19./96.   + 11./24. * delta + 1./4.  * delta2 - 1./6.  * delta3 - 1./6.  * delta4;
+                    coeff[4*npart+ipart] = 1./384.   + 1./48.  * delta + 1./16. * delta2 + 1./12. * delta3 + 1./24. * delta4;
+                }
+                index[ipart] = i - domain_begin - half;
+            }
+        }
+    }
+}
+
+// The nodes are summed in the same order as the interpolators, so that results are identical
+void DiagnosticProbes::interpolateCached( Field *field, ProbeParticles *probe, double *out )
+{
+    unsigned int npart = probe->particles.size();
+    const double *__restrict__ data = field->data();
+    
+    const int *ix = &probe->stencil_index[field->isDual( 0 )*npart];
+    const double *cx = &probe->stencil_coeff[field->isDual( 0 )*stencil_size*npart];
+    for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+        out[ipart] = 0.;
+    }
+    
+    if( nDim_field == 1 ) {
+        for( unsigned int i=0; i<stencil_size; i++ ) {
+            const double *__restrict__ wx = &cx[i*npart];
+            #pragma omp simd
+            for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+                out[ipart] += wx[ipart] * data[ix[ipart]+i];
+            }
+        }
+    } else if( nDim_field == 2 ) {
+        int ny = field->dims()[1];
+        const int *iy = &probe->stencil_index[( 2+field->isDual( 1 ) )*npart];
+        const double *cy = &probe->stencil_coeff[( 2+field->isDual( 1 ) )*stencil_size*npart];
+        for( unsigned int i=0; i<stencil_size; i++ ) {
+            const double *__restrict__ wx = &cx[i*npart];
+            for( unsigned int j=0; j<stencil_size; j++ ) {
+                const double *__restrict__ wy = &cy[j*npart];
+                #pragma omp simd
+                for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+                    out[ipart] += wx[ipart] * wy[ipart] * data[( ix[ipart]+i )*ny + iy[ipart]+j];
+                }
+            }
+        }
+    } else {
+        int ny = field->dims()[1];
+        int nz = field->dims()[2];
+        const int *iy = &probe->stencil_index[( 2+field->isDual( 1 ) )*npart];
+        const double *cy = &probe->stencil_coeff[( 2+field->isDual( 1 ) )*stencil_size*npart];
+        const int *iz = &probe->stencil_index[( 4+field->isDual( 2 ) )*npart];
+        const double *cz = &probe->stencil_coeff[( 4+field->isDual( 2 ) )*stencil_size*npart];
+        for( unsigned int i=0; i<stencil_size; i++ ) {
+            const double *__restrict__ wx = &cx[i*npart];
+            for( unsigned int j=0; j<stencil_size; j++ ) {
+                const double *__restrict__ wy = &cy[j*npart];
+                for( unsigned int k=0; k<stencil_size; k++ ) {
+                    const double *__restrict__ wz = &cz[k*npart];
+                    #pragma omp simd
+                    for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+                        out[ipart] += wx[ipart] * wy[ipart] * wz[ipart] * data[( ( ix[ipart]+i )*ny + iy[ipart]+j )*nz + iz[ipart]+k];
+                    }
+                }
+            }
+        }
+    }
+}
+
 bool DiagnosticProbes::needsRhoJs( int itime )
 {
     return hasRhoJs && timeSelection->theTimeIsNow( itime );
@@ -5,6 +5,8 @@
 
 #include "Field2D.h"
 
+class ProbeParticles;
+class StagedWriter;
 
 class DiagnosticProbes : public Diagnostic
 {
@@ -33,6 +35,15 @@ public :
     //! Creates the probe's particles (or "points")
     void createPoints( SmileiMPI *smpi, VectorPatch &vecPatches, double x_moved );
     
+    //! Computes the interpolation stencils (indices and weights) of the points of one patch
+    void computeStencils( Patch *patch, ProbeParticles *probe );
+    
+    //! Interpolates one field on all the points of one patch, using their cached stencils
+    void interpolateCached( Field *field, ProbeParticles *probe, double *out );
+    
+    //! Hands the data of the current dataset over to the background writer
+    void stageData( H5Write &dset );
+    
     //! Get memory footprint of current diagnostic
     int getMemFootPrint() override
     {
@@ -41,6 +52,8 @@ public :
                    ( nDim_particle+3+1 )*sizeof( double ) + sizeof( short )
                    // eval probesArray (even if temporary)
                    + (nFields + 1)*sizeof( double )
+                   // cached interpolation stencils
+                   + ( cached_stencils ? 2*nDim_field*( sizeof( int ) + stencil_size*sizeof( double ) ) : 0 )
                );
     }
     
@@ -117,6 +130,18 @@ private:
     //! Temporary buffer to write probes
     Field2D *probesArray;
     
+    //! Temporary buffer to write the positions of the points (only when not written yet)
+    Field2D *posArray;
+    
+    //! Number of buffers for writing in the background (0 for synchronous writing)
+    unsigned int staging_buffers;
+    
+    //! Writes the data in the background, when staging_buffers > 0
+    StagedWriter *staged_writer_;
+    
+    //! Copy of the data handed over to the background writer
+    std::vector<double> staged_data;
+    
     //! Array to locate the current patch in the local buffer
     std::vector<unsigned int> offset_in_MPI;
     
@@ -134,6 +159,15 @@ private:
     
     //! patch size
     std::vector<double> patch_size;
+    
+    //! True if the interpolation stencils of the points are computed once and cached
+    bool cached_stencils;
+    
+    //! Number of nodes of the interpolation stencil in each dimension
+    unsigned int stencil_size;
+    
+    //! Inverse of the cell length in each dimension
+    std::vector<double> cell_length_inv;
 };
 
 
@@ -151,6 +185,11 @@ public :
     Particles particles;
     int offset_in_file;
     std::vector<std::vector<double> > integrated_data;
+    
+    //! Cached first node index of the stencil of each point, for each dimension and primal/dual location
+    std::vector<int> stencil_index;
+    //! Cached weights of the stencil nodes of each point, for each dimension and primal/dual location
+    std::vector<double> stencil_coeff;
 };
 
 
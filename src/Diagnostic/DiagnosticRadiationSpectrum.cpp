@@ -6,6 +6,10 @@
 #include "RadiationTools.h"
 #include "RadiationTables.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace std;
 
@@ -128,12 +132,30 @@ void DiagnosticRadiationSpectrum::run( Patch* patch, int itime, SimWindow* simWi
         species.push_back( s );
         npart += s->getNbrOfParticles();
     }
-    vector<int> int_buffer( npart, 0 );
-    vector<double> double_buffer( npart );
+    vector<int> *int_buffer_ptr;
+    vector<double> *double_buffer_ptr;
+    threadBuffers( npart, int_buffer_ptr, double_buffer_ptr );
+    vector<int> &int_buffer = *int_buffer_ptr;
+    vector<double> &double_buffer = *double_buffer_ptr;
     
     // Get the index (int_buffer) of each particle in the final array (data_sum)
     histogram->digitize( species, double_buffer, int_buffer, simWindow );
     
+    // Histogram of the current thread
+#ifdef _OPENMP
+    int ithread = omp_get_thread_num();
+#else
+    int ithread = 0;
+#endif
+    double *data = NULL;
+    vector<pair<unsigned int, double> > &list = thread_sparse_data_[ithread];
+    if( ! sparse_ ) {
+        if( thread_data_[ithread].size() != output_size ) {
+            thread_data_[ithread].assign( output_size, 0. );
+        }
+        data = &thread_data_[ithread][0];
+    }
+    
     // loop species & fill the histogram
     unsigned int istart = 0;
     for( unsigned int ispec=0 ; ispec < species_indices.size() ; ispec++ ) {
@@ -183,8 +205,11 @@ void DiagnosticRadiationSpectrum::run( Patch* patch, int itime, SimWindow* simWi
                 nu   = two_third_ov_chi * zeta;
                 cst  = xi * zeta;
                 increment = increment0 * delta_energies[i] * xi * RadiationTools::computeBesselPartsRadiatedPower(nu,cst);
-                #pragma omp atomic
-                data_sum[ind+i] += increment;
+                if( data ) {
+                    data[ind+i] += increment;
+                } else {
+                    list.push_back( make_pair( ( unsigned int )( ind+i ), increment ) );
+                }
             }
         }
         
@@ -192,6 +217,10 @@ void DiagnosticRadiationSpectrum::run( Patch* patch, int itime, SimWindow* simWi
     
     }
     
+    if( sparse_ ) {
+        compressSparseIfGrown( ithread );
+    }
+    
 } // END run
 
 
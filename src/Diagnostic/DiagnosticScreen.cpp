@@ -217,8 +217,11 @@ void DiagnosticScreen::run( Patch *patch, int itime, SimWindow *simWindow )
         species.push_back( s );
         npart_total += s->getNbrOfParticles();
     }
-    vector<int> int_buffer( npart_total, 0 );
-    vector<double> double_buffer( npart_total );
+    vector<int> *int_buffer_ptr;
+    vector<double> *double_buffer_ptr;
+    threadBuffers( npart_total, int_buffer_ptr, double_buffer_ptr );
+    vector<int> &int_buffer = *int_buffer_ptr;
+    vector<double> &double_buffer = *double_buffer_ptr;
     bool opposite[npart_total]; // cannot use vector<bool>
     for( unsigned int i=0; i<npart_total; i++ ) {
         opposite[i] = false;
@@ -333,7 +336,7 @@ void DiagnosticScreen::run( Patch *patch, int itime, SimWindow *simWindow )
         }
     }
     
-    histogram->distribute( double_buffer, int_buffer, data_sum );
+    distribute( double_buffer, int_buffer );
     
 } // END run
 
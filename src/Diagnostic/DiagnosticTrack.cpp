@@ -4,10 +4,15 @@
 #include <sstream>
 
 #include "ParticleData.h"
+#include "ParticleFilter.h"
 #include "PeekAtSpecies.h"
 #include "DiagnosticTrack.h"
 #include "VectorPatch.h"
 #include "Params.h"
+#include "StagedWriter.h"
+
+#include <algorithm>
+#include <cstring>
 
 using namespace std;
 
@@ -29,6 +34,7 @@ DiagnosticTrack::DiagnosticTrack( Params &params, SmileiMPI *smpi, VectorPatch &
         ERROR( "DiagTrackParticles #" << iDiagTrackParticles << " does not correspond to any existing species" );
     }
     speciesId_ = species_ids[0];
+    species_name_ = species_name;
     
     ostringstream name( "" );
     name << "Tracking species '" << species_name << "'";
@@ -44,10 +50,17 @@ DiagnosticTrack::DiagnosticTrack( Params &params, SmileiMPI *smpi, VectorPatch &
         vecPatches( ipatch )->vecSpecies[speciesId_]->tracking_diagnostic = idiag;
     }
     
-    // Get parameter "filter" which gives a python function to select particles
+    // Get parameter "filter" which gives a python function or an expression to select particles
     filter = PyTools::extract_py( "filter", "DiagTrackParticles", iDiagTrackParticles );
     has_filter = ( filter != Py_None );
-    if( has_filter ) {
+    compiled_filter = NULL;
+    string expression;
+    if( has_filter && PyTools::py2scalar( filter, expression ) ) {
+        compiled_filter = new ParticleFilter( expression, nDim_particle, name.str() );
+        if( compiled_filter->needsChi() && ! vecPatches( 0 )->vecSpecies[speciesId_]->particles->isQuantumParameter ) {
+            ERROR( name.str() << ": filter uses `chi` but the species has no quantum parameter" );
+        }
+    } else if( has_filter ) {
 #ifdef SMILEI_USE_NUMPY
         // Test the filter with temporary, "fake" particles
         name << " filter:";
@@ -134,6 +147,54 @@ DiagnosticTrack::DiagnosticTrack( Params &params, SmileiMPI *smpi, VectorPatch &
         ERROR( "DiagTrackParticles #" << iDiagTrackParticles << ": attribute `chi` not available for this species" );
     }
     
+    // Slots of the double buffer, each filled with one particle property (or interpolated field)
+    slot_weight = -1;
+    slot_momentum.resize( 3, -1 );
+    slot_position.resize( 3, -1 );
+    slot_chi = -1;
+    slot_fields = -1;
+    if( write_weight ) {
+        slot_weight = double_props.size();
+        double_props.push_back( nDim_particle+3 );
+    }
+    for( unsigned int idim=0; idim<3; idim++ ) {
+        if( write_momentum[idim] ) {
+            slot_momentum[idim] = double_props.size();
+            double_props.push_back( nDim_particle+idim );
+        }
+    }
+    for( unsigned int idim=0; idim<nDim_particle; idim++ ) {
+        if( write_position[idim] ) {
+            slot_position[idim] = double_props.size();
+            double_props.push_back( idim );
+        }
+    }
+    if( write_chi ) {
+        slot_chi = double_props.size();
+// Position old exists in this case
+#ifdef  __DEBUG
+        double_props.push_back( nDim_particle+3+3+1 );
+// Else, position old does not exist
+#else
+        double_props.push_back( nDim_particle+3+1 );
+#endif
+    }
+    if( interpolate ) {
+        slot_fields = double_props.size();
+    }
+    
+    // Extract the number of buffers for writing in the background
+    staging_buffers = 0;
+    PyTools::extract( "staging_buffers", staging_buffers, "DiagTrackParticles", iDiagTrackParticles );
+#ifdef _NO_MPI_TM
+    if( staging_buffers > 0 ) {
+        WARNING( "DiagTrackParticles #" << iDiagTrackParticles << ": `staging_buffers` requires MPI_THREAD_MULTIPLE. Particles will be written synchronously" );
+        staging_buffers = 0;
+    }
+#endif
+    staged_writer_ = NULL;
+    staging_now = false;
+    
     // Create the filename
     ostringstream hdf_filename( "" );
     hdf_filename << "TrackParticlesDisordered_" << species_name  << ".h5" ;
@@ -159,6 +220,7 @@ DiagnosticTrack::~DiagnosticTrack()
     delete timeSelection;
     delete flush_timeSelection;
     Py_DECREF( filter );
+    delete compiled_filter;
     closeFile();
 }
 
@@ -168,6 +230,11 @@ void DiagnosticTrack::openFile( Params &params, SmileiMPI *smpi )
     // Create HDF5 file
     file_ = new H5Write( filename, &smpi->world() );
     
+    // Datasets written in the background must be allocated by HDF5 beforehand
+    if( staging_buffers > 0 ) {
+        file_->allocateEarly();
+    }
+    
     file_->attr( "name", diag_name_ );
     
     // Attributes for openPMD
@@ -176,11 +243,19 @@ void DiagnosticTrack::openFile( Params &params, SmileiMPI *smpi )
     data_group = new H5Write( file_, "data" );
     
     file_->flush();
+    
+    if( staging_buffers > 0 ) {
+        staged_writer_ = new StagedWriter( filename, smpi->world(), staging_buffers );
+    }
 }
 
 
 void DiagnosticTrack::closeFile()
 {
+    if( staged_writer_ ) {
+        delete staged_writer_;
+        staged_writer_ = NULL;
+    }
     if( file_ ) {
         delete data_group;
         delete file_;
@@ -218,22 +293,50 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
 {
     uint64_t nParticles_global = 0;
     string xyz = "xyz";
+    unsigned int nPatches = vecPatches.size();
     
     H5Write *momentum_group=NULL, *position_group=NULL, *species_group=NULL;
     H5Space *file_space=NULL, *mem_space=NULL;
+    hsize_t chunk = 0;
+    
+    // A compiled filter is evaluated by all threads
+    if( compiled_filter ) {
+        #pragma omp single
+        patch_selection.resize( nPatches );
+        #pragma omp for schedule(dynamic)
+        for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
+            compiled_filter->select( vecPatches( ipatch )->vecSpecies[speciesId_], patch_selection[ipatch] );
+        }
+    }
+    
     #pragma omp master
     {
         // Obtain the particle partition of all the patches in this MPI
         nParticles_local = 0;
-        patch_start.resize( vecPatches.size() );
+        patch_start.resize( nPatches );
         
-        if( has_filter ) {
+        if( compiled_filter ) {
+            
+            // Set the IDs of the particles not tracked before, in the same order as a python filter
+            for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
+                Particles *p = vecPatches( ipatch )->vecSpecies[speciesId_]->particles;
+                vector<unsigned int> &selection = patch_selection[ipatch];
+                for( unsigned int i=0; i<selection.size(); i++ ) {
+                    if( (p->id( selection[i] ) & 72057594037927935) == 0 ) {
+                        p->id( selection[i] ) += ++latest_Id;
+                    }
+                }
+                patch_start[ipatch] = nParticles_local;
+                nParticles_local += selection.size();
+            }
+            
+        } else if( has_filter ) {
         
 #ifdef SMILEI_USE_NUMPY
-            patch_selection.resize( vecPatches.size() );
+            patch_selection.resize( nPatches );
             PyArrayObject *ret;
             ParticleData particleData( 0 );
-            for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+            for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
                 patch_selection[ipatch].resize( 0 );
                 Particles *p = vecPatches( ipatch )->vecSpecies[speciesId_]->particles;
                 unsigned int npart = p->size();
@@ -267,22 +370,53 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
 #endif
             
         } else {
-            for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+            for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
                 patch_start[ipatch] = nParticles_local;
                 nParticles_local += vecPatches( ipatch )->vecSpecies[speciesId_]->getNbrOfParticles();
             }
         }
         
-        // Specify the memory dataspace (the size of the local buffer)
-        mem_space = new H5Space( (hsize_t)nParticles_local );
+        // Buffers for all the written quantities
+        data_uint64.resize( nParticles_local );
+        if( write_charge ) {
+            data_short.resize( nParticles_local );
+        }
+        data_double.resize( nParticles_local * ( double_props.size() + ( interpolate ? 6 : 0 ) ) );
         
         // Get the number of offset for this MPI rank
-        uint64_t np_local = nParticles_local, offset;
-        MPI_Scan( &np_local, &offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD );
-        nParticles_global = offset;
-        offset -= np_local;
+        uint64_t np_local = nParticles_local;
+        MPI_Scan( &np_local, &offset_local, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD );
+        nParticles_global = offset_local;
+        offset_local -= np_local;
         MPI_Bcast( &nParticles_global, 1, MPI_UNSIGNED_LONG_LONG, smpi->getSize()-1, MPI_COMM_WORLD );
         
+        // Set the chunk size
+        if( nParticles_global>0 ) {
+            unsigned int maximum_chunk_size = 100000000;
+            unsigned int number_of_chunks = nParticles_global/maximum_chunk_size;
+            if( nParticles_global%maximum_chunk_size != 0 ) {
+                number_of_chunks++;
+            }
+            if( number_of_chunks > 1 ) {
+                unsigned int chunk_size = nParticles_global/number_of_chunks;
+                if( nParticles_global%number_of_chunks != 0 ) {
+                    chunk_size++;
+                }
+                chunk = chunk_size;
+            }
+        }
+        
+        // Only contiguous, non-empty arrays have an address in the file for staged writing
+        staging_now = staged_writer_ && nParticles_global > 0 && chunk == 0;
+    }
+    #pragma omp barrier
+    
+    // The master creates the HDF5 groups while the other threads start filling the buffers
+    #pragma omp master
+    {
+        // Specify the memory dataspace (the size of the local buffer)
+        mem_space = new H5Space( (hsize_t)nParticles_local );
+        
         // Make a new group for this iteration
         ostringstream t( "" );
         t << setfill( '0' ) << setw( 10 ) << itime;
@@ -301,195 +435,119 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         // Write x_moved
         iteration_group.attr( "x_moved", simWindow ? simWindow->getXmoved() : 0. );
         
-        // Filespace and chunks
-        hsize_t chunk = 0;
-        if( nParticles_global>0 ) {
-            // Set the chunk size
-            unsigned int maximum_chunk_size = 100000000;
-            unsigned int number_of_chunks = nParticles_global/maximum_chunk_size;
-            if( nParticles_global%maximum_chunk_size != 0 ) {
-                number_of_chunks++;
-            }
-            if( number_of_chunks <= 1 ) {
-                chunk = 0;
-            } else {
-                unsigned int chunk_size = nParticles_global/number_of_chunks;
-                if( nParticles_global%number_of_chunks != 0 ) {
-                    chunk_size++;
-                }
-                chunk = chunk_size;
-            }
-        }
-        file_space = new H5Space( nParticles_global, offset, nParticles_local, chunk );
+        // Filespace
+        file_space = new H5Space( nParticles_global, offset_local, nParticles_local, chunk );
         
         // Create the "latest_IDs" dataset
         // Create file space and select one element for each proc
         iteration_group.vect( "latest_IDs", latest_Id, smpi->getSize(), H5T_NATIVE_UINT64, smpi->getRank(), 1 );
+    }
+    
+    // Each thread fills all the quantities of its patches in a single pass
+    double mass = vecPatches( 0 )->vecSpecies[speciesId_]->mass_;
+    #pragma omp for schedule(dynamic)
+    for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
+        Particles *particles = vecPatches( ipatch )->vecSpecies[speciesId_]->particles;
+        vector<unsigned int> *selection = has_filter ? &patch_selection[ipatch] : NULL;
+        unsigned int start = patch_start[ipatch];
+        unsigned int npart = ( ipatch+1 < nPatches ? patch_start[ipatch+1] : nParticles_local ) - start;
         
+        fill_buffer( particles, 0, selection, data_uint64.data() + start );
+        if( write_charge ) {
+            fill_buffer( particles, 0, selection, data_short.data() + start );
+        }
+        for( unsigned int islot=0; islot<double_props.size(); islot++ ) {
+            fill_buffer( particles, double_props[islot], selection, data_double.data() + islot*nParticles_local + start );
+        }
+        
+        // Multiply by the mass to obtain an actual momentum (except for photons (mass = 0))
+        if( mass != 1. && mass > 0 ) {
+            for( unsigned int idim=0; idim<3; idim++ ) {
+                if( slot_momentum[idim] >= 0 ) {
+                    double *p = data_double.data() + slot_momentum[idim]*nParticles_local + start;
+                    for( unsigned int ip=0; ip<npart; ip++ ) {
+                        p[ip] *= mass;
+                    }
+                }
+            }
+        }
+        
+        // Fields interpolated at the particle positions
+        if( interpolate ) {
+            vecPatches.species( ipatch, speciesId_ )->Interp->fieldsSelection(
+                vecPatches.emfields( ipatch ),
+                *particles,
+                data_double.data() + slot_fields*nParticles_local + start,
+                ( int ) nParticles_local,
+                selection
+            );
+        }
     }
     
-    // Id
-    #pragma omp master
-    data_uint64.resize( nParticles_local, 1 );
-    #pragma omp barrier
-    fill_buffer( vecPatches, 0, data_uint64 );
+    // Only the master issues the HDF5 calls (the data is only staged if written in the background)
     #pragma omp master
     {
+        // Id
         write_scalar( species_group, "id", data_uint64[0], H5T_NATIVE_UINT64, file_space, mem_space, SMILEI_UNIT_NONE );
-        data_uint64.resize( 0 );
-    }
-    
-    // Charge
-    if( write_charge ) {
-        #pragma omp master
-        data_short.resize( nParticles_local, 0 );
-        #pragma omp barrier
-        fill_buffer( vecPatches, 0, data_short );
-        #pragma omp master
-        {
+        
+        // Charge
+        if( write_charge ) {
             write_scalar( species_group, "charge", data_short[0], H5T_NATIVE_SHORT, file_space, mem_space, SMILEI_UNIT_CHARGE );
-            data_short.resize( 0 );
         }
-    }
-    
-    #pragma omp master
-    data_double.resize( nParticles_local, 0 );
-    
-    // Weight
-    if( write_weight ) {
-        #pragma omp barrier
-        fill_buffer( vecPatches, nDim_particle+3, data_double );
-        #pragma omp master
-        write_scalar( species_group, "weight", data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_DENSITY );
-    }
-    
-    // Momentum
-    if( write_any_momentum ) {
-        #pragma omp master
-        {
+        
+        // Weight
+        if( write_weight ) {
+            write_scalar( species_group, "weight", data_double[slot_weight*nParticles_local], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_DENSITY );
+        }
+        
+        // Momentum
+        if( write_any_momentum ) {
             momentum_group = new H5Write( species_group, "momentum" );
             openPMD_->writeRecordAttributes( *momentum_group, SMILEI_UNIT_MOMENTUM );
-        }
-        for( unsigned int idim=0; idim<3; idim++ ) {
-            if( write_momentum[idim] ) {
-                #pragma omp barrier
-                fill_buffer( vecPatches, nDim_particle+idim, data_double );
-                #pragma omp master
-                {
-                    // Multiply by the mass to obtain an actual momentum (except for photons (mass = 0))
-                    if( vecPatches( 0 )->vecSpecies[speciesId_]->mass_ != 1. &&
-                        vecPatches( 0 )->vecSpecies[speciesId_]->mass_ > 0) {
-                        for( unsigned int ip=0; ip<nParticles_local; ip++ ) {
-                            data_double[ip] *= vecPatches( 0 )->vecSpecies[speciesId_]->mass_;
-                        }
-                    }
-                    write_component( momentum_group, xyz.substr( idim, 1 ).c_str(), data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_MOMENTUM );
+            for( unsigned int idim=0; idim<3; idim++ ) {
+                if( write_momentum[idim] ) {
+                    write_component( momentum_group, xyz.substr( idim, 1 ).c_str(), data_double[slot_momentum[idim]*nParticles_local], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_MOMENTUM );
                 }
             }
+            delete momentum_group;
         }
-        #pragma omp master
-        delete momentum_group;
-    }
-    
-    // Position
-    if( write_any_position ) {
-        #pragma omp master
-        {
+        
+        // Position
+        if( write_any_position ) {
             position_group = new H5Write( species_group, "position" );
             openPMD_->writeRecordAttributes( *position_group, SMILEI_UNIT_POSITION );
-        }
-        for( unsigned int idim=0; idim<nDim_particle; idim++ ) {
-            if( write_position[idim] ) {
-                #pragma omp barrier
-                fill_buffer( vecPatches, idim, data_double );
-                #pragma omp master
-                write_component( position_group, xyz.substr( idim, 1 ).c_str(), data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_POSITION );
+            for( unsigned int idim=0; idim<nDim_particle; idim++ ) {
+                if( write_position[idim] ) {
+                    write_component( position_group, xyz.substr( idim, 1 ).c_str(), data_double[slot_position[idim]*nParticles_local], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_POSITION );
+                }
             }
+            delete position_group;
         }
-        #pragma omp master
-        delete position_group;
-    }
-    
-    // Chi - quantum parameter
-    if( write_chi ) {
-        #pragma omp barrier
-// Position old exists in this case
-#ifdef  __DEBUG
-        fill_buffer( vecPatches, nDim_particle+3+3+1, data_double );
-// Else, position old does not exist
-#else
-        fill_buffer( vecPatches, nDim_particle+3+1, data_double );
-#endif
-        #pragma omp master
-        write_scalar( species_group, "chi", data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_NONE );
-    }
-    
-    #pragma omp barrier
-    
-    // If field interpolation necessary
-    if( interpolate ) {
-    
-    
-        #pragma omp master
-        data_double.resize( nParticles_local*6 );
-        
-        // Do the interpolation
-        unsigned int nPatches=vecPatches.size();
-        #pragma omp barrier
         
-        if( has_filter ) {
-            #pragma omp for schedule(static)
-            for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
-                vecPatches.species( ipatch, speciesId_ )->Interp->fieldsSelection(
-                    vecPatches.emfields( ipatch ),
-                    *( vecPatches.species( ipatch, speciesId_ )->particles ),
-                    &data_double[patch_start[ipatch]],
-                    ( int ) nParticles_local,
-                    &patch_selection[ipatch]
-                );
-            }
-        } else {
-            #pragma omp for schedule(static)
-            for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
-                vecPatches.species( ipatch, speciesId_ )->Interp->fieldsSelection(
-                    vecPatches.emfields( ipatch ),
-                    *( vecPatches.species( ipatch, speciesId_ )->particles ),
-                    &data_double[patch_start[ipatch]],
-                    ( int ) nParticles_local,
-                    NULL
-                );
-            }
+        // Chi - quantum parameter
+        if( write_chi ) {
+            write_scalar( species_group, "chi", data_double[slot_chi*nParticles_local], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_NONE );
         }
-        #pragma omp barrier
         
-        // Write out the fields
-        #pragma omp master
-        {
-            if( write_any_E ) {
-                H5Write Efield_group = species_group->group( "E" );
-                openPMD_->writeRecordAttributes( Efield_group, SMILEI_UNIT_EFIELD );
-                for( unsigned int idim=0; idim<3; idim++ ) {
-                    if( write_E[idim] ) {
-                        write_component( &Efield_group, xyz.substr( idim, 1 ).c_str(), data_double[idim*nParticles_local], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_EFIELD );
-                    }
+        // Interpolated fields
+        if( write_any_E ) {
+            H5Write Efield_group = species_group->group( "E" );
+            openPMD_->writeRecordAttributes( Efield_group, SMILEI_UNIT_EFIELD );
+            for( unsigned int idim=0; idim<3; idim++ ) {
+                if( write_E[idim] ) {
+                    write_component( &Efield_group, xyz.substr( idim, 1 ).c_str(), data_double[( slot_fields+idim )*nParticles_local], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_EFIELD );
                 }
             }
-            
-            if( write_any_B ) {
-                H5Write Bfield_group = species_group->group( "B" );
-                openPMD_->writeRecordAttributes( Bfield_group, SMILEI_UNIT_BFIELD );
-                for( unsigned int idim=0; idim<3; idim++ ) {
-                    if( write_B[idim] ) {
-                        write_component( &Bfield_group, xyz.substr( idim, 1 ).c_str(), data_double[( 3+idim )*nParticles_local], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_BFIELD );
-                    }
+        }
+        if( write_any_B ) {
+            H5Write Bfield_group = species_group->group( "B" );
+            openPMD_->writeRecordAttributes( Bfield_group, SMILEI_UNIT_BFIELD );
+            for( unsigned int idim=0; idim<3; idim++ ) {
+                if( write_B[idim] ) {
+                    write_component( &Bfield_group, xyz.substr( idim, 1 ).c_str(), data_double[( slot_fields+3+idim )*nParticles_local], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_BFIELD );
                 }
             }
         }
-    } // END if interpolate
-    
-    #pragma omp master
-    {
-        data_double.resize( 0 );
         
         // PositionOffset (for OpenPMD)
         H5Write positionoffset_group = species_group->group( "positionOffset" );
@@ -502,14 +560,30 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
             xyz_group.attr( "shape", np, H5T_NATIVE_UINT64 );
         }
         
+        // Hand the data over to the background writer
+        if( staging_now ) {
+            stage_arrays();
+        }
+        
         // Close and flush
         patch_selection.resize( 0 );
         
+        // The buffers have been written or copied to the staged bytes: release them until the next dump
+        data_uint64.clear();
+        data_uint64.shrink_to_fit();
+        data_short.clear();
+        data_short.shrink_to_fit();
+        data_double.clear();
+        data_double.shrink_to_fit();
+        
         delete file_space;
         delete mem_space;
         delete species_group;
         
         if( flush_timeSelection->theTimeIsNow( itime ) ) {
+            if( staged_writer_ ) {
+                staged_writer_->sync();
+            }
             file_->flush();
         }
     }
@@ -547,36 +621,20 @@ void DiagnosticTrack::setIDs( Particles &particles )
 
 
 template<typename T>
-void DiagnosticTrack::fill_buffer( VectorPatch &vecPatches, unsigned int iprop, vector<T> &buffer )
+void DiagnosticTrack::fill_buffer( Particles *particles, unsigned int iprop, vector<unsigned int> *selection, T *buffer )
 {
-    unsigned int patch_nParticles, i, j, nPatches=vecPatches.size();
     vector<T> *property = NULL;
+    particles->getProperty( iprop, property );
     
-    if( has_filter ) {
-        #pragma omp for schedule(runtime)
-        for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
-            patch_nParticles = patch_selection[ipatch].size();
-            vecPatches( ipatch )->vecSpecies[speciesId_]->particles->getProperty( iprop, property );
-            i=0;
-            j=patch_start[ipatch];
-            while( i<patch_nParticles ) {
-                buffer[j] = ( *property )[patch_selection[ipatch][i]];
-                i++;
-                j++;
-            }
+    if( selection ) {
+        unsigned int nsel = selection->size();
+        for( unsigned int i=0; i<nsel; i++ ) {
+            buffer[i] = ( *property )[( *selection )[i]];
         }
     } else {
-        #pragma omp for schedule(runtime)
-        for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
-            patch_nParticles = vecPatches( ipatch )->vecSpecies[speciesId_]->particles->size();
-            vecPatches( ipatch )->vecSpecies[speciesId_]->particles->getProperty( iprop, property );
-            i=0;
-            j=patch_start[ipatch];
-            while( i<patch_nParticles ) {
-                buffer[j] = ( *property )[i];
-                i++;
-                j++;
-            }
+        unsigned int npart = particles->size();
+        for( unsigned int i=0; i<npart; i++ ) {
+            buffer[i] = ( *property )[i];
         }
     }
 }
@@ -585,7 +643,7 @@ void DiagnosticTrack::fill_buffer( VectorPatch &vecPatches, unsigned int iprop,
 template<typename T>
 void DiagnosticTrack::write_scalar( H5Write * location, string name, T &buffer, hid_t dtype, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
 {
-    H5Write a = location->array( name, buffer, dtype, file_space, mem_space );
+    H5Write a = write_array( location, name, buffer, dtype, file_space, mem_space );
     openPMD_->writeRecordAttributes( a, unit_type );
     openPMD_->writeComponentAttributes( a, unit_type );
 }
@@ -593,10 +651,62 @@ void DiagnosticTrack::write_scalar( H5Write * location, string name, T &buffer,
 template<typename T>
 void DiagnosticTrack::write_component( H5Write * location, string name, T &buffer, hid_t dtype, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
 {
-    H5Write a = location->array( name, buffer, dtype, file_space, mem_space );
+    H5Write a = write_array( location, name, buffer, dtype, file_space, mem_space );
     openPMD_->writeComponentAttributes( a, unit_type );
 }
 
+template<typename T>
+H5Write DiagnosticTrack::write_array( H5Write * location, string name, T &buffer, hid_t dtype, H5Space *file_space, H5Space *mem_space )
+{
+    // When staged, all processes only create the dataset, which is allocated at a known address
+    H5Write a = staging_now ? location->dataset( name, dtype, file_space ) : location->array( name, buffer, dtype, file_space, mem_space );
+    if( staging_now ) {
+        MPI_Offset address = a.address();
+        if( address == ( MPI_Offset ) HADDR_UNDEF ) {
+            ERROR( filename << ": dataset " << name << " could not be allocated for staged writing" );
+        }
+        staged_address.push_back( address + offset_local*sizeof( T ) );
+        staged_buffer.push_back( reinterpret_cast<const char *>( &buffer ) );
+        staged_size.push_back( sizeof( T ) );
+    }
+    return a;
+}
+
+// The arrays are packed in a single buffer, in the order of their addresses in the file
+void DiagnosticTrack::stage_arrays()
+{
+    unsigned int narrays = staged_address.size();
+    vector<unsigned int> order( narrays );
+    for( unsigned int i=0; i<narrays; i++ ) {
+        order[i] = i;
+    }
+    sort( order.begin(), order.end(), [this]( unsigned int a, unsigned int b ) {
+        return staged_address[a] < staged_address[b];
+    } );
+    
+    vector<MPI_Offset> offsets( narrays );
+    vector<int> lengths( narrays );
+    size_t nbytes = 0;
+    for( unsigned int i=0; i<narrays; i++ ) {
+        offsets[i] = staged_address[order[i]];
+        lengths[i] = staged_size[order[i]] * nParticles_local;
+        nbytes += lengths[i];
+    }
+    staged_bytes.resize( nbytes );
+    nbytes = 0;
+    for( unsigned int i=0; i<narrays; i++ ) {
+        if( lengths[i] > 0 ) {
+            memcpy( &staged_bytes[nbytes], staged_buffer[order[i]], lengths[i] );
+        }
+        nbytes += lengths[i];
+    }
+    staged_writer_->write( staged_bytes, offsets, lengths );
+    
+    staged_address.resize( 0 );
+    staged_buffer.resize( 0 );
+    staged_size.resize( 0 );
+}
+
 
 
 // SUPPOSED TO BE EXECUTED ONLY BY MASTER MPI
@@ -6,6 +6,8 @@
 class Patch;
 class Params;
 class SmileiMPI;
+class StagedWriter;
+class ParticleFilter;
 
 
 class DiagnosticTrack : public Diagnostic
@@ -36,8 +38,8 @@ public :
     //! Get disk footprint of current diagnostic
     uint64_t getDiskFootPrint( int istart, int istop, Patch *patch ) override;
     
-    //! Fills a buffer with the required particle property
-    template<typename T> void fill_buffer( VectorPatch &vecPatches, unsigned int iprop, std::vector<T> &buffer );
+    //! Fills a buffer with the required property of the (selected) particles of one patch
+    template<typename T> void fill_buffer( Particles *particles, unsigned int iprop, std::vector<unsigned int> *selection, T *buffer );
     
     //! Write a scalar dataset with the given buffer
     template<typename T> void write_scalar( H5Write*, std::string, T &, hid_t, H5Space*, H5Space*, unsigned int );
@@ -45,6 +47,12 @@ public :
     //! Write a vector component dataset with the given buffer
     template<typename T> void write_component( H5Write*, std::string, T &, hid_t, H5Space*, H5Space*, unsigned int );
     
+    //! Creates a dataset and writes the given buffer, or stages it for writing in the background
+    template<typename T> H5Write write_array( H5Write*, std::string, T &, hid_t, H5Space*, H5Space* );
+    
+    //! Hands all the arrays staged at this iteration to the background writer
+    void stage_arrays();
+    
     //! Set a given patch's particles with the required IDs
     void setIDs( Patch * );
     
@@ -54,6 +62,9 @@ public :
     //! Index of the species used
     unsigned int speciesId_;
     
+    //! Name of the species used (also known by processes without patches)
+    std::string species_name_;
+    
     //! Last ID assigned to a particle by this MPI domain
     uint64_t latest_Id;
     
@@ -76,10 +87,13 @@ private :
     //! Tells whether this diag includes a particle filter
     PyObject *filter;
     
+    //! Filter given as a string expression, evaluated without python (NULL if python function or no filter)
+    ParticleFilter *compiled_filter;
+    
     //! Selection of the filtered particles in each patch
     std::vector<std::vector<unsigned int> > patch_selection;
     
-    //! Buffer for the output of double array
+    //! Buffer for the output of double arrays: one slot of nParticles_local values per written quantity
     std::vector<double> data_double;
     //! Buffer for the output of short array
     std::vector<short> data_short;
@@ -92,6 +106,37 @@ private :
     //! Number of particles shared among patches in this proc
     uint32_t nParticles_local;
     
+    //! Particle property (see Particles::getProperty) copied in each slot of data_double
+    std::vector<unsigned int> double_props;
+    
+    //! Slots of data_double where each quantity is stored (-1 if not written)
+    int slot_weight;
+    std::vector<int> slot_momentum;
+    std::vector<int> slot_position;
+    int slot_chi;
+    //! First of the 6 slots of the interpolated fields
+    int slot_fields;
+    
+    //! Number of buffers for writing in the background (0 for synchronous writing)
+    unsigned int staging_buffers;
+    
+    //! Writes the data in the background, when staging_buffers > 0
+    StagedWriter *staged_writer_;
+    
+    //! True if the arrays of the current iteration are staged (false for chunked arrays)
+    bool staging_now;
+    
+    //! Offset of the particles of this proc in the arrays of the current iteration
+    uint64_t offset_local;
+    
+    //! Address in the file, buffer and element size of each array staged at the current iteration
+    std::vector<MPI_Offset> staged_address;
+    std::vector<const char *> staged_buffer;
+    std::vector<size_t> staged_size;
+    
+    //! Buffer holding the staged arrays, ordered like their addresses in the file
+    std::vector<char> staged_bytes;
+    
     //! Booleans to determine which attributes to write out
     std::vector<bool> write_position;
     std::vector<bool> write_momentum;
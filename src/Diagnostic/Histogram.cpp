@@ -28,65 +28,39 @@ void Histogram::digitize( vector<Species *> species,
         }
         // Now, double_buffer has the location of each particle along the axis
         
-        // if log scale, loop again and convert to log
-        if( axis->logscale ) {
-            for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
-                if( int_buffer[ipart] < 0 ) {
-                    continue;
-                }
-                double_buffer[ipart] = log10( abs( double_buffer[ipart] ) );
-            }
-        }
-        
         double actual_min = axis->logscale ? log10( axis->global_min ) : axis->global_min;
         double actual_max = axis->logscale ? log10( axis->global_max ) : axis->global_max;
         double coeff = ( ( double ) axis->nbins )/( actual_max - actual_min );
+        double last_bin = ( double )( axis->nbins - 1 );
+        int nbins = axis->nbins;
+        bool logscale = axis->logscale;
+        double *location = &double_buffer[0];
+        int *index = &int_buffer[0];
         
-        // The indexes are "reshaped" in one dimension.
-        // For instance, in 3d, the index has the form  i = i3 + n3*( i2 + n2*i1 )
-        // Here we do the multiplication by n3 or n2 (etc.)
-        if( iaxis>0 ) {
-            for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
-                int_buffer[ipart] *= axis->nbins;
-            }
-        }
-        
-        // loop again on the particles and calculate the index
-        // This is separated in two cases: edge_inclusive and edge_exclusive
+        // Single vectorized pass on the particles: log scale, index along the axis and
+        // "reshaped" index in the final array. For instance, in 3d, the index has the form
+        // i = i3 + n3*( i2 + n2*i1 ). Already discarded particles keep a negative index.
         if( !axis->edge_inclusive ) { // if the particles out of the "box" must be excluded
         
+            #pragma omp simd
             for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
-                // skip already discarded particles
-                if( int_buffer[ipart] < 0 ) {
-                    continue;
-                }
-                // calculate index
-                int ind = floor( ( double_buffer[ipart]-actual_min ) * coeff );
+                double x = logscale ? log10( abs( location[ipart] ) ) : location[ipart];
+                double ind = floor( ( x-actual_min ) * coeff );
                 // index valid only if in the "box"
-                if( ind >= 0  &&  ind < axis->nbins ) {
-                    int_buffer[ipart] += ind;
-                } else {
-                    int_buffer[ipart] = -1;    // discard particle
-                }
+                bool valid = index[ipart] >= 0 && ind >= 0. && ind <= last_bin;
+                index[ipart] = valid ? index[ipart] * nbins + ( int ) ind : -1;
             }
             
         } else { // if the particles out of the "box" must be included
         
+            #pragma omp simd
             for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
-                // skip already discarded particles
-                if( int_buffer[ipart] < 0 ) {
-                    continue;
-                }
-                // calculate index
-                int ind = floor( ( double_buffer[ipart]-actual_min ) * coeff );
+                double x = logscale ? log10( abs( location[ipart] ) ) : location[ipart];
+                double ind = floor( ( x-actual_min ) * coeff );
                 // move out-of-range indexes back into range
-                if( ind < 0 ) {
-                    ind = 0;
-                }
-                if( ind >= axis->nbins ) {
-                    ind = axis->nbins-1;
-                }
-                int_buffer[ipart] += ind;
+                ind = ind > 0. ? ind : 0.;
+                ind = ind < last_bin ? ind : last_bin;
+                index[ipart] = index[ipart] >= 0 ? index[ipart] * nbins + ( int ) ind : -1;
             }
             
         }
@@ -103,19 +77,37 @@ void Histogram::distribute(
     unsigned int ipart, npart=double_buffer.size();
     int ind;
     
-    // Sum the data into the data_sum according to the indexes
+    // Sum the data into the (thread-private) output array according to the indexes
     // ---------------------------------------------------------------
     for( ipart = 0 ; ipart < npart ; ipart++ ) {
         ind = int_buffer[ipart];
         if( ind<0 ) {
             continue;    // skip discarded particles
         }
-        #pragma omp atomic
         output_array[ind] += double_buffer[ipart];
     }
     
 }
 
+void Histogram::distribute(
+    std::vector<double> &double_buffer,
+    std::vector<int>    &int_buffer,
+    std::vector<std::pair<unsigned int, double> > &output_list )
+{
+
+    unsigned int npart=double_buffer.size();
+    
+    // Append the contributions to the (thread-private) list
+    // ---------------------------------------------------------------
+    for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
+        if( int_buffer[ipart]<0 || double_buffer[ipart] == 0. ) {
+            continue;    // skip discarded particles
+        }
+        output_list.push_back( std::make_pair( ( unsigned int ) int_buffer[ipart], double_buffer[ipart] ) );
+    }
+    
+}
+
 
 
 void HistogramAxis::init( string type_, double min_, double max_, int nbins_, bool logscale_, bool edge_inclusive_, vector<double> coefficients_ )
@@ -93,8 +93,10 @@ public:
             istart += species[ispec]->getNbrOfParticles();
         }
     };
-    //! Add the contribution of each particle in the histogram
+    //! Add the contribution of each particle in the histogram (private to the thread)
     void distribute( std::vector<double> &, std::vector<int> &, std::vector<double> & );
+    //! Same as `distribute` for a sparse histogram: list of (index, contribution)
+    void distribute( std::vector<double> &, std::vector<int> &, std::vector<std::pair<unsigned int, double> > & );
 
     std::string deposited_quantity;
 
@@ -119,6 +119,11 @@ public:
                 ERROR( "PrescribedField #"<<n_extfield<<": parameter 'profile' not understood" );
             }
             extField.profile = new Profile( profile, params.nDim_field+1, name.str(), params, true, true, true );
+            std::vector<unsigned int> axes;
+            for( unsigned int i=0; i<params.nDim_field; i++ ) {
+                axes.push_back( i );
+            }
+            extField.profile->tabulate( params, axes, true );
             // Find which index the field is in the allFields vector
             extField.index = 1000;
             for( unsigned int ifield=0; ifield<EMfields->allFields.size(); ifield++ ) {
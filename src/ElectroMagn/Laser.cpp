@@ -77,6 +77,14 @@ Laser::Laser( Params &params, int ilaser, Patch *patch, bool verbose )
     unsigned int spacetime_size = ( has_space_time_AM ? 2*params.nmodes+1 : 2 );//+1 to force spacetime_size to be always >2 in AM geometry.
 
     spacetime.resize( spacetime_size, false ); //Needs to be resized even if non separable profiles are not used.
+    
+    // Axes of the box along which the space-time profiles vary (tabulation only in cartesian geometry)
+    vector<unsigned int> transverse_axes;
+    for( unsigned int i=0; i<params.nDim_field; i++ ) {
+        if( i != normal_axis ) {
+            transverse_axes.push_back( i );
+        }
+    }
 
     if( has_space_time || has_space_time_AM ) {
 
@@ -105,6 +113,9 @@ Laser::Laser( Params &params, int ilaser, Patch *patch, bool verbose )
             name << "Laser[" << ilaser <<"].space_time_profile["<< 2*imode << "]";
             if( spacetime[2*imode] ) {
                 Profile *p = new Profile( space_time_profile[2*imode], params.nDim_field, name.str(), params );
+                if( ! has_space_time_AM ) {
+                    p->tabulate( params, transverse_axes, true );
+                }
                 profiles.push_back( new LaserProfileNonSeparable( p ) );
                 info << "\t\t\tfirst  component : " << p->getInfo();
                 if (has_space_time_AM) info << " mode " << imode ;
@@ -120,6 +131,9 @@ Laser::Laser( Params &params, int ilaser, Patch *patch, bool verbose )
             name << "Laser[" << ilaser <<"].space_time_profile[" << 2*imode+1 << "]";
             if( spacetime[2*imode+1] ) {
                 Profile *p = new Profile( space_time_profile[2*imode+1], params.nDim_field, name.str(), params );
+                if( ! has_space_time_AM ) {
+                    p->tabulate( params, transverse_axes, true );
+                }
                 profiles.push_back( new LaserProfileNonSeparable( p ) );
                 info << "\t\t\tsecond component : " << p->getInfo() ;
                 if (has_space_time_AM) info << " mode " << imode ;
@@ -184,6 +198,8 @@ Laser::Laser( Params &params, int ilaser, Patch *patch, bool verbose )
         name << "Laser[" << ilaser <<"].chirp_profile";
         Profile *pchirp1 = new Profile( chirp_profile, 1, name.str(), params );
         Profile *pchirp2 = new Profile( chirp_profile, 1, name.str(), params );
+        pchirp1->tabulate( params, {}, true );
+        pchirp2->tabulate( params, {}, true );
         info << "\t\t\tchirp_profile      : " << pchirp1->getInfo();
 
         // time envelope
@@ -191,6 +207,8 @@ Laser::Laser( Params &params, int ilaser, Patch *patch, bool verbose )
         name << "Laser[" << ilaser <<"].time_envelope";
         Profile *ptime1 = new Profile( time_profile, 1, name.str(), params );
         Profile *ptime2 = new Profile( time_profile, 1, name.str(), params );
+        ptime1->tabulate( params, {}, true );
+        ptime2->tabulate( params, {}, true );
         info << endl << "\t\t\ttime envelope      : " << ptime1->getInfo();
 
         // space envelope (By)
@@ -0,0 +1,860 @@
+#include "PoissonMultigrid.h"
+
+#include <cmath>
+
+#include "Params.h"
+#include "SmileiMPI.h"
+#include "VectorPatch.h"
+#include "SyncVectorPatch.h"
+#include "ElectroMagn.h"
+#include "Field.h"
+#include "DomainDecomposition.h"
+#include "Timers.h"
+
+using namespace std;
+
+//! Weight of the Jacobi smoother
+#define MULTIGRID_OMEGA (2./3.)
+//! Number of smoothing sweeps before and after the coarse-grid correction, and on the coarsest level
+#define MULTIGRID_SWEEPS 2
+#define MULTIGRID_COARSEST_SWEEPS 8
+//! Maximum number of unknowns of the coarsest level of the coarse problem, solved by a conjugate gradient
+#define MULTIGRID_MAX_COARSE 32768
+
+PoissonMultigrid::PoissonMultigrid( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches, vector<double> coeffs ) :
+    timers_( smpi ),
+    nDim_( params.nDim_field ),
+    coeffs_( coeffs )
+{
+    coeffs_.resize( 3, 0. );
+    double cmax = 0.;
+    for( unsigned int idim=0 ; idim<nDim_ ; idim++ ) {
+        cmax = max( cmax, coeffs_[idim] );
+    }
+
+    // Box size of each patch coordinate along each dimension (the same for all the patches in a slice)
+    vector<int> box_size[3];
+    for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+        box_size[idim].resize( idim<nDim_ ? params.number_of_patches[idim] : 1, 1 );
+    }
+    for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+        Patch *patch = vecPatches( ipatch );
+        ElectroMagn *EMfields = patch->EMfields;
+
+        // Box of the nodes solved for by the patch: the nodes it owns (those accounted for in the scalar
+        // products) and, as in compute_Ap, the ghost nodes beyond the transverse boundaries of the domain
+        array<unsigned int, 3> first = {{ 0, 0, 0 }}, n = {{ 1, 1, 1 }}, coordinates = {{ 0, 0, 0 }};
+        for( unsigned int idim=0 ; idim<nDim_ ; idim++ ) {
+            unsigned int last = EMfields->index_max_p_[idim];
+            first[idim] = EMfields->index_min_p_[idim];
+            if( idim > 0 && patch->isBoundary( idim, 0 ) ) {
+                first[idim] = 1;
+            }
+            if( idim > 0 && patch->isBoundary( idim, 1 ) ) {
+                last = EMfields->r_->dims_[idim] - 2;
+            }
+            n[idim] = last - first[idim] + 1;
+            coordinates[idim] = patch->Pcoordinates[idim];
+            box_size[idim][coordinates[idim]] = n[idim];
+        }
+        first_.push_back( first );
+        coordinates_.push_back( coordinates );
+        patch_levels_.push_back( hierarchy( n ) );
+        z_.push_back( EMfields->r_->clone() );
+    }
+
+    // Global boxes along each dimension. The coarse functions follow every node along the weakly coupled
+    // dimensions, unless the coarse problem would exceed MULTIGRID_MAX_COARSE unknowns: the weakly coupled
+    // dimensions with most nodes are then made linear between the patch corners, as the other ones.
+    // With more patches, the coarse problem is itself solved by V-cycles on coarser levels (see below)
+    unsigned int n_identity[3], n_linear[3];
+    for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+        CoarseAxis &axis = axis_[idim];
+        unsigned int npatches = box_size[idim].size();
+        if( idim < nDim_ ) {
+            MPI_Allreduce( MPI_IN_PLACE, &box_size[idim][0], npatches, MPI_INT, MPI_MAX, MPI_COMM_WORLD );
+        }
+        axis.box_start.resize( npatches+1, 0 );
+        for( unsigned int p=0 ; p<npatches ; p++ ) {
+            axis.box_start[p+1] = axis.box_start[p] + box_size[idim][p];
+        }
+        axis.periodic = idim >= nDim_ || params.EM_BCs[idim][0] == "periodic";
+        axis.identity = idim >= nDim_ || coeffs_[idim] < 0.25*cmax;
+        n_identity[idim] = axis.box_start[npatches];
+        n_linear[idim] = axis.periodic ? ( npatches>=3 ? npatches : 0 ) : npatches-1;
+    }
+    while( true ) {
+        double ncoarse = 1.;
+        unsigned int largest = 3;
+        for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+            ncoarse *= axis_[idim].identity ? n_identity[idim] : n_linear[idim];
+            if( idim < nDim_ && axis_[idim].identity && ( largest == 3 || n_identity[idim] > n_identity[largest] ) ) {
+                largest = idim;
+            }
+        }
+        if( ncoarse <= MULTIGRID_MAX_COARSE || largest == 3 ) {
+            break;
+        }
+        axis_[largest].identity = false;
+    }
+
+    // Coarse functions along each dimension
+    coarse_levels_.resize( 1 );
+    CoarseLevel &C0 = coarse_levels_[0];
+    coarse_singular_ = true;
+    for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+        CoarseAxis &axis = axis_[idim];
+        unsigned int npatches = box_size[idim].size();
+        unsigned int nnodes = axis.box_start[npatches];
+        if( ! axis.periodic ) {
+            coarse_singular_ = false;
+        }
+
+        // Interpolation P from the coarse unknowns to the nodes
+        axis.count .resize( nnodes, 0 );
+        axis.index .resize( 2*nnodes, 0 );
+        axis.weight.resize( 2*nnodes, 0. );
+        if( axis.identity ) {
+            axis.n = nnodes;
+            for( unsigned int g=0 ; g<nnodes ; g++ ) {
+                axis.count [g] = 1;
+                axis.index [2*g] = g;
+                axis.weight[2*g] = 1.;
+            }
+        } else {
+            // Unknowns at the first node of each box, except at the lower boundary of the domain,
+            // where the function is linear from the (fixed) node before the box
+            axis.n = axis.periodic ? ( npatches>=3 ? npatches : 0 ) : npatches-1;
+            for( unsigned int p=0 ; p<npatches && axis.n>0 ; p++ ) {
+                bool has_left  = axis.periodic || p > 0;
+                bool has_right = axis.periodic || p < npatches-1;
+                unsigned int left  = axis.periodic ? p : p-1;
+                unsigned int right = axis.periodic ? ( p+1 )%npatches : p;
+                double left_offset = has_left ? 0. : -1.;
+                for( int k=0 ; k<box_size[idim][p] ; k++ ) {
+                    unsigned int g = axis.box_start[p] + k;
+                    double w = ( k - left_offset ) / ( box_size[idim][p] - left_offset );
+                    if( has_left && w < 1. ) {
+                        axis.index [2*g+axis.count[g]] = left;
+                        axis.weight[2*g+axis.count[g]] = 1. - w;
+                        axis.count [g]++;
+                    }
+                    if( has_right && w > 0. ) {
+                        axis.index [2*g+axis.count[g]] = right;
+                        axis.weight[2*g+axis.count[g]] = w;
+                        axis.count [g]++;
+                    }
+                }
+            }
+        }
+        C0.n[idim] = axis.n;
+        C0.periodic[idim] = axis.periodic;
+        C0.identity[idim] = axis.identity;
+
+        // P^T P and P^T L P, with L = - sum over the edges (g,h) of (e_g-e_h)(e_g-e_h)^T - sum over the
+        // nodes next to a fixed potential of e_g e_g^T
+        for( unsigned int i=0 ; i<3 ; i++ ) {
+            C0.mass     [idim][i].resize( axis.n, 0. );
+            C0.stiffness[idim][i].resize( axis.n, 0. );
+        }
+        for( unsigned int g=0 ; g<nnodes && axis.n>0 ; g++ ) {
+            for( unsigned int a=0 ; a<axis.count[g] ; a++ ) {
+                for( unsigned int b=0 ; b<axis.count[g] ; b++ ) {
+                    double ww = axis.weight[2*g+a] * axis.weight[2*g+b];
+                    addTo( axis.n, C0.mass[idim], axis.index[2*g+a], axis.index[2*g+b], ww );
+                    if( ! axis.periodic && ( g == 0 || g == nnodes-1 ) ) {
+                        addTo( axis.n, C0.stiffness[idim], axis.index[2*g+a], axis.index[2*g+b], -ww );
+                    }
+                }
+            }
+            if( idim >= nDim_ || ( g == nnodes-1 && ! axis.periodic ) ) {
+                continue;
+            }
+            unsigned int h = ( g+1 )%nnodes;
+            unsigned int nonzero = 0, index[4];
+            double difference[4];
+            for( unsigned int a=0 ; a<axis.count[g] ; a++ ) {
+                index[nonzero] = axis.index[2*g+a];
+                difference[nonzero++] = axis.weight[2*g+a];
+            }
+            for( unsigned int a=0 ; a<axis.count[h] ; a++ ) {
+                index[nonzero] = axis.index[2*h+a];
+                difference[nonzero++] = -axis.weight[2*h+a];
+            }
+            for( unsigned int a=0 ; a<nonzero ; a++ ) {
+                for( unsigned int b=0 ; b<nonzero ; b++ ) {
+                    addTo( axis.n, C0.stiffness[idim], index[a], index[b], -difference[a]*difference[b] );
+                }
+            }
+        }
+    }
+
+    coarseDiagonal( C0 );
+
+    // Hierarchy of the coarse problem, until the coarsest level has at most MULTIGRID_MAX_COARSE unknowns
+    while( coarse_levels_.back().size() > MULTIGRID_MAX_COARSE && coarsen() ) {
+    }
+
+    unsigned int ncoarse = C0.size();
+    coarse_b_.resize( ncoarse+1 );
+    unsigned int ncoarsest = coarse_levels_.back().size();
+    coarse_z_ .resize( ncoarsest );
+    coarse_p_ .resize( ncoarsest );
+    coarse_Ap_.resize( ncoarsest );
+}
+
+PoissonMultigrid::~PoissonMultigrid()
+{
+    for( unsigned int ipatch=0 ; ipatch<z_.size() ; ipatch++ ) {
+        delete z_[ipatch];
+    }
+}
+
+// Coarsening is done along the dimensions which are strongly coupled (e.g. not the x direction of the
+// relativistic Poisson problem for large Lorentz factors), until a single node remains
+vector<PoissonMultigrid::Level> *PoissonMultigrid::hierarchy( array<unsigned int, 3> n )
+{
+    auto found = hierarchies_.find( n );
+    if( found != hierarchies_.end() ) {
+        return &( found->second );
+    }
+
+    vector<Level> &levels = hierarchies_[n];
+    double c[3] = { coeffs_[0], coeffs_[1], coeffs_[2] };
+    unsigned int size[3] = { n[0], n[1], n[2] };
+    while( true ) {
+        levels.push_back( Level() );
+        Level &L = levels.back();
+        double cmax = 0.;
+        for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+            L.n[idim] = size[idim];
+            L.c[idim] = c[idim];
+            if( size[idim] > 1 && c[idim] > cmax ) {
+                cmax = c[idim];
+            }
+        }
+        unsigned int npoints = size[0]*size[1]*size[2];
+        L.u  .resize( npoints );
+        L.f  .resize( npoints );
+        L.res.resize( npoints );
+        if( cmax == 0. ) {
+            for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+                L.coarsened[idim] = false;
+            }
+            break;
+        }
+        // Nodes 2I+1 of the fine level are the nodes I of the coarse level
+        for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+            L.coarsened[idim] = size[idim] > 1 && c[idim] >= 0.25*cmax;
+            if( L.coarsened[idim] ) {
+                size[idim] /= 2;
+                c[idim] *= 0.25;
+            }
+        }
+    }
+    return &levels;
+}
+
+void PoissonMultigrid::residual( Level &L )
+{
+    unsigned int npoints = L.n[0]*L.n[1]*L.n[2];
+    double diag = 2.*( L.c[0]+L.c[1]+L.c[2] );
+    double *u = &L.u[0], *f = &L.f[0], *res = &L.res[0];
+
+    #pragma omp simd
+    for( unsigned int i=0 ; i<npoints ; i++ ) {
+        res[i] = f[i] + diag * u[i];
+    }
+    // Neighbours along each dimension, zero outside the box
+    unsigned int stride = npoints;
+    for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+        unsigned int block = stride;
+        stride /= L.n[idim];
+        if( L.n[idim] < 2 || L.c[idim] == 0. ) {
+            continue;
+        }
+        double c = L.c[idim];
+        for( unsigned int start=0 ; start<npoints ; start+=block ) {
+            double *r = &res[start];
+            double *v = &u[start];
+            #pragma omp simd
+            for( unsigned int i=stride ; i<block ; i++ ) {
+                r[i] -= c * v[i-stride];
+            }
+            #pragma omp simd
+            for( unsigned int i=0 ; i<block-stride ; i++ ) {
+                r[i] -= c * v[i+stride];
+            }
+        }
+    }
+}
+
+void PoissonMultigrid::smooth( Level &L, unsigned int nsweeps )
+{
+    unsigned int npoints = L.n[0]*L.n[1]*L.n[2];
+    double factor = - MULTIGRID_OMEGA / ( 2.*( L.c[0]+L.c[1]+L.c[2] ) );
+    for( unsigned int isweep=0 ; isweep<nsweeps ; isweep++ ) {
+        residual( L );
+        double *u = &L.u[0], *res = &L.res[0];
+        #pragma omp simd
+        for( unsigned int i=0 ; i<npoints ; i++ ) {
+            u[i] += factor * res[i];
+        }
+    }
+}
+
+// Linear interpolation along the coarsened dimensions: the fine node 2I+1 is the coarse node I,
+// the fine node 2I is between the coarse nodes I-1 and I (zero outside the box).
+// The restriction is the transposed interpolation, divided by 2 for each coarsened dimension.
+void PoissonMultigrid::transfer( vector<Level> &levels, unsigned int l, bool restriction )
+{
+    Level &F = levels[l], &C = levels[l+1];
+
+    // For each dimension and each fine index: the coarse indices and weights
+    vector<unsigned int> index[3];
+    vector<double> weight[3];
+    vector<unsigned int> count[3];
+    for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+        index[idim].resize( 2*F.n[idim] );
+        weight[idim].resize( 2*F.n[idim] );
+        count[idim].resize( F.n[idim] );
+        double w = restriction && F.coarsened[idim] ? 0.5 : 1.;
+        for( unsigned int i=0 ; i<F.n[idim] ; i++ ) {
+            unsigned int k = 0;
+            if( ! F.coarsened[idim] ) {
+                index[idim][2*i] = i;
+                weight[idim][2*i] = 1.;
+                k = 1;
+            } else if( i%2 == 1 ) {
+                index[idim][2*i] = i/2;
+                weight[idim][2*i] = w;
+                k = 1;
+            } else {
+                if( i > 0 ) {
+                    index[idim][2*i+k] = i/2-1;
+                    weight[idim][2*i+k] = 0.5*w;
+                    k++;
+                }
+                if( i/2 < C.n[idim] ) {
+                    index[idim][2*i+k] = i/2;
+                    weight[idim][2*i+k] = 0.5*w;
+                    k++;
+                }
+            }
+            count[idim][i] = k;
+        }
+    }
+
+    if( restriction ) {
+        fill( C.f.begin(), C.f.end(), 0. );
+    }
+    for( unsigned int i=0 ; i<F.n[0] ; i++ ) {
+        for( unsigned int j=0 ; j<F.n[1] ; j++ ) {
+            for( unsigned int k=0 ; k<F.n[2] ; k++ ) {
+                unsigned int ifine = ( i*F.n[1] + j )*F.n[2] + k;
+                for( unsigned int a=0 ; a<count[0][i] ; a++ ) {
+                    for( unsigned int b=0 ; b<count[1][j] ; b++ ) {
+                        for( unsigned int c=0 ; c<count[2][k] ; c++ ) {
+                            unsigned int icoarse = ( index[0][2*i+a]*C.n[1] + index[1][2*j+b] )*C.n[2] + index[2][2*k+c];
+                            double w = weight[0][2*i+a] * weight[1][2*j+b] * weight[2][2*k+c];
+                            if( restriction ) {
+                                C.f[icoarse] += w * F.res[ifine];
+                            } else {
+                                F.u[ifine] += w * C.u[icoarse];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Symmetric V-cycle: same number of Jacobi sweeps before and after the coarse correction
+void PoissonMultigrid::vcycle( vector<Level> &levels, unsigned int l )
+{
+    Level &L = levels[l];
+    fill( L.u.begin(), L.u.end(), 0. );
+    if( l == levels.size()-1 ) {
+        smooth( L, MULTIGRID_COARSEST_SWEEPS );
+        return;
+    }
+    smooth( L, MULTIGRID_SWEEPS );
+    residual( L );
+    transfer( levels, l, true );
+    vcycle( levels, l+1 );
+    transfer( levels, l, false );
+    smooth( L, MULTIGRID_SWEEPS );
+}
+
+void PoissonMultigrid::addTo( unsigned int n, vector<double> *T, unsigned int a, unsigned int b, double v )
+{
+    if( b == a ) {
+        T[1][a] += v;
+    } else if( b == ( a+1 )%n ) {
+        T[2][a] += v;
+    } else {
+        T[0][a] += v;
+    }
+}
+
+// Diagonal of A0 = sum over the dimensions d of c_d ( X_0 x X_1 x X_2 ), X_e being K along e=d and M otherwise
+void PoissonMultigrid::coarseDiagonal( CoarseLevel &C )
+{
+    C.diag.resize( C.size() );
+    for( unsigned int i=0 ; i<C.n[0] ; i++ ) {
+        for( unsigned int j=0 ; j<C.n[1] ; j++ ) {
+            for( unsigned int k=0 ; k<C.n[2] ; k++ ) {
+                unsigned int index[3] = { i, j, k };
+                double diag = 0.;
+                for( unsigned int idim=0 ; idim<nDim_ ; idim++ ) {
+                    double term = coeffs_[idim];
+                    for( unsigned int jdim=0 ; jdim<3 ; jdim++ ) {
+                        term *= ( jdim == idim ? C.stiffness[jdim] : C.mass[jdim] )[1][index[jdim]];
+                    }
+                    diag += term;
+                }
+                C.diag[( i*C.n[1] + j )*C.n[2] + k] = diag;
+            }
+        }
+    }
+    C.b  .resize( C.size() );
+    C.x  .resize( C.size() );
+    C.res.resize( C.size() );
+    C.tmp[0].resize( C.size() );
+    C.tmp[1].resize( C.size() );
+}
+
+// Adds a coarser level to the hierarchy of the coarse problem. As inside the patches, the dimensions which
+// are strongly coupled are coarsened: the nodes 2I+1 of the fine level (2I if periodic) are the nodes I of the
+// coarse level, and the functions are linear between them. The operator of the coarse level is the Galerkin
+// operator R^T A0 R, computed along each dimension on the tridiagonal matrices M and K.
+// Returns false if no dimension can be coarsened.
+bool PoissonMultigrid::coarsen()
+{
+    coarse_levels_.push_back( CoarseLevel() );
+    CoarseLevel &F = coarse_levels_[coarse_levels_.size()-2], &C = coarse_levels_.back();
+
+    // Strength of the coupling along each dimension, for the first nodes
+    double strength[3] = { 0., 0., 0. }, smax = 0.;
+    for( unsigned int idim=0 ; idim<nDim_ ; idim++ ) {
+        unsigned int n = F.n[idim];
+        if( F.periodic[idim] ? n%2 == 0 && n >= 6 : n >= 2 ) {
+            strength[idim] = coeffs_[idim] * abs( F.stiffness[idim][1][0] / F.mass[idim][1][0] );
+            smax = max( smax, strength[idim] );
+        }
+    }
+    if( smax == 0. ) {
+        coarse_levels_.pop_back();
+        return false;
+    }
+
+    for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+        unsigned int n = F.n[idim];
+        F.coarsened[idim] = strength[idim] > 0. && strength[idim] >= 0.25*smax;
+        C.n[idim] = F.coarsened[idim] ? n/2 : n;
+        C.periodic[idim] = F.periodic[idim];
+        C.identity[idim] = F.identity[idim] && ! F.coarsened[idim];
+
+        // Interpolation R from the coarse level
+        F.count [idim].resize( n, 0 );
+        F.index [idim].resize( 2*n, 0 );
+        F.weight[idim].resize( 2*n, 0. );
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            unsigned int k = 0;
+            if( ! F.coarsened[idim] ) {
+                F.index [idim][2*i] = i;
+                F.weight[idim][2*i] = 1.;
+                k = 1;
+            } else if( F.periodic[idim] ) {
+                F.index [idim][2*i] = i/2;
+                F.weight[idim][2*i] = i%2 == 0 ? 1. : 0.5;
+                k = 1;
+                if( i%2 == 1 ) {
+                    F.index [idim][2*i+1] = ( i/2+1 )%C.n[idim];
+                    F.weight[idim][2*i+1] = 0.5;
+                    k = 2;
+                }
+            } else if( i%2 == 1 ) {
+                F.index [idim][2*i] = i/2;
+                F.weight[idim][2*i] = 1.;
+                k = 1;
+            } else {
+                if( i > 0 ) {
+                    F.index [idim][2*i+k] = i/2-1;
+                    F.weight[idim][2*i+k] = 0.5;
+                    k++;
+                }
+                if( i/2 < C.n[idim] ) {
+                    F.index [idim][2*i+k] = i/2;
+                    F.weight[idim][2*i+k] = 0.5;
+                    k++;
+                }
+            }
+            F.count[idim][i] = k;
+        }
+
+        // R^T M R and R^T K R
+        for( unsigned int t=0 ; t<3 ; t++ ) {
+            C.mass     [idim][t].resize( C.n[idim], 0. );
+            C.stiffness[idim][t].resize( C.n[idim], 0. );
+        }
+        for( unsigned int a=0 ; a<n ; a++ ) {
+            for( int offset=-1 ; offset<=1 ; offset++ ) {
+                int b = ( int )a + offset;
+                if( F.periodic[idim] ) {
+                    b = ( b + ( int )n )%( int )n;
+                } else if( b < 0 || b >= ( int )n ) {
+                    continue;
+                }
+                for( unsigned int ia=0 ; ia<F.count[idim][a] ; ia++ ) {
+                    for( unsigned int ib=0 ; ib<F.count[idim][b] ; ib++ ) {
+                        double ww = F.weight[idim][2*a+ia] * F.weight[idim][2*b+ib];
+                        unsigned int I = F.index[idim][2*a+ia], J = F.index[idim][2*b+ib];
+                        addTo( C.n[idim], C.mass     [idim], I, J, ww * F.mass     [idim][offset+1][a] );
+                        addTo( C.n[idim], C.stiffness[idim], I, J, ww * F.stiffness[idim][offset+1][a] );
+                    }
+                }
+            }
+        }
+    }
+    coarseDiagonal( C );
+    return true;
+}
+
+void PoissonMultigrid::applyAxis( CoarseLevel &C, unsigned int idim, vector<double> *T, vector<double> &x, vector<double> &y )
+{
+    unsigned int n = C.n[idim];
+    unsigned int stride = 1;
+    for( unsigned int jdim=idim+1 ; jdim<3 ; jdim++ ) {
+        stride *= C.n[jdim];
+    }
+    unsigned int block = n*stride;
+    for( unsigned int start=0 ; start<x.size() ; start+=block ) {
+        for( unsigned int a=0 ; a<n ; a++ ) {
+            // The lower and upper terms are zero where there is no neighbour
+            double *ya = &y[start + a*stride];
+            double *xa = &x[start + a*stride];
+            double *xl = &x[start + ( ( a+n-1 )%n )*stride];
+            double *xu = &x[start + ( ( a+1 )%n )*stride];
+            double lower = T[0][a], diag = T[1][a], upper = T[2][a];
+            #pragma omp simd
+            for( unsigned int i=0 ; i<stride ; i++ ) {
+                ya[i] = lower * xl[i] + diag * xa[i] + upper * xu[i];
+            }
+        }
+    }
+}
+
+void PoissonMultigrid::applyCoarse( CoarseLevel &C, vector<double> &x, vector<double> &y )
+{
+    fill( y.begin(), y.end(), 0. );
+    for( unsigned int idim=0 ; idim<nDim_ ; idim++ ) {
+        // c_d ( X_0 x X_1 x X_2 ) x, as successive products along each dimension (M = 1 for the identity)
+        vector<double> *in = &x;
+        unsigned int itmp = 0;
+        for( unsigned int jdim=0 ; jdim<nDim_ ; jdim++ ) {
+            if( jdim != idim && C.identity[jdim] ) {
+                continue;
+            }
+            applyAxis( C, jdim, jdim == idim ? C.stiffness[jdim] : C.mass[jdim], *in, C.tmp[itmp] );
+            in = &C.tmp[itmp];
+            itmp = 1-itmp;
+        }
+        double c = coeffs_[idim];
+        double *yd = &y[0], *t = &( *in )[0];
+        #pragma omp simd
+        for( unsigned int i=0 ; i<y.size() ; i++ ) {
+            yd[i] += c * t[i];
+        }
+    }
+}
+
+// res = b - A0 x, then weighted Jacobi sweeps
+void PoissonMultigrid::coarseSmooth( CoarseLevel &C, unsigned int nsweeps )
+{
+    unsigned int n = C.size();
+    for( unsigned int isweep=0 ; isweep<nsweeps ; isweep++ ) {
+        coarseResidual( C );
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            C.x[i] += MULTIGRID_OMEGA * C.res[i] / C.diag[i];
+        }
+    }
+}
+
+void PoissonMultigrid::coarseResidual( CoarseLevel &C )
+{
+    applyCoarse( C, C.x, C.res );
+    for( unsigned int i=0 ; i<C.size() ; i++ ) {
+        C.res[i] = C.b[i] - C.res[i];
+    }
+}
+
+// Restriction of the residual of level l to the right-hand side of level l+1 (or prolongation of the solution
+// of level l+1, added to the solution of level l), along the three dimensions
+void PoissonMultigrid::coarseTransferLevels( unsigned int l, bool restriction )
+{
+    CoarseLevel &F = coarse_levels_[l], &C = coarse_levels_[l+1];
+    if( restriction ) {
+        fill( C.b.begin(), C.b.end(), 0. );
+    }
+    for( unsigned int i=0 ; i<F.n[0] ; i++ ) {
+        for( unsigned int j=0 ; j<F.n[1] ; j++ ) {
+            for( unsigned int k=0 ; k<F.n[2] ; k++ ) {
+                unsigned int ifine = ( i*F.n[1] + j )*F.n[2] + k;
+                for( unsigned int a=0 ; a<F.count[0][i] ; a++ ) {
+                    for( unsigned int b=0 ; b<F.count[1][j] ; b++ ) {
+                        for( unsigned int c=0 ; c<F.count[2][k] ; c++ ) {
+                            unsigned int icoarse = ( F.index[0][2*i+a]*C.n[1] + F.index[1][2*j+b] )*C.n[2] + F.index[2][2*k+c];
+                            double w = F.weight[0][2*i+a] * F.weight[1][2*j+b] * F.weight[2][2*k+c];
+                            if( restriction ) {
+                                C.b[icoarse] += w * F.res[ifine];
+                            } else {
+                                F.x[ifine] += w * C.x[icoarse];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Symmetric V-cycle on the levels of the coarse problem, with x=0 initially; the coarsest level is solved
+void PoissonMultigrid::coarseVcycle( unsigned int l )
+{
+    if( l == coarse_levels_.size()-1 ) {
+        solveCoarsest();
+        return;
+    }
+    CoarseLevel &C = coarse_levels_[l];
+    fill( C.x.begin(), C.x.end(), 0. );
+    coarseSmooth( C, MULTIGRID_SWEEPS );
+    coarseResidual( C );
+    coarseTransferLevels( l, true );
+    coarseVcycle( l+1 );
+    coarseTransferLevels( l, false );
+    coarseSmooth( C, MULTIGRID_SWEEPS );
+}
+
+// Jacobi-preconditioned conjugate gradient on the coarsest level
+void PoissonMultigrid::solveCoarsest()
+{
+    CoarseLevel &C = coarse_levels_.back();
+    unsigned int n = C.size();
+    // Without any fixed potential, the solution is defined up to a constant: remove the average source
+    if( coarse_singular_ ) {
+        double mean = 0.;
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            mean += C.b[i];
+        }
+        mean /= ( double ) n;
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            C.b[i] -= mean;
+        }
+    }
+
+    double b_dot_b = 0., r_dot_z = 0.;
+    for( unsigned int i=0 ; i<n ; i++ ) {
+        C.x[i] = 0.;
+        C.res[i] = C.b[i];
+        coarse_z_[i] = C.res[i] / C.diag[i];
+        coarse_p_[i] = coarse_z_[i];
+        b_dot_b += C.b[i]*C.b[i];
+        r_dot_z += C.res[i]*coarse_z_[i];
+    }
+    double r_dot_r = b_dot_b;
+    // Tight tolerance so that the preconditioner remains a linear operator
+    for( unsigned int iteration=0 ; iteration<n && r_dot_r > 1.e-24*b_dot_b ; iteration++ ) {
+        applyCoarse( C, coarse_p_, coarse_Ap_ );
+        double p_dot_Ap = 0.;
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            p_dot_Ap += coarse_p_[i]*coarse_Ap_[i];
+        }
+        double alpha = r_dot_z / p_dot_Ap;
+        double rnew_dot_z = 0.;
+        r_dot_r = 0.;
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            C.x[i] += alpha * coarse_p_[i];
+            C.res[i] -= alpha * coarse_Ap_[i];
+            coarse_z_[i] = C.res[i] / C.diag[i];
+            r_dot_r    += C.res[i]*C.res[i];
+            rnew_dot_z += C.res[i]*coarse_z_[i];
+        }
+        double beta = rnew_dot_z / r_dot_z;
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            coarse_p_[i] = coarse_z_[i] + beta * coarse_p_[i];
+        }
+        r_dot_z = rnew_dot_z;
+    }
+}
+
+// Approximate solution of the coarse problem (exact if it has a single level). In the singular case, the
+// source and the solution are both made of zero average, so that the operator remains symmetric
+void PoissonMultigrid::solveCoarse()
+{
+    CoarseLevel &C = coarse_levels_[0];
+    unsigned int n = C.size();
+    if( n == 0 ) {
+        return;
+    }
+    copy( coarse_b_.begin(), coarse_b_.begin()+n, C.b.begin() );
+    if( coarse_singular_ ) {
+        double mean = 0.;
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            mean += C.b[i];
+        }
+        mean /= ( double ) n;
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            C.b[i] -= mean;
+        }
+    }
+    coarseVcycle( 0 );
+    if( coarse_singular_ ) {
+        double mean = 0.;
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            mean += C.x[i];
+        }
+        mean /= ( double ) n;
+        for( unsigned int i=0 ; i<n ; i++ ) {
+            C.x[i] -= mean;
+        }
+    }
+}
+
+// Restriction of the field in the box of a patch to the right-hand side of the coarse problem (or prolongation
+// of the coarse solution, added to the field): the two operations are transposed
+void PoissonMultigrid::coarseTransfer( unsigned int ipatch, Field *field, bool restriction )
+{
+    Level &L = ( *patch_levels_[ipatch] )[0];
+    array<unsigned int, 3> &first = first_[ipatch];
+    unsigned int ny = nDim_ > 1 ? field->dims_[1] : 1;
+    unsigned int nz = nDim_ > 2 ? field->dims_[2] : 1;
+    CoarseAxis &X = axis_[0], &Y = axis_[1], &Z = axis_[2];
+    vector<double> &coarse_x = coarse_levels_[0].x;
+    unsigned int gx0 = X.box_start[coordinates_[ipatch][0]];
+    unsigned int gy0 = Y.box_start[coordinates_[ipatch][1]];
+    unsigned int gz0 = Z.box_start[coordinates_[ipatch][2]];
+
+    for( unsigned int i=0 ; i<L.n[0] ; i++ ) {
+        unsigned int gx = gx0 + i;
+        for( unsigned int j=0 ; j<L.n[1] ; j++ ) {
+            unsigned int gy = gy0 + j;
+            double *line = &( field->data_[( ( first[0]+i )*ny + first[1]+j )*nz + first[2]] );
+            for( unsigned int k=0 ; k<L.n[2] ; k++ ) {
+                unsigned int gz = gz0 + k;
+                for( unsigned int a=0 ; a<X.count[gx] ; a++ ) {
+                    for( unsigned int b=0 ; b<Y.count[gy] ; b++ ) {
+                        unsigned int ixy = X.index[2*gx+a]*Y.n + Y.index[2*gy+b];
+                        double wxy = X.weight[2*gx+a] * Y.weight[2*gy+b];
+                        for( unsigned int c=0 ; c<Z.count[gz] ; c++ ) {
+                            unsigned int icoarse = ixy*Z.n + Z.index[2*gz+c];
+                            double w = wxy * Z.weight[2*gz+c];
+                            if( restriction ) {
+                                coarse_b_[icoarse] += w * line[k];
+                            } else {
+                                line[k] += w * coarse_x[icoarse];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+double PoissonMultigrid::ownedDot( ElectroMagn *EMfields, Field *a, Field *b )
+{
+    unsigned int imin[3] = { 0, 0, 0 }, imax[3] = { 0, 0, 0 }, n[3] = { 1, 1, 1 };
+    for( unsigned int idim=0 ; idim<nDim_ ; idim++ ) {
+        imin[idim] = EMfields->index_min_p_[idim];
+        imax[idim] = EMfields->index_max_p_[idim];
+        n[idim] = a->dims_[idim];
+    }
+    double a_dot_b = 0.;
+    for( unsigned int i=imin[0] ; i<=imax[0] ; i++ ) {
+        for( unsigned int j=imin[1] ; j<=imax[1] ; j++ ) {
+            double *aline = &( a->data_[( i*n[1] + j )*n[2]] );
+            double *bline = &( b->data_[( i*n[1] + j )*n[2]] );
+            #pragma omp simd reduction(+:a_dot_b)
+            for( unsigned int k=imin[2] ; k<=imax[2] ; k++ ) {
+                a_dot_b += aline[k]*bline[k];
+            }
+        }
+    }
+    return a_dot_b;
+}
+
+void PoissonMultigrid::precondition( VectorPatch &vecPatches, SmileiMPI *smpi, double &r_dot_r, double &r_dot_z )
+{
+    unsigned int ncoarse = coarse_levels_[0].size();
+
+    // Local V-cycles, and restriction of the residual to the right-hand side of the coarse problem
+    fill( coarse_b_.begin(), coarse_b_.end(), 0. );
+    for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+        vector<Level> &levels = *patch_levels_[ipatch];
+        Level &L = levels[0];
+        Field *r = vecPatches( ipatch )->EMfields->r_;
+        unsigned int ny = nDim_ > 1 ? r->dims_[1] : 1;
+        unsigned int nz = nDim_ > 2 ? r->dims_[2] : 1;
+        array<unsigned int, 3> &first = first_[ipatch];
+
+        for( unsigned int i=0 ; i<L.n[0] ; i++ ) {
+            for( unsigned int j=0 ; j<L.n[1] ; j++ ) {
+                double *rline = &( r->data_[( ( first[0]+i )*ny + first[1]+j )*nz + first[2]] );
+                double *fline = &( L.f[( i*L.n[1] + j )*L.n[2]] );
+                #pragma omp simd
+                for( unsigned int k=0 ; k<L.n[2] ; k++ ) {
+                    fline[k] = rline[k];
+                }
+            }
+        }
+        coarseTransfer( ipatch, r, true );
+        coarse_b_[ncoarse] += ownedDot( vecPatches( ipatch )->EMfields, r, r );
+
+        vcycle( levels, 0 );
+
+        Field *z = z_[ipatch];
+        z->put_to( 0. );
+        for( unsigned int i=0 ; i<L.n[0] ; i++ ) {
+            for( unsigned int j=0 ; j<L.n[1] ; j++ ) {
+                double *zline = &( z->data_[( ( first[0]+i )*ny + first[1]+j )*nz + first[2]] );
+                double *uline = &( L.u[( i*L.n[1] + j )*L.n[2]] );
+                #pragma omp simd
+                for( unsigned int k=0 ; k<L.n[2] ; k++ ) {
+                    zline[k] = uline[k];
+                }
+            }
+        }
+    }
+
+    // Single reduction for the coarse problem and r.r, then the coarse problem is solved by all processes
+    MPI_Allreduce( MPI_IN_PLACE, &coarse_b_[0], ncoarse+1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+    r_dot_r = coarse_b_[ncoarse];
+    solveCoarse();
+
+    // Coarse correction
+    double r_dot_z_local = 0.;
+    for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+        coarseTransfer( ipatch, z_[ipatch], false );
+        r_dot_z_local += ownedDot( vecPatches( ipatch )->EMfields, vecPatches( ipatch )->EMfields->r_, z_[ipatch] );
+    }
+    MPI_Allreduce( &r_dot_z_local, &r_dot_z, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+
+    // Values of z at the nodes owned by the neighbours. z is zero outside the box of each patch, so that a sum
+    // also provides the primal nodes shared with the next patch (which are not exchanged)
+    SyncVectorPatch::sum<double,Field>( z_, vecPatches, smpi, timers_, 0 );
+}
+
+void PoissonMultigrid::updateDirection( VectorPatch &vecPatches, double beta )
+{
+    for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+        double *p = vecPatches( ipatch )->EMfields->p_->data_;
+        double *z = z_[ipatch]->data_;
+        unsigned int npoints = z_[ipatch]->globalDims_;
+        #pragma omp simd
+        for( unsigned int i=0 ; i<npoints ; i++ ) {
+            p[i] = z[i] + beta * p[i];
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#ifndef POISSONMULTIGRID_H
+#define POISSONMULTIGRID_H
+
+#include <vector>
+#include <map>
+#include <array>
+
+#include "Timers.h"
+
+class Params;
+class SmileiMPI;
+class VectorPatch;
+class Field;
+class ElectroMagn;
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class PoissonMultigrid
+//! Preconditioner of the conjugate-gradient Poisson solvers (cartesian geometries), z = M^-1 r.
+//! M^-1 approximates the inverse of the laplacian at two levels of the patch hierarchy:
+//!  - inside each patch, a geometric multigrid V-cycle on the nodes owned by the patch (zero outside),
+//!    extended to the ghost nodes beyond the transverse boundaries which are also unknowns of compute_Ap,
+//!  - across patches, a coarse problem (Galerkin operator P^T A P) whose functions are linear between the
+//!    corners of the patches along the strongly coupled dimensions, and follow every node along the weakly
+//!    coupled ones (e.g. the x direction of the relativistic problem for large Lorentz factors),
+//!    unless the coarse problem would exceed MULTIGRID_MAX_COARSE unknowns (e.g. with anisotropic cells):
+//!    these dimensions are then coarsened as the other ones.
+//!    It is reduced once per iteration and solved identically by all processes: exactly when it has at most
+//!    MULTIGRID_MAX_COARSE unknowns, otherwise by a V-cycle on coarser levels grouping the patch corners
+//!    (Galerkin operators, conjugate gradient on the coarsest level).
+//! Both parts are symmetric, so that the conjugate gradient remains valid, and the number of iterations
+//! barely depends on the size of the whole grid.
+//! The AM solvers are not preconditioned: their operator has coefficients varying with the radius and
+//! an axis condition, which are neither in the constant-coefficient smoother nor in the coarse problem.
+//  --------------------------------------------------------------------------------------------------------------------
+class PoissonMultigrid
+{
+public:
+    //! coeffs are the coefficients of the discrete laplacian along each dimension (e.g. 1/dx^2).
+    //! Must be created after EMfields->initPoisson
+    PoissonMultigrid( Params &params, SmileiMPI *smpi, VectorPatch &vecPatches, std::vector<double> coeffs );
+    ~PoissonMultigrid();
+
+    //! Computes z = M^-1 r for all patches from the residuals r_, and synchronizes z between patches.
+    //! Also returns the global scalar products r.r and r.z
+    void precondition( VectorPatch &vecPatches, SmileiMPI *smpi, double &r_dot_r, double &r_dot_z );
+
+    //! New direction of the conjugate gradient p = z + beta p
+    void updateDirection( VectorPatch &vecPatches, double beta );
+
+private:
+
+    //! Required by the synchronization of z
+    Timers timers_;
+
+    //! One level of the multigrid hierarchy inside a patch
+    struct Level {
+        //! Number of nodes along each dimension (1 for the unused dimensions)
+        unsigned int n[3];
+        //! Coefficients of the laplacian along each dimension
+        double c[3];
+        //! Whether the next level is coarser along each dimension
+        bool coarsened[3];
+        //! Solution, right-hand side and residual
+        std::vector<double> u, f, res;
+    };
+
+    //! Builds the hierarchy of levels for a box of n nodes
+    std::vector<Level> *hierarchy( std::array<unsigned int, 3> n );
+
+    //! V-cycle starting at level l, with u=0 initially
+    void vcycle( std::vector<Level> &levels, unsigned int l );
+    //! res = f - A u
+    void residual( Level &L );
+    //! Weighted Jacobi sweeps
+    void smooth( Level &L, unsigned int nsweeps );
+    //! Restriction of the residual of level l to the right-hand side of level l+1 (or prolongation of the
+    //! solution of level l+1, added to the solution of level l): the two operations are transposed
+    void transfer( std::vector<Level> &levels, unsigned int l, bool restriction );
+
+    //! Scalar product of two fields over the nodes owned by a patch
+    double ownedDot( ElectroMagn *EMfields, Field *a, Field *b );
+
+    //! Coarse functions along one dimension
+    struct CoarseAxis {
+        //! Number of coarse unknowns; whether P is the identity (all nodes are unknowns); periodicity
+        unsigned int n;
+        bool identity, periodic;
+        //! First global node of the boxes of the patches, for each patch coordinate
+        std::vector<unsigned int> box_start;
+        //! For each global node: the number of coarse unknowns involved (up to 2), their indices and weights
+        std::vector<unsigned int> count, index;
+        std::vector<double> weight;
+    };
+
+    //! One level of the hierarchy of the coarse problem, whose operator is A0 = sum over the dimensions d of
+    //! c_d ( X_0 x X_1 x X_2 ), X_e being the matrix K along e=d and M otherwise. On the first level, M = P^T P
+    //! and K = P^T L P, L being the 1D laplacian; on the next ones, M and K are the Galerkin products R^T M R
+    //! and R^T K R of the previous level, R being the interpolation from the next level
+    struct CoarseLevel {
+        //! Number of unknowns along each dimension, periodicity, whether M is the identity
+        unsigned int n[3];
+        bool periodic[3], identity[3];
+        //! Tridiagonal matrices M and K along each dimension (lower, diagonal and upper terms)
+        std::vector<double> mass[3][3], stiffness[3][3];
+        //! Whether the next level is coarser along each dimension, and the interpolation R from it: for each
+        //! unknown, the number of unknowns of the next level involved (up to 2), their indices and weights
+        bool coarsened[3];
+        std::vector<unsigned int> count[3], index[3];
+        std::vector<double> weight[3];
+        //! Diagonal of A0, right-hand side, solution, residual and work arrays
+        std::vector<double> diag, b, x, res, tmp[2];
+        unsigned int size() { return n[0]*n[1]*n[2]; }
+    };
+    //! Adds v to the element (a,b) of a tridiagonal matrix of size n
+    static void addTo( unsigned int n, std::vector<double> *T, unsigned int a, unsigned int b, double v );
+    //! y = T x, with T a tridiagonal matrix acting along the dimension idim of the unknowns of a level
+    void applyAxis( CoarseLevel &C, unsigned int idim, std::vector<double> *T, std::vector<double> &x, std::vector<double> &y );
+
+    //! Restriction of a field to the right-hand side of the coarse problem (or prolongation of the coarse
+    //! solution, added to the field), in the box of a patch
+    void coarseTransfer( unsigned int ipatch, Field *field, bool restriction );
+
+    //! Computes the diagonal of A0 and allocates the arrays of a level
+    void coarseDiagonal( CoarseLevel &C );
+    //! Adds a coarser level to the coarse problem; false if no dimension can be coarsened
+    bool coarsen();
+    //! Solves the coarse problem A0 x = b, from coarse_b_ to the solution of the first level
+    void solveCoarse();
+    //! V-cycle starting at level l of the coarse problem, with x=0 initially
+    void coarseVcycle( unsigned int l );
+    //! Solves the coarsest level (Jacobi-preconditioned conjugate gradient)
+    void solveCoarsest();
+    //! res = b - A0 x
+    void coarseResidual( CoarseLevel &C );
+    //! Weighted Jacobi sweeps
+    void coarseSmooth( CoarseLevel &C, unsigned int nsweeps );
+    //! Restriction of the residual of level l to the right-hand side of level l+1 (or prolongation of the
+    //! solution of level l+1, added to the solution of level l)
+    void coarseTransferLevels( unsigned int l, bool restriction );
+    //! y = A0 x
+    void applyCoarse( CoarseLevel &C, std::vector<double> &x, std::vector<double> &y );
+
+    unsigned int nDim_;
+    std::vector<double> coeffs_;
+
+    //! Hierarchies of levels, for each size of the boxes of the patches
+    std::map<std::array<unsigned int, 3>, std::vector<Level> > hierarchies_;
+
+    //! For each local patch: the preconditioned residual z, the first node of the box, the patch coordinates
+    //! and the hierarchy used
+    std::vector<Field *> z_;
+    std::vector<std::array<unsigned int, 3> > first_, coordinates_;
+    std::vector<std::vector<Level> *> patch_levels_;
+
+    //! Coarse problem: functions along each dimension, levels, right-hand side (P^T r, followed by r.r so
+    //! that both are reduced together) and work arrays of the conjugate gradient on the coarsest level
+    CoarseAxis axis_[3];
+    std::vector<CoarseLevel> coarse_levels_;
+    std::vector<double> coarse_b_, coarse_z_, coarse_p_, coarse_Ap_;
+    //! Whether the coarse problem is singular (no boundary with a fixed potential)
+    bool coarse_singular_;
+};
+
+#endif
@@ -454,252 +454,262 @@ void InterpolatorAM2OrderV::fieldsWrapper( ElectroMagn *EMfields, Particles &par
     } //end loop on ivec
 }
 
-//void InterpolatorAM2OrderV::fieldsAndEnvelope( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
-//{
-//    
-//    
-//    std::vector<double> *Epart = &( smpi->dynamics_Epart[ithread] );
-//    std::vector<double> *Bpart = &( smpi->dynamics_Bpart[ithread] );
-//
-//    std::vector<double> *PHIpart        = &( smpi->dynamics_PHIpart[ithread] );
-//    std::vector<double> *GradPHIpart    = &( smpi->dynamics_GradPHIpart[ithread] );
-//
-//    std::vector<int>    *iold  = &( smpi->dynamics_iold[ithread] );
-//    std::vector<double> *delta = &( smpi->dynamics_deltaold[ithread] );
-//    
-//    // Interpolate E, B
-//    cField2D *El = ( static_cast<ElectroMagnAM *>( EMfields ) )->El_[0];
-//    cField2D *Er = ( static_cast<ElectroMagnAM *>( EMfields ) )->Er_[0];
-//    cField2D *Et = ( static_cast<ElectroMagnAM *>( EMfields ) )->Et_[0];
-//    cField2D *Bl = ( static_cast<ElectroMagnAM *>( EMfields ) )->Bl_m[0];
-//    cField2D *Br = ( static_cast<ElectroMagnAM *>( EMfields ) )->Br_m[0];
-//    cField2D *Bt = ( static_cast<ElectroMagnAM *>( EMfields ) )->Bt_m[0];
-//
-//    // Static cast of the envelope fields
-//    Field2D *Phi = static_cast<Field2D *>( EMfields->envelope->Phi_ );
-//    Field2D *GradPhil = static_cast<Field2D *>( EMfields->envelope->GradPhil_ );
-//    Field2D *GradPhir = static_cast<Field2D *>( EMfields->envelope->GradPhir_ );
-//    
-//    // auxiliary quantities    
-//    double delta2, xpn, r, rpn;
-//    int nparts = particles.size() ;
-//
-//    for( int ipart=*istart ; ipart<*iend; ipart++ ) {
-//
-//        // Normalized particle position
-//        xpn = particles.position( 0, ipart ) * D_inv_[0];
-//        r = sqrt( particles.position( 1, ipart )*particles.position( 1, ipart )+particles.position( 2, ipart )*particles.position( 2, ipart ) ) ;
-//        rpn = r * D_inv_[1];
-//    
-//        // Calculate coeffs
-//        coeffs( xpn, rpn );
-//    
-//        
-//        // only mode 0 is used
-//
-//        // Interpolation of El^(d,p)
-//        ( *Epart ) [ 0*nparts+ipart ]       = std::real( compute( &coeffld_[1], &coeffrp_[1], El, id_, jp_ ) );
-//        // Interpolation of Er^(p,d)
-//        ( *Epart ) [ 1*nparts+ipart ]       = std::real( compute( &coefflp_[1], &coeffrd_[1], Er, ip_, jd_ ) );
-//        // Interpolation of Et^(p,p)
-//        ( *Epart ) [ 2*nparts+ipart ]       = std::real( compute( &coefflp_[1], &coeffrp_[1], Et, ip_, jp_ ) );
-//        // Interpolation of Bl^(p,d)
-//        ( *Bpart ) [ 0*nparts+ipart ]       = std::real( compute( &coefflp_[1], &coeffrd_[1], Bl, ip_, jd_ ) );
-//        // Interpolation of Br^(d,p)
-//        ( *Bpart ) [ 1*nparts+ipart ]       = std::real( compute( &coeffld_[1], &coeffrp_[1], Br, id_, jp_ ) );
-//        // Interpolation of Bt^(d,d)
-//        ( *Bpart ) [ 2*nparts+ipart ]       = std::real( compute( &coeffld_[1], &coeffrd_[1], Bt, id_, jd_ ) );
-//        // Interpolation of Phi^(p,p)
-//        ( *PHIpart ) [ 0*nparts+ipart ]     = compute( &coefflp_[1], &coeffrp_[1], Phi, ip_, jp_ ) ;
-//        // Interpolation of GradPhil^(p,p)
-//        ( *GradPHIpart ) [ 0*nparts+ipart ] = compute( &coefflp_[1], &coeffrp_[1], GradPhil, ip_, jp_ ) ;
-//        // Interpolation of GradPhir^(p,p)
-//        ( *GradPHIpart ) [ 1*nparts+ipart ] = compute( &coefflp_[1], &coeffrp_[1], GradPhir, ip_, jp_ ) ;
-//        // GradPhit = 0 in cylindr_ical symmetry
-//        ( *GradPHIpart ) [ 2*nparts+ipart ] = 0.;
-//   
-//        if (r > 0){ 
-//            exp_m_theta_ = ( particles.position( 1, ipart ) - Icpx * particles.position( 2, ipart ) ) / r ;
-//        } else {
-//            exp_m_theta_ = 1. ;
-//        }
-//
-//        // project on x,y,z, remember that GradPhit = 0 in cylindr_ical symmetry
-//        delta2 = std::real( exp_m_theta_ ) * ( *Epart ) [ 1*nparts+ipart ] + std::imag( exp_m_theta_ ) * ( *Epart ) [ 2*nparts+ipart ];
-//        ( *Epart ) [ 2*nparts+ipart ] = -std::imag( exp_m_theta_ ) * ( *Epart ) [ 1*nparts+ipart ] + std::real( exp_m_theta_ ) * ( *Epart ) [ 2*nparts+ipart ];
-//        ( *Epart ) [ 1*nparts+ipart ] = delta2 ;
-//        delta2 = std::real( exp_m_theta_ ) * ( *Bpart ) [ 1*nparts+ipart ] + std::imag( exp_m_theta_ ) *  ( *Bpart ) [ 2*nparts+ipart ];
-//        ( *Bpart ) [ 2*nparts+ipart ] = -std::imag( exp_m_theta_ ) * ( *Bpart ) [ 1*nparts+ipart ] + std::real( exp_m_theta_ ) * ( *Bpart ) [ 2*nparts+ipart ];
-//        ( *Bpart ) [ 1*nparts+ipart ] = delta2 ;
-//
-//        delta2 = std::real( exp_m_theta_ ) * ( *GradPHIpart ) [ 1*nparts+ipart ] ; 
-//        ( *GradPHIpart ) [ 2*nparts+ipart ] = -std::imag( exp_m_theta_ ) * ( *GradPHIpart ) [ 1*nparts+ipart ] ;
-//        ( *GradPHIpart ) [ 1*nparts+ipart ] = delta2 ;
-//
-//        //Buffering of iold and delta
-//        ( *iold )[ipart+0*nparts]  = ip_;
-//        ( *iold )[ipart+1*nparts]  = jp_;
-//        ( *delta )[ipart+0*nparts] = deltax;
-//        ( *delta )[ipart+1*nparts] = deltar;
-//        
-//
-//    }
-//    
-//} // END InterpolatorAM2OrderV
-//
-//
-//void InterpolatorAM2OrderV::timeCenteredEnvelope( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
-//{
-//    // // Static cast of the envelope fields
-//    // Static cast of the envelope fields
-//    Field2D *Phi_m2Dcyl = static_cast<Field2D *>( EMfields->envelope->Phi_m );
-//    Field2D *GradPhil_m2Dcyl = static_cast<Field2D *>( EMfields->envelope->GradPhil_m );
-//    Field2D *GradPhir_m2Dcyl = static_cast<Field2D *>( EMfields->envelope->GradPhir_m );
-//    
-//    std::vector<double> *PHI_mpart     = &( smpi->dynamics_PHI_mpart[ithread] );
-//    std::vector<double> *GradPHI_mpart = &( smpi->dynamics_GradPHI_mpart[ithread] );
-//    
-//    std::vector<int>    *iold  = &( smpi->dynamics_iold[ithread] );
-//    std::vector<double> *delta = &( smpi->dynamics_deltaold[ithread] );
-//    
-//    double r, delta2, xpn, rpn;
-//    //Loop on bin particles
-//    int nparts =  particles.size() ;
-//    for( int ipart=*istart ; ipart<*iend; ipart++ ) {
-//    
-//        // Normalized particle position
-//        xpn = particles.position( 0, ipart ) * D_inv_[0];
-//        r = sqrt( particles.position( 1, ipart )*particles.position( 1, ipart )+particles.position( 2, ipart )*particles.position( 2, ipart ) ) ;
-//        rpn = r * D_inv_[1];
-//    
-//        // Compute coefficients
-//        coeffs( xpn, rpn );
-//
-//        // only mode 0 is used
-//    
-//        // -------------------------
-//        // Interpolation of Phi_m^(p,p)
-//        // -------------------------
-//        ( *PHI_mpart )[ipart] = compute( &coefflp_[1], &coeffrp_[1], Phi_m2Dcyl, ip_, jp_ );
-//    
-//        // -------------------------
-//        // Interpolation of GradPhi_m^(p,p), l component
-//        // -------------------------
-//        ( *GradPHI_mpart )[ipart+0*nparts] = compute( &coefflp_[1], &coeffrp_[1], GradPhil_m2Dcyl, ip_, jp_ );
-//    
-//        // -------------------------
-//        // Interpolation of GradPhi_m^(p,p), r component
-//        // -------------------------
-//        ( *GradPHI_mpart )[ipart+1*nparts] = compute( &coefflp_[1], &coeffrp_[1], GradPhir_m2Dcyl, ip_, jp_ );
-//    
-//        // -------------------------
-//        // Interpolation of GradPhi_m^(p,p), theta component
-//        // -------------------------
-//        ( *GradPHI_mpart )[ipart+2*nparts] = 0.; // zero with cylindr_ical symmetry
-//
-//
-//        if (r > 0){ 
-//            exp_m_theta_ = ( particles.position( 1, ipart ) - Icpx * particles.position( 2, ipart ) ) / r ;
-//        } else {
-//            exp_m_theta_ = 1. ;
-//        }
-//
-//
-//        // project on x,y,z, remember that GradPhit = 0 in cylindr_ical symmetry
-//        delta2 = std::real( exp_m_theta_ ) * ( *GradPHI_mpart ) [ 1*nparts+ipart ] ; 
-//        ( *GradPHI_mpart ) [ 2*nparts+ipart ] = -std::imag( exp_m_theta_ ) * ( *GradPHI_mpart ) [ 1*nparts+ipart ] ;
-//        ( *GradPHI_mpart ) [ 1*nparts+ipart ] = delta2 ;
-//
-//        //Buffering of iold and delta
-//        ( *iold )[ipart+0*nparts]  = ip_;
-//        ( *iold )[ipart+1*nparts]  = jp_;
-//      
-//        ( *delta )[ipart+0*nparts] = deltax;
-//        ( *delta )[ipart+1*nparts] = deltar;
-//      
-//    
-//    }
-//    
-//} // END InterpolatorAM2OrderV
-//
-//
-//void InterpolatorAM2OrderV::envelopeAndSusceptibility( ElectroMagn *EMfields, Particles &particles, int ipart, double *Env_A_abs_Loc, double *Env_Chi_Loc, double *Env_E_abs_Loc, double *Env_Ex_abs_Loc )
-//{
-//    // Static cast of the electromagnetic fields
-//    Field2D *Env_A_abs_2Dcyl  = static_cast<Field2D *>( EMfields->Env_A_abs_ );
-//    Field2D *Env_Chi_2Dcyl    = static_cast<Field2D *>( EMfields->Env_Chi_ );
-//    Field2D *Env_E_abs_2Dcyl  = static_cast<Field2D *>( EMfields->Env_E_abs_ );
-//    Field2D *Env_Ex_abs_2Dcyl = static_cast<Field2D *>( EMfields->Env_Ex_abs_ );
-//
-//    // Normalized particle position
-//    double xpn = particles.position( 0, ipart ) * D_inv_[0];
-//    double r = sqrt( particles.position( 1, ipart )*particles.position( 1, ipart )+particles.position( 2, ipart )*particles.position( 2, ipart ) ) ;
-//    double rpn = r * D_inv_[1];
-//
-//    // Compute coefficients
-//    coeffs( xpn, rpn );
-//    
-//    // -------------------------
-//    // Interpolation of Env_A_abs_^(p,p)
-//    // -------------------------
-//    *( Env_A_abs_Loc ) = compute( &coefflp_[1], &coeffrp_[1], Env_A_abs_2Dcyl, ip_, jp_);
-//  
-//    // -------------------------  
-//    // Interpolation of Env_Chi_^(p,p)
-//    // -------------------------
-//    *( Env_Chi_Loc ) = compute( &coefflp_[1], &coeffrp_[1], Env_Chi_2Dcyl, ip_, jp_);
-//   
-//    // -------------------------
-//    // Interpolation of Env_E_abs_^(p,p)
-//    // -------------------------
-//    *( Env_E_abs_Loc ) = compute( &coefflp_[1], &coeffrp_[1], Env_E_abs_2Dcyl, ip_, jp_);
-//
-//    // -------------------------
-//    // Interpolation of Env_Ex_abs_^(p,p)
-//    // -------------------------
-//    *( Env_Ex_abs_Loc ) = compute( &coefflp_[1], &coeffrp_[1], Env_Ex_abs_2Dcyl, ip_, jp_);
-//  
-//} // END InterpolatorAM2OrderV
-//
-//void InterpolatorAM2OrderV::envelopeFieldForIonization( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
-//{
-//    // Static cast of the envelope fields
-//    Field2D *EnvEabs  = static_cast<Field2D*>( EMfields->Env_E_abs_ );
-//    Field2D *EnvExabs = static_cast<Field2D*>( EMfields->Env_Ex_abs_ );
-//    
-//    std::vector<double> *EnvEabs_part  = &( smpi->dynamics_EnvEabs_part[ithread] );
-//    std::vector<double> *EnvExabs_part = &( smpi->dynamics_EnvExabs_part[ithread] );
-// 
-//    double xpn,rpn,r;
-//   
-//    //Loop on bin particles
-//    for( int ipart=*istart ; ipart<*iend; ipart++ ) {
-//
-//        // Normalized particle position
-//        xpn = particles.position( 0, ipart ) * D_inv_[0];
-//        r = sqrt( particles.position( 1, ipart )*particles.position( 1, ipart )+particles.position( 2, ipart )*particles.position( 2, ipart ) ) ;
-//        rpn = r * D_inv_[1];
-//                                     
-//        // Compute coefficients
-//        coeffs( xpn, rpn );
-// 
-//        // only mode 0 is used
-//    
-//        // ---------------------------------
-//        // Interpolation of Env_E_abs^(p,p)
-//        // ---------------------------------
-//        ( *EnvEabs_part )[ipart] = compute( &coefflp_[1], &coeffrp_[1], EnvEabs, ip_, jp_ );
-//  
-//        // ---------------------------------
-//        // Interpolation of Env_Ex_abs^(p,p)
-//        // ---------------------------------
-//        ( *EnvExabs_part )[ipart] = compute( &coefflp_[1], &coeffrp_[1], EnvExabs, ip_, jp_ );
-//    
-//    }
-//    
-//    
-//} // END InterpolatorAM2OrderV
+// ---------------------------------------------------------------------------------------------------------------------
+// Interpolation of the fields and of the envelope quantities for the particles of one cell (vectorized),
+// used by the ponderomotive momentum advance. Only the mode 0 of the fields interacts with the envelope.
+// ---------------------------------------------------------------------------------------------------------------------
+void InterpolatorAM2OrderV::fieldsAndEnvelope( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
+{
+    if( istart[0] == iend[0] ) {
+        return;    //Don't treat empty cells.
+    }
+
+    int nparts( ( smpi->dynamics_invgf[ithread] ).size() );
+
+    double * __restrict__ position_x = particles.getPtrPosition(0);
+    double * __restrict__ position_y = particles.getPtrPosition(1);
+    double * __restrict__ position_z = particles.getPtrPosition(2);
+
+    ElectroMagnAM *emAM = static_cast<ElectroMagnAM *>( EMfields );
+    cField2D *El = emAM->El_[0];
+    cField2D *Er = emAM->Er_[0];
+    cField2D *Et = emAM->Et_[0];
+    cField2D *Bl = emAM->Bl_m[0];
+    cField2D *Br = emAM->Br_m[0];
+    cField2D *Bt = emAM->Bt_m[0];
+    Field2D *Phi      = static_cast<Field2D *>( EMfields->envelope->Phi_ );
+    Field2D *GradPhil = static_cast<Field2D *>( EMfields->envelope->GradPhil_ );
+    Field2D *GradPhir = static_cast<Field2D *>( EMfields->envelope->GradPhir_ );
+
+    double *Epart[3], *Bpart[3], *GradPhipart[3];
+    for( unsigned int k=0; k<3; k++ ) {
+        Epart[k]       = &( smpi->dynamics_Epart[ithread][k*nparts-ipart_ref] );
+        Bpart[k]       = &( smpi->dynamics_Bpart[ithread][k*nparts-ipart_ref] );
+        GradPhipart[k] = &( smpi->dynamics_GradPHIpart[ithread][k*nparts-ipart_ref] );
+    }
+    double *Phipart = &( smpi->dynamics_PHIpart[ithread][-ipart_ref] );
+    double *deltaO[2];
+    deltaO[0] = &( smpi->dynamics_deltaold[ithread][       -ipart_ref] );
+    deltaO[1] = &( smpi->dynamics_deltaold[ithread][nparts -ipart_ref] );
+    std::complex<double> *eitheta_old = &( smpi->dynamics_eithetaold[ithread][-ipart_ref] );
+
+    int idx[2];
+    //Primal indices are constant over the all cell
+    cellIndices( particles, istart, idx );
+
+    double coeff[2][2][3][32];
+    int dual[2][32];
+    double cos_theta[32], sin_theta[32];
 
+    for( int ivect=0 ; ivect < iend[0]-istart[0]; ivect += 32 ) {
 
+        int np_computed = min( iend[0]-istart[0]-ivect, 32 );
+        int ipart0 = istart[0] + ivect;
 
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+            blockCoefficients( position_x[ipart0+ipart], position_y[ipart0+ipart], position_z[ipart0+ipart], idx, ipart,
+                               coeff, dual, cos_theta, sin_theta,
+                               deltaO[0][ipart0+ipart], deltaO[1][ipart0+ipart], eitheta_old[ipart0+ipart] );
+        }
+
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+
+            const double *coefflp = &( coeff[0][0][1][ipart] );
+            const double *coeffld = &( coeff[0][1][1][ipart] );
+            const double *coeffrp = &( coeff[1][0][1][ipart] );
+            const double *coeffrd = &( coeff[1][1][1][ipart] );
+            int il = idx[0] + dual[0][ipart];
+            int ir = idx[1] + dual[1][ipart];
+            int i = ipart0+ipart;
+
+            double Elp  = compute( coeffld, coeffrp, El, il    , idx[1] );
+            double Erp  = compute( coefflp, coeffrd, Er, idx[0], ir     );
+            double Etp  = compute( coefflp, coeffrp, Et, idx[0], idx[1] );
+            double Blp  = compute( coefflp, coeffrd, Bl, idx[0], ir     );
+            double Brp  = compute( coeffld, coeffrp, Br, il    , idx[1] );
+            double Btp  = compute( coeffld, coeffrd, Bt, il    , ir     );
+            double GPlp = compute( coefflp, coeffrp, GradPhil, idx[0], idx[1] );
+            double GPrp = compute( coefflp, coeffrp, GradPhir, idx[0], idx[1] );
+            Phipart[i]  = compute( coefflp, coeffrp, Phi, idx[0], idx[1] );
+
+            // project on x,y,z, remember that GradPhit = 0 in cylindrical symmetry
+            Epart[0][i] = Elp;
+            Epart[1][i] = cos_theta[ipart] * Erp - sin_theta[ipart] * Etp;
+            Epart[2][i] = sin_theta[ipart] * Erp + cos_theta[ipart] * Etp;
+            Bpart[0][i] = Blp;
+            Bpart[1][i] = cos_theta[ipart] * Brp - sin_theta[ipart] * Btp;
+            Bpart[2][i] = sin_theta[ipart] * Brp + cos_theta[ipart] * Btp;
+            GradPhipart[0][i] = GPlp;
+            GradPhipart[1][i] = cos_theta[ipart] * GPrp;
+            GradPhipart[2][i] = sin_theta[ipart] * GPrp;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Interpolation of the time-centered envelope quantities for the particles of one cell (vectorized),
+// used by the ponderomotive position advance
+// ---------------------------------------------------------------------------------------------------------------------
+void InterpolatorAM2OrderV::timeCenteredEnvelope( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
+{
+    if( istart[0] == iend[0] ) {
+        return;    //Don't treat empty cells.
+    }
+
+    int nparts( ( smpi->dynamics_invgf[ithread] ).size() );
+
+    double * __restrict__ position_x = particles.getPtrPosition(0);
+    double * __restrict__ position_y = particles.getPtrPosition(1);
+    double * __restrict__ position_z = particles.getPtrPosition(2);
+
+    Field2D *Phi_m      = static_cast<Field2D *>( EMfields->envelope->Phi_m );
+    Field2D *GradPhil_m = static_cast<Field2D *>( EMfields->envelope->GradPhil_m );
+    Field2D *GradPhir_m = static_cast<Field2D *>( EMfields->envelope->GradPhir_m );
+
+    double *GradPhi_mpart[3];
+    for( unsigned int k=0; k<3; k++ ) {
+        GradPhi_mpart[k] = &( smpi->dynamics_GradPHI_mpart[ithread][k*nparts-ipart_ref] );
+    }
+    double *Phi_mpart = &( smpi->dynamics_PHI_mpart[ithread][-ipart_ref] );
+    double *deltaO[2];
+    deltaO[0] = &( smpi->dynamics_deltaold[ithread][       -ipart_ref] );
+    deltaO[1] = &( smpi->dynamics_deltaold[ithread][nparts -ipart_ref] );
+    std::complex<double> *eitheta_old = &( smpi->dynamics_eithetaold[ithread][-ipart_ref] );
+
+    int idx[2];
+    //Primal indices are constant over the all cell
+    cellIndices( particles, istart, idx );
+
+    double coeff[2][2][3][32];
+    int dual[2][32];
+    double cos_theta[32], sin_theta[32];
+
+    for( int ivect=0 ; ivect < iend[0]-istart[0]; ivect += 32 ) {
+
+        int np_computed = min( iend[0]-istart[0]-ivect, 32 );
+        int ipart0 = istart[0] + ivect;
+
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+            blockCoefficients( position_x[ipart0+ipart], position_y[ipart0+ipart], position_z[ipart0+ipart], idx, ipart,
+                               coeff, dual, cos_theta, sin_theta,
+                               deltaO[0][ipart0+ipart], deltaO[1][ipart0+ipart], eitheta_old[ipart0+ipart] );
+        }
 
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+
+            const double *coefflp = &( coeff[0][0][1][ipart] );
+            const double *coeffrp = &( coeff[1][0][1][ipart] );
+            int i = ipart0+ipart;
+
+            Phi_mpart[i] = compute( coefflp, coeffrp, Phi_m, idx[0], idx[1] );
+            double GPlp  = compute( coefflp, coeffrp, GradPhil_m, idx[0], idx[1] );
+            double GPrp  = compute( coefflp, coeffrp, GradPhir_m, idx[0], idx[1] );
+
+            // project on x,y,z, remember that GradPhit = 0 in cylindrical symmetry
+            GradPhi_mpart[0][i] = GPlp;
+            GradPhi_mpart[1][i] = cos_theta[ipart] * GPrp;
+            GradPhi_mpart[2][i] = sin_theta[ipart] * GPrp;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Interpolation of the envelope fields used by the envelope tunnel ionization, for the particles of one cell (vectorized)
+// ---------------------------------------------------------------------------------------------------------------------
+void InterpolatorAM2OrderV::envelopeFieldForIonization( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
+{
+    if( istart[0] == iend[0] ) {
+        return;    //Don't treat empty cells.
+    }
+
+    double * __restrict__ position_x = particles.getPtrPosition(0);
+    double * __restrict__ position_y = particles.getPtrPosition(1);
+    double * __restrict__ position_z = particles.getPtrPosition(2);
+
+    Field2D *EnvEabs  = static_cast<Field2D *>( EMfields->Env_E_abs_ );
+    Field2D *EnvExabs = static_cast<Field2D *>( EMfields->Env_Ex_abs_ );
+
+    double *EnvEabs_part  = &( smpi->dynamics_EnvEabs_part[ithread][-ipart_ref] );
+    double *EnvExabs_part = &( smpi->dynamics_EnvExabs_part[ithread][-ipart_ref] );
+
+    int idx[2];
+    //Primal indices are constant over the all cell
+    cellIndices( particles, istart, idx );
+
+    double coeff[2][3][32];
+
+    for( int ivect=0 ; ivect < iend[0]-istart[0]; ivect += 32 ) {
+
+        int np_computed = min( iend[0]-istart[0]-ivect, 32 );
+        int ipart0 = istart[0] + ivect;
+
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+            double y = position_y[ipart0+ipart];
+            double z = position_z[ipart0+ipart];
+            double delta = position_x[ipart0+ipart] * D_inv_[0] - ( double )( idx[0] + i_domain_begin_ );
+            double delta2 = delta*delta;
+            coeff[0][0][ipart] = 0.5 * ( delta2-delta+0.25 );
+            coeff[0][1][ipart] = 0.75 - delta2;
+            coeff[0][2][ipart] = 0.5 * ( delta2+delta+0.25 );
+            delta = sqrt( y*y + z*z ) * D_inv_[1] - ( double )( idx[1] + j_domain_begin_ );
+            delta2 = delta*delta;
+            coeff[1][0][ipart] = 0.5 * ( delta2-delta+0.25 );
+            coeff[1][1][ipart] = 0.75 - delta2;
+            coeff[1][2][ipart] = 0.5 * ( delta2+delta+0.25 );
+        }
+
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+            EnvEabs_part [ipart0+ipart] = compute( &coeff[0][1][ipart], &coeff[1][1][ipart], EnvEabs , idx[0], idx[1] );
+            EnvExabs_part[ipart0+ipart] = compute( &coeff[0][1][ipart], &coeff[1][1][ipart], EnvExabs, idx[0], idx[1] );
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Interpolation of the envelope and susceptibility for one particle (probes)
+// ---------------------------------------------------------------------------------------------------------------------
+void InterpolatorAM2OrderV::envelopeAndSusceptibility( ElectroMagn *EMfields, Particles &particles, int ipart, double *Env_A_abs_Loc, double *Env_Chi_Loc, double *Env_E_abs_Loc, double *Env_Ex_abs_Loc )
+{
+    double xpn = particles.position( 0, ipart ) * D_inv_[0];
+    double r = sqrt( particles.position( 1, ipart )*particles.position( 1, ipart )+particles.position( 2, ipart )*particles.position( 2, ipart ) ) ;
+    double rpn = r * D_inv_[1];
+    int ip = round( xpn );
+    int jp = round( rpn );
+
+    double coeffl[3], coeffr[3];
+    double delta = xpn - ( double )ip;
+    double delta2 = delta*delta;
+    coeffl[0] = 0.5 * ( delta2-delta+0.25 );
+    coeffl[1] = 0.75 - delta2;
+    coeffl[2] = 0.5 * ( delta2+delta+0.25 );
+    delta = rpn - ( double )jp;
+    delta2 = delta*delta;
+    coeffr[0] = 0.5 * ( delta2-delta+0.25 );
+    coeffr[1] = 0.75 - delta2;
+    coeffr[2] = 0.5 * ( delta2+delta+0.25 );
+    ip -= i_domain_begin_;
+    jp -= j_domain_begin_;
+
+    Field2D *fields[4] = {
+        static_cast<Field2D *>( EMfields->Env_A_abs_ ),
+        static_cast<Field2D *>( EMfields->Env_Chi_ ),
+        static_cast<Field2D *>( EMfields->Env_E_abs_ ),
+        static_cast<Field2D *>( EMfields->Env_Ex_abs_ )
+    };
+    double *results[4] = { Env_A_abs_Loc, Env_Chi_Loc, Env_E_abs_Loc, Env_Ex_abs_Loc };
+    for( unsigned int ifield=0; ifield<4; ifield++ ) {
+        double interp_res = 0.;
+        for( int iloc=-1 ; iloc<2 ; iloc++ ) {
+            for( int jloc=-1 ; jloc<2 ; jloc++ ) {
+                interp_res += coeffl[iloc+1] * coeffr[jloc+1] * ( *fields[ifield] )( ip+iloc, jp+jloc );
+            }
+        }
+        *results[ifield] = interp_res;
+    }
+}
@@ -6,6 +6,7 @@
 #include "cField2D.h"
 #include "Field2D.h"
 #include "Pragma.h"
+#include "Particles.h"
 
 
 //  --------------------------------------------------------------------------------------------------------------------
@@ -23,14 +24,69 @@ public:
     void fieldsSelection( ElectroMagn *EMfields, Particles &particles, double *buffer, int offset, std::vector<unsigned int> *selection ) override final {};
     void oneField( Field **field, Particles &particles, int *istart, int *iend, double *FieldLoc, double *l1=NULL, double *l2=NULL, double *l3=NULL ) override final {};
     
-    void fieldsAndEnvelope( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref = 0 ) override final {};
-    void timeCenteredEnvelope( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref = 0 ) override final {};
-    void envelopeAndSusceptibility( ElectroMagn *EMfields, Particles &particles, int ipart, double *Env_A_abs_Loc, double *Env_Chi_Loc, double *Env_E_abs_Loc, double *Env_Ex_abs_Loc ) override final {};
-    void envelopeFieldForIonization( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref = 0 ) override final {};    
+    void fieldsAndEnvelope( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref = 0 ) override final;
+    void timeCenteredEnvelope( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref = 0 ) override final;
+    void envelopeAndSusceptibility( ElectroMagn *EMfields, Particles &particles, int ipart, double *Env_A_abs_Loc, double *Env_Chi_Loc, double *Env_E_abs_Loc, double *Env_Ex_abs_Loc ) override final;
+    void envelopeFieldForIonization( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref = 0 ) override final;
 
 
 private:
     
+    //! Local primal indices (l, r) of the sorting cell whose bounds in particles.first_index are pointed by istart.
+    //! The indices must be those of the sorting cell, as for the projector: rounding the position of a particle
+    //! located exactly between two nodes may give the neighbouring node.
+    inline void cellIndices( Particles &particles, int *istart, int *idx )
+    {
+        int scell = istart - &( particles.first_index[0] );
+        idx[0] = scell/nscellr_ + oversize_[0];
+        idx[1] = scell%nscellr_ + oversize_[1];
+    }
+    
+    //! Interpolation coefficients (primal and dual, l and r) of the particle ipart of a block of 32 particles
+    //! located in the cell of local primal indices idx. Also returns the distances to the primal nodes,
+    //! cos(theta), sin(theta) and exp(i theta) of the particle.
+    inline void __attribute__((always_inline)) blockCoefficients( double x, double y, double z, const int *idx, int ipart,
+            double coeff[2][2][3][32], int dual[2][32], double *cos_theta, double *sin_theta,
+            double &deltal, double &deltar, std::complex<double> &eitheta )
+    {
+        double r = sqrt( y*y + z*z );
+        cos_theta[ipart] = r > 0. ? y / r : 1.;
+        sin_theta[ipart] = r > 0. ? z / r : 0.;
+        eitheta = std::complex<double>( cos_theta[ipart], sin_theta[ipart] );
+        
+        double delta[2];
+        delta[0] = x * D_inv_[0] - ( double )( idx[0] + i_domain_begin_ );
+        delta[1] = r * D_inv_[1] - ( double )( idx[1] + j_domain_begin_ );
+        deltal = delta[0];
+        deltar = delta[1];
+        for( int i=0; i<2; i++ ) {
+            dual[i][ipart] = ( delta[i] >= 0. );
+            for( int j=0; j<2; j++ ) {
+                // j=0: primal, j=1: dual (distance to the dual node)
+                double d  = delta[i] + ( double )j * ( 0.5 - dual[i][ipart] );
+                double d2 = d*d;
+                coeff[i][j][0][ipart] = 0.5 * ( d2-d+0.25 );
+                coeff[i][j][1][ipart] = 0.75 - d2;
+                coeff[i][j][2][ipart] = 0.5 * ( d2+d+0.25 );
+            }
+        }
+    }
+    
+    //! Interpolation of the real part of a field (or mode 0 of a complex field), with coefficients strided by 32
+    template<typename FieldType>
+    inline double __attribute__((always_inline)) compute( const double *coeffl, const double *coeffr, FieldType *f, int il, int ir )
+    {
+        double interp_res = 0.;
+        UNROLL_S(3)
+        for( int iloc=-1 ; iloc<2 ; iloc++ ) {
+            UNROLL_S(3)
+            for( int jloc=-1 ; jloc<2 ; jloc++ ) {
+                interp_res += coeffl[iloc*32] * coeffr[jloc*32] * std::real( ( *f )( il+iloc, ir+jloc ) );
+            }
+        }
+        return interp_res;
+    }
+    
     //! Number of modes;
     unsigned int nmodes_;
     
@@ -62,33 +62,86 @@ void IonizationTunnel::operator()( Particles *particles, unsigned int ipart_min,
     double *Ey = &( ( *Epart )[1*nparts] );
     double *Ez = &( ( *Epart )[2*nparts] );
     
-    for( unsigned int ipart=ipart_min ; ipart<ipart_max; ipart++ ) {
+    if( ipart_max <= ipart_min ) {
+        return;
+    }
+    const unsigned int npart = ipart_max - ipart_min;
     
-        // Current charge state of the ion
-        Z = ( unsigned int )( particles->charge( ipart ) );
-        
-        // If ion already fully ionized then skip
-        if( Z==atomic_number_ ) {
-            continue;
-        }
+    // -----------------------------------------------------------------
+    // First pass (vectorized): rate of the first ionization of each ion,
+    // and selection of the ions that are ionized at least once
+    // -----------------------------------------------------------------
+    
+    random_numbers_.resize( npart );
+    rate_.resize( npart );
+    double *ran  = &random_numbers_[0];
+    double *rate = &rate_[0];
+    patch->rand_->uniform( npart, ran );
+    
+    short *charge = particles->getPtrCharge();
+    const double *alpha = &alpha_tunnel[0];
+    const double *beta  = &beta_tunnel[0];
+    const double *gamma = &gamma_tunnel[0];
+    const int last_Z = ( int ) atomic_number_ - 1;
+    
+    #pragma omp simd
+    for( unsigned int i=0 ; i<npart; i++ ) {
+        const unsigned int ipart = ipart_min + i;
+        const int Zi = charge[ipart];
+        // Fully ionized ions read the coefficients of the last state, and are discarded below
+        const int Zc = min( Zi, last_Z );
         
         // Absolute value of the electric field normalized in atomic units
-        E = EC_to_au * sqrt( pow( *( Ex+ipart-ipart_ref ), 2 )
-                             +pow( *( Ey+ipart-ipart_ref ), 2 )
-                             +pow( *( Ez+ipart-ipart_ref ), 2 ) );
-        if( E<1e-10 ) {
-            continue;
+        const double ex = Ex[ipart-ipart_ref];
+        const double ey = Ey[ipart-ipart_ref];
+        const double ez = Ez[ipart-ipart_ref];
+        const double Ei = EC_to_au * sqrt( ex*ex + ey*ey + ez*ez );
+        
+        const double deltai = gamma[Zc] / Ei;
+        const double ratei  = beta[Zc] * exp( -deltai*one_third + alpha[Zc]*log( deltai ) );
+        
+        // Probability of no ionization during the timestep
+        const double P0 = exp( -ratei*dt );
+        // The last electron is treated separately (see below)
+        const bool ionized = ( Zi < ( int ) atomic_number_ ) && ( Ei >= 1e-10 )
+                             && ( Zi == last_Z ? ran[i] < 1.0 - P0 : P0 < ran[i] );
+        
+        // A negative rate flags the ions that are not ionized
+        rate[i] = ionized ? ratei : -1.0;
+    }
+    
+    // Compact list of the ionized particles
+    ionized_.resize( 0 );
+    for( unsigned int i=0 ; i<npart; i++ ) {
+        if( rate[i] >= 0. ) {
+            ionized_.push_back( i );
         }
+    }
+    const unsigned int nionized = ionized_.size();
+    if( nionized == 0 ) {
+        return;
+    }
+    k_times_.resize( nionized );
+    
+    // -----------------------------------------------------------------
+    // Second pass: Monte-Carlo routine for the ionized particles only
+    // -----------------------------------------------------------------
+    
+    for( unsigned int iion=0 ; iion<nionized; iion++ ) {
+    
+        const unsigned int i = ionized_[iion];
+        const unsigned int ipart = ipart_min + i;
         
-        // --------------------------------
-        // Start of the Monte-Carlo routine
-        // --------------------------------
+        // Current charge state of the ion
+        Z = ( unsigned int )( charge[ipart] );
         
+        E = EC_to_au * sqrt( Ex[ipart-ipart_ref]*Ex[ipart-ipart_ref]
+                             +Ey[ipart-ipart_ref]*Ey[ipart-ipart_ref]
+                             +Ez[ipart-ipart_ref]*Ez[ipart-ipart_ref] );
         invE = 1./E;
         factorJion = factorJion_0 * invE*invE;
-        delta      = gamma_tunnel[Z]*invE;
-        ran_p = patch->rand_->uniform();
-        IonizRate_tunnel[Z] = beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) );
+        ran_p = ran[i];
+        IonizRate_tunnel[Z] = rate[i];
         
         // Total ionization potential (used to compute the ionization current)
         TotalIonizPot = 0.0;
@@ -98,12 +151,10 @@ void IonizationTunnel::operator()( Particles *particles, unsigned int ipart_min,
         Zp1=Z+1;
         
         if( Zp1 == atomic_number_ ) {
-            // if ionization of the last electron: single ionization
-            // -----------------------------------------------------
-            if( ran_p < 1.0 -exp( -IonizRate_tunnel[Z]*dt ) ) {
-                TotalIonizPot += Potential[Z];
-                k_times        = 1;
-            }
+            // if ionization of the last electron: single ionization (already selected in the first pass)
+            // ------------------------------------------------------------------------------------------
+            TotalIonizPot += Potential[Z];
+            k_times        = 1;
             
         } else {
             // else : multiple ionization can occur in one time-step
@@ -154,26 +205,45 @@ void IonizationTunnel::operator()( Particles *particles, unsigned int ipart_min,
             Proj->ionizationCurrents( patch->EMfields->Jx_, patch->EMfields->Jy_, patch->EMfields->Jz_, *particles, ipart, Jion );
         }
         
-        // Creation of the new electrons
-        // (variable weights are used)
-        // -----------------------------
-        if( k_times !=0 ) {
-            new_electrons.createParticle();
-            //new_electrons.initialize( new_electrons.size()+1, new_electrons.dimension() );
-            int idNew = new_electrons.size() - 1;
-            for( unsigned int i=0; i<new_electrons.dimension(); i++ ) {
-                new_electrons.position( i, idNew )=particles->position( i, ipart );
-            }
-            for( unsigned int i=0; i<3; i++ ) {
-                new_electrons.momentum( i, idNew ) = particles->momentum( i, ipart )*ionized_species_invmass;
-            }
-            new_electrons.weight( idNew )=double( k_times )*particles->weight( ipart );
-            new_electrons.charge( idNew )=-1;
-            
-            // Increase the charge of the particle
-            particles->charge( ipart ) += k_times;
-        }
-        
+        k_times_[iion] = k_times;
         
-    } // Loop on particles
+    } // Loop on ionized particles
+    
+    // -----------------------------------------------------------------
+    // Creation of all the new electrons at once
+    // (variable weights are used)
+    // -----------------------------------------------------------------
+    
+    const unsigned int inew0 = new_electrons.size();
+    new_electrons.createParticles( nionized );
+    
+    const unsigned int *ionized = &ionized_[0];
+    const unsigned int *k = &k_times_[0];
+    for( unsigned int idim=0; idim<new_electrons.dimension(); idim++ ) {
+        const double *position = particles->getPtrPosition( idim );
+        double *new_position = new_electrons.getPtrPosition( idim );
+        #pragma omp simd
+        for( unsigned int iion=0 ; iion<nionized; iion++ ) {
+            new_position[inew0+iion] = position[ipart_min+ionized[iion]];
+        }
+    }
+    for( unsigned int idim=0; idim<3; idim++ ) {
+        const double *momentum = particles->getPtrMomentum( idim );
+        double *new_momentum = new_electrons.getPtrMomentum( idim );
+        #pragma omp simd
+        for( unsigned int iion=0 ; iion<nionized; iion++ ) {
+            new_momentum[inew0+iion] = momentum[ipart_min+ionized[iion]]*ionized_species_invmass;
+        }
+    }
+    const double *weight = particles->getPtrWeight();
+    double *new_weight = new_electrons.getPtrWeight();
+    short *new_charge = new_electrons.getPtrCharge();
+    #pragma omp simd
+    for( unsigned int iion=0 ; iion<nionized; iion++ ) {
+        const unsigned int ipart = ipart_min+ionized[iion];
+        new_weight[inew0+iion] = double( k[iion] )*weight[ipart];
+        new_charge[inew0+iion] = -1;
+        // Increase the charge of the particle
+        charge[ipart] += k[iion];
+    }
 }
@@ -28,6 +28,11 @@ private:
     
     double one_third;
     std::vector<double> alpha_tunnel, beta_tunnel, gamma_tunnel;
+    
+    //! Buffers for the current block of particles: random numbers and rates of the first ionization
+    std::vector<double> random_numbers_, rate_;
+    //! Indices (in the block) of the particles ionized during the timestep, and their number of ionizations
+    std::vector<unsigned int> ionized_, k_times_;
 };
 
 
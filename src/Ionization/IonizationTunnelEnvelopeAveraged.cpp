@@ -62,9 +62,8 @@ void IonizationTunnelEnvelopeAveraged::operator()( Particles *particles, unsigne
 void IonizationTunnelEnvelopeAveraged::envelopeIonization( Particles *particles, unsigned int ipart_min, unsigned int ipart_max, std::vector<double> *Epart, std::vector<double> *EnvEabs_part, std::vector<double> *EnvExabs_part, std::vector<double> *Phipart, Patch *patch, Projector *Proj, int ipart_ref )
 {
     unsigned int Z, Zp1, newZ, k_times;
-    double E, E_sq, EnvE_sq, Aabs, invE, delta, ran_p, Mult, D_sum, P_sum, Pint_tunnel;
+    double E, invE, delta, ran_p, Mult, D_sum, P_sum, Pint_tunnel;
     double coeff_ellipticity_in_ionization_rate = 1.;
-    double p_perp; 
     vector<double> IonizRate_tunnel_envelope( atomic_number_ ), Dnom_tunnel( atomic_number_ );
     
     
@@ -76,63 +75,112 @@ void IonizationTunnelEnvelopeAveraged::envelopeIonization( Particles *particles,
     double *Ex_env  = &( ( *EnvExabs_part )[0*nparts] );
     double *Phi_env = &( ( *Phipart )[0*nparts] );
     
-    for( unsigned int ipart=ipart_min ; ipart<ipart_max; ipart++ ) {
+    if( ipart_max <= ipart_min ) {
+        return;
+    }
+    const unsigned int npart = ipart_max - ipart_min;
     
-        // Current charge state of the ion
-        Z = ( unsigned int )( particles->charge( ipart ) );
+    // -----------------------------------------------------------------
+    // First pass (vectorized): averaged rate of the first ionization of
+    // each ion, and selection of the ions that are ionized at least once
+    // -----------------------------------------------------------------
     
-        // If ion already fully ionized then skip
-        if( Z==atomic_number_ ) {
-            continue;
-        }
+    random_numbers_.resize( npart );
+    rate_.resize( npart );
+    field_.resize( npart );
+    double *ran  = &random_numbers_[0];
+    double *rate = &rate_[0];
+    double *field = &field_[0];
+    patch->rand_->uniform( npart, ran );
     
+    short *charge = particles->getPtrCharge();
+    const double *alpha = &alpha_tunnel[0];
+    const double *beta  = &beta_tunnel[0];
+    const double *gamma = &gamma_tunnel[0];
+    const int last_Z = ( int ) atomic_number_ - 1;
+    const double EC_to_au_sq = EC_to_au*EC_to_au;
+    const bool linear_polarization = ( ellipticity==0. );
     
+    #pragma omp simd
+    for( unsigned int i=0 ; i<npart; i++ ) {
+        const unsigned int ipart = ipart_min + i;
+        const int Zi = charge[ipart];
+        // Fully ionized ions read the coefficients of the last state, and are discarded below
+        const int Zc = min( Zi, last_Z );
+        
         // Absolute value of the electric field |E_plasma| (from the plasma) normalized in atomic units
-        E_sq    = pow(EC_to_au,2) * (pow( *( Ex+ipart-ipart_ref ), 2 )
-                                    +pow( *( Ey+ipart-ipart_ref ), 2 )
-                                    +pow( *( Ez+ipart-ipart_ref ), 2 ) );
+        const double ex = Ex[ipart-ipart_ref];
+        const double ey = Ey[ipart-ipart_ref];
+        const double ez = Ez[ipart-ipart_ref];
+        const double E_sq = EC_to_au_sq * ( ex*ex + ey*ey + ez*ez );
         // Laser envelope electric field normalized in atomic units, using both transverse and longitudinal components:
         // |E_envelope|^2 = |Env_E|^2 + |Env_Ex|^2
-
-        EnvE_sq = pow(EC_to_au,2)*( pow( *( E_env+ipart-ipart_ref ), 2 ) ) + pow(EC_to_au,2)*( pow( *( Ex_env+ipart-ipart_ref ), 2 ) );
-
+        const double eenv  = E_env [ipart-ipart_ref];
+        const double exenv = Ex_env[ipart-ipart_ref];
+        const double EnvE_sq = EC_to_au_sq * ( eenv*eenv + exenv*exenv );
         // Effective electric field for ionization:
         // |E| = sqrt(|E_plasma|^2+|E_envelope|^2)
-        E = sqrt(E_sq+EnvE_sq);
+        const double Ei = sqrt( E_sq + EnvE_sq );
+        field[i] = Ei;
+        
+        const double deltai = gamma[Zc] / Ei; // 2*(2I_p)^{3/2}/E
+        // Corrections on averaged ionization rate given by the polarization ellipticity
+        // (for circular polarization, the ionization rate is unchanged)
+        const double coeff = linear_polarization ? sqrt( ( 3./M_PI )/deltai*2. ) : 1.;
+        const double ratei = coeff * beta[Zc] * exp( -deltai*one_third + alpha[Zc]*log( deltai ) );
+        
+        // Probability of no ionization during the timestep
+        const double P0 = exp( -ratei*dt );
+        // The last electron is treated separately (see below)
+        const bool ionized = ( Zi < ( int ) atomic_number_ ) && ( Ei >= 1e-10 )
+                             && ( Zi == last_Z ? ran[i] < 1.0 - P0 : P0 < ran[i] );
+        
+        // A negative rate flags the ions that are not ionized
+        rate[i] = ionized ? ratei : -1.0;
+    }
     
-        if( E<1e-10 ) {
-            continue;
+    // Compact list of the ionized particles
+    ionized_.resize( 0 );
+    for( unsigned int i=0 ; i<npart; i++ ) {
+        if( rate[i] >= 0. ) {
+            ionized_.push_back( i );
         }
+    }
+    const unsigned int nionized = ionized_.size();
+    if( nionized == 0 ) {
+        return;
+    }
     
-        // --------------------------------
-        // Start of the Monte-Carlo routine
-        // --------------------------------
+    // -----------------------------------------------------------------
+    // Second pass: Monte-Carlo routine for the ionized particles only.
+    // Each ionized level creates an electron: the list of the new
+    // electrons contains their ion and their ionized level.
+    // -----------------------------------------------------------------
     
-        invE = 1./E;
-        delta      = gamma_tunnel[Z]*invE; // 2*(2I_p)^{3/2}/E
-        ran_p = patch->rand_->uniform();
-        IonizRate_tunnel_envelope[Z] = beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) );
-    
-        // Corrections on averaged ionization rate given by the polarization ellipticity  
-        if( ellipticity==0. ){ // linear polarization
-            coeff_ellipticity_in_ionization_rate = pow((3./M_PI)/delta*2.,0.5);
-        } else if( ellipticity==1. ){ // circular polarization
-            coeff_ellipticity_in_ionization_rate = 1.; // for circular polarization, the ionization rate is unchanged
-        }
-
-        IonizRate_tunnel_envelope[Z] = coeff_ellipticity_in_ionization_rate * IonizRate_tunnel_envelope[Z];
+    electron_ion_.resize( 0 );
+    electron_level_.resize( 0 );
+    
+    for( unsigned int iion=0 ; iion<nionized; iion++ ) {
     
+        const unsigned int i = ionized_[iion];
+        const unsigned int ipart = ipart_min + i;
+        
+        // Current charge state of the ion
+        Z = ( unsigned int )( charge[ipart] );
+        
+        E = field[i];
+        invE = 1./E;
+        ran_p = ran[i];
+        IonizRate_tunnel_envelope[Z] = rate[i];
+        
         // k_times will give the nb of ionization events
         k_times = 0;
         Zp1=Z+1;
 
         if( Zp1 == atomic_number_ ) {
-            // if ionization of the last electron: single ionization
-            // -----------------------------------------------------
-            if( ran_p < 1.0 -exp( -IonizRate_tunnel_envelope[Z]*dt ) ) {
-                k_times        = 1;
-                //Ip_times2_power_minus3ov4 = Ip_times2_to_minus3ov4[Z];
-            }
+            // if ionization of the last electron: single ionization (already selected in the first pass)
+            // ------------------------------------------------------------------------------------------
+            k_times        = 1;
     
         } else {
             // else : multiple ionization can occur in one time-step
@@ -151,7 +199,6 @@ void IonizationTunnelEnvelopeAveraged::envelopeIonization( Particles *particles,
 
                 // Corrections on averaged ionization rate given by the polarization ellipticity  
                 if( ellipticity==0. ){ // linear polarization
-                    //coeff_ellipticity_in_ionization_rate = pow((3./M_PI)/(gamma_tunnel[newZ-1]*invE)*2.,0.5);
                     coeff_ellipticity_in_ionization_rate = pow((3./M_PI)/delta*2.,0.5);
                 } else if( ellipticity==1. ){ // circular polarization
                     coeff_ellipticity_in_ionization_rate = 1.; // for circular polarization, the ionization rate is unchanged
@@ -173,89 +220,113 @@ void IonizationTunnelEnvelopeAveraged::envelopeIonization( Particles *particles,
                 Pint_tunnel             = Pint_tunnel + P_sum*Mult;
     
                 k_times++;
-           
-                //Ip_times2_power_minus3ov4 += Ip_times2_to_minus3ov4[newZ-1];
             }//END while
     
             // final ionization (of last electron)
             if( ( ( 1.0-Pint_tunnel )>ran_p ) && ( k_times==atomic_number_-Zp1 ) ) {
                 k_times++;
-                //Ip_times2_power_minus3ov4 += Ip_times2_to_minus3ov4[atomic_number_-1];
             }
         }//END Multiple ionization routine
+        
+        for( unsigned int ionized_level = 0; ionized_level < k_times ; ionized_level++ ) {
+            electron_ion_.push_back( iion );
+            electron_level_.push_back( Z + ionized_level );
+        }
     
         // ---- Ionization ion current cannot be computed with the envelope ionization model
-      
-        // ---- Creation of the new electrons
         
-        if( k_times !=0 ) {
-            // loop on all the ionization levels that have been ionized for this ion:
-            // each level creates an electron
-            for (int ionized_level = 0; ionized_level < k_times ; ionized_level++){
-                new_electrons.createParticle();
-                //new_electrons.initialize( new_electrons.size()+1, new_electrons.dimension() );
-                int idNew = new_electrons.size() - 1;
-
-                // The new electron is in the same position of the atom where it originated from
-                for( unsigned int i=0; i<new_electrons.dimension(); i++ ) {
-                    new_electrons.position( i, idNew )=particles->position( i, ipart );
-                }
-                for( unsigned int i=0; i<3; i++ ) {
-                    new_electrons.momentum( i, idNew ) = particles->momentum( i, ipart )*ionized_species_invmass;
-                }
-
-           
-                // ----  Initialise the momentum, weight and charge of the new electron
-
-                if (ellipticity==0.){ // linear polarization
-
-                    double rand_gaussian  = patch->rand_->normal();
-
-                    Aabs    = sqrt(2. * (*(Phi_env+ipart-ipart_ref))  ); // envelope of the laser vector potential component along the polarization direction
-                
-                    // recreate gaussian distribution with rms momentum spread for linear polarization, estimated by C.B. Schroeder
-                    // C. B. Schroeder et al., Phys. Rev. ST Accel. Beams 17, 2014, first part of Eqs. 7,10 
-                    double Ip_times2_power_minus3ov4 = Ip_times2_to_minus3ov4[Z+ionized_level];
-                    p_perp = rand_gaussian * Aabs * sqrt(1.5*E) * Ip_times2_power_minus3ov4;         
-
-                    // add the transverse momentum p_perp to obtain a gaussian distribution 
-                    // in the momentum in the polarization direction p_perp, following Schroeder's result
-                    new_electrons.momentum( 1, idNew ) += p_perp*cos_phi;
-                    new_electrons.momentum( 2, idNew ) += p_perp*sin_phi;
-
-                    // initialize px to take into account the average drift <px>=A^2/4 and the px=|p_perp|^2/2 relation
-                    // Note: the agreement in the phase space between envelope and standard laser simulation will be seen only after the passage of the ionizing laser
-                    new_electrons.momentum( 0, idNew ) += Aabs*Aabs/4. + p_perp*p_perp/2.;
-
-                } else if (ellipticity==1.){ // circular polarization
-
-                    // extract a random angle between 0 and 2pi, and assign p_perp = eA
-                    double rand_times_2pi = patch->rand_->uniform_2pi(); // from uniform distribution between [0,2pi]
-                
-                    Aabs    = sqrt(2. * (*(Phi_env+ipart-ipart_ref))  );                 
-
-                    p_perp = Aabs;   // in circular polarization it corresponds to a0/sqrt(2)
-                    new_electrons.momentum( 1, idNew ) += p_perp*cos(rand_times_2pi)/sqrt(2);
-                    new_electrons.momentum( 2, idNew ) += p_perp*sin(rand_times_2pi)/sqrt(2); 
-     
-                    // initialize px to take into account the average drift <px>=A^2/4 and the px=|p_perp|^2/2 result
-                    // Note: the agreement in the phase space between envelope and standard laser simulation will be seen only after the passage of the ionizing laser
-                    new_electrons.momentum( 0, idNew ) += Aabs*Aabs/2.; 
-            
-                }
-
-                // weight and charge of the new electron
-                new_electrons.weight( idNew )= particles->weight( ipart );
-                new_electrons.charge( idNew )= -1;
-
-            } // end loop on electrons to create
-
-            // Increase the charge of the ion particle
-            particles->charge( ipart ) += k_times;
+        // Increase the charge of the ion particle
+        charge[ipart] += k_times;
+    
+    } // Loop on ionized particles
+    
+    // -----------------------------------------------------------------
+    // Creation of all the new electrons at once
+    // -----------------------------------------------------------------
+    
+    const unsigned int nnew = electron_ion_.size();
+    const unsigned int inew0 = new_electrons.size();
+    new_electrons.createParticles( nnew );
+    
+    const unsigned int *ionized = &ionized_[0];
+    const unsigned int *ion = &electron_ion_[0];
+    const unsigned int *level = &electron_level_[0];
+    
+    // The new electron is in the same position of the atom where it originated from
+    for( unsigned int idim=0; idim<new_electrons.dimension(); idim++ ) {
+        const double *position = particles->getPtrPosition( idim );
+        double *new_position = new_electrons.getPtrPosition( idim );
+        #pragma omp simd
+        for( unsigned int inew=0 ; inew<nnew; inew++ ) {
+            new_position[inew0+inew] = position[ipart_min+ionized[ion[inew]]];
         }
+    }
     
+    // ----  Initialise the momentum, weight and charge of the new electron
+    const double *momentum_x = particles->getPtrMomentum( 0 );
+    const double *momentum_y = particles->getPtrMomentum( 1 );
+    const double *momentum_z = particles->getPtrMomentum( 2 );
+    double *new_momentum_x = new_electrons.getPtrMomentum( 0 );
+    double *new_momentum_y = new_electrons.getPtrMomentum( 1 );
+    double *new_momentum_z = new_electrons.getPtrMomentum( 2 );
+    const double *weight = particles->getPtrWeight();
+    double *new_weight = new_electrons.getPtrWeight();
+    short *new_charge = new_electrons.getPtrCharge();
+    const double *Ip_times2_power_minus3ov4 = &Ip_times2_to_minus3ov4[0];
     
-    } // Loop on particles
-
+    // One random number per new electron
+    random_numbers_.resize( nnew );
+    ran = &random_numbers_[0];
+    if( linear_polarization ) {
+        patch->rand_->normal( nnew, ran );
+    } else {
+        patch->rand_->uniform( nnew, ran );
+    }
+    
+    #pragma omp simd
+    for( unsigned int inew=0 ; inew<nnew; inew++ ) {
+        const unsigned int i = ionized[ion[inew]];
+        const unsigned int ipart = ipart_min + i;
+        
+        double px = momentum_x[ipart]*ionized_species_invmass;
+        double py = momentum_y[ipart]*ionized_species_invmass;
+        double pz = momentum_z[ipart]*ionized_species_invmass;
+        
+        // envelope of the laser vector potential component along the polarization direction
+        const double Aabs = sqrt( 2. * Phi_env[ipart-ipart_ref] );
+        
+        if( linear_polarization ) {
+            // recreate gaussian distribution with rms momentum spread for linear polarization, estimated by C.B. Schroeder
+            // C. B. Schroeder et al., Phys. Rev. ST Accel. Beams 17, 2014, first part of Eqs. 7,10
+            const double p_perp = ran[inew] * Aabs * sqrt( 1.5*field[i] ) * Ip_times2_power_minus3ov4[level[inew]];
+            
+            // add the transverse momentum p_perp to obtain a gaussian distribution
+            // in the momentum in the polarization direction p_perp, following Schroeder's result
+            py += p_perp*cos_phi;
+            pz += p_perp*sin_phi;
+            
+            // initialize px to take into account the average drift <px>=A^2/4 and the px=|p_perp|^2/2 relation
+            // Note: the agreement in the phase space between envelope and standard laser simulation will be seen only after the passage of the ionizing laser
+            px += Aabs*Aabs/4. + p_perp*p_perp/2.;
+            
+        } else { // circular polarization
+        
+            // random angle between 0 and 2pi, and p_perp = eA (in circular polarization it corresponds to a0/sqrt(2))
+            const double angle = 2.*M_PI*ran[inew];
+            py += Aabs*cos( angle )/sqrt( 2. );
+            pz += Aabs*sin( angle )/sqrt( 2. );
+            
+            // initialize px to take into account the average drift <px>=A^2/4 and the px=|p_perp|^2/2 result
+            // Note: the agreement in the phase space between envelope and standard laser simulation will be seen only after the passage of the ionizing laser
+            px += Aabs*Aabs/2.;
+        }
+        
+        new_momentum_x[inew0+inew] = px;
+        new_momentum_y[inew0+inew] = py;
+        new_momentum_z[inew0+inew] = pz;
+        
+        // weight and charge of the new electron
+        new_weight[inew0+inew] = weight[ipart];
+        new_charge[inew0+inew] = -1;
+    }
 }
-
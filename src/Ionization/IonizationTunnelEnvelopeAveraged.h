@@ -33,6 +33,13 @@ private:
     
     double one_third;
     std::vector<double> alpha_tunnel, beta_tunnel, gamma_tunnel,Ip_times2_to_minus3ov4;
+    
+    //! Buffers for the current block of particles: random numbers, rates of the first ionization and effective fields
+    std::vector<double> random_numbers_, rate_, field_;
+    //! Indices (in the block) of the particles ionized during the timestep
+    std::vector<unsigned int> ionized_;
+    //! For each new electron, index of its ion in ionized_, and ionized level
+    std::vector<unsigned int> electron_ion_, electron_level_;
 };
 
 
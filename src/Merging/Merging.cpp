@@ -10,20 +10,22 @@
 
 #include "Merging.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+std::vector<MergingBuffers> Merging::thread_buffers_;
+
 // -----------------------------------------------------------------------------
 //! Constructor for Merging
 // input: simulation parameters & Species index
 //! \param params simulation parameters
 //! \param species Species index
-//! \param rand local random generator
 // -----------------------------------------------------------------------------
-Merging::Merging( Params &params, Species *species, Random * rand )
+Merging::Merging( Params &params, Species *species )
 {
     // minimum particles per cell to process the merging
     min_particles_per_cell_ = species->merge_min_particles_per_cell_;
-    
-    // Pointer to the local patch random generator
-    rand_ = rand;
 }
 
 // -----------------------------------------------------------------------------
@@ -32,3 +34,30 @@ Merging::Merging( Params &params, Species *species, Random * rand )
 Merging::~Merging()
 {
 }
+
+// -----------------------------------------------------------------------------
+//! Allocates the scratch arrays of all threads
+// -----------------------------------------------------------------------------
+void Merging::allocateBuffers()
+{
+#ifdef _OPENMP
+    unsigned int nthreads = omp_get_max_threads();
+#else
+    unsigned int nthreads = 1;
+#endif
+    if( thread_buffers_.size() < nthreads ) {
+        thread_buffers_.resize( nthreads );
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! Scratch arrays of the current thread
+// -----------------------------------------------------------------------------
+MergingBuffers &Merging::buffers()
+{
+#ifdef _OPENMP
+    return thread_buffers_[omp_get_thread_num()];
+#else
+    return thread_buffers_[0];
+#endif
+}
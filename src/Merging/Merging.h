@@ -16,6 +16,29 @@
 #include "Species.h"
 #include "Random.h"
 
+//! Approximate number of macro-particles merged by one task
+#define SMILEI_MERGING_TASKSIZE 20000
+
+//  ----------------------------------------------------------------------------
+//! Scratch arrays of the merging process, one set per OpenMP thread.
+//! They only grow: once the most populated cell has been treated,
+//! the merging of a cell does not allocate any memory.
+//  ----------------------------------------------------------------------------
+struct MergingBuffers
+{
+    // Per particle: gamma factor, momentum norm and angles, momentum cell index, particles sorted by momentum cell
+    std::vector<double> gamma, momentum_norm, theta, phi;
+    std::vector<unsigned int> momentum_cell_index, sorted_particles;
+    
+    // Per momentum cell: number of particles and first particle in the sorted array, cell direction
+    std::vector<unsigned int> particles_per_momentum_cells, momentum_cell_particle_index;
+    std::vector<double> cell_vec_x, cell_vec_y, cell_vec_z;
+    
+    // Per phi band (spherical discretization): theta discretization
+    std::vector<unsigned int> theta_dim, theta_start_index;
+    std::vector<double> theta_min, theta_max, theta_delta, inv_theta_delta;
+};
+
 //  ----------------------------------------------------------------------------
 //! Class Merging
 //  ----------------------------------------------------------------------------
@@ -24,7 +47,7 @@ class Merging
 public:
 
     //! Creator for Merging
-    Merging( Params &params, Species *species, Random * rand );
+    Merging( Params &params, Species *species );
 
     virtual ~Merging();
 
@@ -34,6 +57,7 @@ public:
     //! \param smpi        MPI properties
     //! \param istart      Index of the first particle
     //! \param iend        Index of the last particle
+    //! \param rand        Random generator (the one of the patch, or a sub-stream of it)
     virtual void operator()(
         double mass,
         Particles &particles,
@@ -41,20 +65,37 @@ public:
         SmileiMPI *smpi,
         int istart,
         int iend,
-        int & count) = 0;
+        int & count,
+        Random * rand ) = 0;
+
+    //! Allocates the scratch arrays of all threads (to be called by a single thread)
+    static void allocateBuffers();
 
     // parameters _______________________________________________
 
 protected:
     
-    // Local rand generator
-    Random * rand_;
+    //! Scratch arrays of the current thread
+    static MergingBuffers &buffers();
+    
+    //! Pointer to the first n elements of a scratch array, grown if needed
+    template<typename T>
+    static inline T *scratch( std::vector<T> &buffer, unsigned int n )
+    {
+        if( buffer.size() < n ) {
+            buffer.resize( n );
+        }
+        return buffer.data();
+    }
     
     // Minimum number of particles per cell to process the merging
     unsigned int min_particles_per_cell_;
     
 private:
     
+    //! Scratch arrays of each thread
+    static std::vector<MergingBuffers> thread_buffers_;
+    
 };
 
 #endif
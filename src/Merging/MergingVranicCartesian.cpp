@@ -20,8 +20,8 @@
 //! Inherited from Radiation
 // -----------------------------------------------------------------------------
 MergingVranicCartesian::MergingVranicCartesian(Params& params,
-                             Species * species, Random * rand)
-      : Merging(params, species, rand)
+                             Species * species)
+      : Merging(params, species)
 {
     // Momentum cell discretization
     dimensions_[0] = (unsigned int)(species->merge_momentum_cell_size_[0]);
@@ -64,6 +64,7 @@ MergingVranicCartesian::~MergingVranicCartesian()
 //! \param istart      Index of the first particle
 //! \param iend        Index of the last particle
 //! \param count       Final number of particles
+//! \param rand        Random generator
 // ---------------------------------------------------------------------
 void MergingVranicCartesian::operator() (
         double mass,
@@ -72,9 +73,8 @@ void MergingVranicCartesian::operator() (
         SmileiMPI* smpi,
         int istart,
         int iend,
-        int & count)
-        //unsigned int &remaining_particles,
-        //unsigned int &merged_particles)
+        int & count,
+        Random * rand)
 {
 
     unsigned int number_of_particles = (unsigned int)(iend - istart);
@@ -156,20 +156,17 @@ void MergingVranicCartesian::operator() (
         // Cell keys shortcut
         // int *cell_keys = &( particles.cell_keys[0] );
 
+        // Scratch arrays of the current thread
+        MergingBuffers &buffers = Merging::buffers();
+
         // Local vector to store the momentum index in the momentum discretization
-        // std::vector <unsigned int> momentum_cell_index(number_of_particles,0);
-        // unsigned int  * momentum_cell_index = (unsigned int*) aligned_alloc(64, number_of_particles*sizeof(unsigned int));
-        unsigned int  * momentum_cell_index = new unsigned int [number_of_particles];
+        unsigned int  * momentum_cell_index = scratch( buffers.momentum_cell_index, number_of_particles );
 
         // Sorted array of particle index
-        // std::vector <unsigned int> sorted_particles(number_of_particles,0);
-        // unsigned int  * sorted_particles = (unsigned int*) aligned_alloc(64, number_of_particles*sizeof(unsigned int));
-        unsigned int  * sorted_particles = new unsigned int [number_of_particles];
+        unsigned int  * sorted_particles = scratch( buffers.sorted_particles, number_of_particles );
 
         // Particle gamma factor
-        // std::vector <double> gamma(number_of_particles,0);
-        // double  * gamma = (double*) aligned_alloc(64, number_of_particles*sizeof(double));
-        double  * gamma = new double [number_of_particles];
+        double  * gamma = scratch( buffers.gamma, number_of_particles );
 
         // Computation of the particle gamma factor
         if (mass == 0) {
@@ -201,31 +198,30 @@ void MergingVranicCartesian::operator() (
         }
 
         // Computation of the maxima and minima for each direction
-        momentum_min[0] = momentum_x[istart];
-        momentum_max[0] = momentum_x[istart];
-
-        momentum_min[1] = momentum_y[istart];
-        momentum_max[1] = momentum_y[istart];
+        // (scalar reduction variables so that the loop is vectorized by all compilers)
+        double mx_min = momentum_x[istart], mx_max = momentum_x[istart];
+        double my_min = momentum_y[istart], my_max = momentum_y[istart];
+        double mz_min = momentum_z[istart], mz_max = momentum_z[istart];
 
-        momentum_min[2] = momentum_z[istart];
-        momentum_max[2] = momentum_z[istart];
-
-#if __INTEL_COMPILER > 18000
-        #pragma omp simd \
-        reduction(min:momentum_min)  \
-        reduction(max:momentum_max)
-#endif
-        for (ip=(unsigned int) (istart) ; ip < (unsigned int) (iend); ip++ ) {
-            momentum_min[0] = std::min(momentum_min[0],momentum_x[ip]);
-            momentum_max[0] = std::max(momentum_max[0],momentum_x[ip]);
+        #pragma omp simd reduction(min:mx_min,my_min,mz_min) reduction(max:mx_max,my_max,mz_max)
+        for (int ipart = istart ; ipart < iend; ipart++ ) {
+            mx_min = std::min(mx_min,momentum_x[ipart]);
+            mx_max = std::max(mx_max,momentum_x[ipart]);
 
-            momentum_min[1] = std::min(momentum_min[1],momentum_y[ip]);
-            momentum_max[1] = std::max(momentum_max[1],momentum_y[ip]);
+            my_min = std::min(my_min,momentum_y[ipart]);
+            my_max = std::max(my_max,momentum_y[ipart]);
 
-            momentum_min[2] = std::min(momentum_min[2],momentum_z[ip]);
-            momentum_max[2] = std::max(momentum_max[2],momentum_z[ip]);
+            mz_min = std::min(mz_min,momentum_z[ipart]);
+            mz_max = std::max(mz_max,momentum_z[ipart]);
         }
 
+        momentum_min[0] = mx_min;
+        momentum_max[0] = mx_max;
+        momentum_min[1] = my_min;
+        momentum_max[1] = my_max;
+        momentum_min[2] = mz_min;
+        momentum_max[2] = mz_max;
+
         // ---------------------------------------------------------------------
         // debugging
         // std::cerr << " momentum_min[0]: " << momentum_min[0]
@@ -278,7 +274,7 @@ void MergingVranicCartesian::operator() (
                     if (accumulation_correction_) {
                         momentum_delta[ip] = (momentum_max[ip] - momentum_min[ip]) / (dim[ip]-1);
                         //momentum_min[ip] -= 0.99*momentum_delta[ip]*Rand::uniform();
-                        momentum_min[ip] -= 0.99*momentum_delta[ip]*rand_->uniform();
+                        momentum_min[ip] -= 0.99*momentum_delta[ip]*rand->uniform();
                     } else {
                         momentum_delta[ip] = (momentum_max[ip] - momentum_min[ip]) / (dim[ip]);
                     }
@@ -288,7 +284,7 @@ void MergingVranicCartesian::operator() (
                 } else {
                     if (accumulation_correction_) {
                         //dim[ip] = int(dim[ip]*(1+Rand::uniform()));
-                        dim[ip] = int(dim[ip]*(1+rand_->uniform()));
+                        dim[ip] = int(dim[ip]*(1+rand->uniform()));
                     }
 
                     // if (ip == 1) {
@@ -391,17 +387,13 @@ void MergingVranicCartesian::operator() (
                                     * dim[2];
 
         // Array containing the number of particles per momentum cells
-        // std::vector <unsigned int> particles_per_momentum_cells(momentum_cells,0);
-        // unsigned int  * particles_per_momentum_cells = (unsigned int*) aligned_alloc(64, momentum_cells*sizeof(unsigned int));
-        unsigned int  * particles_per_momentum_cells = new unsigned int [momentum_cells];
-        
+        unsigned int  * particles_per_momentum_cells = scratch( buffers.particles_per_momentum_cells, momentum_cells );
+
         // Array containing the first particle index of each momentum cell
         // in the sorted particle array
-        //std::vector <unsigned int> momentum_cell_particle_index(momentum_cells,0);
-        // unsigned int  * momentum_cell_particle_index = (unsigned int*) aligned_alloc(64, momentum_cells*sizeof(unsigned int));
-        unsigned int  * momentum_cell_particle_index = new unsigned int [momentum_cells];
-        
-        // Initialization when using aligned_alloc
+        unsigned int  * momentum_cell_particle_index = scratch( buffers.momentum_cell_particle_index, momentum_cells );
+
+        // Initialization (the scratch arrays are reused from cell to cell)
         #pragma omp simd
         for (ic = 0 ; ic < momentum_cells ; ic++) {
             momentum_cell_particle_index[ic] = 0;
@@ -824,19 +816,6 @@ void MergingVranicCartesian::operator() (
             }
         }
 
-        // Free aligned arrays
-        // free(gamma);
-        // free(momentum_cell_index);
-        // free(sorted_particles);
-        // free(particles_per_momentum_cells);
-        // free(momentum_cell_particle_index);
-        
-        // Free arrays
-        delete [] gamma;
-        delete [] momentum_cell_index;
-        delete [] sorted_particles;
-        delete [] particles_per_momentum_cells;
-        delete [] momentum_cell_particle_index;
     }
 
 }
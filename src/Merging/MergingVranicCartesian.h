@@ -30,7 +30,7 @@ class MergingVranicCartesian : public Merging
 public:
 
     //! Constructor for RadiationLandauLifshitz
-    MergingVranicCartesian( Params &params, Species *species, Random * rand );
+    MergingVranicCartesian( Params &params, Species *species );
 
     //! Destructor for RadiationLandauLifshitz
     ~MergingVranicCartesian();
@@ -43,6 +43,7 @@ public:
     //! \param istart      Index of the first particle
     //! \param iend        Index of the last particle
     //! \param count       Final number of particles
+    //! \param rand        Random generator
     // ---------------------------------------------------------------------
     virtual void operator()(
         double mass,
@@ -51,7 +52,8 @@ public:
         SmileiMPI *smpi,
         int istart,
         int iend,
-        int & count);
+        int & count,
+        Random * rand);
         //unsigned int &remaining_particles,
         //unsigned int &merged_particles);
 
@@ -17,8 +17,8 @@
 //! Inherited from Radiation
 // -----------------------------------------------------------------------------
 MergingVranicSpherical::MergingVranicSpherical(Params& params,
-                             Species * species, Random * rand)
-      : Merging(params, species, rand)
+                             Species * species)
+      : Merging(params, species)
 {
     // Momentum cell discretization
     dimensions_[0] = (unsigned int)(species->merge_momentum_cell_size_[0]);
@@ -61,6 +61,7 @@ MergingVranicSpherical::~MergingVranicSpherical()
 //! \param istart      Index of the first particle
 //! \param iend        Index of the last particle
 //! \param count       Final number of particles
+//! \param rand        Random generator
 // ---------------------------------------------------------------------
 void MergingVranicSpherical::operator() (
         double mass,
@@ -69,9 +70,8 @@ void MergingVranicSpherical::operator() (
         SmileiMPI* smpi,
         int istart,
         int iend,
-        int & count)
-        //unsigned int &remaining_particles,
-        //unsigned int &merged_particles)
+        int & count,
+        Random * rand)
 {
 
     unsigned int number_of_particles = (unsigned int)(iend - istart);
@@ -80,6 +80,9 @@ void MergingVranicSpherical::operator() (
     // to process the merging.
     if (number_of_particles > min_particles_per_cell_) {
 
+        // Scratch arrays of the current thread
+        MergingBuffers &buffers = Merging::buffers();
+
         // Momentum discretization
         // unsigned int dim[3];
         // for (unsigned int i = 0; i < 3 ; i++) {
@@ -90,38 +93,29 @@ void MergingVranicSpherical::operator() (
         unsigned int theta_dim_ref = dimensions_[1];
         unsigned int theta_dim_min = 1;
         unsigned int phi_dim = dimensions_[2];
-//        std::vector <unsigned int> theta_dim(phi_dim,0);
-        // unsigned int  * theta_dim = (unsigned int*) aligned_alloc(64, phi_dim*sizeof(unsigned int));
-        unsigned int  * theta_dim = new unsigned int [phi_dim];
+        unsigned int * theta_dim = scratch( buffers.theta_dim, phi_dim );
 
         // Minima
         double mr_min;
         double theta_min_ref;
-//        std::vector <double> theta_min(phi_dim,0);
-        // double  * theta_min = (double*) aligned_alloc(64, phi_dim*sizeof(double));
-        double  * theta_min = new double [phi_dim];
+        double * theta_min = scratch( buffers.theta_min, phi_dim );
         double phi_min;
 
         // Maxima
         double mr_max;
         double theta_max_ref;
-//        std::vector <double> theta_max(phi_dim,0);
-        // double  * theta_max = (double*) aligned_alloc(64, phi_dim*sizeof(double));
-        double  * theta_max = new double[phi_dim];
+        double * theta_max = scratch( buffers.theta_max, phi_dim );
         double phi_max;
 
         // Delta
         double mr_delta;
         double theta_delta_ref;
-//        std::vector <double> theta_delta(phi_dim,0);
-        double  * theta_delta = new double[phi_dim];
+        double * theta_delta = scratch( buffers.theta_delta, phi_dim );
         double phi_delta;
 
         // Inverse Delta
         double inv_mr_delta;
-//        std::vector <double> inv_theta_delta(phi_dim,0);
-        //double  * inv_theta_delta = (double*) aligned_alloc(64, phi_dim*sizeof(double));
-        double  * inv_theta_delta = new double [phi_dim];
+        double * inv_theta_delta = scratch( buffers.inv_theta_delta, phi_dim );
         double inv_phi_delta;
 
         // Interval
@@ -181,27 +175,17 @@ void MergingVranicSpherical::operator() (
         // int *cell_keys = &( particles.cell_keys[0] );
 
         // Norm of the momentum
-//        std::vector <double> momentum_norm(number_of_particles,0);
-        // double  * momentum_norm = (double*) aligned_alloc(64, number_of_particles*sizeof(double));
-        double  * momentum_norm = new double [number_of_particles];
+        double * momentum_norm = scratch( buffers.momentum_norm, number_of_particles );
 
         // Local vector to store the momentum index in the momentum discretization
-//        std::vector <unsigned int> momentum_cell_index(number_of_particles,0);
-        // unsigned int  * momentum_cell_index = (unsigned int*) aligned_alloc(64, number_of_particles*sizeof(unsigned int));
-        unsigned int  * momentum_cell_index = new unsigned int [number_of_particles];
+        unsigned int * momentum_cell_index = scratch( buffers.momentum_cell_index, number_of_particles );
 
         // Sorted array of particle index
-//        std::vector <unsigned int> sorted_particles(number_of_particles,0);
-        // unsigned int  * sorted_particles = (unsigned int*) aligned_alloc(64, number_of_particles*sizeof(unsigned int));
-        unsigned int  * sorted_particles = new unsigned int [number_of_particles];
+        unsigned int * sorted_particles = scratch( buffers.sorted_particles, number_of_particles );
 
         // Local vector to store the momentum angles in the spherical base
-//        std::vector <double> particles_phi(number_of_particles,0);
-//        std::vector <double> particles_theta(number_of_particles,0);
-        // double  * particles_phi = (double*) aligned_alloc(64, number_of_particles*sizeof(double));
-        double  * particles_phi = new double [number_of_particles];
-        // double  * particles_theta = (double*) aligned_alloc(64, number_of_particles*sizeof(double));
-        double  * particles_theta = new double [number_of_particles];
+        double * particles_phi = scratch( buffers.phi, number_of_particles );
+        double * particles_theta = scratch( buffers.theta, number_of_particles );
 
         // Computation of the particle momentum properties
         #pragma omp simd private(ipr)
@@ -283,7 +267,7 @@ void MergingVranicSpherical::operator() (
                         mr_delta = (mr_interval) / (mr_dim-1);
                         // A bit of chaos to kill the accumulation effect
                         // mr_min -= 0.99*mr_delta*Rand::uniform();
-                        mr_min -= 0.99*mr_delta*rand_->uniform();
+                        mr_min -= 0.99*mr_delta*rand->uniform();
                         inv_mr_delta = 1./mr_delta;
                     } else {
                         mr_max += (mr_interval)*0.01;
@@ -311,7 +295,7 @@ void MergingVranicSpherical::operator() (
                     phi_delta = (phi_interval) / (phi_dim-1);
                     // A bit of chaos to kill the accumulation effect
                     // phi_min -= 0.99*phi_delta*Rand::uniform();
-                    phi_min -= 0.99*phi_delta*rand_->uniform();
+                    phi_min -= 0.99*phi_delta*rand->uniform();
                     inv_phi_delta = 1./phi_delta;
                 } else {
                     phi_max += (phi_interval)*0.01;
@@ -378,7 +362,7 @@ void MergingVranicSpherical::operator() (
                     theta_dim[phi_i]   = std::max((unsigned int)(round(theta_interval / theta_delta[phi_i])), theta_dim_min);
                     if (accumulation_correction_) {
                         theta_delta[phi_i] = theta_interval / (theta_dim[phi_i]-1);
-                        theta_min[phi_i]   = theta_min_ref - 0.99*theta_delta[phi_i]*rand_->uniform();
+                        theta_min[phi_i]   = theta_min_ref - 0.99*theta_delta[phi_i]*rand->uniform();
                         theta_max[phi_i]   = theta_delta[phi_i]*theta_dim[phi_i] + theta_min[phi_i];
                     } else {
                         theta_delta[phi_i] = theta_interval / (theta_dim[phi_i]);
@@ -391,7 +375,7 @@ void MergingVranicSpherical::operator() (
                     theta_dim[phi_i]   = theta_dim_min;
                     if (accumulation_correction_) {
                         theta_delta[phi_i] = theta_interval / (theta_dim[phi_i]-1);
-                        theta_min[phi_i]   = theta_min_ref - 0.99*theta_delta[phi_i]*rand_->uniform();
+                        theta_min[phi_i]   = theta_min_ref - 0.99*theta_delta[phi_i]*rand->uniform();
                         theta_max[phi_i]   = theta_delta[phi_i]*theta_dim[phi_i] + theta_min[phi_i];
                     } else {
                         theta_delta[phi_i] = theta_interval / (theta_dim[phi_i]);
@@ -447,17 +431,12 @@ void MergingVranicSpherical::operator() (
         }
 
         // Array containing the number of particles per momentum cells
-//        std::vector <unsigned int> particles_per_momentum_cells(momentum_cells,0);
-        //unsigned int  * particles_per_momentum_cells = (unsigned int*) aligned_alloc(64, momentum_cells*sizeof(unsigned int));
-        unsigned int  * particles_per_momentum_cells = new unsigned int [momentum_cells];
+        unsigned int * particles_per_momentum_cells = scratch( buffers.particles_per_momentum_cells, momentum_cells );
 
         // Array containing the first particle index of each momentum cell
         // in the sorted particle array
-//        std::vector <unsigned int> momentum_cell_particle_index(momentum_cells,0);
-        //unsigned int  * momentum_cell_particle_index = (unsigned int*) aligned_alloc(64, momentum_cells*sizeof(unsigned int));
-        unsigned int  * momentum_cell_particle_index = new unsigned int [momentum_cells];
+        unsigned int * momentum_cell_particle_index = scratch( buffers.momentum_cell_particle_index, momentum_cells );
 //
-//         // Initialization when using aligned_alloc
         #pragma omp simd
         for (ic = 0 ; ic < momentum_cells ; ic++) {
             momentum_cell_particle_index[ic] = 0;
@@ -466,9 +445,7 @@ void MergingVranicSpherical::operator() (
 
         // First Cell index in theta for each phi coordinates
         // (necessary since the theta_dim depends on phi)
-//        std::vector <unsigned int>  theta_start_index (phi_dim);
-        // unsigned int *  theta_start_index = (unsigned int *) aligned_alloc(64, phi_dim*sizeof(unsigned int));
-        unsigned int *  theta_start_index = new unsigned int [phi_dim];
+        unsigned int * theta_start_index = scratch( buffers.theta_start_index, phi_dim );
 
         // Computation of the first cell index for each phi
         theta_start_index[0] = 0;
@@ -480,15 +457,9 @@ void MergingVranicSpherical::operator() (
         // Only necessary for mass particles
 
         // Cell direction unit vector in the spherical base
-        //std::vector <double> cell_vec_x(momentum_angular_cells,0);
-        //std::vector <double> cell_vec_y(momentum_angular_cells,0);
-        //std::vector <double> cell_vec_z(momentum_angular_cells,0);
-        // double  * cell_vec_x = (double*) aligned_alloc(64, momentum_angular_cells*sizeof(double));
-        // double  * cell_vec_y = (double*) aligned_alloc(64, momentum_angular_cells*sizeof(double));
-        // double  * cell_vec_z = (double*) aligned_alloc(64, momentum_angular_cells*sizeof(double));
-        double  * cell_vec_x = new double [momentum_angular_cells];
-        double  * cell_vec_y = new double [momentum_angular_cells];
-        double  * cell_vec_z = new double [momentum_angular_cells];
+        double * cell_vec_x = scratch( buffers.cell_vec_x, momentum_angular_cells );
+        double * cell_vec_y = scratch( buffers.cell_vec_y, momentum_angular_cells );
+        double * cell_vec_z = scratch( buffers.cell_vec_z, momentum_angular_cells );
         
         for (phi_i = 0 ; phi_i < phi_dim ; phi_i ++) {
 
@@ -1011,41 +982,6 @@ void MergingVranicSpherical::operator() (
             }
         }
 
-        // Free aligned arrays
-        //free(momentum_norm);
-        //free(momentum_cell_index);
-        //free(cell_vec_x);
-        //free(cell_vec_y);
-        //free(cell_vec_z);
-        //free(particles_phi);
-        //free(particles_theta);
-        //free(sorted_particles);
-        //free(particles_per_momentum_cells);
-        //free(momentum_cell_particle_index);
-        //free(theta_start_index);
-        //free(theta_dim);
-        //free(theta_min);
-        //free(theta_max);
-        //free(theta_delta);
-        //free(inv_theta_delta);
-        
-        delete [] momentum_norm;
-        delete [] momentum_cell_index;
-        delete [] cell_vec_x;
-        delete [] cell_vec_y;
-        delete [] cell_vec_z;
-        delete [] particles_phi;
-        delete [] particles_theta;
-        delete [] sorted_particles;
-        delete [] particles_per_momentum_cells;
-        delete [] momentum_cell_particle_index;
-        delete [] theta_start_index;
-        delete [] theta_dim;
-        delete [] theta_min;
-        delete [] theta_max;
-        delete [] theta_delta;
-        delete [] inv_theta_delta;
-        
     }
 
 }
@@ -335,6 +335,7 @@ void SimWindow::shift( VectorPatch &vecPatches, SmileiMPI *smpi, Params &params,
                             init_space.box_size_[1]   = params.n_space[1];
                             init_space.box_size_[2]   = params.n_space[2];
                             
+                            mypatch->rand_->reset( Random::stream_moving_window, ispec, itime );
                             particle_creator.create( init_space, params, mypatch, 0 );
                             
                         }
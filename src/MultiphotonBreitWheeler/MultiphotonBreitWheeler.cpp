@@ -253,6 +253,13 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
                                 Bx[ipart-ipart_ref], By[ipart-ipart_ref], Bz[ipart-ipart_ref] );
     }
 
+    // Production rates of all photons, in a vectorized call to the tables
+    if( rate_.size() < ( unsigned int )( iend-istart ) ) {
+        rate_.resize( iend-istart );
+    }
+    double *const __restrict__ rate = rate_.data();
+    mBW_tables.computeBreitWheelerPairProductionRate( iend-istart, &photon_chi[istart], &photon_gamma[istart], rate );
+
     // 2. Monte-Carlo process
     //    No vectorized
     for( int ipart=istart ; ipart<iend; ipart++ ) {
@@ -279,7 +286,7 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
             // If epsilon_tau_ > 0
             else if( tau[ipart] > epsilon_tau_ ) {
                 // from the cross section
-                temp = mBW_tables.computeBreitWheelerPairProductionRate( photon_chi[ipart], photon_gamma [ipart] );
+                temp = rate[ipart-istart];
 
                 // Time to decay
                 // If this time is above the remaining iteration time,
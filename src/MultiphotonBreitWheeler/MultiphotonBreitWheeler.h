@@ -134,6 +134,9 @@ private:
     //! Local random generator
     Random * rand_;
 
+    //! Buffer for the pair production rates of the photons (kept between calls to avoid reallocations)
+    std::vector<double> rate_;
+
     // _________________________________________
     // Factors
 
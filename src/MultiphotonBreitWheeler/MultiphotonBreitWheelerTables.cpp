@@ -142,22 +142,9 @@ void MultiphotonBreitWheelerTables::computePairQuantumParameter( const double ph
     // If xip > 0.5, the electron will bring more energy than the positron
     const double xipp = xip > 0.5 ? 1.0 - xip : xip;    
 
-    // index for particle chi
-    int ichipa;
-
-    // check boundaries
-    // Lower bound
-    if( xipp < xi_.data_[ichiph*xi_.dim_size_[1]] ) {
-        ichipa = 0;
-    }
-    // Upper bound
-    else if( xipp >= xi_.data_[( ichiph+1 )*xi_.dim_size_[1]-1] ) {
-        ichipa = xi_.dim_size_[1]-2;
-    } else {
-        // Search for the corresponding index ichipa for xip
-        ichipa = userFunctions::searchValuesInMonotonicArray(
-                     &xi_.data_[ichiph*xi_.dim_size_[1]], xipp, xi_.dim_size_[1] );
-    }
+    // index for particle chi (inverse of the cumulative distribution),
+    // bounded by the first and last intervals of the row
+    const int ichipa = xi_.findInRow( ichiph, xipp );
 
     // Delta for the particle_chi dimension
     const double delta_chipa = ( std::log10( 0.5*photon_chi )-xi_.axis1_min_[ichiph] )
@@ -190,46 +177,21 @@ void MultiphotonBreitWheelerTables::computePairQuantumParameter( const double ph
 }
 
 // -----------------------------------------------------------------------------
-//! Computation of the production rate of pairs per photon
-//! \param photon_chi photon quantum parameter
-//! \param photon_gamma photon normalized energy
+//! Computation of the production rate of pairs for n photons, in a vectorized loop
+//! \param photon_chi photon quantum parameters
+//! \param photon_gamma photon normalized energies
+//! \param[out] rate production rates
 // -----------------------------------------------------------------------------
-double MultiphotonBreitWheelerTables::computeBreitWheelerPairProductionRate( 
-    const double photon_chi,
-    const double photon_gamma )
+void MultiphotonBreitWheelerTables::computeBreitWheelerPairProductionRate(
+    unsigned int n,
+    const double * photon_chi,
+    const double * photon_gamma,
+    double * rate )
 {
-    // final value to return
-    double dNBWdt;
-
-    // Log of the photon quantum parameter particle_chi
-    const double logchiph = std::log10( photon_chi );
-
-    // Lower index for interpolation in the table integfochi
-    int ichiph = int( std::floor( ( logchiph-T_.log10_min_ )
-                         *T_.inv_delta_ ) );
-
-    // If photon_chi is below the lower bound of the table
-    // An asymptotic approximation is used
-    if( ichiph < 0 ) {
-        ichiph = 0;
-        // 0.2296 * sqrt(3) * pi [MG/correction by Antony]
-        dNBWdt = 1.2493450020845291*std::exp( -8.0/( 3.0*photon_chi ) ) * photon_chi*photon_chi;
-    }
-    // If photon_chi is above the upper bound of the table
-    // An asymptotic approximation is used
-    else if( ichiph >= T_.size_-1 ) {
-        ichiph = T_.size_-2;
-        dNBWdt = 2.067731275227008*std::pow( photon_chi, 5.0/3.0 );
-    } else {
-        // Upper and lower values for linear interpolation
-        const double logchiphm = ichiph*T_.delta_ + T_.log10_min_;
-        const double logchiphp = logchiphm + T_.delta_;
-
-        // Interpolation
-        dNBWdt = ( T_.data_[ichiph+1]*std::fabs( logchiph-logchiphm ) +
-                   T_.data_[ichiph]*std::fabs( logchiphp - logchiph ) )*T_.inv_delta_;
+    #pragma omp simd
+    for( unsigned int i = 0; i < n; i++ ) {
+        rate[i] = computeBreitWheelerPairProductionRate( photon_chi[i], photon_gamma[i] );
     }
-    return factor_dNBW_dt_*dNBWdt/(photon_chi*photon_gamma);
 }
 
 
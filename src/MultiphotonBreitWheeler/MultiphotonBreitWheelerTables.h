@@ -68,9 +68,36 @@ public:
     //! \param photon_chi photon quantum parameter
     //! \param gamma photon normalized energy
     // -----------------------------------------------------------------------------
-    double computeBreitWheelerPairProductionRate( 
-        const double photon_chi, 
-        const double photon_gamma);
+    inline double __attribute__((always_inline)) computeBreitWheelerPairProductionRate(
+        const double photon_chi,
+        const double photon_gamma )
+    {
+        // Position of photon_chi in the table T
+        const double position = T_.position( photon_chi );
+
+        // Out of the table, asymptotic approximations are used
+        // (written without branches so that the calling loops can be vectorized)
+        // - below: 0.2296 * sqrt(3) * pi [MG/correction by Antony]
+        // - above: 2.067731275227008 * photon_chi^(5/3)
+        const double dNBWdt = position < 0. ?
+                              1.2493450020845291*std::exp( -8.0/( 3.0*photon_chi ) ) * photon_chi*photon_chi
+                              : ( position >= T_.size_-1 ?
+                                  2.067731275227008*std::pow( photon_chi, 5.0/3.0 )
+                                  : T_.get( photon_chi ) );
+
+        return factor_dNBW_dt_*dNBWdt/( photon_chi*photon_gamma );
+    }
+
+    //! Computation of the production rate of pairs for n photons at once, in a vectorized loop
+    //! \param n number of photons
+    //! \param photon_chi photon quantum parameters
+    //! \param photon_gamma photon normalized energies
+    //! \param[out] rate production rates
+    void computeBreitWheelerPairProductionRate(
+        unsigned int n,
+        const double * photon_chi,
+        const double * photon_gamma,
+        double * rate );
 
     // ---------------------------------------------------------------------
     // TABLE READING
@@ -523,6 +523,10 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     PyTools::extract( "solve_poisson", solve_poisson, "Main"   );
     PyTools::extract( "poisson_max_iteration", poisson_max_iteration, "Main"   );
     PyTools::extract( "poisson_max_error", poisson_max_error, "Main"   );
+    PyTools::extract( "poisson_preconditioner", poisson_preconditioner, "Main"   );
+    if( poisson_preconditioner != "multigrid" && poisson_preconditioner != "none" ) {
+        ERROR_NAMELIST( "Main.poisson_preconditioner must be `multigrid` or `none`", LINK_NAMELIST + std::string("#main-variables") );
+    }
     // Relativistic Poisson Solver
     PyTools::extract( "solve_relativistic_poisson", solve_relativistic_poisson, "Main"   );
     PyTools::extract( "relativistic_poisson_max_iteration", relativistic_poisson_max_iteration, "Main"   );
@@ -813,6 +817,13 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     // Read the "print_expected_disk_usage" parameter
     PyTools::extract( "print_expected_disk_usage", print_expected_disk_usage, "Main"   );
 
+    // Read the parameters of the tabulation of python profiles
+    PyTools::extract( "profile_tabulation", profile_tabulation, "Main"   );
+    PyTools::extract( "profile_tabulation_tolerance", profile_tabulation_tolerance, "Main"   );
+    if( profile_tabulation_tolerance <= 0. ) {
+        ERROR_NAMELIST( "profile_tabulation_tolerance must be positive", LINK_NAMELIST + std::string("#main-variables") );
+    }
+
     // Decide when necessary to keep position_old
     keep_position_old = false;
     DEBUGEXEC( keep_position_old = true );
@@ -824,7 +835,7 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     unsigned int tot_species_number = PyTools::nComponents( "Species" );
 
     double mass, mass2=0;
-    std::string merging_method;
+    std::string merging_method, splitting_method;
 
     for( unsigned int ispec = 0; ispec < tot_species_number; ispec++ ) {
         PyTools::extract( "mass", mass, "Species", ispec );
@@ -854,6 +865,24 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
                 }
             }
         }
+        //Use cell sorting if splitting is used.
+        PyTools::extract( "splitting_method", splitting_method, "Species", ispec );
+        if (splitting_method != "none"){
+
+            if (defined_cell_sort && !cell_sorting_){
+                ERROR_NAMELIST(" Cell sorting or vectorization must be allowed in order to use particle splitting.",  LINK_NAMELIST + std::string("#particle-splitting"));
+            }
+
+            if (!defined_cell_sort && !cell_sorting_) {
+                if (vectorization_mode == "off") {
+                    cell_sorting_ = true;
+                    vectorization_mode = "on";
+                    if (geometry != "1Dcartesian" ) {
+                        WARNING("For particle splitting, vectorization activated for cell sorting capability. Disabled vectorization not compatible with cell sorting for the moment.")
+                    }
+                }
+            }
+        }
     }
 
     // -------------------------------------------------------
@@ -155,6 +155,8 @@ public:
     unsigned int poisson_max_iteration;
     //! Maxium poisson error tolerated
     double poisson_max_error;
+    //! Preconditioner of the conjugate gradient ("multigrid" or "none"), for both Poisson solvers
+    std::string poisson_preconditioner;
 
     //"Relativistic" Poisson solver
     //! Do we solve "relativistic poisson problem" for relativistic species
@@ -338,6 +340,12 @@ public:
     //! Boolean for printing the expected disk usage or not
     bool print_expected_disk_usage;
 
+    //! Maximum number of samples of each tabulated python profile (0 disables the tabulation)
+    unsigned int profile_tabulation;
+    
+    //! Maximum relative error of the tabulated python profiles
+    double profile_tabulation_tolerance;
+
     //! Random seed
     unsigned int random_seed;
     
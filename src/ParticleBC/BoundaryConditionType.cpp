@@ -11,6 +11,7 @@
 #include "Params.h"
 #include "tabulatedFunctions.h"
 #include "userFunctions.h"
+#include "MomentumSampler.h"
 
 
 void internal_inf( Species *species, int imin, int imax, int direction, double limit_inf, double dt, std::vector<double> &invgf, Random * rand, double &energy_change )
@@ -372,312 +373,124 @@ void stop_particle_AM( Species *species, int imin, int imax, int direction, doub
     
 }
 
-void thermalize_particle_inf( Species *species, int imin, int imax, int direction, double limit_inf, double dt, std::vector<double> &invgf, Random * rand, double &energy_change )
+//! Thermalization of the particles of the given indices, that crossed the boundary at position limit_pos:
+//! particles faster than 3 times the thermal velocity get new momenta from the flux of a Maxwellian
+//! (drawn by blocks in the MomentumSampler), the others are simply reflected
+static void thermalize_particles( Species *species, std::vector<int> &indices, int direction, double limit_pos, Random * rand, double &energy_change )
 {
+    energy_change = 0;
+    if( indices.empty() ) {
+        return;
+    }
+
     int nDim = species->nDim_particle;
     double* position = species->particles->getPtrPosition(direction);
     double* momentum = species->particles->getPtrMomentum(direction);
-    double* momentumRefl_2D = species->particles->getPtrMomentum((direction+1)%nDim);
-    double* momentumRefl_3D = species->particles->getPtrMomentum((direction+2)%nDim);
     double* momentum_x = species->particles->getPtrMomentum(0);
     double* momentum_y = species->particles->getPtrMomentum(1);
     double* momentum_z = species->particles->getPtrMomentum(2);
     double* weight     = species->particles->getPtrWeight();
 
-    energy_change = 0;
-    for (int ipart=imin ; ipart<imax ; ipart++ ) {
-        if ( position[ ipart ] < limit_inf) {
-            // checking the particle's velocity compared to the thermal one
-            double p2 = pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 );
-            double LorentzFactor = sqrt( 1.+p2 );
-            double v = sqrt( p2 )/LorentzFactor;
-
-            // energy before thermalization
-            double initial_energy = LorentzFactor-1.0;
-
-            // Apply bcs depending on the particle velocity
-            // --------------------------------------------
-            if( v>3.0*species->thermal_velocity_[0] ) {     //IF VELOCITY > 3*THERMAL VELOCITY THEN THERMALIZE IT
-
-                // velocity of the particle after thermalization/reflection
-                //for (int i=0; i<species->nDim_fields; i++) {
-
-                // change of velocity in the direction normal to the reflection plane
-                double sign_vel = -momentum[ ipart ]/std::abs( momentum[ ipart ] );
-                momentum[ ipart ] = sign_vel * species->thermal_momentum_[direction] * std::sqrt( -std::log( 1.0-rand->uniform1() ) );
-
-                // change of momentum in the direction(s) along the reflection plane
-                if (nDim>1) {
-                    momentumRefl_2D[ipart] = species->thermal_momentum_[(direction+1)%nDim] * perp_rand( rand );
-                    if (nDim>2) {
-                        momentumRefl_3D[ipart] = species->thermal_momentum_[(direction+2)%nDim] * perp_rand( rand );
-                    }
-                }
-
-                // Adding the mean velocity (using relativistic composition)
-                double vx, vy, vz, v2, g, gm1, Lxx, Lyy, Lzz, Lxy, Lxz, Lyz, gp, px, py, pz;
-                // mean-velocity
-                vx  = -species->thermal_boundary_velocity_[0];
-                vy  = -species->thermal_boundary_velocity_[1];
-                vz  = -species->thermal_boundary_velocity_[2];
-                v2  = vx*vx + vy*vy + vz*vz;
-                if( v2>0. ) {
-
-                    g   = 1.0/sqrt( 1.0-v2 );
-                    gm1 = g - 1.0;
-
-                    // compute the different component of the Matrix block of the Lorentz transformation
-                    Lxx = 1.0 + gm1 * vx*vx/v2;
-                    Lyy = 1.0 + gm1 * vy*vy/v2;
-                    Lzz = 1.0 + gm1 * vz*vz/v2;
-                    Lxy = gm1 * vx*vy/v2;
-                    Lxz = gm1 * vx*vz/v2;
-                    Lyz = gm1 * vy*vz/v2;
-
-                    // Lorentz transformation of the momentum
-                    gp = sqrt( 1.0 + pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 ) );
-                    px = -gp*g*vx + Lxx * momentum_x[ ipart ] + Lxy * momentum_y[ ipart ] + Lxz * momentum_z[ ipart ];
-                    py = -gp*g*vy + Lxy * momentum_x[ ipart ] + Lyy * momentum_y[ ipart ] + Lyz * momentum_z[ ipart ];
-                    pz = -gp*g*vz + Lxz * momentum_x[ ipart ] + Lyz * momentum_y[ ipart ] + Lzz * momentum_z[ ipart ];
-                    momentum_x[ ipart ] = px;
-                    momentum_y[ ipart ] = py;
-                    momentum_z[ ipart ] = pz;
-
-                }//ENDif vel != 0
-
-            } else {                                    // IF VELOCITY < 3*THERMAL SIMPLY REFLECT IT
-                momentum[ ipart ] = -momentum[ ipart ];
-
-            }// endif on v vs. thermal_velocity_
-
-            // position of the particle after reflection
-            position[ ipart ] = 2.*limit_inf - position[ ipart ];
+    // Energy before thermalization and position after reflection.
+    // Particles slower than 3*thermal velocity are simply reflected, the others are thermalized
+    std::vector<int> thermalized;
+    for( unsigned int i=0; i<indices.size(); i++ ) {
+        int ipart = indices[i];
+        double p2 = pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 );
+        double LorentzFactor = sqrt( 1.+p2 );
+        double v = sqrt( p2 )/LorentzFactor;
+        energy_change += weight[ ipart ]*( LorentzFactor-1.0 );
+
+        position[ ipart ] = 2.*limit_pos - position[ ipart ];
+
+        if( v>3.0*species->thermal_velocity_[0] ) {
+            thermalized.push_back( ipart );
+        } else {
+            momentum[ ipart ] = -momentum[ ipart ];
+        }
+    }
 
-            // energy lost during thermalization
-            LorentzFactor = sqrt( 1.+pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 ) );
-            energy_change += weight[ ipart ]*( initial_energy - LorentzFactor+1.0 );
+    unsigned int n = thermalized.size();
+    if( n > 0 ) {
+        // Momenta of the thermalized particles, in the order (normal, along the reflection plane)
+        std::vector<double> p( 3*n, 0. );
+        double *p_normal = &p[0];
+        double *p_perp[2] = { &p[n], &p[2*n] };
+        MomentumSampler::maxwellianFlux( n, species->thermal_momentum_[direction], p_normal, rand );
+        for( int d=1; d<nDim; d++ ) {
+            MomentumSampler::maxwellian( n, species->thermal_momentum_[(direction+d)%nDim], p_perp[d-1], rand );
+        }
 
+        // Place the components in x, y, z order, the normal one being opposite to the incoming momentum
+        std::vector<double> pxyz( 3*n );
+        double *pc[3] = { &pxyz[0], &pxyz[n], &pxyz[2*n] };
+        double *momentum_c[3] = { momentum_x, momentum_y, momentum_z };
+        for( unsigned int i=0; i<n; i++ ) {
+            int ipart = thermalized[i];
+            for( int c=0; c<3; c++ ) {
+                pc[c][i] = momentum_c[c][ipart];
+            }
+            pc[direction][i] = std::copysign( p_normal[i], -momentum[ ipart ] );
+            for( int d=1; d<nDim; d++ ) {
+                pc[(direction+d)%nDim][i] = p_perp[d-1][i];
+            }
+        }
 
-            /* HERE IS AN ATTEMPT TO INTRODUCE A SPACE DEPENDENCE ON THE BCs
-            // double val_min(params.dens_profile.vacuum_length[1]), val_max(params.dens_profile.vacuum_length[1]+params.dens_profile.length_params_y[0]);
+        // Adding the mean velocity (using relativistic composition)
+        MomentumSampler::boost( n, &species->thermal_boundary_velocity_[0], pc[0], pc[1], pc[2], NULL );
 
-            if ( ( species->particles->position(1,ipart) >= val_min ) && ( species->particles->position(1,ipart) <= val_max ) ) {
-            // nrj computed during diagnostics
-            species->particles->position(direction, ipart) = limit_pos - species->particles->position(direction, ipart);
-            species->particles->momentum(direction, ipart) = sqrt(params.thermal_velocity_[direction]) * tabFcts.erfinv( rand->uniform() );
+        for( unsigned int i=0; i<n; i++ ) {
+            int ipart = thermalized[i];
+            for( int c=0; c<3; c++ ) {
+                momentum_c[c][ipart] = pc[c][i];
             }
-            else {
-            stop_particle( species->particles, ipart, direction, limit_pos, params, energy_change );
-            }
-            */
         }
     }
+
+    // energy lost during thermalization
+    for( unsigned int i=0; i<indices.size(); i++ ) {
+        int ipart = indices[i];
+        double LorentzFactor = sqrt( 1.+pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 ) );
+        energy_change -= weight[ ipart ]*( LorentzFactor-1.0 );
+    }
 }
 
-void thermalize_particle_sup( Species *species, int imin, int imax, int direction, double limit_sup, double dt, std::vector<double> &invgf, Random * rand, double &energy_change )
+void thermalize_particle_inf( Species *species, int imin, int imax, int direction, double limit_inf, double dt, std::vector<double> &invgf, Random * rand, double &energy_change )
 {
-    int nDim = species->nDim_particle;
     double* position = species->particles->getPtrPosition(direction);
-    double* momentum = species->particles->getPtrMomentum(direction);
-    double* momentumRefl_2D = species->particles->getPtrMomentum((direction+1)%nDim);
-    double* momentumRefl_3D = species->particles->getPtrMomentum((direction+2)%nDim);
-    double* momentum_x = species->particles->getPtrMomentum(0);
-    double* momentum_y = species->particles->getPtrMomentum(1);
-    double* momentum_z = species->particles->getPtrMomentum(2);
-    double* weight     = species->particles->getPtrWeight();
+    std::vector<int> indices;
+    for (int ipart=imin ; ipart<imax ; ipart++ ) {
+        if ( position[ ipart ] < limit_inf) {
+            indices.push_back( ipart );
+        }
+    }
+    thermalize_particles( species, indices, direction, limit_inf, rand, energy_change );
+}
 
-    energy_change = 0;
+void thermalize_particle_sup( Species *species, int imin, int imax, int direction, double limit_sup, double dt, std::vector<double> &invgf, Random * rand, double &energy_change )
+{
+    double* position = species->particles->getPtrPosition(direction);
+    std::vector<int> indices;
     for (int ipart=imin ; ipart<imax ; ipart++ ) {
         if ( position[ ipart ] >= limit_sup) {
-            // checking the particle's velocity compared to the thermal one
-            double p2 = pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 );
-            double LorentzFactor = sqrt( 1.+p2 );
-            double v = sqrt( p2 )/LorentzFactor;
-
-            // energy before thermalization
-            double initial_energy = LorentzFactor-1.0;
-
-            // Apply bcs depending on the particle velocity
-            // --------------------------------------------
-            if( v>3.0*species->thermal_velocity_[0] ) {     //IF VELOCITY > 3*THERMAL VELOCITY THEN THERMALIZE IT
-
-                // velocity of the particle after thermalization/reflection
-                //for (int i=0; i<species->nDim_fields; i++) {
-
-                // change of velocity in the direction normal to the reflection plane
-                double sign_vel = -momentum[ ipart ]/std::abs( momentum[ ipart ] );
-                momentum[ ipart ] = sign_vel * species->thermal_momentum_[direction] * std::sqrt( -std::log( 1.0-rand->uniform1() ) );
-
-                // change of momentum in the direction(s) along the reflection plane
-                if (nDim>1) {
-                    momentumRefl_2D[ ipart ] = species->thermal_momentum_[(direction+1)%nDim] * perp_rand( rand );
-                    if (nDim>2) {
-                        momentumRefl_3D[ ipart ] = species->thermal_momentum_[(direction+2)%nDim] * perp_rand( rand );
-                    }
-                }
-
-                // Adding the mean velocity (using relativistic composition)
-                double vx, vy, vz, v2, g, gm1, Lxx, Lyy, Lzz, Lxy, Lxz, Lyz, gp, px, py, pz;
-                // mean-velocity
-                vx  = -species->thermal_boundary_velocity_[0];
-                vy  = -species->thermal_boundary_velocity_[1];
-                vz  = -species->thermal_boundary_velocity_[2];
-                v2  = vx*vx + vy*vy + vz*vz;
-                if( v2>0. ) {
-
-                    g   = 1.0/sqrt( 1.0-v2 );
-                    gm1 = g - 1.0;
-
-                    // compute the different component of the Matrix block of the Lorentz transformation
-                    Lxx = 1.0 + gm1 * vx*vx/v2;
-                    Lyy = 1.0 + gm1 * vy*vy/v2;
-                    Lzz = 1.0 + gm1 * vz*vz/v2;
-                    Lxy = gm1 * vx*vy/v2;
-                    Lxz = gm1 * vx*vz/v2;
-                    Lyz = gm1 * vy*vz/v2;
-
-                    // Lorentz transformation of the momentum
-                    gp = sqrt( 1.0 + pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 ) );
-                    px = -gp*g*vx + Lxx * momentum_x[ ipart ] + Lxy * momentum_y[ ipart ] + Lxz * momentum_z[ ipart ];
-                    py = -gp*g*vy + Lxy * momentum_x[ ipart ] + Lyy * momentum_y[ ipart ] + Lyz * momentum_z[ ipart ];
-                    pz = -gp*g*vz + Lxz * momentum_x[ ipart ] + Lyz * momentum_y[ ipart ] + Lzz * momentum_z[ ipart ];
-                    momentum_x[ ipart ] = px;
-                    momentum_y[ ipart ] = py;
-                    momentum_z[ ipart ] = pz;
-
-                }//ENDif vel != 0
-
-            } else {                                    // IF VELOCITY < 3*THERMAL SIMPLY REFLECT IT
-                momentum[ ipart ] = -momentum[ ipart ];
-
-            }// endif on v vs. thermal_velocity_
-
-            // position of the particle after reflection
-            position[ ipart ] = 2.*limit_sup - position[ ipart ];
-
-            // energy lost during thermalization
-            LorentzFactor = sqrt( 1.+pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 ) );
-            energy_change += weight[ ipart ]*( initial_energy - LorentzFactor+1.0 );
-
-
-            /* HERE IS AN ATTEMPT TO INTRODUCE A SPACE DEPENDENCE ON THE BCs
-            // double val_min(params.dens_profile.vacuum_length[1]), val_max(params.dens_profile.vacuum_length[1]+params.dens_profile.length_params_y[0]);
-
-            if ( ( species->particles->position(1,ipart) >= val_min ) && ( species->particles->position(1,ipart) <= val_max ) ) {
-            // nrj computed during diagnostics
-            species->particles->position(direction, ipart) = limit_pos - species->particles->position(direction, ipart);
-            species->particles->momentum(direction, ipart) = sqrt(params.thermal_velocity_[direction]) * tabFcts.erfinv( rand->uniform() );
-            }
-            else {
-            stop_particle( species->particles, ipart, direction, limit_pos, params, energy_change );
-            }
-            */
+            indices.push_back( ipart );
         }
     }
+    thermalize_particles( species, indices, direction, limit_sup, rand, energy_change );
 }
 
 
 void thermalize_particle_wall( Species *species, int imin, int imax, int direction, double wall_position, double dt, std::vector<double> &invgf, Random * rand, double &energy_change )
 {
-    int nDim = species->nDim_particle;
     double* position = species->particles->getPtrPosition(direction);
     double* momentum = species->particles->getPtrMomentum(direction);
-    double* momentumRefl_2D = species->particles->getPtrMomentum((direction+1)%nDim);
-    double* momentumRefl_3D = species->particles->getPtrMomentum((direction+2)%nDim);
-    double* momentum_x = species->particles->getPtrMomentum(0);
-    double* momentum_y = species->particles->getPtrMomentum(1);
-    double* momentum_z = species->particles->getPtrMomentum(2);
-    double* weight     = species->particles->getPtrWeight();
-
-    energy_change = 0;
+    std::vector<int> indices;
     for (int ipart=imin ; ipart<imax ; ipart++ ) {
         double particle_position     = position[ipart];
-        double particle_position_old = particle_position - dt*invgf[ipart]*species->particles->Momentum[direction][ipart];
+        double particle_position_old = particle_position - dt*invgf[ipart]*momentum[ipart];
         if ( ( wall_position-particle_position_old )*( wall_position-particle_position )<0 ) {
-            // checking the particle's velocity compared to the thermal one
-            double p2 = pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 );
-            double LorentzFactor = sqrt( 1.+p2 );
-            double v = sqrt( p2 )/LorentzFactor;
-
-            // energy before thermalization
-            double initial_energy = LorentzFactor-1.0;
-
-            // Apply bcs depending on the particle velocity
-            // --------------------------------------------
-            if( v>3.0*species->thermal_velocity_[0] ) {     //IF VELOCITY > 3*THERMAL VELOCITY THEN THERMALIZE IT
-
-                // velocity of the particle after thermalization/reflection
-                //for (int i=0; i<species->nDim_fields; i++) {
-
-                // change of velocity in the direction normal to the reflection plane
-                double sign_vel = -momentum[ ipart ]/std::abs( momentum[ ipart ] );
-                momentum[ ipart ] = sign_vel * species->thermal_momentum_[direction]
-                    *                             std::sqrt( -std::log( 1.0-rand->uniform1() ) );
-
-                // change of momentum in the direction(s) along the reflection plane
-                if (nDim>1) {
-                    momentumRefl_2D[ ipart ] = species->thermal_momentum_[(direction+1)%nDim] * perp_rand( rand );
-                    if (nDim>2) {
-                        momentumRefl_3D[ ipart ] = species->thermal_momentum_[(direction+2)%nDim] * perp_rand( rand );
-                    }
-                }
-
-                // Adding the mean velocity (using relativistic composition)
-                double vx, vy, vz, v2, g, gm1, Lxx, Lyy, Lzz, Lxy, Lxz, Lyz, gp, px, py, pz;
-                // mean-velocity
-                vx  = -species->thermal_boundary_velocity_[0];
-                vy  = -species->thermal_boundary_velocity_[1];
-                vz  = -species->thermal_boundary_velocity_[2];
-                v2  = vx*vx + vy*vy + vz*vz;
-                if( v2>0. ) {
-
-                    g   = 1.0/sqrt( 1.0-v2 );
-                    gm1 = g - 1.0;
-
-                    // compute the different component of the Matrix block of the Lorentz transformation
-                    Lxx = 1.0 + gm1 * vx*vx/v2;
-                    Lyy = 1.0 + gm1 * vy*vy/v2;
-                    Lzz = 1.0 + gm1 * vz*vz/v2;
-                    Lxy = gm1 * vx*vy/v2;
-                    Lxz = gm1 * vx*vz/v2;
-                    Lyz = gm1 * vy*vz/v2;
-
-                    // Lorentz transformation of the momentum
-                    gp = sqrt( 1.0 + pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 ) );
-                    px = -gp*g*vx + Lxx * momentum_x[ ipart ] + Lxy * momentum_y[ ipart ] + Lxz * momentum_z[ ipart ];
-                    py = -gp*g*vy + Lxy * momentum_x[ ipart ] + Lyy * momentum_y[ ipart ] + Lyz * momentum_z[ ipart ];
-                    pz = -gp*g*vz + Lxz * momentum_x[ ipart ] + Lyz * momentum_y[ ipart ] + Lzz * momentum_z[ ipart ];
-                    momentum_x[ ipart ] = px;
-                    momentum_y[ ipart ] = py;
-                    momentum_z[ ipart ] = pz;
-
-                }//ENDif vel != 0
-
-            } else {                                    // IF VELOCITY < 3*THERMAL SIMPLY REFLECT IT
-                momentum[ ipart ] = -momentum[ ipart ];
-
-            }// endif on v vs. thermal_velocity_
-
-            // position of the particle after reflection
-            position[ ipart ] = 2.*wall_position - position[ ipart ];
-
-            // energy lost during thermalization
-            LorentzFactor = sqrt( 1.+pow( momentum_x[ipart], 2 )+pow( momentum_y[ipart], 2 )+pow( momentum_z[ipart], 2 ) );
-            energy_change += weight[ ipart ]*( initial_energy - LorentzFactor+1.0 );
-
-
-            /* HERE IS AN ATTEMPT TO INTRODUCE A SPACE DEPENDENCE ON THE BCs
-            // double val_min(params.dens_profile.vacuum_length[1]), val_max(params.dens_profile.vacuum_length[1]+params.dens_profile.length_params_y[0]);
-
-            if ( ( species->particles->position(1,ipart) >= val_min ) && ( species->particles->position(1,ipart) <= val_max ) ) {
-            // nrj computed during diagnostics
-            species->particles->position(direction, ipart) = limit_pos - species->particles->position(direction, ipart);
-            species->particles->momentum(direction, ipart) = sqrt(params.thermal_velocity_[direction]) * tabFcts.erfinv( rand->uniform() );
-            }
-            else {
-            stop_particle( species->particles, ipart, direction, limit_pos, params, energy_change );
-            }
-            */
+            indices.push_back( ipart );
         }
     }
+    thermalize_particles( species, indices, direction, wall_position, rand, energy_change );
 }
@@ -16,14 +16,6 @@
 #include "tabulatedFunctions.h"
 #include "userFunctions.h"
 
-inline double perp_rand( Random * rand ) {
-    double a = userFunctions::erfinv( rand->uniform1() );
-    if( rand->cointoss() ) { 
-        a *= -1.;
-    }
-    return a;
-}
-
 void internal_inf( Species *species, int imin, int imax, int direction, double limit_inf, double dt, std::vector<double> &invgf, Random * rand, double &energy_change );
 
 void internal_sup( Species *species, int imin, int imax, int direction, double limit_sup, double dt, std::vector<double> &invgf, Random * rand, double &energy_change );
@@ -250,6 +250,7 @@ public:
         
         PyTools::extract_pyProfile( "time_envelope", profile1, "ParticleInjector", injector_index );
         this_particle_injector->time_profile_ = new Profile( profile1, 1, Tools::merge( "time_profile_", injector_name ), params );
+        this_particle_injector->time_profile_->tabulate( params, {}, true );
         MESSAGE( 2, "> Time profile: " << this_particle_injector->time_profile_->getInfo());
 
         // Number of particles per cell
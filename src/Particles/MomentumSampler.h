@@ -0,0 +1,45 @@
+#ifndef MOMENTUMSAMPLER_H
+#define MOMENTUMSAMPLER_H
+
+class Random;
+
+//! Number of particles sampled together by the MomentumSampler
+#define SMILEI_SAMPLER_BLOCK 128
+
+//! Samplers of momentum distributions for whole arrays of particles.
+//! The random numbers are drawn by blocks (Random::uniform(n, out), Random::normal(n, out))
+//! and the distributions are computed in vectorized loops.
+//! Used for the particle initialization, the injection and the thermalizing boundary conditions.
+class MomentumSampler
+{
+public:
+    //! Kinetic energies (gamma-1) of n particles in a Maxwell-Juttner distribution
+    //! (temperature in units of the rest mass energy)
+    static void maxwellJuttner( double temperature, unsigned int n, double *energies, Random *rand );
+
+    //! Momenta of n particles of given kinetic energies, in random isotropic directions
+    //! (energies may be the same array as px)
+    static void isotropic( unsigned int n, double *energies, double *px, double *py, double *pz, Random *rand );
+
+    //! n momentum components uniformly distributed between -width and width
+    static void rectangular( unsigned int n, double width, double *p, Random *rand );
+
+    //! n momentum components in a Maxwellian distribution of thermal momentum p_th (std deviation p_th/sqrt(2))
+    static void maxwellian( unsigned int n, double p_th, double *p, Random *rand );
+
+    //! n momentum components of the particles of a Maxwellian crossing a surface (p_th sqrt(-ln U), positive)
+    static void maxwellianFlux( unsigned int n, double p_th, double *p, Random *rand );
+
+    //! Lorentz boost of n momenta by the given mean velocity. If rand is not NULL, the volume
+    //! transformation of Zenitani, Phys. Plasmas 22, 042116 (2015) is applied to obtain the
+    //! correct drifting distribution
+    static void boost( unsigned int n, const double *velocity, double *px, double *py, double *pz, Random *rand );
+
+private:
+    //! Array used in the Maxwell-Juttner sampling (see doc)
+    static const double lnInvF[1000];
+    //! Array used in the Maxwell-Juttner sampling (see doc)
+    static const double lnInvH[1000];
+};
+
+#endif
@@ -28,6 +28,16 @@ struct SubSpace {
     unsigned int box_size_[3];
 };
 
+// Values of the profiles in the cells where particles are created (always 3d)
+
+struct CellProfiles {
+    Field3D charge;
+    Field3D density;
+    Field3D n_part_in_cell;
+    Field3D temperature[3];
+    Field3D velocity[3];
+};
+
 // ParticleCreator class
 
 class ParticleCreator
@@ -52,6 +62,22 @@ public:
                 Patch *patch,
                 unsigned int itime );
     
+    //! Creation of the particle properties, from the profiles already evaluated in the cells of `n_space_to_create`
+    int create( struct SubSpace n_space_to_create,
+                Params &params,
+                Patch *patch,
+                unsigned int itime,
+                CellProfiles &profiles );
+    
+    //! Evaluation of the profiles required to create the particles, with one call to each profile
+    //! for all the coordinates `xyz` (of dimensions `dims`)
+    void evaluateProfiles( std::vector<Field *> &xyz,
+                           std::vector<unsigned int> dims,
+                           CellProfiles &profiles );
+    
+    //! Whether the profiles may be evaluated for several patches at once (not the case of profiles from files)
+    bool canEvaluateProfilesTogether();
+    
     //! Creation of the charge profile and initialization of `max_charge_`
     void createChargeProfile( struct SubSpace n_space_to_create,
                 Patch *patch);
@@ -135,15 +161,6 @@ public:
 
     //! Pointer toward regular number of particles array
     std::vector<int> regular_number_array_;
-
-private:
-
-    //! Provides a Maxwell-Juttner distribution of energies
-    static std::vector<double> maxwellJuttner( Species * species, unsigned int npoints, double temperature, Random * rand );
-    //! Array used in the Maxwell-Juttner sampling (see doc)
-    static const double lnInvF[1000];
-    //! Array used in the Maxwell-Juttner sampling (see doc)
-    static const double lnInvH[1000];
 };
 
 #endif
@@ -0,0 +1,449 @@
+#include "ParticleFilter.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+#include "Species.h"
+#include "Tools.h"
+
+using namespace std;
+
+ParticleFilter::ParticleFilter( string expression, unsigned int nDim_particle, string errorPrefix ) :
+    expression_( expression ),
+    nDim_particle_( nDim_particle ),
+    needs_chi_( false ),
+    pos_( 0 ),
+    errorPrefix_( errorPrefix )
+{
+    program_ = parseOr();
+    while( pos_ < expression_.size() && isspace( expression_[pos_] ) ) {
+        pos_++;
+    }
+    if( pos_ < expression_.size() ) {
+        ERROR( errorPrefix_ << ": unexpected `" << expression_.substr( pos_ ) << "` in filter `" << expression_ << "`" );
+    }
+
+    // Verify that the evaluation stack is large enough
+    int depth = 0, max_depth = 0;
+    for( unsigned int i=0; i<program_.size(); i++ ) {
+        if( program_[i].op <= CONSTANT ) {
+            depth++;
+        } else if( program_[i].op >= ADD ) {
+            depth--;
+        }
+        max_depth = max( depth, max_depth );
+    }
+    if( max_depth > SMILEI_FILTER_STACK ) {
+        ERROR( errorPrefix_ << ": filter `" << expression_ << "` is too deeply nested" );
+    }
+}
+
+
+// Fill selection with the indices of the particles of the species that pass the filter
+void ParticleFilter::select( Species *species, vector<unsigned int> &selection )
+{
+    selection.resize( 0 );
+    double result[SMILEI_FILTER_BLOCK];
+    unsigned int npart = species->getNbrOfParticles();
+    for( unsigned int istart = 0; istart < npart; istart += SMILEI_FILTER_BLOCK ) {
+        unsigned int n = min( npart - istart, ( unsigned int ) SMILEI_FILTER_BLOCK );
+        evaluate( species, istart, n, result );
+        for( unsigned int i = 0; i < n; i++ ) {
+            if( result[i] != 0. ) {
+                selection.push_back( istart + i );
+            }
+        }
+    }
+}
+
+
+// Set to -1 the index of each particle of the species that does not pass the filter
+void ParticleFilter::discard( Species *species, int *index )
+{
+    double result[SMILEI_FILTER_BLOCK];
+    unsigned int npart = species->getNbrOfParticles();
+    for( unsigned int istart = 0; istart < npart; istart += SMILEI_FILTER_BLOCK ) {
+        unsigned int n = min( npart - istart, ( unsigned int ) SMILEI_FILTER_BLOCK );
+        evaluate( species, istart, n, result );
+        int *ind = &index[istart];
+        #pragma omp simd
+        for( unsigned int i = 0; i < n; i++ ) {
+            ind[i] = result[i] != 0. ? ind[i] : -1;
+        }
+    }
+}
+
+
+// Run the program on a block of particles: each instruction is a vectorized loop on the block
+void ParticleFilter::evaluate( Species *species, unsigned int istart, unsigned int n, double *result )
+{
+    Particles *particles = species->particles;
+    double stack[SMILEI_FILTER_STACK][SMILEI_FILTER_BLOCK];
+    int top = -1;
+
+    for( unsigned int k=0; k<program_.size(); k++ ) {
+        const Opcode op = program_[k].op;
+
+        // Push a quantity on the stack
+        if( op <= CONSTANT ) {
+            double *s = stack[++top];
+            if( op <= LOAD_Z || op == LOAD_WEIGHT || op == LOAD_CHI ) {
+                const double *q = op == LOAD_WEIGHT ? particles->getPtrWeight()
+                                  : op == LOAD_CHI  ? particles->getPtrChi()
+                                  : particles->getPtrPosition( op - LOAD_X );
+                q += istart;
+                #pragma omp simd
+                for( unsigned int i=0; i<n; i++ ) {
+                    s[i] = q[i];
+                }
+            } else if( op <= LOAD_PZ ) {
+                const double *q = particles->getPtrMomentum( op - LOAD_PX ) + istart;
+                #pragma omp simd
+                for( unsigned int i=0; i<n; i++ ) {
+                    s[i] = q[i];
+                }
+            } else if( op == LOAD_P || op == LOAD_GAMMA ) {
+                const double *px = particles->getPtrMomentum( 0 ) + istart;
+                const double *py = particles->getPtrMomentum( 1 ) + istart;
+                const double *pz = particles->getPtrMomentum( 2 ) + istart;
+                // gamma of massless particles is the momentum norm
+                const double one = ( op == LOAD_GAMMA && species->mass_ > 0. ) ? 1. : 0.;
+                #pragma omp simd
+                for( unsigned int i=0; i<n; i++ ) {
+                    s[i] = sqrt( one + px[i]*px[i] + py[i]*py[i] + pz[i]*pz[i] );
+                }
+            } else if( op == LOAD_CHARGE ) {
+                const short *q = particles->getPtrCharge() + istart;
+                #pragma omp simd
+                for( unsigned int i=0; i<n; i++ ) {
+                    s[i] = ( double ) q[i];
+                }
+            } else if( op == LOAD_ID ) {
+                const uint64_t *q = particles->getPtrId() + istart;
+                for( unsigned int i=0; i<n; i++ ) {
+                    s[i] = ( double ) q[i];
+                }
+            } else {
+                const double value = program_[k].value;
+                #pragma omp simd
+                for( unsigned int i=0; i<n; i++ ) {
+                    s[i] = value;
+                }
+            }
+
+        // Unary operators
+        } else if( op == NEG || op == NOT ) {
+            double *s = stack[top];
+            if( op == NEG ) {
+                #pragma omp simd
+                for( unsigned int i=0; i<n; i++ ) {
+                    s[i] = -s[i];
+                }
+            } else {
+                #pragma omp simd
+                for( unsigned int i=0; i<n; i++ ) {
+                    s[i] = s[i] == 0. ? 1. : 0.;
+                }
+            }
+
+        // Binary operators: the result replaces the first operand
+        } else {
+            double *a = stack[--top];
+            const double *b = stack[top+1];
+            switch( op ) {
+                case ADD:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = a[i] + b[i];
+                    }
+                    break;
+                case SUB:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = a[i] - b[i];
+                    }
+                    break;
+                case MUL:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = a[i] * b[i];
+                    }
+                    break;
+                case DIV:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = a[i] / b[i];
+                    }
+                    break;
+                case LT:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = a[i] < b[i] ? 1. : 0.;
+                    }
+                    break;
+                case LE:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = a[i] <= b[i] ? 1. : 0.;
+                    }
+                    break;
+                case GT:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = a[i] > b[i] ? 1. : 0.;
+                    }
+                    break;
+                case GE:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = a[i] >= b[i] ? 1. : 0.;
+                    }
+                    break;
+                case EQ:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = a[i] == b[i] ? 1. : 0.;
+                    }
+                    break;
+                case NE:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = a[i] != b[i] ? 1. : 0.;
+                    }
+                    break;
+                case AND:
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = ( a[i] != 0. && b[i] != 0. ) ? 1. : 0.;
+                    }
+                    break;
+                default: // OR
+                    #pragma omp simd
+                    for( unsigned int i=0; i<n; i++ ) {
+                        a[i] = ( a[i] != 0. || b[i] != 0. ) ? 1. : 0.;
+                    }
+                    break;
+            }
+        }
+    }
+
+    const double *s = stack[0];
+    #pragma omp simd
+    for( unsigned int i=0; i<n; i++ ) {
+        result[i] = s[i];
+    }
+}
+
+
+// or_expr := and_expr ( "|" and_expr )*
+ParticleFilter::Program ParticleFilter::parseOr()
+{
+    Program p = parseAnd();
+    while( accept( "|" ) || accept( "or" ) ) {
+        append( p, parseAnd(), OR );
+    }
+    return p;
+}
+
+// and_expr := not_expr ( "&" not_expr )*
+ParticleFilter::Program ParticleFilter::parseAnd()
+{
+    Program p = parseNot();
+    while( accept( "&" ) || accept( "and" ) ) {
+        append( p, parseNot(), AND );
+    }
+    return p;
+}
+
+// not_expr := "~" not_expr | comparison
+ParticleFilter::Program ParticleFilter::parseNot()
+{
+    if( accept( "~" ) || accept( "not" ) ) {
+        Program p = parseNot();
+        p.push_back( { NOT, 0. } );
+        return p;
+    }
+    return parseComparison();
+}
+
+// comparison := sum ( op sum )*   where a<b<c means (a<b)&(b<c)
+ParticleFilter::Program ParticleFilter::parseComparison()
+{
+    Program p = parseSum();
+    Program left = p;
+    unsigned int ncomparisons = 0;
+    while( true ) {
+        Opcode op = CONSTANT;
+        if( accept( "<=" ) ) {
+            op = LE;
+        } else if( accept( ">=" ) ) {
+            op = GE;
+        } else if( accept( "==" ) ) {
+            op = EQ;
+        } else if( accept( "!=" ) ) {
+            op = NE;
+        } else if( accept( "<" ) ) {
+            op = LT;
+        } else if( accept( ">" ) ) {
+            op = GT;
+        } else {
+            break;
+        }
+        Program right = parseSum();
+        if( ncomparisons == 0 ) {
+            append( p, right, op );
+        } else {
+            Program next = left;
+            append( next, right, op );
+            append( p, next, AND );
+        }
+        left = right;
+        ncomparisons++;
+    }
+    return p;
+}
+
+// sum := product ( ("+"|"-") product )*
+ParticleFilter::Program ParticleFilter::parseSum()
+{
+    Program p = parseProduct();
+    while( true ) {
+        if( accept( "+" ) ) {
+            append( p, parseProduct(), ADD );
+        } else if( accept( "-" ) ) {
+            append( p, parseProduct(), SUB );
+        } else {
+            return p;
+        }
+    }
+}
+
+// product := unary ( ("*"|"/") unary )*
+ParticleFilter::Program ParticleFilter::parseProduct()
+{
+    Program p = parseUnary();
+    while( true ) {
+        if( accept( "*" ) ) {
+            append( p, parseUnary(), MUL );
+        } else if( accept( "/" ) ) {
+            append( p, parseUnary(), DIV );
+        } else {
+            return p;
+        }
+    }
+}
+
+// unary := "-" unary | "+" unary | primary
+ParticleFilter::Program ParticleFilter::parseUnary()
+{
+    if( accept( "-" ) ) {
+        Program p = parseUnary();
+        p.push_back( { NEG, 0. } );
+        return p;
+    }
+    if( accept( "+" ) ) {
+        return parseUnary();
+    }
+    return parsePrimary();
+}
+
+// primary := number | quantity | "(" or_expr ")"
+ParticleFilter::Program ParticleFilter::parsePrimary()
+{
+    Program p;
+    if( accept( "(" ) ) {
+        p = parseOr();
+        if( ! accept( ")" ) ) {
+            ERROR( errorPrefix_ << ": missing `)` in filter `" << expression_ << "`" );
+        }
+        return p;
+    }
+
+    // Number
+    const char *start = expression_.c_str() + pos_;
+    char *end;
+    double value = strtod( start, &end );
+    if( end != start && ( isdigit( *start ) || *start == '.' ) ) {
+        pos_ += end - start;
+        p.push_back( { CONSTANT, value } );
+        return p;
+    }
+
+    // Quantity
+    string name = word();
+    Opcode op = CONSTANT;
+    if( name == "x" ) {
+        op = LOAD_X;
+    } else if( name == "y" && nDim_particle_ > 1 ) {
+        op = LOAD_Y;
+    } else if( name == "z" && nDim_particle_ > 2 ) {
+        op = LOAD_Z;
+    } else if( name == "px" ) {
+        op = LOAD_PX;
+    } else if( name == "py" ) {
+        op = LOAD_PY;
+    } else if( name == "pz" ) {
+        op = LOAD_PZ;
+    } else if( name == "p" ) {
+        op = LOAD_P;
+    } else if( name == "gamma" ) {
+        op = LOAD_GAMMA;
+    } else if( name == "weight" || name == "w" ) {
+        op = LOAD_WEIGHT;
+    } else if( name == "charge" || name == "q" ) {
+        op = LOAD_CHARGE;
+    } else if( name == "chi" ) {
+        op = LOAD_CHI;
+        needs_chi_ = true;
+    } else if( name == "id" ) {
+        op = LOAD_ID;
+    } else if( name.empty() ) {
+        ERROR( errorPrefix_ << ": syntax error at `" << expression_.substr( pos_ ) << "` in filter `" << expression_ << "`" );
+    } else {
+        ERROR( errorPrefix_ << ": unknown quantity `" << name << "` in filter `" << expression_ << "`" );
+    }
+    p.push_back( { op, 0. } );
+    return p;
+}
+
+
+// Skip spaces, then consume the given token if it is next in the expression
+bool ParticleFilter::accept( string token )
+{
+    while( pos_ < expression_.size() && isspace( expression_[pos_] ) ) {
+        pos_++;
+    }
+    if( expression_.compare( pos_, token.size(), token ) != 0 ) {
+        return false;
+    }
+    // Keywords must not be the beginning of a longer word
+    string::size_type next = pos_ + token.size();
+    if( isalpha( token[0] ) && next < expression_.size() && ( isalnum( expression_[next] ) || expression_[next] == '_' ) ) {
+        return false;
+    }
+    pos_ = next;
+    return true;
+}
+
+
+// Skip spaces, then consume a word (quantity or keyword) and return it
+string ParticleFilter::word()
+{
+    while( pos_ < expression_.size() && isspace( expression_[pos_] ) ) {
+        pos_++;
+    }
+    string::size_type start = pos_;
+    while( pos_ < expression_.size() && ( isalnum( expression_[pos_] ) || expression_[pos_] == '_' ) ) {
+        pos_++;
+    }
+    return expression_.substr( start, pos_-start );
+}
+
+
+// Append a program to another one, followed by an operator
+void ParticleFilter::append( Program &to, const Program &from, Opcode op )
+{
+    to.insert( to.end(), from.begin(), from.end() );
+    to.push_back( { op, 0. } );
+}
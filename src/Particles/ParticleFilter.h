@@ -0,0 +1,81 @@
+#ifndef PARTICLEFILTER_H
+#define PARTICLEFILTER_H
+
+#include <string>
+#include <vector>
+
+class Species;
+
+//! Number of particles evaluated together by a ParticleFilter
+#define SMILEI_FILTER_BLOCK 128
+//! Maximum depth of the evaluation stack of a ParticleFilter
+#define SMILEI_FILTER_STACK 16
+
+//! Particle selection given as a string such as "(px>0.1) & (weight<2)", compiled once in a small
+//! stack program and evaluated by blocks of particles, without python.
+//! Quantities: x, y, z, px, py, pz, p, gamma, weight, charge, chi, id.
+//! Operators, by increasing priority: | (or), & (and), ~ (not), comparisons (< <= > >= == !=,
+//! which may be chained as in -1<px<1), + -, * /, unary -.
+class ParticleFilter
+{
+public:
+    //! Compile the expression (errors are prefixed by errorPrefix)
+    ParticleFilter( std::string expression, unsigned int nDim_particle, std::string errorPrefix );
+
+    //! Whether the expression requires the quantum parameter of the particles
+    bool needsChi()
+    {
+        return needs_chi_;
+    };
+
+    //! Fill selection with the indices of the particles of the species that pass the filter
+    void select( Species *species, std::vector<unsigned int> &selection );
+
+    //! Set to -1 the index of each particle of the species that does not pass the filter
+    void discard( Species *species, int *index );
+
+    //! The original expression
+    std::string expression_;
+
+private:
+    enum Opcode {
+        LOAD_X, LOAD_Y, LOAD_Z, LOAD_PX, LOAD_PY, LOAD_PZ, LOAD_P, LOAD_GAMMA,
+        LOAD_WEIGHT, LOAD_CHARGE, LOAD_CHI, LOAD_ID, CONSTANT,
+        NEG, NOT, ADD, SUB, MUL, DIV, LT, LE, GT, GE, EQ, NE, AND, OR
+    };
+    struct Instruction {
+        Opcode op;
+        double value;
+    };
+    typedef std::vector<Instruction> Program;
+
+    //! Evaluate the program on the particles [istart, istart+n) of the species: 1 for selected particles, 0 otherwise
+    void evaluate( Species *species, unsigned int istart, unsigned int n, double *result );
+
+    //! Recursive descent parser, each level returns the program of the parsed sub-expression
+    Program parseOr();
+    Program parseAnd();
+    Program parseNot();
+    Program parseComparison();
+    Program parseSum();
+    Program parseProduct();
+    Program parseUnary();
+    Program parsePrimary();
+
+    //! Skip spaces, then consume the given token if it is next in the expression
+    bool accept( std::string token );
+    //! Skip spaces, then consume a word (quantity or keyword) and return it
+    std::string word();
+    //! Append a program to another one
+    static void append( Program &to, const Program &from, Opcode op );
+
+    Program program_;
+    unsigned int nDim_particle_;
+    bool needs_chi_;
+
+    //! Parser state
+    std::string::size_type pos_;
+    std::string errorPrefix_;
+};
+
+#endif
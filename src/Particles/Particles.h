@@ -89,6 +89,12 @@ public:
         return Weight.capacity();
     }
 
+    //! Get the number of bytes of all the properties of one particle
+    inline unsigned int bytesPerParticle() const
+    {
+        return double_prop_.size()*sizeof( double ) + short_prop_.size()*sizeof( short ) + uint64_prop_.size()*sizeof( uint64_t );
+    }
+
     //! Get dimension of particules
     inline unsigned int dimension() const
     {
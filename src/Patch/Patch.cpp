@@ -112,7 +112,7 @@ void Patch::initStep1( Params &params )
     }
     
     // Initialize the random number generator
-    rand_ = new Random( params.random_seed + hindex );
+    rand_ = new Random( params.random_seed, &hindex );
     
     // Obtain the cell_volume
     cell_volume = params.cell_volume;
@@ -955,6 +955,7 @@ void Patch::prepareParticles( SmileiMPI *smpi, int ispec, Params &params, int iD
                     }
                 }
             }
+            profiler_.addExchangedBytes( ispec, n_part_send * cuParticles.bytesPerParticle() );
             // Send particles
             if( is_a_MPI_neighbor( iDim, iNeighbor ) ) {
                 // If MPI comm, first copy particles in the sendbuffer
@@ -1152,8 +1153,12 @@ void Patch::importAndSortParticles( SmileiMPI *smpi, int ispec, Params &params,
     timer = MPI_Wtime();
 #endif
 
+    double t_profile = profiler_.start();
+
     vecSpecies[ispec]->sortParticles( params , this);
 
+    profiler_.stop( ispec, PatchProfiler::sorting, t_profile );
+
 #ifdef  __DETAILED_TIMERS
     this->patch_timers[13] += MPI_Wtime() - timer;
 #endif
@@ -8,6 +8,7 @@
 #include <limits.h>
 
 #include "Random.h"
+#include "PatchProfiler.h"
 #include "Params.h"
 #include "SmileiMPI.h"
 #include "PartWall.h"
@@ -95,6 +96,9 @@ public:
     //! Timers for the patch
     std::vector<double> patch_timers;
 #endif
+
+    //! Runtime profiler of the patch operators (see DiagPerformances)
+    PatchProfiler profiler_;
     
     // Random number generator.
     Random * rand_;
@@ -336,8 +340,8 @@ public:
     //! MPI rank of current patch
     int MPI_me_;
     
-    //! The debye length, computed for collisions
-    std::vector<double> debye_length_squared;
+    //! Moments of each species in each cell, required by the debye length of collisions
+    std::vector<double> debye_moments;
     
     //! The patch geometrical center
     std::vector<double> center_;
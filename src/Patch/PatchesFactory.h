@@ -75,13 +75,19 @@ public:
         MESSAGE( 1, "First patch created" );
         
         // If normal mode (not test mode) clone the first patch to create the others
+        // Their particles are created afterwards, for all patches at once
         unsigned int percent=10;
         for( unsigned int ipatch = 1 ; ipatch < npatches ; ipatch++ ) {
             if( ( 100*ipatch )/npatches > percent ) {
                 MESSAGE( 2, "Approximately "<<percent<<"% of patches created" );
                 percent += 10;
             }
-            vecPatches.patches_[ipatch] = clone( vecPatches( 0 ), params, smpi, vecPatches.domain_decomposition_, firstpatch + ipatch, n_moved );
+            vecPatches.patches_[ipatch] = clone( vecPatches( 0 ), params, smpi, vecPatches.domain_decomposition_, firstpatch + ipatch, n_moved, params.restart );
+        }
+        
+        if( ! params.restart && npatches > 1 ) {
+            vecPatches.createParticles( params, 1 );
+            MESSAGE( 1, "Particles created" );
         }
         
         // Clean numpy/HDF5 arrays for particle initialization
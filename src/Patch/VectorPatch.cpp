@@ -8,6 +8,10 @@
 #include <math.h>
 //#include <string>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "BinaryProcesses.h"
 #include "DomainDecompositionFactory.h"
 #include "PatchesFactory.h"
@@ -26,6 +30,7 @@
 #include "ElectroMagnBCAM_PML.h"
 
 #include "SyncVectorPatch.h"
+#include "PoissonMultigrid.h"
 #include "interface.h"
 #include "Timers.h"
 
@@ -292,6 +297,97 @@ void VectorPatch::reconfiguration( Params &params, Timers &timers, int itime )
 }
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Create the particles of the patches [first_patch, size()), species by species:
+//   - the profiles are evaluated in the cells of all these patches at once (one call to each python profile)
+//   - the particles are created in parallel, each patch using its own sequence of random numbers
+//     so that the result does not depend on the number of threads
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::createParticles( Params &params, unsigned int first_patch )
+{
+    unsigned int npatches = size() - first_patch;
+    if( npatches == 0 ) {
+        return;
+    }
+    
+    struct SubSpace init_space;
+    std::vector<unsigned int> n_space( 3 );
+    for( unsigned int idim=0 ; idim<3 ; idim++ ) {
+        init_space.cell_index_[idim] = 0;
+        init_space.box_size_[idim] = params.n_space[idim];
+        n_space[idim] = params.n_space[idim];
+    }
+    unsigned int ncells = n_space[0] * n_space[1] * n_space[2];
+    
+    // Coordinates of the cell centers of all patches, concatenated along the first axis
+    std::vector<unsigned int> dims = { npatches * n_space[0], n_space[1], n_space[2] };
+    std::vector<Field *> xyz( params.nDim_field );
+    for( unsigned int idim=0 ; idim<params.nDim_field ; idim++ ) {
+        xyz[idim] = new Field3D( dims );
+    }
+    #pragma omp parallel for schedule(static)
+    for( unsigned int ipatch=0 ; ipatch<npatches ; ipatch++ ) {
+        Patch *patch = patches_[first_patch + ipatch];
+        unsigned int ijk[3];
+        for( ijk[0]=0; ijk[0]<n_space[0]; ijk[0]++ ) {
+            for( ijk[1]=0; ijk[1]<n_space[1]; ijk[1]++ ) {
+                for( ijk[2]=0; ijk[2]<n_space[2]; ijk[2]++ ) {
+                    for( unsigned int idim=0 ; idim<params.nDim_field ; idim++ ) {
+                        ( *xyz[idim] )( ipatch*n_space[0]+ijk[0], ijk[1], ijk[2] ) = patch->getDomainLocalMin( idim ) + ( ijk[idim]+0.5 )*params.cell_length[idim];
+                    }
+                }
+            }
+        }
+    }
+    
+    for( unsigned int ispec=0 ; ispec<patches_[first_patch]->vecSpecies.size(); ispec++ ) {
+        ParticleCreator particle_creator;
+        particle_creator.associate( species( first_patch, ispec ) );
+        
+        // Particles from numpy arrays or files, or profiles from files: one patch at a time
+        if( species( first_patch, ispec )->position_initialization_array_
+         || species( first_patch, ispec )->file_position_npart_ > 0
+         || ! particle_creator.canEvaluateProfilesTogether() ) {
+            for( unsigned int ipatch=first_patch ; ipatch<size() ; ipatch++ ) {
+                species( ipatch, ispec )->initParticles( params, patches_[ipatch] );
+            }
+            continue;
+        }
+        
+        CellProfiles profiles;
+        particle_creator.evaluateProfiles( xyz, dims, profiles );
+        
+        #pragma omp parallel for schedule(dynamic)
+        for( unsigned int ipatch=0 ; ipatch<npatches ; ipatch++ ) {
+            Patch *patch = patches_[first_patch + ipatch];
+            
+            // Copy the profiles of this patch
+            CellProfiles patch_profiles;
+            Field3D *from[9] = { &profiles.charge, &profiles.density, &profiles.n_part_in_cell,
+                                 &profiles.temperature[0], &profiles.temperature[1], &profiles.temperature[2],
+                                 &profiles.velocity[0], &profiles.velocity[1], &profiles.velocity[2] };
+            Field3D *to[9] = { &patch_profiles.charge, &patch_profiles.density, &patch_profiles.n_part_in_cell,
+                               &patch_profiles.temperature[0], &patch_profiles.temperature[1], &patch_profiles.temperature[2],
+                               &patch_profiles.velocity[0], &patch_profiles.velocity[1], &patch_profiles.velocity[2] };
+            for( unsigned int i=0; i<9; i++ ) {
+                if( from[i]->globalDims_ > 0 ) {
+                    to[i]->allocateDims( n_space );
+                    memcpy( to[i]->data(), from[i]->data() + ipatch*ncells, ncells*sizeof( double ) );
+                }
+            }
+            
+            ParticleCreator patch_particle_creator;
+            patch_particle_creator.associate( patch->vecSpecies[ispec] );
+            patch->rand_->reset( Random::stream_initialization, ispec, 0 );
+            patch_particle_creator.create( init_space, params, patch, 0, patch_profiles );
+        }
+    }
+    
+    for( unsigned int idim=0 ; idim<params.nDim_field ; idim++ ) {
+        delete xyz[idim];
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Sort all patches for the new time step
 // ---------------------------------------------------------------------------------------------------------------------
@@ -341,6 +437,7 @@ void VectorPatch::dynamics( Params &params,
             }
 
             if( spec->isProj( time_dual, simWindow ) || diag_flag ) {
+                ( *this )( ipatch )->rand_->reset( Random::stream_dynamics, ispec, itime );
                 // Dynamics with vectorized operators
                 if( spec->vectorized_operators ) {
                     spec->dynamics( time_dual, ispec,
@@ -493,25 +590,63 @@ void VectorPatch::mergeParticles(Params &params, SmileiMPI *smpi, double time_du
 {
     timers.particleMerging.restart();
 
+    // Patches are merged in tasks so that the cells of dense patches can be
+    // distributed over idle threads (see SpeciesV::mergeParticles)
+    #pragma omp single
+    {
+        Merging::allocateBuffers();
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            #pragma omp task default(shared) firstprivate(ipatch)
+            {
+                // Particle importation for all species
+                for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+                    // Check if the particle merging is activated for this species
+                    if (species( ipatch, ispec )->has_merging_) {
+
+                        // Check the time selection
+                        if( species( ipatch, ispec )->merging_time_selection_->theTimeIsNow( itime ) ) {
+                            ( *this )( ipatch )->rand_->reset( Random::stream_merging, ispec, itime );
+                            species( ipatch, ispec )->mergeParticles( time_dual, ispec,
+                                    params,
+                                    ( *this )( ipatch ), smpi,
+                                    localDiags );
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    timers.particleMerging.update( params.printNow( itime ) );
+
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Particle splitting
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::splitParticles(Params &params, double time_dual, Timers &timers, int itime )
+{
+    timers.particleSplitting.restart();
+
     #pragma omp for schedule(runtime)
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-        // Particle importation for all species
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
-            // Check if the particle merging is activated for this species
-            if (species( ipatch, ispec )->has_merging_) {
+            // Check if the particle splitting is activated for this species
+            if( species( ipatch, ispec )->has_splitting_ ) {
 
                 // Check the time selection
-                if( species( ipatch, ispec )->merging_time_selection_->theTimeIsNow( itime ) ) {
-                    species( ipatch, ispec )->mergeParticles( time_dual, ispec,
+                if( species( ipatch, ispec )->splitting_time_selection_->theTimeIsNow( itime ) ) {
+                    ( *this )( ipatch )->rand_->reset( Random::stream_splitting, ispec, itime );
+                    species( ipatch, ispec )->splitParticles( time_dual, ispec,
                             params,
-                            ( *this )( ipatch ), smpi,
+                            ( *this )( ipatch ),
                             localDiags );
                 }
             }
         }
     }
 
-    timers.particleMerging.update( params.printNow( itime ) );
+    timers.particleSplitting.update( params.printNow( itime ) );
 
 }
 
@@ -587,6 +722,7 @@ void VectorPatch::injectParticlesFromBoundaries(Params &params, Timers &timers,
             particle_creator.associate( particle_injector, &local_particles_vector[i_injector], injector_species );
             
             // Creation of the particles in local_particles_vector
+            patch->rand_->reset( Random::stream_injection, i_injector, itime );
             particle_creator.create( init_space, params, patch, itime );
 
 
@@ -1314,17 +1450,52 @@ void VectorPatch::runAllDiags( Params &params, SmileiMPI *smpi, unsigned int iti
     #pragma omp barrier
 
     // Global diags: scalars + binnings
-    for( unsigned int idiag = 0 ; idiag < globalDiags.size() ; idiag++ ) {
+    unsigned int nglobal = globalDiags.size();
+    bool any_global = false;
+    for( unsigned int idiag = 0 ; idiag < nglobal ; idiag++ ) {
         diag_timers_[idiag]->restart();
-        
         #pragma omp single
         globalDiags[idiag]->theTimeIsNow_ = globalDiags[idiag]->prepare( itime );
-        
+        any_global = any_global || globalDiags[idiag]->theTimeIsNow_;
+        diag_timers_[idiag]->update();
+    }
+
+    // All patches run: each patch is processed by all the diags due at this timestep
+    // before moving to the next one, so that its particles are read from memory only once.
+    // The time spent in each diag is summed over the threads and averaged.
+    if( any_global ) {
+#ifdef _OPENMP
+        double inv_nthreads = 1./( double )omp_get_num_threads();
+#else
+        double inv_nthreads = 1.;
+#endif
+        std::vector<double> run_time( nglobal, 0. );
+        #pragma omp for schedule(runtime)
+        for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+            for( unsigned int idiag = 0 ; idiag < nglobal ; idiag++ ) {
+                if( globalDiags[idiag]->theTimeIsNow_ ) {
+                    double start = MPI_Wtime();
+                    globalDiags[idiag]->run( ( *this )( ipatch ), itime, simWindow );
+                    run_time[idiag] += MPI_Wtime() - start;
+                }
+            }
+        }
+        for( unsigned int idiag = 0 ; idiag < nglobal ; idiag++ ) {
+            if( run_time[idiag] > 0. ) {
+                #pragma omp atomic
+                diag_timers_[idiag]->time_acc_ += run_time[idiag] * inv_nthreads;
+            }
+        }
+    }
+
+    for( unsigned int idiag = 0 ; idiag < nglobal ; idiag++ ) {
+        diag_timers_[idiag]->restart();
+
         if( globalDiags[idiag]->theTimeIsNow_ ) {
-            // All patches run
-            #pragma omp for schedule(runtime)
-            for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
-                globalDiags[idiag]->run( ( *this )( ipatch ), itime, simWindow );
+            // Binning diags accumulate in per-thread histograms, summed here by all threads
+            DiagnosticParticleBinningBase* binning = dynamic_cast<DiagnosticParticleBinningBase*>( globalDiags[idiag] );
+            if( binning ) {
+                binning->reduceThreads();
             }
             // MPI procs gather the data and compute
             #pragma omp single
@@ -1429,6 +1600,21 @@ void VectorPatch::solvePoisson( Params &params, SmileiMPI *smpi )
         }
     }
 
+    // Multigrid preconditioner: the first direction is the preconditioned residual z
+    PoissonMultigrid *multigrid = NULL;
+    double r_dot_z( 0. );
+    if( params.poisson_preconditioner == "multigrid" ) {
+        vector<double> coeffs( Ex_[0]->dims_.size() );
+        for( unsigned int idim=0 ; idim<coeffs.size() ; idim++ ) {
+            coeffs[idim] = 1./( params.cell_length[idim]*params.cell_length[idim] );
+        }
+        multigrid = new PoissonMultigrid( params, smpi, *this, coeffs );
+    }
+    if( multigrid ) {
+        multigrid->precondition( *this, smpi, rnew_dot_rnew, r_dot_z );
+        multigrid->updateDirection( *this, 0. );
+    }
+
     // compute control parameter
     double ctrl = rnew_dot_rnew / ( double )( nx_p2_global );
 
@@ -1464,27 +1650,41 @@ void VectorPatch::solvePoisson( Params &params, SmileiMPI *smpi )
         MPI_Allreduce( &p_dot_Ap_local, &p_dot_Ap, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
 
 
-        // compute new potential and residual
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            ( *this )( ipatch )->EMfields->update_pand_r( r_dot_r, p_dot_Ap );
-        }
+        if( multigrid ) {
+            // compute new potential and residual
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->EMfields->update_pand_r( r_dot_z, p_dot_Ap );
+            }
 
-        // compute new residual norm
-        rnew_dot_rnew       = 0.0;
-        rnew_dot_rnew_local = 0.0;
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            rnew_dot_rnew_local += ( *this )( ipatch )->EMfields->compute_r();
+            // preconditioned residual, new residual norm and new direction
+            double rnew_dot_z;
+            multigrid->precondition( *this, smpi, rnew_dot_rnew, rnew_dot_z );
+            multigrid->updateDirection( *this, rnew_dot_z/r_dot_z );
+            r_dot_z = rnew_dot_z;
+
+        } else {
+            // compute new potential and residual
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->EMfields->update_pand_r( r_dot_r, p_dot_Ap );
+            }
+
+            // compute new residual norm
+            rnew_dot_rnew       = 0.0;
+            rnew_dot_rnew_local = 0.0;
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                rnew_dot_rnew_local += ( *this )( ipatch )->EMfields->compute_r();
+            }
+            MPI_Allreduce( &rnew_dot_rnew_local, &rnew_dot_rnew, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+
+            // compute new directio
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->EMfields->update_p( rnew_dot_rnew, r_dot_r );
+            }
         }
-        MPI_Allreduce( &rnew_dot_rnew_local, &rnew_dot_rnew, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
         if( smpi->isMaster() ) {
             DEBUG( "new residual norm: rnew_dot_rnew = " << rnew_dot_rnew );
         }
 
-        // compute new directio
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            ( *this )( ipatch )->EMfields->update_p( rnew_dot_rnew, r_dot_r );
-        }
-
         // compute control parameter
         ctrl = rnew_dot_rnew / ( double )( nx_p2_global );
         if( smpi->isMaster() ) {
@@ -1492,6 +1692,7 @@ void VectorPatch::solvePoisson( Params &params, SmileiMPI *smpi )
         }
 
     }//End of the iterative loop
+    delete multigrid;
 
 
     // --------------------------------
@@ -2041,6 +2242,22 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
     }
 
 
+    // Multigrid preconditioner: the first direction is the preconditioned residual z
+    PoissonMultigrid *multigrid = NULL;
+    double r_dot_z( 0. );
+    if( params.poisson_preconditioner == "multigrid" ) {
+        vector<double> coeffs( Ex_rel_[0]->dims_.size() );
+        for( unsigned int idim=0 ; idim<coeffs.size() ; idim++ ) {
+            coeffs[idim] = 1./( params.cell_length[idim]*params.cell_length[idim] );
+        }
+        coeffs[0] /= gamma_mean*gamma_mean;
+        multigrid = new PoissonMultigrid( params, smpi, *this, coeffs );
+    }
+    if( multigrid ) {
+        multigrid->precondition( *this, smpi, rnew_dot_rnew, r_dot_z );
+        multigrid->updateDirection( *this, 0. );
+    }
+
     // compute control parameter
     double norm2_source_term = sqrt( rnew_dot_rnew );
     //double ctrl = rnew_dot_rnew / (double)(nx_p2_global);
@@ -2080,27 +2297,41 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
         MPI_Allreduce( &p_dot_Ap_local, &p_dot_Ap, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
 
 
-        // compute new potential and residual
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            ( *this )( ipatch )->EMfields->update_pand_r( r_dot_r, p_dot_Ap );
-        }
+        if( multigrid ) {
+            // compute new potential and residual
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->EMfields->update_pand_r( r_dot_z, p_dot_Ap );
+            }
 
-        // compute new residual norm
-        rnew_dot_rnew       = 0.0;
-        rnew_dot_rnew_local = 0.0;
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            rnew_dot_rnew_local += ( *this )( ipatch )->EMfields->compute_r();
+            // preconditioned residual, new residual norm and new direction
+            double rnew_dot_z;
+            multigrid->precondition( *this, smpi, rnew_dot_rnew, rnew_dot_z );
+            multigrid->updateDirection( *this, rnew_dot_z/r_dot_z );
+            r_dot_z = rnew_dot_z;
+
+        } else {
+            // compute new potential and residual
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->EMfields->update_pand_r( r_dot_r, p_dot_Ap );
+            }
+
+            // compute new residual norm
+            rnew_dot_rnew       = 0.0;
+            rnew_dot_rnew_local = 0.0;
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                rnew_dot_rnew_local += ( *this )( ipatch )->EMfields->compute_r();
+            }
+            MPI_Allreduce( &rnew_dot_rnew_local, &rnew_dot_rnew, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+
+            // compute new directio
+            for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+                ( *this )( ipatch )->EMfields->update_p( rnew_dot_rnew, r_dot_r );
+            }
         }
-        MPI_Allreduce( &rnew_dot_rnew_local, &rnew_dot_rnew, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
         if( smpi->isMaster() ) {
             DEBUG( "new residual norm: rnew_dot_rnew = " << rnew_dot_rnew );
         }
 
-        // compute new directio
-        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
-            ( *this )( ipatch )->EMfields->update_p( rnew_dot_rnew, r_dot_r );
-        }
-
         // compute control parameter
 
         ctrl = sqrt( rnew_dot_rnew )/norm2_source_term;
@@ -2109,6 +2340,7 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
         }
 
     }//End of the iterative loop
+    delete multigrid;
 
 
     // --------------------------------
@@ -3710,19 +3942,25 @@ void VectorPatch::applyBinaryProcesses( Params &params, int itime, Timers &timer
 {
     timers.collisions.restart();
 
-    if( BinaryProcesses::debye_length_required_ ) {
-        #pragma omp for schedule(runtime)
-        for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
-            BinaryProcesses::calculate_debye_length( params, patches_[ipatch] );
-        }
-    }
-
     unsigned int nBPs = patches_[0]->vecBPs.size();
 
-    #pragma omp for schedule(runtime)
+    // One task per patch; patches with many particles spawn more tasks over their bins
+    #pragma omp single
     for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
-        for( unsigned int iBPs=0 ; iBPs<nBPs; iBPs++ ) {
-            patches_[ipatch]->vecBPs[iBPs]->apply( params, patches_[ipatch], itime, localDiags );
+        #pragma omp task default(shared) firstprivate(ipatch)
+        {
+            // The moments required by the debye length are calculated before any process modifies the particles
+            bool debye_length_required = false;
+            for( unsigned int iBPs=0 ; iBPs<nBPs; iBPs++ ) {
+                debye_length_required = debye_length_required || patches_[ipatch]->vecBPs[iBPs]->needsDebyeLength( itime );
+            }
+            if( debye_length_required ) {
+                BinaryProcesses::calculateDebyeMoments( patches_[ipatch] );
+            }
+            for( unsigned int iBPs=0 ; iBPs<nBPs; iBPs++ ) {
+                patches_[ipatch]->rand_->reset( Random::stream_collisions, iBPs, itime );
+                patches_[ipatch]->vecBPs[iBPs]->apply( params, patches_[ipatch], itime, localDiags );
+            }
         }
     }
 
@@ -3785,8 +4023,23 @@ void VectorPatch::applyExternalFields()
 // For each patch, apply external fields
 void VectorPatch::applyPrescribedFields(double time)
 {
-    for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
-        patches_[ipatch]->EMfields->applyPrescribedFields( ( *this )( ipatch ), time );
+    // Python profiles can only be evaluated by one thread, tabulated ones by all threads
+    // (points outside the tables are still evaluated in python, one thread at a time)
+    bool tabulated = true;
+    vector<PrescribedField> &prescribedFields = patches_[0]->EMfields->prescribedFields;
+    for( unsigned int i=0 ; i<prescribedFields.size() ; i++ ) {
+        tabulated = tabulated && prescribedFields[i].profile->isTabulated();
+    }
+    if( tabulated ) {
+        #pragma omp for schedule(dynamic)
+        for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+            patches_[ipatch]->EMfields->applyPrescribedFields( ( *this )( ipatch ), time );
+        }
+    } else {
+        #pragma omp single
+        for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+            patches_[ipatch]->EMfields->applyPrescribedFields( ( *this )( ipatch ), time );
+        }
     }
 }
 
@@ -4079,6 +4332,7 @@ void VectorPatch::ponderomotiveUpdateSusceptibilityAndMomentum( Params &params,
         ( *this )( ipatch )->EMfields->restartEnvChi();
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
             if( ( *this )( ipatch )->vecSpecies[ispec]->isProj( time_dual, simWindow ) || diag_flag ) {
+                ( *this )( ipatch )->rand_->reset( Random::stream_envelope_momentum, ispec, itime );
                 if( ( *this )( ipatch )->vecSpecies[ispec]->vectorized_operators )
                     species( ipatch, ispec )->ponderomotiveUpdateSusceptibilityAndMomentum( time_dual, ispec,
                                 emfields( ipatch ),
@@ -4128,6 +4382,7 @@ void VectorPatch::ponderomotiveUpdatePositionAndCurrents( Params &params,
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
             if( ( *this )( ipatch )->vecSpecies[ispec]->isProj( time_dual, simWindow ) || diag_flag ) {
+                ( *this )( ipatch )->rand_->reset( Random::stream_envelope_position, ispec, itime );
                 if( ( *this )( ipatch )->vecSpecies[ispec]->vectorized_operators ){
                     species( ipatch, ispec )->ponderomotiveUpdatePositionAndCurrents( time_dual, ispec,
                            emfields( ipatch ),
@@ -113,6 +113,9 @@ public :
     //! Reconfigure all patches for the new time step
     void reconfiguration( Params &params, Timers &timers, int itime );
     
+    //! Creation of the particles of the patches [first_patch, size()) at the beginning of the simulation
+    void createParticles( Params &params, unsigned int first_patch );
+    
     //! Particle sorting for all patches
     void sortAllParticles( Params &params );
     
@@ -135,6 +138,9 @@ public :
     //! Particle merging
     void mergeParticles(Params &params, SmileiMPI *smpi, double time_dual,Timers &timers, int itime );
 
+    //! Particle splitting
+    void splitParticles(Params &params, double time_dual, Timers &timers, int itime );
+
     //! Clean MPI buffers and resize particle arrays to save memory
     void cleanParticlesOverhead(Params &params, Timers &timers, int itime );
                               
@@ -1,6 +1,8 @@
 #include "Function.h"
 #include <complex>
 #include <cmath>
+#include <sstream>
+#include <algorithm>
 
 using namespace std;
 
@@ -134,6 +136,147 @@ PyArrayObject *Function_Python4D::complexValueAt( std::vector<PyArrayObject *> x
 
 #endif
 
+// Tabulated python profiles
+bool Function_Tabulated::interpolate( const double *x, double &value )
+{
+    unsigned int nvar = n_.size();
+    size_t base = 0;
+    double w[4];
+    for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+        double u = ( x[ivar] - min_[ivar] ) * inv_step_[ivar];
+        if( !( u >= 0. && u <= ( double )( n_[ivar]-1 ) ) ) {
+            return false;
+        }
+        unsigned int i = std::min( ( unsigned int ) u, n_[ivar]-2 );
+        w[ivar] = u - i;
+        base += i * stride_[ivar];
+    }
+    value = 0.;
+    for( unsigned int corner=0; corner < ( 1u<<nvar ); corner++ ) {
+        double c = 1.;
+        size_t index = base;
+        for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+            if( ( corner >> ivar ) & 1 ) {
+                c *= w[ivar];
+                index += stride_[ivar];
+            } else {
+                c *= 1. - w[ivar];
+            }
+        }
+        value += c * ( *values_ )[index];
+    }
+    return true;
+}
+double Function_Tabulated::valueAt( double x )
+{
+    double value;
+    return interpolate( &x, value ) ? value : python_->valueAt( x );
+}
+double Function_Tabulated::valueAt( vector<double> x )
+{
+    double value;
+    return interpolate( &x[0], value ) ? value : python_->valueAt( x );
+}
+double Function_Tabulated::valueAt( vector<double> x, double time )
+{
+    unsigned int nvar = n_.size();
+    vector<double> y( nvar, time );
+    for( unsigned int ivar=0; ivar<nvar-1; ivar++ ) {
+        y[ivar] = x[ivar];
+    }
+    double value;
+    return interpolate( &y[0], value ) ? value : python_->valueAt( x, time );
+}
+void Function_Tabulated::valuesAt( vector<double *> x, double time, double *ret, unsigned int size, bool add )
+{
+    const unsigned int B = 64;
+    unsigned int nvar = n_.size();
+    unsigned int nspace = time_variable_ ? nvar-1 : nvar;
+    const double *values = &( *values_ )[0];
+    size_t base[B];
+    double w[4][B], value[B];
+    int inside[B];
+
+    for( unsigned int start=0; start<size; start+=B ) {
+        unsigned int n = std::min( B, size-start );
+
+        // Cell of each point and weights along each variable
+        for( unsigned int i=0; i<n; i++ ) {
+            base[i] = 0;
+            inside[i] = 1;
+            value[i] = 0.;
+        }
+        for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+            const double *xv = ivar < nspace ? x[ivar] + start : NULL;
+            const double min = min_[ivar], inv_step = inv_step_[ivar], last = ( double )( n_[ivar]-1 );
+            const unsigned int imax = n_[ivar]-2;
+            const size_t stride = stride_[ivar];
+            double *wv = w[ivar];
+            #pragma omp simd
+            for( unsigned int i=0; i<n; i++ ) {
+                double u = ( ( xv ? xv[i] : time ) - min ) * inv_step;
+                int in = u >= 0. && u <= last;
+                unsigned int j = in ? std::min( ( unsigned int ) u, imax ) : 0;
+                wv[i] = u - j;
+                base[i] += j * stride;
+                inside[i] &= in;
+            }
+        }
+
+        // Sum the contributions of the corners of the cells
+        for( unsigned int corner=0; corner < ( 1u<<nvar ); corner++ ) {
+            size_t offset = 0;
+            for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+                offset += ( ( corner >> ivar ) & 1 ) * stride_[ivar];
+            }
+            #pragma omp simd
+            for( unsigned int i=0; i<n; i++ ) {
+                double c = 1.;
+                for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+                    c *= ( ( corner >> ivar ) & 1 ) ? w[ivar][i] : 1. - w[ivar][i];
+                }
+                value[i] += inside[i] ? c * values[base[i] + offset] : 0.;
+            }
+        }
+
+        // Points outside the grid are evaluated in python
+        // This may be called by several threads (see VectorPatch::applyPrescribedFields): one at a time in python
+        for( unsigned int i=0; i<n; i++ ) {
+            if( ! inside[i] ) {
+                vector<double> y( nspace );
+                for( unsigned int ivar=0; ivar<nspace; ivar++ ) {
+                    y[ivar] = x[ivar][start+i];
+                }
+                #pragma omp critical (python_function)
+                value[i] = time_variable_ ? python_->valueAt( y, time ) : python_->valueAt( y );
+            }
+        }
+
+        double *r = ret + start;
+        if( add ) {
+            #pragma omp simd
+            for( unsigned int i=0; i<n; i++ ) {
+                r[i] += value[i];
+            }
+        } else {
+            #pragma omp simd
+            for( unsigned int i=0; i<n; i++ ) {
+                r[i] = value[i];
+            }
+        }
+    }
+}
+string Function_Tabulated::getInfo()
+{
+    ostringstream info( "" );
+    info << " (tabulated on " << n_[0];
+    for( unsigned int ivar=1; ivar<n_.size(); ivar++ ) {
+        info << "x" << n_[ivar];
+    }
+    info << " points)";
+    return info.str();
+}
+
 // Profiles from file
 double Function_File::valueAt( vector<double> x_cell )
 {
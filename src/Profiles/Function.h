@@ -194,6 +194,68 @@ private:
 };
 
 
+//! Multilinear interpolation of a python function sampled on a regular grid (see Profile::tabulate).
+//! If time_variable, the last variable is the time. Points outside the grid are given to the python function.
+class Function_Tabulated : public Function
+{
+public:
+    Function_Tabulated( Function *python, bool time_variable, std::vector<double> min, std::vector<double> step, std::vector<unsigned int> n, std::vector<double> *values )
+    : python_( python ), time_variable_( time_variable ), min_( min ), n_( n ), values_( values )
+    {
+        inv_step_.resize( step.size() );
+        stride_.resize( step.size() );
+        size_t stride = 1;
+        for( int i=step.size()-1; i>=0; i-- ) {
+            inv_step_[i] = 1. / step[i];
+            stride_[i] = stride;
+            stride *= n_[i];
+        }
+        shared_count_ = new int( 0 );
+    };
+    Function_Tabulated( Function_Tabulated *f )
+    : python_( f->python_ ), time_variable_( f->time_variable_ ), min_( f->min_ ), inv_step_( f->inv_step_ ), n_( f->n_ ), stride_( f->stride_ ), values_( f->values_ )
+    {
+        shared_count_ = f->shared_count_;
+        (*shared_count_) ++;
+    };
+    ~Function_Tabulated()
+    {
+        if( (*shared_count_) == 0 ) {
+            delete python_;
+            delete values_;
+            delete shared_count_;
+        } else {
+            (*shared_count_) --;
+        }
+    }
+    double valueAt( double ); // 1 variable
+    double valueAt( std::vector<double> ); // all variables
+    double valueAt( std::vector<double>, double ); // space + time
+    //! Values at many points, x[ivar][i] being the variable ivar of point i (time excluded): ret[i] = f( x[.][i], time ), or ret[i] += f( x[.][i], time ) if add
+    void valuesAt( std::vector<double *> x, double time, double *ret, unsigned int size, bool add );
+    //! Interpolated value at the point x (all variables); false if outside the grid
+    bool interpolate( const double *x, double &value );
+    //! Detach the python function, which will not be deleted with this object
+    void releasePython()
+    {
+        python_ = NULL;
+    };
+    std::string getInfo();
+private:
+    //! The python function
+    Function *python_;
+    bool time_variable_;
+    //! Grid: first point, inverse step and number of points for each variable
+    std::vector<double> min_, inv_step_;
+    std::vector<unsigned int> n_;
+    std::vector<size_t> stride_;
+    //! Samples, the last variable being contiguous
+    std::vector<double> *values_;
+    //! Number of clones sharing the samples
+    int *shared_count_;
+};
+
+
 // Children classes for hard-coded functions
 
 class Function_Constant1D : public Function
@@ -13,7 +13,9 @@ Profile::Profile( PyObject *py_profile, unsigned int nvariables, string name, Pa
     nvariables_( nvariables ),
     uses_numpy_( false ),
     uses_file_( false ),
-    filename_( "" )
+    filename_( "" ),
+    tabulated_( false ),
+    tabulation_info_( "" )
 {
     // In case the function was created in "pyprofiles.py", then we transform it
     //  in a "hard-coded" function
@@ -321,6 +323,8 @@ Profile::Profile( Profile *p )
     uses_numpy_  = p->uses_numpy_ ;
     uses_file_ = p->uses_file_;
     filename_ = p->filename_;
+    tabulated_ = p->tabulated_;
+    tabulation_info_ = p->tabulation_info_;
     
     if( profileName_ != "" ) {
         if( profileName_ == "constant" ) {
@@ -388,6 +392,8 @@ Profile::Profile( Profile *p )
         }
     } else if( uses_file_ ) {
         function_ = new Function_File( static_cast<Function_File *>( p->function_ ) );
+    } else if( tabulated_ ) {
+        function_ = new Function_Tabulated( static_cast<Function_Tabulated *>( p->function_ ) );
     } else {
         if( nvariables_ == 1 ) {
             function_ = new Function_Python1D( static_cast<Function_Python1D *>( p->function_ ) );
@@ -417,6 +423,15 @@ void Profile::valuesAt( std::vector<Field *> &coordinates, std::vector<double> g
 {
     unsigned int nvar = coordinates.size();
     unsigned int size = coordinates[0]->globalDims_;
+    // Tabulated profile: interpolation of all the points at once
+    if( tabulated_ ) {
+        std::vector<double *> x( nvar );
+        for( unsigned int ivar=0; ivar<nvar; ivar++ ) {
+            x[ivar] = coordinates[ivar]->data();
+        }
+        static_cast<Function_Tabulated *>( function_ )->valuesAt( x, time, ret.data(), size, mode & 0b01 );
+        return;
+    }
 #ifdef SMILEI_USE_NUMPY
     // If numpy profile, then expose coordinates as numpy before evaluating profile
     if( uses_numpy_ ) {
@@ -647,4 +662,173 @@ void Profile::complexValuesAtTimes( std::vector<Field *> &coordinates, Field *ti
             ret( i ) = function_->complexValueAt( x, t );
         }
     }
-}
\ No newline at end of file
+}
+// Value of the python function at the point x (the last variable being the time if time_variable)
+double Profile::pythonValueAt( std::vector<double> &x, bool time_variable )
+{
+    if( time_variable ) {
+        std::vector<double> space( x.begin(), x.end()-1 );
+        return function_->valueAt( space, x.back() );
+    }
+    return function_->valueAt( x );
+}
+
+//! Replace a python profile by a multilinear interpolation of its values sampled on a regular grid
+void Profile::tabulate( Params &params, std::vector<unsigned int> axes, bool time_variable )
+{
+    unsigned int nspace = axes.size();
+    unsigned int nvar = nspace + ( time_variable ? 1 : 0 );
+    if( params.profile_tabulation == 0 || tabulated_ || ! profileName_.empty() || uses_file_
+        || nvar == 0 || nvar != ( unsigned int ) nvariables_ ) {
+        return;
+    }
+    
+    // Largest displacement of the moving window (by whole patches, possibly with additional shifts)
+    double x_moved = 0.;
+    if( params.hasWindow ) {
+        double time_start, velocity_x;
+        unsigned int number_of_additional_shifts;
+        PyTools::extract( "time_start", time_start, "MovingWindow" );
+        PyTools::extract( "velocity_x", velocity_x, "MovingWindow" );
+        PyTools::extract( "number_of_additional_shifts", number_of_additional_shifts, "MovingWindow" );
+        double patch_length = params.n_space[0] * params.cell_length[0];
+        x_moved = std::max( 0., ( params.simulation_time - time_start ) * velocity_x )
+                  + ( number_of_additional_shifts + 1. ) * patch_length;
+    }
+    
+    // Domain: the box including ghost cells, and the simulation time
+    std::vector<double> min( nvar ), max( nvar ), cell( nvar );
+    for( unsigned int i=0; i<nspace; i++ ) {
+        double dx = params.cell_length[axes[i]];
+        min [i] = -( params.oversize[axes[i]] + 1. ) * dx;
+        max [i] = params.grid_length[axes[i]] + ( params.oversize[axes[i]] + 1. ) * dx;
+        if( axes[i] == 0 ) {
+            max[i] += x_moved;
+        }
+        cell[i] = dx;
+    }
+    if( time_variable ) {
+        min [nvar-1] = -params.timestep;
+        max [nvar-1] = params.simulation_time + params.timestep;
+        cell[nvar-1] = params.timestep;
+    }
+    
+    // Start with one point per cell and per timestep, or a coarser grid if too many points.
+    // The grid is refined (up to 8 points per cell) while the error is too large and the points are allowed.
+    Function_Tabulated *tabulated = NULL;
+    double error = 0.;
+    for( double refinement = 1.; ; refinement *= 2. ) {
+        std::vector<unsigned int> n( nvar );
+        std::vector<double> step( nvar );
+        double npoints, coarsening = 1. / refinement;
+        bool coarsened = false;
+        while( true ) {
+            npoints = 1.;
+            for( unsigned int i=0; i<nvar; i++ ) {
+                n[i] = std::max( 2., ceil( ( max[i]-min[i] ) / ( cell[i]*coarsening ) - 1.e-6 ) + 1. );
+                npoints *= n[i];
+            }
+            if( npoints <= params.profile_tabulation || npoints <= pow( 2., nvar ) ) {
+                break;
+            }
+            coarsening *= 1.1;
+            coarsened = true;
+        }
+        if( refinement > 1. && coarsened ) {
+            break;
+        }
+        for( unsigned int i=0; i<nvar; i++ ) {
+            step[i] = ( max[i]-min[i] ) / ( n[i]-1 );
+        }
+        size_t size = ( size_t ) npoints;
+        
+        // Sample the python function, the last variable being contiguous
+        std::vector<double> *values = new std::vector<double>( size );
+        std::vector<double> x( nvar );
+#ifdef SMILEI_USE_NUMPY
+        if( uses_numpy_ && time_variable && nspace > 0 ) {
+            // One call for each time, with numpy arrays of all the points in space
+            size_t nt = n[nvar-1], size_space = size / nt;
+            std::vector<std::vector<double> > coords( nspace, std::vector<double>( size_space ) );
+            for( size_t ip=0; ip<size_space; ip++ ) {
+                size_t r = ip;
+                for( int i=nspace-1; i>=0; i-- ) {
+                    coords[i][ip] = min[i] + ( r % n[i] ) * step[i];
+                    r /= n[i];
+                }
+            }
+            npy_intp dims[1] = { ( npy_intp ) size_space };
+            std::vector<PyArrayObject *> a( nspace );
+            for( unsigned int i=0; i<nspace; i++ ) {
+                a[i] = ( PyArrayObject * )PyArray_SimpleNewFromData( 1, dims, NPY_DOUBLE, ( double * )( &coords[i][0] ) );
+            }
+            for( size_t it=0; it<nt; it++ ) {
+                PyArrayObject *v = function_->valueAt( a, min[nvar-1] + it*step[nvar-1] );
+                PyTools::checkPyError();
+                if( ! v || ( size_t ) PyArray_SIZE( v ) != size_space ) {
+                    ERROR( "Profile could not be tabulated: wrong size of the returned array" );
+                }
+                double *arr = ( double * ) PyArray_GETPTR1( v, 0 );
+                for( size_t ip=0; ip<size_space; ip++ ) {
+                    ( *values )[ip*nt + it] = arr[ip];
+                }
+                Py_DECREF( v );
+            }
+            for( unsigned int i=0; i<nspace; i++ ) {
+                Py_DECREF( a[i] );
+            }
+        } else
+#endif
+        {
+            for( size_t ip=0; ip<size; ip++ ) {
+                size_t r = ip;
+                for( int i=nvar-1; i>=0; i-- ) {
+                    x[i] = min[i] + ( r % n[i] ) * step[i];
+                    r /= n[i];
+                }
+                ( *values )[ip] = pythonValueAt( x, time_variable );
+            }
+        }
+    
+        // Verify the interpolation at the centers of some cells, picked pseudo-randomly
+        tabulated = new Function_Tabulated( function_, time_variable, min, step, n, values );
+        double scale = 0.;
+        error = 0.;
+        for( size_t ip=0; ip<size; ip++ ) {
+            scale = std::max( scale, std::abs( ( *values )[ip] ) );
+        }
+        uint64_t state = 1;
+        unsigned int ncheck = std::min( ( size_t ) 1000, size );
+        for( unsigned int k=0; k<ncheck; k++ ) {
+            for( unsigned int i=0; i<nvar; i++ ) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                x[i] = min[i] + ( ( double )( ( state >> 33 ) % ( n[i]-1 ) ) + 0.5 ) * step[i];
+            }
+            double interpolated;
+            tabulated->interpolate( &x[0], interpolated );
+            error = std::max( error, std::abs( interpolated - pythonValueAt( x, time_variable ) ) );
+        }
+        if( scale > 0. ) {
+            error /= scale;
+        }
+        
+        if( error <= params.profile_tabulation_tolerance ) {
+            break;
+        }
+        tabulated->releasePython();
+        delete tabulated;
+        tabulated = NULL;
+        if( coarsened || refinement >= 8. ) {
+            break;
+        }
+    }
+    
+    std::ostringstream info( "" );
+    if( tabulated ) {
+        function_ = tabulated;
+        tabulated_ = true;
+    } else {
+        info << " (not tabulated: relative error " << error << ")";
+    }
+    tabulation_info_ = info.str();
+}
@@ -63,6 +63,18 @@ public:
     //! Get the complex value of the profile at several locations (spatial + times)
     void complexValuesAtTimes( std::vector<Field *> &coordinates, Field *time, cField &ret );
     
+    //! Replace a python profile by a multilinear interpolation of its values sampled on a regular grid, if
+    //! Main.profile_tabulation>0 and if the error at the centers of the grid cells is within the tolerance.
+    //! The variables are the coordinates along the given axes of the box, followed by the time if time_variable.
+    //! The box is extended along x by the largest displacement of the moving window.
+    void tabulate( Params &params, std::vector<unsigned int> axes, bool time_variable );
+    
+    //! Whether the profile is interpolated from a table (it may then be evaluated by several threads)
+    bool isTabulated()
+    {
+        return tabulated_;
+    }
+    
     //! Get info on the loaded profile, to be printed later
     std::string getInfo()
     {
@@ -83,6 +95,7 @@ public:
         if( function_ ) {
             info << function_->getInfo();
         }
+        info << tabulation_info_;
         
         return info.str();
     };
@@ -92,6 +105,12 @@ public:
     {
         return profileName_;
     }
+    
+    //! Whether the profile is taken from a file
+    bool usesFile()
+    {
+        return uses_file_;
+    }
 
 private:
     
@@ -101,6 +120,9 @@ private:
     //! Object that holds the information on the profile function
     Function *function_;
     
+    //! Value of the python function at the point x (the last variable being the time if time_variable)
+    double pythonValueAt( std::vector<double> &x, bool time_variable );
+    
     //! Number of variables for the profile function
     int nvariables_;
     
@@ -111,6 +133,12 @@ private:
     bool uses_file_;
     std::string filename_;
     
+    //! Whether the python profile has been replaced by a Function_Tabulated
+    bool tabulated_;
+    
+    //! Outcome of the tabulation, when it was not possible
+    std::string tabulation_info_;
+    
 };//END class Profile
 
 
@@ -667,7 +667,7 @@ void Projector3D2OrderV::susceptibility( ElectroMagn *EMfields, Particles &parti
             inv_gamma_ponderomotive[istart0 + ipart - ipart_ref] = 1./gamma_ponderomotive;
 
             // susceptibility for the macro-particle
-            charge_weight[ipart] = c*c*inv_cell_volume * weight[istart0+ipart]*one_over_mass*inv_gamma_ponderomotive[ipart-ipart_ref] ;
+            charge_weight[ipart] = c*c*inv_cell_volume * weight[istart0+ipart]*one_over_mass*inv_gamma_ponderomotive[istart0 + ipart - ipart_ref] ;
 
             // variable declaration
             double xpn, ypn, zpn;
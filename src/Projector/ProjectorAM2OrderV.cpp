@@ -20,6 +20,8 @@ using namespace std;
 ProjectorAM2OrderV::ProjectorAM2OrderV( Params &params, Patch *patch ) : ProjectorAM( params, patch )
 {
     dt = params.timestep;
+    dts2 = params.timestep/2.;
+    dts4 = params.timestep/4.;
     dr = params.cell_length[1];
     dl_inv_   = 1.0/params.cell_length[0];
     dl_ov_dt_  = params.cell_length[0] / params.timestep;
@@ -639,8 +641,132 @@ void ProjectorAM2OrderV::currentsAndDensityWrapper( ElectroMagn *EMfields, Parti
 }
 
 // Project susceptibility
-void ProjectorAM2OrderV::susceptibility( ElectroMagn *EMfields, Particles &particles, double species_mass, SmileiMPI *smpi, int istart, int iend,  int ithread, int icell, int ipart_ref )
+void ProjectorAM2OrderV::susceptibility( ElectroMagn *EMfields, Particles &particles, double species_mass, SmileiMPI *smpi, int istart, int iend,  int ithread, int scell, int ipart_ref )
 {
-    ERROR( "Vectorized projection of the susceptibility for the envelope model is not implemented for AM geometry" );
+    if( istart == iend ) {
+        return;    //Don't treat empty cells.
+    }
+
+    double * __restrict__ Chi_envelope = &( *EMfields->Env_Chi_ )( 0 ) ;
+
+    int iold[2];
+    iold[0] = scell/nscellr_+oversize_[0];
+    iold[1] = ( scell%nscellr_ )+oversize_[1];
+
+    int nparts = smpi->dynamics_invgf[ithread].size();
+    double * __restrict__ Ex       = &( smpi->dynamics_Epart[ithread][0*nparts-ipart_ref] );
+    double * __restrict__ Ey       = &( smpi->dynamics_Epart[ithread][1*nparts-ipart_ref] );
+    double * __restrict__ Ez       = &( smpi->dynamics_Epart[ithread][2*nparts-ipart_ref] );
+    double * __restrict__ Phi      = &( smpi->dynamics_PHIpart[ithread][-ipart_ref] );
+    double * __restrict__ GradPhix = &( smpi->dynamics_GradPHIpart[ithread][0*nparts-ipart_ref] );
+    double * __restrict__ GradPhiy = &( smpi->dynamics_GradPHIpart[ithread][1*nparts-ipart_ref] );
+    double * __restrict__ GradPhiz = &( smpi->dynamics_GradPHIpart[ithread][2*nparts-ipart_ref] );
+    double * __restrict__ inv_gamma_ponderomotive = &( smpi->dynamics_inv_gamma_ponderomotive[ithread][-ipart_ref] );
+
+    double * __restrict__ position_x = particles.getPtrPosition(0);
+    double * __restrict__ position_y = particles.getPtrPosition(1);
+    double * __restrict__ position_z = particles.getPtrPosition(2);
+    double * __restrict__ momentum_x = particles.getPtrMomentum(0);
+    double * __restrict__ momentum_y = particles.getPtrMomentum(1);
+    double * __restrict__ momentum_z = particles.getPtrMomentum(2);
+    double * __restrict__ weight     = particles.getPtrWeight();
+    short  * __restrict__ charge     = particles.getPtrCharge();
+
+    int vecSize = 8;
+    unsigned int bsize = 3*3*vecSize; // primal grid, particles did not yet move (3x3 enough)
+    double bChi[bsize] __attribute__( ( aligned( 64 ) ) );
+    double Sl1[24] __attribute__( ( aligned( 64 ) ) );
+    double Sr1[24] __attribute__( ( aligned( 64 ) ) );
+    double charge_weight[8] __attribute__( ( aligned( 64 ) ) );
+
+    double one_over_mass = 1./species_mass;
+    // Only mode 0 is used: the inverse radius of the 3 nodes around the cell
+    double *invR_local = &( invR_[iold[1]-1] );
+
+    #pragma omp simd
+    for( unsigned int j=0; j<bsize; j++ ) {
+        bChi[j] = 0.;
+    }
+
+    int cell_nparts( ( int )iend-( int )istart );
+
+    for( int ivect=0 ; ivect < cell_nparts; ivect += vecSize ) {
+
+        int np_computed( min( cell_nparts-ivect, vecSize ) );
+        int istart0 = ( int )istart + ivect;
+
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+
+            int i = istart0+ipart;
+            double c = charge[i];
+
+            double charge_over_mass_dts2       = c*dts2*one_over_mass;
+            // ! ponderomotive force is proportional to charge squared and the field is divided by 4 instead of 2
+            double charge_sq_over_mass_sq_dts4 = c*c*dts4*one_over_mass*one_over_mass;
+            // (charge over mass)^2
+            double charge_sq_over_mass_sq      = c*c*one_over_mass*one_over_mass;
+
+            // compute initial ponderomotive gamma
+            double gamma0_sq = 1. + momentum_x[i]*momentum_x[i] + momentum_y[i]*momentum_y[i] + momentum_z[i]*momentum_z[i] + Phi[i]*charge_sq_over_mass_sq ;
+            double gamma0    = sqrt( gamma0_sq ) ;
+            double inv_gamma0_sq = 1./gamma0_sq;
+
+            // ( electric field + ponderomotive force for ponderomotive gamma advance ) scalar multiplied by momentum
+            double pxsm = ( gamma0 * charge_over_mass_dts2*Ex[i] - charge_sq_over_mass_sq_dts4*GradPhix[i] ) * momentum_x[i] * inv_gamma0_sq;
+            double pysm = ( gamma0 * charge_over_mass_dts2*Ey[i] - charge_sq_over_mass_sq_dts4*GradPhiy[i] ) * momentum_y[i] * inv_gamma0_sq;
+            double pzsm = ( gamma0 * charge_over_mass_dts2*Ez[i] - charge_sq_over_mass_sq_dts4*GradPhiz[i] ) * momentum_z[i] * inv_gamma0_sq;
+
+            // update of gamma ponderomotive
+            double inv_gamma_ponderomotive_i = 1./( gamma0 + ( pxsm+pysm+pzsm )*0.5 );
+            // buffer inverse of ponderomotive gamma to use it in ponderomotive momentum pusher
+            inv_gamma_ponderomotive[i] = inv_gamma_ponderomotive_i;
+
+            // susceptibility for the macro-particle
+            charge_weight[ipart] = c*c*inv_cell_volume * weight[i]*one_over_mass*inv_gamma_ponderomotive_i;
+
+            // locate the particle on the primal grid & calculate coeff. S1
+            double delta  = position_x[i] * dl_inv_ - ( double )( iold[0] + i_domain_begin_ );
+            double delta2 = delta*delta;
+            Sl1[0*vecSize+ipart] = 0.5 * ( delta2-delta+0.25 );
+            Sl1[1*vecSize+ipart] = 0.75-delta2;
+            Sl1[2*vecSize+ipart] = 0.5 * ( delta2+delta+0.25 );
+
+            double r = sqrt( position_y[i]*position_y[i] + position_z[i]*position_z[i] );
+            delta  = r * dr_inv_ - ( double )( iold[1] + j_domain_begin_ );
+            delta2 = delta*delta;
+            Sr1[0*vecSize+ipart] = 0.5 * ( delta2-delta+0.25 );
+            Sr1[1*vecSize+ipart] = 0.75-delta2;
+            Sr1[2*vecSize+ipart] = 0.5 * ( delta2+delta+0.25 );
+        }
+
+        #pragma omp simd
+        for( int ipart=0 ; ipart<np_computed; ipart++ ) {
+            UNROLL(3)
+            for( unsigned int i=0 ; i<3 ; i++ ) {
+                UNROLL(3)
+                for( unsigned int j=0 ; j<3 ; j++ ) {
+                    bChi[( i*3+j )*vecSize+ipart] += charge_weight[ipart] * Sl1[i*vecSize+ipart]*Sr1[j*vecSize+ipart] * invR_local[j];
+                }
+            }
+        }
+
+    } // end ivect
+
+    // Reduction of the buffer on the grid
+    int iloc = ( iold[0]-1 )*nprimr_ + iold[1]-1;
+    for( unsigned int i=0 ; i<3 ; i++ ) {
+        #pragma omp simd
+        for( unsigned int j=0 ; j<3 ; j++ ) {
+            double tmpChi = 0.;
+            int ilocal = ( i*3+j )*vecSize;
+            UNROLL(8)
+            for( int ipart=0 ; ipart<8; ipart++ ) {
+                tmpChi += bChi[ilocal+ipart];
+            }
+            Chi_envelope[iloc+j] += tmpChi;
+        }
+        iloc += nprimr_;
+    }
 }
 
@@ -43,6 +43,9 @@ public:
     
 private:
 
+    //! Half and quarter of the timestep, for the ponderomotive gamma in the susceptibility
+    double dts2, dts4;
+
     inline void __attribute__((always_inline)) compute_distances(  double * __restrict__ position_x,
                                                                    double * __restrict__ position_y,
                                                                    double * __restrict__ position_z,
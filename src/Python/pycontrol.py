@@ -52,15 +52,19 @@ def _smilei_check():
         if len(Checkpoints.restart_files) == 0 :
             Checkpoints.restart = True
             pattern = Checkpoints.restart_dir + os.sep + "checkpoints" + os.sep
+            # files shared by all ranks are never grouped in sub-directories
+            shared_files = glob(pattern + "dump-*.h5")
             if Checkpoints.file_grouping:
                 pattern += "*"+ os.sep
             pattern += "dump-*-*.h5"
             # pick those file that match the mpi rank
             files = filter(lambda a: smilei_mpi_rank==int(search(r'dump-[0-9]*-([0-9]*).h5$',a).groups()[-1]), glob(pattern))
+            # and those shared by all ranks
+            files = list(files) + [a for a in shared_files if search(r'dump-[0-9]*.h5$',a)]
             
             if Checkpoints.restart_number is not None:
                 # pick those file that match the restart_number
-                files = filter(lambda a: Checkpoints.restart_number==int(search(r'dump-([0-9]*)-[0-9]*.h5$',a).groups()[-1]), files)
+                files = filter(lambda a: Checkpoints.restart_number==int(search(r'dump-([0-9]*)(-[0-9]*)?.h5$',a).groups()[0]), files)
             
             Checkpoints.restart_files = list(files)
             
@@ -152,7 +156,7 @@ def _keep_python_running():
         return True
     # Verify the tracked species that require a particle selection
     for d in DiagTrackParticles:
-        if d.filter is not None:
+        if callable(d.filter):
             return True
     # Verify the particle binning having a function for deposited_quantity or axis type
     for d in DiagParticleBinning._list + DiagScreen._list:
@@ -187,6 +187,7 @@ class Main(SmileiSingleton):
     solve_poisson = True
     poisson_max_iteration = 50000
     poisson_max_error = 1.e-14
+    poisson_preconditioner = "none"
 
     # Relativistic Poisson tuning
     solve_relativistic_poisson = False
@@ -207,6 +208,8 @@ class Main(SmileiSingleton):
     print_every = None
     random_seed = None
     print_expected_disk_usage = True
+    profile_tabulation = 0
+    profile_tabulation_tolerance = 1e-4
 
     terminal_mode = True
 
@@ -346,6 +349,9 @@ class Checkpoints(SmileiSingleton):
     dump_deflate = 0
     exit_after_dump = True
     file_grouping = 0
+    full_dump_every = 1
+    shared_file = False
+    aggregators_per_node = 0
     restart_files = []
 
 class CurrentFilter(SmileiSingleton):
@@ -400,6 +406,14 @@ class Species(SmileiComponent):
     merge_discretization_scale = "linear"
     merge_min_momentum = 1e-5
 
+    # Particle splitting species Parameters
+    splitting_method = "none"
+    split_every = 0
+    split_min_particles_per_cell = 4
+    split_number = 2
+    split_min_weight = 0.
+    split_displacement = 0.25
+
     time_frozen = 0.0
     radiating = False
     relativistic_field_initialization = False
@@ -463,6 +477,7 @@ class Collisions(SmileiComponent):
     every = 1
     debug_every = 0
     time_frozen = 0
+    cells_per_bin = 1
     ionizing = False
     nuclear_reaction = None
     nuclear_reaction_multiplier = 0.
@@ -480,6 +495,7 @@ class DiagProbe(SmileiComponent):
     fields = []
     flush_every = 1
     time_integral = False
+    staging_buffers = 0
 
 class DiagParticleBinning(SmileiComponent):
     """Particle Binning diagnostic"""
@@ -488,6 +504,7 @@ class DiagParticleBinning(SmileiComponent):
     time_average = 1
     species = None
     axes = []
+    filter = None
     every = None
     flush_every = 1
 
@@ -529,6 +546,9 @@ class DiagFields(SmileiComponent):
     time_average = 1
     subgrid = None
     flush_every = 1
+    staging_buffers = 0
+    chunk_patches = 0
+    deflate = 0
 
 class DiagTrackParticles(SmileiComponent):
     """Track diagnostic"""
@@ -538,12 +558,16 @@ class DiagTrackParticles(SmileiComponent):
     flush_every = 1
     filter = None
     attributes = ["x", "y", "z", "px", "py", "pz", "w"]
+    staging_buffers = 0
 
 class DiagPerformances(SmileiSingleton):
     """Performances diagnostic"""
     every = 0
     flush_every = 1
     patch_information = True
+    patch_profiling = False
+    profiling_trace = False
+    hardware_counters = False
 
 # external fields
 class ExternalField(SmileiComponent):
@@ -112,67 +112,117 @@ void RadiationMonteCarlo::operator()(
     // Optical depth for the Monte-Carlo process
     double *const __restrict__ chi = &( particles.chi(0));
     
-    // Photon properties ----------------------------------------------------------------
-    
-    // Number of photons
-    int nphotons;
-    
-    if (photons) {
-        nphotons = photons->size();
-        // We reserve a large number of potential particles since we can't reallocate on device
-        photons->reserve( nphotons + radiation_photon_sampling_ * (iend - istart) * max_photon_emissions_ );
-    } else {
-        nphotons = 0;
+    // Thresholds and table data for the vectorized pass
+    const double minimum_chi_discontinuous = RadiationTables.getMinimumChiDiscontinuous();
+    const double minimum_chi_continuous    = RadiationTables.getMinimumChiContinuous();
+
+    // Time already spent in the Monte-Carlo loop by each particle after the first pass
+    if( local_time_.size() < ( unsigned int )( iend - istart ) ) {
+        local_time_.resize( iend - istart );
     }
-    
-    // Photon position shortcut
-    double *const __restrict__ photon_position_x = photons ? photons->getPtrPosition( 0 ) : nullptr;
-    double *const __restrict__ photon_position_y = photons ? (nDim_ > 1 ? photons->getPtrPosition( 1 ) : nullptr) : nullptr;
-    double *const __restrict__ photon_position_z = photons ? (nDim_ > 2 ? photons->getPtrPosition( 2 ) : nullptr) : nullptr;
+    double *const __restrict__ local_time = &local_time_[0] - istart;
 
-    // Particles Momentum shortcut
-    double *const __restrict__ photon_momentum_x = photons ? photons->getPtrMomentum(0) : nullptr;
-    double *const __restrict__ photon_momentum_y = photons ? photons->getPtrMomentum(1) : nullptr;
-    double *const __restrict__ photon_momentum_z = photons ? photons->getPtrMomentum(2) : nullptr;
+    emitting_.resize( 0 );
+    emission_particle_.resize( 0 );
+    emission_px_.resize( 0 );
+    emission_py_.resize( 0 );
+    emission_pz_.resize( 0 );
+    emission_chi_.resize( 0 );
 
-    // Charge shortcut
-    short *const __restrict__ photon_charge = photons ? photons->getPtrCharge() : nullptr;
+    // _______________________________________________________________
+    // First pass (vectorized): first Monte-Carlo iteration of all particles.
+    // The optical depth advances and the continuous radiation reaction is applied,
+    // but particles that must draw a new optical depth or that reach the end
+    // of their optical depth are only flagged (local time < dt)
 
-    // Weight shortcut
-    double *const __restrict__ photon_weight = photons ? photons->getPtrWeight() : nullptr;
+    #pragma omp simd reduction(+:radiated_energy)
+    for( int ipart=istart ; ipart<iend; ipart++ ) {
 
-    // Quantum Parameter
-    double *const __restrict__ photon_chi_array = photons ? (photons->isQuantumParameter ? photons->getPtrChi() : nullptr) : nullptr;
-    
-    double *const __restrict__ photon_tau = photons ? (photons->isMonteCarlo ? photons->getPtrTau() : nullptr) : nullptr;
+        // charge / mass^2
+        const double charge_over_mass_square = ( double )( charge[ipart] )*one_over_mass_square;
+
+        // Gamma
+        const double particle_gamma = std::sqrt( 1.0 + momentum_x[ipart]*momentum_x[ipart]
+                      + momentum_y[ipart]*momentum_y[ipart]
+                      + momentum_z[ipart]*momentum_z[ipart] );
 
-    // Table properties ----------------------------------------------------------------
+        // Computation of the Lorentz invariant quantum parameter
+        const double particle_chi = Radiation::computeParticleChi( charge_over_mass_square,
+                       momentum_x[ipart], momentum_y[ipart], momentum_z[ipart],
+                       particle_gamma,
+                       Ex[ipart-ipart_ref], Ey[ipart-ipart_ref], Ez[ipart-ipart_ref],
+                       Bx[ipart-ipart_ref], By[ipart-ipart_ref], Bz[ipart-ipart_ref] );
+        chi[ipart] = particle_chi;
+
+        // does not apply the MC routine for particles with 0 kinetic energy,
+        // nor for particles that do not radiate (chi = 0, for instance outside the fields)
+        const bool active = particle_gamma >= 1.1 && particle_chi > 0.;
+
+        // The tables are only evaluated with the values of the active particles,
+        // the others get harmless values that are discarded below
+        const double masked_chi = active ? particle_chi : 1.;
+        const double masked_gamma = active ? particle_gamma : 1.1;
+
+        // Discontinuous emission: new optical depth to draw
+        const bool new_emission = active && particle_chi > minimum_chi_discontinuous && tau[ipart] <= epsilon_tau_;
+
+        // Discontinuous emission: emission under progress
+        const bool discontinuous = active && tau[ipart] > epsilon_tau_;
+        const double yield = RadiationTables.computePhotonProductionYield( masked_chi, masked_gamma );
+        const double emission_time = discontinuous ? std::min( tau[ipart]/yield, dt_ ) : dt_;
+        tau[ipart] = discontinuous ? tau[ipart] - yield*emission_time : tau[ipart];
+
+        // Continuous emission
+        const bool continuous = active && !discontinuous && !new_emission && particle_chi > minimum_chi_continuous;
+        const double continuous_energy = RadiationTables.getRidgersCorrectedRadiatedEnergy( masked_chi, dt_ );
+        const double recoil = continuous ? continuous_energy*particle_gamma/( particle_gamma*particle_gamma-1. ) : 0.;
+        momentum_x[ipart] -= recoil*momentum_x[ipart];
+        momentum_y[ipart] -= recoil*momentum_y[ipart];
+        momentum_z[ipart] -= recoil*momentum_z[ipart];
+        radiated_energy += continuous ? weight[ipart]*( particle_gamma - std::sqrt( 1.0
+                                         + momentum_x[ipart]*momentum_x[ipart]
+                                         + momentum_y[ipart]*momentum_y[ipart]
+                                         + momentum_z[ipart]*momentum_z[ipart] ) ) : 0.;
+
+        local_time[ipart] = new_emission ? 0. : ( discontinuous ? emission_time : dt_ );
+    }
 
-    // Tables for MC
-    // const double *const table_integfochi = &(RadiationTables.integfochi_.data_[0]);
-    // const double *const table_min_photon_chi = &(RadiationTables.xi_.axis1_min_[0]);
-    // double * table_xi = &(RadiationTables.xi_.table_[0]);
+    // Compact list of the particles that continue the Monte-Carlo loop
+    // (usually a small fraction of the particles)
+    for( int ipart=istart ; ipart<iend; ipart++ ) {
+        if( local_time[ipart] < dt_ ) {
+            emitting_.push_back( ipart );
+        }
+    }
 
     // _______________________________________________________________
-    // Computation
+    // Second pass: emission, and next Monte-Carlo iterations, for the listed particles
+
+    for( unsigned int i=0 ; i<emitting_.size(); i++ ) {
+
+        const int ipart = emitting_[i];
 
-    for( int ipart=istart ; ipart<iend; ipart++ ) {
-        
         // charge / mass^2
         const double charge_over_mass_square = ( double )( charge[ipart] )*one_over_mass_square;
 
-        // Time to emission
-        double emission_time = 0;
-        
         // time spent in the iteration
-        double local_it_time = 0;
-        
-        // Number of Monte-Carlo iteration
-        int mc_it_nb = 0;
-        
+        double local_it_time = local_time[ipart];
+
+        // Number of Monte-Carlo iteration (the first pass has done one iteration if some time was spent)
+        int mc_it_nb = local_it_time > 0. ? 1 : 0;
+
         // Number of emitted photons per particles
         int i_photon_emission = 0;
 
+        // The final optical depth was reached during the first pass
+        if( mc_it_nb > 0 && tau[ipart] <= epsilon_tau_ ) {
+            const double particle_gamma = std::sqrt( 1.0 + momentum_x[ipart]*momentum_x[ipart]
+                          + momentum_y[ipart]*momentum_y[ipart]
+                          + momentum_z[ipart]*momentum_z[ipart] );
+            emitPhoton( particles, photons, RadiationTables, ipart, chi[ipart], particle_gamma,
+                        i_photon_emission, radiated_energy );
+        }
+
         // Monte-Carlo Manager inside the time step
         while( ( local_it_time < dt_ )
                 &&( mc_it_nb < max_monte_carlo_iterations_ ) ) {
@@ -193,18 +243,14 @@ void RadiationMonteCarlo::operator()(
                            Ex[ipart-ipart_ref], Ey[ipart-ipart_ref], Ez[ipart-ipart_ref],
                            Bx[ipart-ipart_ref], By[ipart-ipart_ref], Bz[ipart-ipart_ref] );
 
-            // Update the quantum parameter in species
-            // chi[ipart] = particle_chi;
-
             // Discontinuous emission: New emission
             // If tau[ipart] <= 0, this is a new emission
             // We also check that particle_chi > chipa_threshold,
             // else particle_chi is too low to induce a discontinuous emission
-            if( ( particle_chi > RadiationTables.getMinimumChiDiscontinuous() )
+            if( ( particle_chi > minimum_chi_discontinuous )
                     && ( tau[ipart] <= epsilon_tau_ ) ) {
                 // New final optical depth to reach for emision
                 while( tau[ipart] <= epsilon_tau_ ) {
-                    //tau[ipart] = -log( 1.-Rand::uniform() );
                     tau[ipart] = -std::log( 1.-rand_->uniform() );
                 }
 
@@ -215,128 +261,22 @@ void RadiationMonteCarlo::operator()(
             if( tau[ipart] > epsilon_tau_ ) {
 
                 // from the cross section
-                temp = RadiationTables.computePhotonProductionYield( 
-                                              particle_chi, 
+                temp = RadiationTables.computePhotonProductionYield(
+                                              particle_chi,
                                               particle_gamma);
 
                 // Time to discontinuous emission
                 // If this time is > the remaining iteration time,
                 // we have a synchronization
-                emission_time = std::min( tau[ipart]/temp, dt_ - local_it_time );
+                const double emission_time = std::min( tau[ipart]/temp, dt_ - local_it_time );
 
                 // Update of the optical depth
                 tau[ipart] -= temp*emission_time;
 
                 // If the final optical depth is reached, photons are emitted
                 if( tau[ipart] <= epsilon_tau_ ) {
-
-                    // Emission of a photon
-                    // Radiated energy is incremented only if the macro-photon is not created
-
-                    double xi = rand_->uniform();
-
-                    // Get the photon quantum parameter from the table xip
-                    // photon_chi = RadiationTables.computeRandomPhotonChi( particle_chi );
-                    double photon_chi = RadiationTables.computeRandomPhotonChiWithInterpolation( particle_chi, xi);
-
-                    // compute the photon gamma factor
-                    double photon_gamma = photon_chi/particle_chi*( particle_gamma-1.0 );
-
-                    // *****************************************************************
-                    // Creation of the new photon
-
-                    // Update of the particle properties
-                    // direction d'emission // direction de l'electron (1/gamma << 1)
-                    // With momentum conservation
-                    double inv_old_norm_p = photon_gamma/std::sqrt( particle_gamma*particle_gamma - 1.0 );
-                    momentum_x[ipart] -= momentum_x[ipart]*inv_old_norm_p;
-                    momentum_y[ipart] -= momentum_y[ipart]*inv_old_norm_p;
-                    momentum_z[ipart] -= momentum_z[ipart]*inv_old_norm_p;
-
-                    // With energy conservation
-                    /*inv_old_norm_p = 1./sqrt(particle_gamma*particle_gamma - 1.0);
-                    particle_gamma -= photon_gamma;
-                    new_norm_p = sqrt(particle_gamma*particle_gamma - 1.0);
-                    px *= new_norm_p * inv_old_norm_p;
-                    py *= new_norm_p * inv_old_norm_p;
-                    pz *= new_norm_p * inv_old_norm_p;*/
-
-                    // Creation of macro-photons if requested
-                    // Check that the photons is defined and the threshold on the energy
-                    if(          photons
-                            && ( photon_gamma >= radiation_photon_gamma_threshold_ ) 
-                            && ( i_photon_emission < max_photon_emissions_)) {
-                                
-                        // Creation of new photons in the temporary array photons
-                        photons->createParticles( radiation_photon_sampling_ );
-                        
-                        // New number of photons
-                        nphotons += radiation_photon_sampling_;
-
-                        // Inverse of the momentum norm
-                        inv_old_norm_p = 1./std::sqrt( momentum_x[ipart]*momentum_x[ipart]
-                                                  + momentum_y[ipart]*momentum_y[ipart]
-                                                  + momentum_z[ipart]*momentum_z[ipart] );
-
-                        // For all new photons
-                        for( auto iphoton=nphotons-radiation_photon_sampling_; iphoton<nphotons; iphoton++ ) {
-
-                            // std::cerr  << photons << " "
-                            //            << iphoton << " " 
-                            //            << photons->size() << " " 
-                            //            << radiation_photon_sampling_ << " " 
-                            //            << ipart << " "
-                            //            << photon_position_x << " "
-                            //            << photons->getPtrPosition( 0 ) << " "
-                            //            << std::endl;
-
-                            photon_position_x[iphoton]=position_x[ipart];
-                            if (nDim_>1) {
-                                photon_position_y[iphoton]=position_y[ipart];
-                                if (nDim_>2) {
-                                    photon_position_z[iphoton]=position_z[ipart];
-                                }
-                            }
-
-                            photon_momentum_x[iphoton] =
-                                photon_gamma*momentum_x[ipart]*inv_old_norm_p;
-                            photon_momentum_y[iphoton] =
-                                photon_gamma*momentum_y[ipart]*inv_old_norm_p;
-                            photon_momentum_z[iphoton] =
-                                photon_gamma*momentum_z[ipart]*inv_old_norm_p;
-
-
-                            photon_weight[iphoton] = weight[ipart]*inv_radiation_photon_sampling_;
-                            photon_charge[iphoton] = 0;
-
-                            if( photons->isQuantumParameter ) {
-                                photon_chi_array[iphoton] = photon_chi;
-                            }
-
-                            if( photons->isMonteCarlo ) {
-                                photon_tau[iphoton] = -1.;
-                            }
-
-                        } // end for iphoton
-                        
-                        // Number of emitted photons
-                        i_photon_emission += 1;
-                        
-                    }
-                    // If no emiision of a macro-photon:
-                    // Addition of the emitted energy in the cumulating parameter
-                    // for the scalar diagnostics
-                    else {
-                        photon_gamma = particle_gamma - std::sqrt( 1.0 + momentum_x[ipart]*momentum_x[ipart]
-                                                         + momentum_y[ipart]*momentum_y[ipart]
-                                                         + momentum_z[ipart]*momentum_z[ipart] );
-                        radiated_energy += weight[ipart]*photon_gamma;
-                    }
-
-                    // Optical depth becomes negative meaning
-                    // that a new drawing is possible
-                    // at the next Monte-Carlo iteration
-                    tau[ipart] = -1.;
+                    emitPhoton( particles, photons, RadiationTables, ipart, particle_chi, particle_gamma,
+                                i_photon_emission, radiated_energy );
                 }
 
                 // Incrementation of the Monte-Carlo iteration counter
@@ -351,12 +291,12 @@ void RadiationMonteCarlo::operator()(
             // particle_chi needs to be above the continuous thresholdF
             // No discontiuous emission is in progress:
             // tau[ipart] <= epsilon_tau_
-            else if( particle_chi <=  RadiationTables.getMinimumChiDiscontinuous()
+            else if( particle_chi <= minimum_chi_discontinuous
                      && tau[ipart] <= epsilon_tau_
-                     && particle_chi >  RadiationTables.getMinimumChiContinuous() ) {
+                     && particle_chi > minimum_chi_continuous ) {
 
                 // Remaining time of the iteration
-                emission_time = dt_ - local_it_time;
+                const double emission_time = dt_ - local_it_time;
 
                 // Radiated energy during emission_time
                 cont_rad_energy =
@@ -387,6 +327,79 @@ void RadiationMonteCarlo::operator()(
 
     }
 
+    // _______________________________________________________________
+    // Creation of all the macro-photons at once
+
+    const int nemissions = emission_particle_.size();
+    if( photons && nemissions > 0 ) {
+
+        const int nphotons = photons->size();
+        photons->createParticles( nemissions * radiation_photon_sampling_ );
+
+        // Photon position shortcut
+        double *const __restrict__ photon_position_x = photons->getPtrPosition( 0 );
+        double *const __restrict__ photon_position_y = nDim_ > 1 ? photons->getPtrPosition( 1 ) : nullptr;
+        double *const __restrict__ photon_position_z = nDim_ > 2 ? photons->getPtrPosition( 2 ) : nullptr;
+
+        // Photon momentum shortcut
+        double *const __restrict__ photon_momentum_x = photons->getPtrMomentum(0);
+        double *const __restrict__ photon_momentum_y = photons->getPtrMomentum(1);
+        double *const __restrict__ photon_momentum_z = photons->getPtrMomentum(2);
+
+        // Charge shortcut
+        short *const __restrict__ photon_charge = photons->getPtrCharge();
+
+        // Weight shortcut
+        double *const __restrict__ photon_weight = photons->getPtrWeight();
+
+        // Quantum Parameter
+        double *const __restrict__ photon_chi_array = photons->isQuantumParameter ? photons->getPtrChi() : nullptr;
+
+        double *const __restrict__ photon_tau = photons->isMonteCarlo ? photons->getPtrTau() : nullptr;
+
+        const int *const __restrict__ emission_particle = &emission_particle_[0];
+        const double *const __restrict__ emission_px = &emission_px_[0];
+        const double *const __restrict__ emission_py = &emission_py_[0];
+        const double *const __restrict__ emission_pz = &emission_pz_[0];
+        const double *const __restrict__ emission_chi = &emission_chi_[0];
+
+        // Each emission creates radiation_photon_sampling_ identical macro-photons
+        #pragma omp simd
+        for( int iphoton=0; iphoton<nemissions * radiation_photon_sampling_; iphoton++ ) {
+            const int iemission = iphoton / radiation_photon_sampling_;
+            const int ipart = emission_particle[iemission];
+
+            photon_position_x[nphotons+iphoton] = position_x[ipart];
+            if( nDim_>1 ) {
+                photon_position_y[nphotons+iphoton] = position_y[ipart];
+                if( nDim_>2 ) {
+                    photon_position_z[nphotons+iphoton] = position_z[ipart];
+                }
+            }
+
+            photon_momentum_x[nphotons+iphoton] = emission_px[iemission];
+            photon_momentum_y[nphotons+iphoton] = emission_py[iemission];
+            photon_momentum_z[nphotons+iphoton] = emission_pz[iemission];
+
+            photon_weight[nphotons+iphoton] = weight[ipart]*inv_radiation_photon_sampling_;
+            photon_charge[nphotons+iphoton] = 0;
+        }
+
+        if( photons->isQuantumParameter ) {
+            #pragma omp simd
+            for( int iphoton=0; iphoton<nemissions * radiation_photon_sampling_; iphoton++ ) {
+                photon_chi_array[nphotons+iphoton] = emission_chi[iphoton / radiation_photon_sampling_];
+            }
+        }
+
+        if( photons->isMonteCarlo ) {
+            #pragma omp simd
+            for( int iphoton=0; iphoton<nemissions * radiation_photon_sampling_; iphoton++ ) {
+                photon_tau[nphotons+iphoton] = -1.;
+            }
+        }
+    }
+
     // ____________________________________________________
     // Update of the quantum parameter chi
 
@@ -408,3 +421,72 @@ void RadiationMonteCarlo::operator()(
 
     }
 }
+
+// ---------------------------------------------------------------------------------------------------------------------
+//! Emission of a photon by a particle that reached its final optical depth:
+//! the photon quantum parameter is drawn, the recoil is applied to the particle
+//! and the emission is stored to create the macro-photons at the end of the operator.
+//! If the macro-photon is not created, the radiated energy is incremented instead.
+// ---------------------------------------------------------------------------------------------------------------------
+void RadiationMonteCarlo::emitPhoton(
+    Particles       &particles,
+    Particles       *photons,
+    RadiationTables &RadiationTables,
+    int             ipart,
+    double          particle_chi,
+    double          particle_gamma,
+    int             &i_photon_emission,
+    double          &radiated_energy )
+{
+    double &px = particles.momentum( 0, ipart );
+    double &py = particles.momentum( 1, ipart );
+    double &pz = particles.momentum( 2, ipart );
+
+    double xi = rand_->uniform();
+
+    // Get the photon quantum parameter from the table xip
+    double photon_chi = RadiationTables.computeRandomPhotonChiWithInterpolation( particle_chi, xi );
+
+    // compute the photon gamma factor
+    double photon_gamma = photon_chi/particle_chi*( particle_gamma-1.0 );
+
+    // Update of the particle properties
+    // direction d'emission // direction de l'electron (1/gamma << 1)
+    // With momentum conservation
+    double inv_old_norm_p = photon_gamma/std::sqrt( particle_gamma*particle_gamma - 1.0 );
+    px -= px*inv_old_norm_p;
+    py -= py*inv_old_norm_p;
+    pz -= pz*inv_old_norm_p;
+
+    // Creation of macro-photons if requested
+    // Check that the photons is defined and the threshold on the energy
+    if(          photons
+            && ( photon_gamma >= radiation_photon_gamma_threshold_ )
+            && ( i_photon_emission < max_photon_emissions_ ) ) {
+
+        // Inverse of the momentum norm
+        inv_old_norm_p = 1./std::sqrt( px*px + py*py + pz*pz );
+
+        emission_particle_.push_back( ipart );
+        emission_px_.push_back( photon_gamma*px*inv_old_norm_p );
+        emission_py_.push_back( photon_gamma*py*inv_old_norm_p );
+        emission_pz_.push_back( photon_gamma*pz*inv_old_norm_p );
+        emission_chi_.push_back( photon_chi );
+
+        // Number of emitted photons
+        i_photon_emission += 1;
+
+    }
+    // If no emiision of a macro-photon:
+    // Addition of the emitted energy in the cumulating parameter
+    // for the scalar diagnostics
+    else {
+        photon_gamma = particle_gamma - std::sqrt( 1.0 + px*px + py*py + pz*pz );
+        radiated_energy += particles.weight( ipart )*photon_gamma;
+    }
+
+    // Optical depth becomes negative meaning
+    // that a new drawing is possible
+    // at the next Monte-Carlo iteration
+    particles.tau( ipart ) = -1.;
+}
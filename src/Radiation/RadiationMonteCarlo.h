@@ -82,6 +82,25 @@ protected:
     //! Espilon to check when tau is near 0
     const double epsilon_tau_ = 1e-100;
 
+    //! Emission of a photon by the particle ipart, which has reached its final optical depth
+    void emitPhoton(
+        Particles       &particles,
+        Particles       *photons,
+        RadiationTables &RadiationTables,
+        int             ipart,
+        double          particle_chi,
+        double          particle_gamma,
+        int             &i_photon_emission,
+        double          &radiated_energy );
+
+    //! Time spent in the Monte-Carlo loop by each particle after the first (vectorized) pass
+    std::vector<double> local_time_;
+    //! Compact list of the particles that continue the Monte-Carlo loop after the first pass
+    std::vector<int> emitting_;
+    //! Emissions of macro-photons: emitting particle, photon momentum and quantum parameter
+    std::vector<int> emission_particle_;
+    std::vector<double> emission_px_, emission_py_, emission_pz_, emission_chi_;
+
 private:
 
 };
@@ -157,22 +157,8 @@ void RadiationNiel::operator()(
     }*/
 
     // Vectorized computation of the random number in a uniform distribution
-    // #pragma omp simd
-    for( ipart=0 ; ipart < nbparticles; ipart++ ) {
-
-        // Below particle_chi = minimum_chi_continuous_, radiation losses are negligible
-        if( particle_chi[ipart+istart] > minimum_chi_continuous ) {
-
-            // Pick a random number in the normal distribution of standard
-            // deviation sqrt(dt_) (variance dt_)
-            //random_numbers[ipart] = 2.*Rand::uniform() -1.;
-            //random_numbers[ipart] = 2.*drand48() -1.;
-            random_numbers[ipart] = rand_->uniform2();
-        }
-        // else {
-        //     random_numbers[ipart] = 0;
-        // }
-    }
+    // (also drawn for particles below minimum_chi_continuous_, where they are not used)
+    rand_->uniform2( nbparticles, random_numbers );
 
     // Vectorized computation of the random number in a normal distribution
     double p;
@@ -215,20 +201,18 @@ void RadiationNiel::operator()(
     //double t2 = MPI_Wtime();
 
     // Computation of the diffusion coefficients
-    // Using the table (non-vectorized)
+    // Using the table (vectorized lookup of all particles at once)
     if( niel_computation_method == 0 ) {
-        // #pragma omp simd
+
+        RadiationTables.niel_.get( nbparticles, &particle_chi[istart], diffusion );
+
+        #pragma omp simd
         for( ipart=0 ; ipart < nbparticles; ipart++ ) {
 
             // Below particle_chi = minimum_chi_continuous_, radiation losses are negligible
             if( particle_chi[ipart+istart] > minimum_chi_continuous ) {
 
-                //h = RadiationTables.getHNielFitOrder10(particle_chi[ipart]);
-                //h = RadiationTables.getHNielFitOrder5(particle_chi[ipart]);
-                //temp = RadiationTables.getHNielFromTable( particle_chi[ipart+istart] );
-                temp = RadiationTables.niel_.get( particle_chi[ipart+istart] );
-
-                diffusion[ipart] = std::sqrt( factor_classical_radiated_power*gamma[ipart+istart-ipart_ref]*temp )*random_numbers[ipart];
+                diffusion[ipart] = std::sqrt( factor_classical_radiated_power*gamma[ipart+istart-ipart_ref]*diffusion[ipart] )*random_numbers[ipart];
             }
         }
     }
@@ -214,47 +214,6 @@ void RadiationTables::initialization( Params &params , SmileiMPI *smpi )
 // PHYSICAL COMPUTATION
 // -----------------------------------------------------------------------------
 
-// ---------------------------------------------------------------------------------------------------------------------
-//! Computation of the Cross Section dNph/dt which is also
-//! the number of photons generated per time unit.
-//
-//! param[in] particle_chi particle quantum parameter
-//! param[in] particle_gamma particle Lorentz factor
-//! param[in] integfochi table of the discretized integrated f/chi function for Photon production yield computation
-// ---------------------------------------------------------------------------------------------------------------------
-double RadiationTables::computePhotonProductionYield( 
-                                            const double particle_chi, 
-                                            const double particle_gamma)
-{
-    // final value
-    double dNphdt;
-
-    // Log of the particle quantum parameter particle_chi
-    const double logchipa = std::log10( particle_chi );
-
-    // Lower index for interpolation in the table integfochi_
-    int ichipa = int( std::floor( ( logchipa-integfochi_.log10_min_ )
-                         *integfochi_.inv_delta_ ) );
-
-    // If we are not in the table...
-    if( ichipa < 0 ) {
-        ichipa = 0;
-        dNphdt = integfochi_.data_[ichipa];
-    } else if( ichipa >= integfochi_.size_-1 ) {
-        ichipa = integfochi_.size_-2;
-        dNphdt = integfochi_.data_[ichipa];
-    } else {
-        // Upper and lower values for linear interpolation
-        const double logchipam = ichipa*integfochi_.delta_ + integfochi_.log10_min_;
-        const double logchipap = logchipam + integfochi_.delta_;
-
-        // Interpolation
-        dNphdt = ( integfochi_.data_[ichipa+1]*std::fabs( logchipa-logchipam ) +
-                   integfochi_.data_[ichipa]*std::fabs( logchipap - logchipa ) )*integfochi_.inv_delta_;
-    }
-    return factor_dNph_dt_*dNphdt*particle_chi/particle_gamma;
-}
-
 // -----------------------------------------------------------------------------
 //! Computation of the photon quantum parameter photon_chi for emission
 //! ramdomly and using the tables xi and chiphmin
@@ -412,17 +371,10 @@ double RadiationTables::computeRandomPhotonChiWithInterpolation( double particle
     }
     // Above the last xi of the row, the last one corresponds
     // to the maximal photon photon_chi
-    // else if( xi > table_xi[( ichipa+1 )*xi_.size_photon_chi_-2] ) {
-    //     ichiph = xi_.size_photon_chi_-2;
-    //     xi = table_xi[( ichipa+1 )*xi_.size_photon_chi_-1];
-    // If nearest point: ichiph = xi_.size_photon_chi_-1
-    // }
     else {
-        // Search for the corresponding index ichiph for xi
-        ichiph_1 = userFunctions::searchValuesInMonotonicArray(
-                     &xi_.data_[ichipa*xi_.dim_size_[1]], xi, xi_.dim_size_[1] );
-        ichiph_2 = userFunctions::searchValuesInMonotonicArray(
-                  &xi_.data_[(ichipa+1)*xi_.dim_size_[1]], xi, xi_.dim_size_[1] );
+        // Search for the corresponding index ichiph for xi (inverse of the cumulative distribution)
+        ichiph_1 = xi_.findInRow( ichipa, xi );
+        ichiph_2 = xi_.findInRow( ichipa+1, xi );
     }
 
     // Corresponding particle_chi for ichipa
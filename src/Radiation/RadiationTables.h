@@ -58,8 +58,12 @@ public:
     //! param[in] particle_chi particle quantum parameter
     //! param[in] particle_gamma particle Lorentz factor
     //! param[in] integfochi_table table of the discretized integrated f/chi function for Photon production yield computation
-    double computePhotonProductionYield( const double particle_chi, 
-                                         const double particle_gamma);
+    inline double __attribute__((always_inline)) computePhotonProductionYield( const double particle_chi,
+            const double particle_gamma )
+    {
+        // Out of the table, the closest value is used
+        return factor_dNph_dt_*integfochi_.get( particle_chi )*particle_chi/particle_gamma;
+    };
 
     //! Determine randomly a photon quantum parameter photon_chi
     //! for an emission process
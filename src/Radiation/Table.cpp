@@ -20,6 +20,10 @@ Table::Table()
 // -----------------------------------------------------------------------------
 Table::~Table()
 {
+    if (lookup_) {
+        delete [] lookup_;
+        lookup_ = nullptr;
+    }
     if (data_) {
         delete [] data_;
         data_ = nullptr;
@@ -102,6 +106,12 @@ void Table::compute_parameters() {
     for (auto i = 0; i < dimension_ ; ++i) {
             inv_dim_size_minus_one_[i] = 1.0/( dim_size_[i] - 1. );
     }
+    
+    // First step of the binary search along the last axis
+    search_step_ = 1;
+    while (2*search_step_ <= (int) dim_size_[dimension_-1] - 2) {
+        search_step_ *= 2;
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -116,6 +126,11 @@ void Table::set (std::vector<double> & input_data) {
     for (unsigned int i = 0 ; i < size_ ; i++) {
         data_[i] = input_data[i];
     }
+    
+    // Only 1D tables are interpolated through the lookup
+    if (dimension_ == 1) {
+        compute_lookup();
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -235,21 +250,38 @@ void Table::bcast (SmileiMPI *smpi) {
     // Compute useful parameters from bcast inputs
     compute_parameters();
     
+    if (dimension_ == 1) {
+        compute_lookup();
+    }
+    
 }
 
 // -----------------------------------------------------------------------------
-//! get value using linear interpolation
+//! Prepares the data for the 1D lookups
 // -----------------------------------------------------------------------------
-double Table::get (double x) {
-
-    // Position in the niel_.table
-    double d = ( std::log10( x )-log10_min_ )*inv_delta_;
-    int index = int( std::floor( d ) );
-
-    // distance for interpolation
-    d = d - std::floor( d );
-
-    // Linear interpolation
-    return data_[index]*( 1.-d ) + data_[index+1]*( d );
+void Table::compute_lookup() {
+    
+    if (lookup_) {
+        delete [] lookup_;
+    }
+    lookup_ = new float[2*(size_-1)];
+    for (unsigned int i = 0 ; i < size_-1 ; i++) {
+        lookup_[2*i]   = data_[i];
+        lookup_[2*i+1] = data_[i+1] - data_[i];
+    }
+    
+    // log10(x) = log2(x) * log10(2)
+    log2_factor_ = std::log10( 2. )*inv_delta_;
+    log2_offset_ = -log10_min_*inv_delta_;
 }
 
+// -----------------------------------------------------------------------------
+//! get n values using linear interpolation, in a vectorized loop
+// -----------------------------------------------------------------------------
+void Table::get (unsigned int n, const double * x, double * values) {
+    
+    #pragma omp simd
+    for (unsigned int i = 0 ; i < n ; i++) {
+        values[i] = get( x[i] );
+    }
+}
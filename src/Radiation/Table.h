@@ -9,6 +9,9 @@
 #define TABLE_H
 
 #include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -44,8 +47,61 @@ public:
     //! Compute usefull parameters using inputs
     void compute_parameters();
     
+    //! Fast log2: exponent bits of x, plus a polynomial of the mantissa
+    //! (absolute error < 3e-11). Does not use any table nor branch, so that it vectorizes.
+    static inline double __attribute__((always_inline)) fastLog2( double x )
+    {
+        uint64_t bits;
+        std::memcpy( &bits, &x, sizeof( double ) );
+        double exponent = ( double )( int( ( bits >> 52 ) & 0x7ff ) - 1023 );
+        // Mantissa in [1, 2[, then brought to [sqrt(1/2), sqrt(2)[
+        bits = ( bits & 0x000fffffffffffffULL ) | 0x3ff0000000000000ULL;
+        double m;
+        std::memcpy( &m, &bits, sizeof( double ) );
+        const bool high = m > M_SQRT2;
+        m = high ? 0.5*m : m;
+        exponent = high ? exponent + 1. : exponent;
+        // log(m) = 2 atanh(s), with |s| < 0.172
+        const double s = ( m-1. )/( m+1. );
+        const double s2 = s*s;
+        const double log_m = 2.*s*( 1. + s2*( 1./3. + s2*( 1./5. + s2*( 1./7. + s2*( 1./9. + s2*( 1./11. ) ) ) ) ) );
+        return exponent + log_m*M_LOG2E;
+    }
+
+    //! Position of x in the table, in units of the table step (log-scaled axis)
+    inline double __attribute__((always_inline)) position( double x )
+    {
+        return fastLog2( x )*log2_factor_ + log2_offset_;
+    }
+
     //! get value using linear interpolation at position x
-    double get(double x);
+    //! (the values at the boundaries are used outside of the table)
+    inline double __attribute__((always_inline)) get( double x )
+    {
+        double d = std::min( std::max( position( x ), 0. ), ( double )( size_-1 ) );
+        const int i = std::min( int( d ), ( int ) size_-2 );
+        d -= i;
+        return lookup_[2*i] + d*lookup_[2*i+1];
+    }
+
+    //! get n values at once, in a vectorized loop
+    void get( unsigned int n, const double * x, double * values );
+
+    //! Index i of the interval [data_[i], data_[i+1][ that contains value,
+    //! in the row irow of a 2D table, monotonically increasing along axis 1.
+    //! The result is in [0, dim_size_[1]-2].
+    //! Binary search without branches and with a fixed number of steps, so that it vectorizes.
+    inline int __attribute__((always_inline)) findInRow( unsigned int irow, double value )
+    {
+        const double * row = &data_[irow*dim_size_[1]];
+        const int imax = dim_size_[1]-2;
+        int i = 0;
+        for( int step = search_step_; step > 0; step >>= 1 ) {
+            const int j = std::min( i + step, imax );
+            i = row[j] <= value ? j : i;
+        }
+        return i;
+    }
 
     //! Copy values from input_data to the table data
     //! params[in] std::vector<double> & input_data : vector to be used to initialize table data
@@ -98,6 +154,21 @@ protected:
     
 private:
 
+    //! Prepares the data for the 1D lookups
+    void compute_lookup();
+
+    //! Single-precision copy of the 1D data used by the lookups: for each interval,
+    //! the value at the lower bound and the slope, stored next to each other
+    //! so that a lookup loads only one pair of floats
+    float * lookup_ = nullptr;
+
+    //! Conversion from log2(x) to the position in the table
+    double log2_factor_;
+    double log2_offset_;
+
+    //! First step of the binary search along axis 1 (largest power of 2 below the size)
+    int search_step_;
+
 };
 
 
@@ -34,6 +34,7 @@
 #include "DoubleGrids.h"
 #include "DoubleGridsAM.h"
 #include "Timers.h"
+#include "HardwareCounters.h"
 
 using namespace std;
 
@@ -347,6 +348,12 @@ int main( int argc, char *argv[] )
         vecPatches.saveOldRho( params );
     }
     
+    // Hardware counters requested by DiagPerformances
+    if( HardwareCounters::requested ) {
+        timers.enableHardwareCounters();
+    }
+    
+    timers.initialization.update();
     timers.reboot();
     timers.global.reboot();
     
@@ -540,6 +547,9 @@ int main( int argc, char *argv[] )
             // Particle merging
             vecPatches.mergeParticles(params, &smpi, time_dual,timers, itime );
 
+            // Particle splitting
+            vecPatches.splitParticles(params, time_dual, timers, itime );
+
             // Particle injection from the boundaries
             vecPatches.injectParticlesFromBoundaries(params, timers, itime );
 
@@ -554,9 +564,7 @@ int main( int argc, char *argv[] )
                     // Standard fields operations (maxwell + comms + boundary conditions) are completed
                     // apply prescribed fields can be considered if requested
                     if( vecPatches(0)->EMfields->prescribedFields.size() ) {
-                        #pragma omp single
                         vecPatches.applyPrescribedFields( time_prim );
-                        #pragma omp barrier
                     }
                 }
             }
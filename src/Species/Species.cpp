@@ -18,6 +18,7 @@
 #include "MultiphotonBreitWheelerFactory.h"
 #include "ParticlesFactory.h"
 #include "MergingFactory.h"
+#include "SplittingFactory.h"
 #include "PartBoundCond.h"
 #include "PartWall.h"
 #include "BoundaryConditionType.h"
@@ -91,7 +92,8 @@ Species::Species( Params &params, Patch *patch ) :
     tracking_diagnostic( 10000 ),
     nDim_particle( params.nDim_particle ),
     nDim_field(    params.nDim_field  ),
-    merging_time_selection_( 0 )
+    merging_time_selection_( 0 ),
+    splitting_time_selection_( 0 )
 {
     
     particles         = ParticlesFactory::create( params );
@@ -101,6 +103,7 @@ Species::Species( Params &params, Patch *patch ) :
     partBoundCond = NULL;
     min_loc = patch->getDomainLocalMin( 0 );
     merging_method_ = "none";
+    splitting_method_ = "none";
 
     PI2 = 2.0 * M_PI;
     PI_ov_2 = 0.5*M_PI;
@@ -241,6 +244,7 @@ void Species::initParticles( Params &params, Patch *patch, bool with_particles,
     } else {
 
         // Create profiles and particles
+        patch->rand_->reset( Random::stream_initialization, species_number_, 0 );
         particle_creator.create( init_space, params, patch, 0 );
 
     }
@@ -277,7 +281,10 @@ void Species::initOperators( Params &params, Patch *patch )
     Multiphoton_Breit_Wheeler_process = MultiphotonBreitWheelerFactory::create( params, this, patch->rand_  );
 
     // assign the correct Merging method to Merge
-    Merge = MergingFactory::create( params, this, patch->rand_ );
+    Merge = MergingFactory::create( params, this );
+
+    // assign the correct Splitting method to Split
+    Split = SplittingFactory::create( params, this );
 
     // Evaluation of the particle computation time
     if (params.has_adaptive_vectorization ) {
@@ -320,6 +327,10 @@ Species::~Species()
         delete Merge;
     }
 
+    if( Split ) {
+        delete Split;
+    }
+
     if( Ionize ) {
         delete Ionize;
     }
@@ -395,6 +406,7 @@ void Species::dynamics( double time_dual, unsigned int ispec,
 #ifdef  __DETAILED_TIMERS
     double timer;
 #endif
+    double t_profile;
 
     unsigned int iPart;
 
@@ -417,7 +429,9 @@ void Species::dynamics( double time_dual, unsigned int ispec,
 #endif
 
             // Interpolate the fields at the particle position
+            t_profile = patch->profiler_.start();
             Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[ibin] ), &( particles->last_index[ibin] ), ithread );
+            patch->profiler_.stop( ispec, PatchProfiler::interpolation, t_profile );
 
 #ifdef  __DETAILED_TIMERS
             patch->patch_timers[0] += MPI_Wtime() - timer;
@@ -512,7 +526,9 @@ void Species::dynamics( double time_dual, unsigned int ispec,
 #endif
 
             // Push the particles and the photons
+            t_profile = patch->profiler_.start();
             ( *Push )( *particles, smpi, particles->first_index[ibin], particles->last_index[ibin], ithread );
+            patch->profiler_.stop( ispec, PatchProfiler::push, t_profile );
             //particles->testMove( particles->first_index[ibin], particles->last_index[ibin], params );
 
 #ifdef  __DETAILED_TIMERS
@@ -530,6 +546,7 @@ void Species::dynamics( double time_dual, unsigned int ispec,
 #endif
 
                 // Apply wall and boundary conditions
+                t_profile = patch->profiler_.start();
                 if( mass_>0 ) {
                     for( unsigned int iwall=0; iwall<partWalls->size(); iwall++ ) {
                         (*partWalls)[iwall]->apply( this, particles->first_index[ibin], particles->last_index[ibin], smpi->dynamics_invgf[ithread], patch->rand_, energy_lost );
@@ -551,6 +568,8 @@ void Species::dynamics( double time_dual, unsigned int ispec,
                     nrj_lost_per_thd[tid] += energy_lost;
                 }
 
+                patch->profiler_.stop( ispec, PatchProfiler::boundaries, t_profile );
+
 #ifdef  __DETAILED_TIMERS
                 patch->patch_timers[3] += MPI_Wtime() - timer;
 #endif
@@ -564,7 +583,9 @@ void Species::dynamics( double time_dual, unsigned int ispec,
                 // Project currents if not a Test species and charges as well if a diag is needed.
                 // Do not project if a photon
                 if( ( !particles->is_test ) && ( mass_ > 0 ) ) {
+                    t_profile = patch->profiler_.start();
                     Proj->currentsAndDensityWrapper( EMfields, *particles, smpi, particles->first_index[ibin], particles->last_index[ibin], ithread, diag_flag, params.is_spectral, ispec );
+                    patch->profiler_.stop( ispec, PatchProfiler::projection, t_profile );
                 }
 
 #ifdef  __DETAILED_TIMERS
@@ -1266,6 +1287,14 @@ void Species::mergeParticles( double time_dual, unsigned int ispec,
                               Patch *patch, SmileiMPI *smpi,
                               std::vector<Diagnostic *> &localDiags ) {}
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Particle splitting cell by cell
+// ---------------------------------------------------------------------------------------------------------------------
+void Species::splitParticles( double time_dual, unsigned int ispec,
+                              Params &params,
+                              Patch *patch,
+                              std::vector<Diagnostic *> &localDiags ) {}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // For all particles of the species reacting to laser envelope
 //   - interpolate the fields at the particle position
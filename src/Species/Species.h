@@ -19,6 +19,7 @@
 #include "MultiphotonBreitWheeler.h"
 #include "MultiphotonBreitWheelerTables.h"
 #include "Merging.h"
+#include "Splitting.h"
 #include "PartCompTime.h"
 
 class ElectroMagn;
@@ -32,6 +33,7 @@ class Patch;
 class SimWindow;
 class Radiation;
 class Merging;
+class Splitting;
 class PartCompTime;
 
 
@@ -289,6 +291,28 @@ public:
     //! Minimum momentum value in log scale
     double merge_min_momentum_log_scale_;
 
+    // Splitting parameters :
+    //! Splitting method
+    std::string splitting_method_;
+
+    //! Boolean to test if the species has the splitting ready
+    bool has_splitting_;
+
+    //! Time selection for the particle splitting
+    TimeSelection *splitting_time_selection_;
+
+    //! Cells with fewer particles are split until they reach this number
+    unsigned int split_min_particles_per_cell_;
+
+    //! Number of children of each split particle
+    unsigned int split_number_;
+
+    //! Minimum weight of the children
+    double split_min_weight_;
+
+    //! Maximum displacement of the children, in units of the cell length
+    double split_displacement_;
+
     //! Local minimum of MPI domain
     double min_loc;
 
@@ -324,6 +348,9 @@ public:
 
     //! Merging
     Merging *Merge;
+
+    //! Splitting
+    Splitting *Split;
     
     //! Particle Computation time evaluation
     PartCompTime *part_comp_time_ = NULL;
@@ -432,6 +459,12 @@ public:
                                  Patch *patch, SmileiMPI *smpi,
                                  std::vector<Diagnostic *> &localDiags );
 
+    //! Method performing the splitting of particles
+    virtual void splitParticles( double time_dual, unsigned int ispec,
+                                 Params &params,
+                                 Patch *patch,
+                                 std::vector<Diagnostic *> &localDiags );
+
 
     //! Method calculating the Particle charge on the grid (projection)
     virtual void computeCharge( unsigned int ispec, ElectroMagn *EMfields, bool old=false );
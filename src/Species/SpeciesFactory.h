@@ -538,6 +538,100 @@ public:
                      << this_species->merge_max_packet_size_ );
         }
 
+        // Particle Splitting
+
+        // Extract splitting method
+        this_species->splitting_method_ = "none"; // default value
+        this_species->has_splitting_ = false; // default value
+        PyTools::extract( "splitting_method", this_species->splitting_method_, "Species", ispec );
+
+        // Cancelation of the letter case for `splitting_method_`
+        std::transform( this_species->splitting_method_.begin(),
+                        this_species->splitting_method_.end(),
+                        this_species->splitting_method_.begin(), ::tolower );
+
+        if( ( this_species->splitting_method_ != "symmetric" ) &&
+            ( this_species->splitting_method_ != "none" ) ) {
+            ERROR_NAMELIST( "In Species " << this_species->name_
+                            << ": splitting method not valid, must be `symmetric` or `none`",
+                            LINK_NAMELIST + std::string("#particle-splitting") );
+        }
+
+        if ( this_species->splitting_method_ != "none" ) {
+
+            // get parameter "split_every" (time selection)
+            if( !this_species->splitting_time_selection_ ) {
+                this_species->splitting_time_selection_ = new TimeSelection(
+                    PyTools::extract_py( "split_every", "Species", ispec ), "Particle splitting"
+                );
+            }
+
+            // Threshold on the number of particles per cell
+            PyTools::extract( "split_min_particles_per_cell", this_species->split_min_particles_per_cell_ , "Species", ispec );
+            if( this_species->split_min_particles_per_cell_ < 2 ) {
+                ERROR_NAMELIST(
+                    "In Species " << this_species->name_
+                    << ": the threshold on the number of particles per cell "
+                    << "(`split_min_particles_per_cell`) must be above or equal to 2",
+                    LINK_NAMELIST + std::string("#particle-splitting")
+                );
+            }
+            if( this_species->has_merging_
+                && this_species->split_min_particles_per_cell_ >= this_species->merge_min_particles_per_cell_ ) {
+                ERROR_NAMELIST(
+                    "In Species " << this_species->name_
+                    << ": `split_min_particles_per_cell` must be below `merge_min_particles_per_cell`",
+                    LINK_NAMELIST + std::string("#particle-splitting")
+                );
+            }
+
+            // Number of children of each split particle
+            PyTools::extract( "split_number", this_species->split_number_ , "Species", ispec );
+            if( this_species->split_number_ < 2 ) {
+                ERROR_NAMELIST(
+                    "In Species " << this_species->name_
+                    << ": the number of children of a split particle (`split_number`) must be above or equal to 2",
+                    LINK_NAMELIST + std::string("#particle-splitting")
+                );
+            }
+
+            // Minimum weight of the children
+            PyTools::extract( "split_min_weight", this_species->split_min_weight_ , "Species", ispec );
+            if( this_species->split_min_weight_ < 0. ) {
+                ERROR_NAMELIST(
+                    "In Species " << this_species->name_
+                    << ": `split_min_weight` must be positive",
+                    LINK_NAMELIST + std::string("#particle-splitting")
+                );
+            }
+
+            // Maximum displacement of the children
+            PyTools::extract( "split_displacement", this_species->split_displacement_ , "Species", ispec );
+            if( this_species->split_displacement_ < 0. || this_species->split_displacement_ > 0.5 ) {
+                ERROR_NAMELIST(
+                    "In Species " << this_species->name_
+                    << ": `split_displacement` must be between 0 and 0.5",
+                    LINK_NAMELIST + std::string("#particle-splitting")
+                );
+            }
+
+            // We activate the splitting
+            this_species->has_splitting_ = true;
+
+            MESSAGE( 2, "> Particle splitting with the method: "
+                     << this_species->splitting_method_ );
+            MESSAGE( 3, "| Splitting time selection: "
+                     << this_species->splitting_time_selection_->info() );
+            MESSAGE( 3, "| Minimum particle number per cell: "
+                     << this_species->split_min_particles_per_cell_ );
+            MESSAGE( 3, "| Number of children: "
+                     << this_species->split_number_ );
+            MESSAGE( 3, "| Minimum weight of the children: "
+                     << this_species->split_min_weight_ );
+            MESSAGE( 3, "| Maximum displacement: "
+                     << this_species->split_displacement_ << " cell" );
+        }
+
         // Position initialization
         PyObject *py_pos_init = PyTools::extract_py( "position_initialization", "Species", ispec );
         if( PyTools::py2scalar( py_pos_init, this_species->position_initialization_ ) ) {
@@ -1228,6 +1322,13 @@ public:
         new_species->merge_min_momentum_cell_length_[0]       = species->merge_min_momentum_cell_length_[0];
         new_species->merge_min_momentum_cell_length_[1]       = species->merge_min_momentum_cell_length_[1];
         new_species->merge_min_momentum_cell_length_[2]       = species->merge_min_momentum_cell_length_[2];
+        new_species->splitting_method_                        = species->splitting_method_;
+        new_species->has_splitting_                           = species->has_splitting_;
+        new_species->splitting_time_selection_                = species->splitting_time_selection_;
+        new_species->split_min_particles_per_cell_            = species->split_min_particles_per_cell_;
+        new_species->split_number_                            = species->split_number_;
+        new_species->split_min_weight_                        = species->split_min_weight_;
+        new_species->split_displacement_                      = species->split_displacement_;
 
 
         new_species->charge_profile_                            = new Profile( species->charge_profile_ );
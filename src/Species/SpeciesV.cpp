@@ -135,6 +135,7 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
 #ifdef  __DETAILED_TIMERS
     double timer;
 #endif
+    double t_profile;
 
     if( npack_==0 ) {
         npack_    = 1;
@@ -175,12 +176,15 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
 #endif
 
             // Interpolate the fields at the particle position
+            t_profile = patch->profiler_.start();
             for( unsigned int scell = 0 ; scell < packsize_ ; scell++ ){
                 Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[ipack*packsize_+scell] ),
                                        &( particles->last_index[ipack*packsize_+scell] ),
                                        ithread, scell, particles->first_index[ipack*packsize_]);
             }
 
+            patch->profiler_.stop( ispec, PatchProfiler::interpolation, t_profile );
+
 #ifdef  __DETAILED_TIMERS
             patch->patch_timers[0] += MPI_Wtime() - timer;
 #endif
@@ -272,9 +276,11 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
             timer = MPI_Wtime();
 #endif
             // Push the particles and the photons
+            t_profile = patch->profiler_.start();
             ( *Push )( *particles, smpi, particles->first_index[ipack*packsize_],
                        particles->last_index[ipack*packsize_+packsize_-1],
                        ithread, particles->first_index[ipack*packsize_] );
+            patch->profiler_.stop( ispec, PatchProfiler::push, t_profile );
 
 #ifdef  __DETAILED_TIMERS
             patch->patch_timers[1] += MPI_Wtime() - timer;
@@ -283,6 +289,7 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
 
             // Boundary conditions and energy lost
 
+            t_profile = patch->profiler_.start();
             double energy_lost( 0. );
 
             if( mass_>0 ) {
@@ -413,12 +420,15 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
 
 
 
+            patch->profiler_.stop( ispec, PatchProfiler::boundaries, t_profile );
+
 #ifdef  __DETAILED_TIMERS
             patch->patch_timers[3] += MPI_Wtime() - timer;
 #endif
 
             // Project currents if not a Test species and charges as well if a diag is needed.
             // Do not project if a photon
+            t_profile = patch->profiler_.start();
             if( ( !particles->is_test ) && ( mass_ > 0 ) )
 #ifdef  __DETAILED_TIMERS
                 timer = MPI_Wtime();
@@ -433,6 +443,8 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
                     ispec, ipack*packsize_+scell, particles->first_index[ipack*packsize_]
                 );
 
+            patch->profiler_.stop( ispec, PatchProfiler::projection, t_profile );
+
 #ifdef  __DETAILED_TIMERS
             patch->patch_timers[2] += MPI_Wtime() - timer;
 #endif
@@ -910,12 +922,45 @@ void SpeciesV::mergeParticles( double time_dual, unsigned int ispec,
         //         energy_before += sqrt(1 + pow(particles->momentum(0,ip),2) + pow(particles->momentum(1,ip),2) + pow(particles->momentum(2,ip),2));
         // }
 
-        // For each cell, we apply independently the merging process
-        for( scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
-
+        // Split the cells in chunks of about SMILEI_MERGING_TASKSIZE macro-particles.
+        // The splitting does not depend on the number of threads, so that results are reproducible.
+        unsigned int ncell = particles->first_index.size();
+        std::vector<unsigned int> chunk_start( 1, 0 );
+        if( ( unsigned int )( particles->last_index.back() ) > SMILEI_MERGING_TASKSIZE ) {
+            unsigned int n = 0;
+            for( scell = 0 ; scell < ncell-1 ; scell++ ) {
+                n += particles->last_index[scell] - particles->first_index[scell];
+                if( n >= SMILEI_MERGING_TASKSIZE ) {
+                    chunk_start.push_back( scell+1 );
+                    n = 0;
+                }
+            }
+        }
+        chunk_start.push_back( ncell );
+        unsigned int nchunk = chunk_start.size() - 1;
+
+        // Each chunk (other than the first) is merged in a separate task,
+        // with its own sub-stream of the patch random numbers.
+        // Cells are independent: a chunk only modifies its own particles, mask and count.
+        std::vector<Random *> randoms( nchunk, patch->rand_ );
+        for( unsigned int ichunk = 1; ichunk < nchunk; ichunk++ ) {
+            randoms[ichunk] = new Random( *patch->rand_ );
+            randoms[ichunk]->substream( ichunk );
+        }
+        for( unsigned int ichunk = 1; ichunk < nchunk; ichunk++ ) {
+            #pragma omp task default(shared) firstprivate(ichunk)
+            for( unsigned int icell = chunk_start[ichunk] ; icell < chunk_start[ichunk+1] ; icell++ ) {
+                ( *Merge )( mass_, *particles, mask, smpi, particles->first_index[icell],
+                            particles->last_index[icell], count[icell], randoms[ichunk] );
+            }
+        }
+        for( scell = chunk_start[0] ; scell < chunk_start[1] ; scell++ ) {
             ( *Merge )( mass_, *particles, mask, smpi, particles->first_index[scell],
-                        particles->last_index[scell], count[scell]);
-
+                        particles->last_index[scell], count[scell], patch->rand_ );
+        }
+        #pragma omp taskwait
+        for( unsigned int ichunk = 1; ichunk < nchunk; ichunk++ ) {
+            delete randoms[ichunk];
         }
 
         // We remove empty space in an optimized manner
@@ -1004,6 +1049,41 @@ void SpeciesV::mergeParticles( double time_dual, unsigned int ispec,
     }
 }
 
+// -----------------------------------------------------------------------------
+//! Split the heaviest particles of the cells that contain fewer than
+//! split_min_particles_per_cell_ particles.
+//! The children are sorted in their cells by importParticles.
+// -----------------------------------------------------------------------------
+void SpeciesV::splitParticles( double time_dual, unsigned int ispec,
+                               Params &params,
+                               Patch *patch,
+                               std::vector<Diagnostic *> &localDiags )
+{
+    // Only for moving particles
+    if( time_dual>time_frozen_ ) {
+
+        // Bounds of the patch that the children may not cross
+        double box_min[3] = { 0., 0., 0. };
+        double box_max[3] = { 0., 0., 0. };
+        for( unsigned int idim = 0; idim < nDim_field; idim++ ) {
+            box_min[idim] = patch->getDomainLocalMin( idim );
+            box_max[idim] = patch->getDomainLocalMax( idim );
+        }
+
+        Particles new_particles;
+        new_particles.initialize( 0, *particles );
+
+        for( unsigned int icell = 0 ; icell < particles->first_index.size() ; icell++ ) {
+            ( *Split )( *particles, particles->first_index[icell], particles->last_index[icell],
+                        split_min_particles_per_cell_, new_particles, box_min, box_max, patch->rand_ );
+        }
+
+        if( new_particles.size() > 0 ) {
+            importParticles( params, patch, new_particles, localDiags );
+        }
+    }
+}
+
 
 // ---------------------------------------------------------------------------------------------------------------------
 // For all particles of the species reacting to laser envelope
@@ -1039,7 +1119,7 @@ void SpeciesV::ponderomotiveUpdateSusceptibilityAndMomentum( double time_dual, u
         //else
         //    npack_ *= (f_dim0-2*oversize[0]);
 
-        if( nDim_particle == 3 ) {
+        if( nDim_field == 3 ) {
             packsize_ *= ( f_dim2-2*oversize[2] );
         }
     }
@@ -1151,7 +1231,7 @@ void SpeciesV::ponderomotiveProjectSusceptibility( double time_dual, unsigned in
         //else
         //    npack_ *= (f_dim0-2*oversize[0]);
 
-        if( nDim_particle == 3 ) {
+        if( nDim_field == 3 ) {
             packsize_ *= ( f_dim2-2*oversize[2] );
         }
     }
@@ -99,6 +99,12 @@ public:
                                  SmileiMPI *smpi,
                                  std::vector<Diagnostic *> &localDiags )override;
 
+    //! Method performing the splitting of particles
+    virtual void splitParticles( double time_dual, unsigned int ispec,
+                                 Params &params,
+                                 Patch *patch,
+                                 std::vector<Diagnostic *> &localDiags )override;
+
 private:
 
     //! Number of packs of particles that divides the total number of particles
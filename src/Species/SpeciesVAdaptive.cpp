@@ -79,6 +79,7 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
 #ifdef  __DETAILED_TIMERS
     double timer;
 #endif
+    double t_profile;
 
     unsigned int iPart;
 
@@ -114,7 +115,9 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
         //                         particles->first_index[0] );
 
         // Interpolate the fields at the particle position
+        t_profile = patch->profiler_.start();
         Interp->fieldsWrapper( EMfields, *particles, smpi, &( particles->first_index[0] ), &( particles->last_index[particles->last_index.size()-1] ), ithread );
+        patch->profiler_.stop( ispec, PatchProfiler::interpolation, t_profile );
 
         // Interpolate the fields at the particle position
         // for( unsigned int scell = 0 ; scell < packsize_ ; scell++ ){
@@ -209,7 +212,10 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
             timer = MPI_Wtime();
 #endif
             // Push the particles and the photons
+            t_profile = patch->profiler_.start();
             ( *Push )( *particles, smpi, 0, particles->last_index.back(), ithread, 0. );
+            patch->profiler_.stop( ispec, PatchProfiler::push, t_profile );
+            t_profile = patch->profiler_.start();
 #ifdef  __DETAILED_TIMERS
             patch->patch_timers[1] += MPI_Wtime() - timer;
             timer = MPI_Wtime();
@@ -242,6 +248,7 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
 
             // Cell keys
             computeParticleCellKeys( params );
+            patch->profiler_.stop( ispec, PatchProfiler::boundaries, t_profile );
 
 #ifdef  __DETAILED_TIMERS
             patch->patch_timers[3] += MPI_Wtime() - timer;
@@ -254,6 +261,7 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
 #ifdef  __DETAILED_TIMERS
                 timer = MPI_Wtime();
 #endif
+                t_profile = patch->profiler_.start();
                 Proj->currentsAndDensityWrapper(
                     EMfields, *particles, smpi, particles->first_index[0],
                     particles->last_index.back(),
@@ -262,6 +270,7 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
                     params.is_spectral,
                     ispec
                 );
+                patch->profiler_.stop( ispec, PatchProfiler::projection, t_profile );
                 
 #ifdef  __DETAILED_TIMERS
                 patch->patch_timers[2] += MPI_Wtime() - timer;
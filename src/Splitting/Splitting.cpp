@@ -0,0 +1,69 @@
+// ----------------------------------------------------------------------------
+//! \file Splitting.cpp
+//
+//! \brief Class implementation for the generic class
+//!  Splitting dedicated to the particle splitting.
+//
+// ----------------------------------------------------------------------------
+
+#include "Splitting.h"
+
+#include <algorithm>
+
+// -----------------------------------------------------------------------------
+//! Constructor for Splitting
+// input: simulation parameters & Species index
+//! \param params simulation parameters
+//! \param species Species index
+// -----------------------------------------------------------------------------
+Splitting::Splitting( Params &params, Species *species )
+{
+    number_ = species->split_number_;
+    min_weight_ = species->split_min_weight_;
+    nDim_ = params.nDim_field;
+    cylindrical_ = params.geometry == "AMcylindrical";
+    for( unsigned int idim = 0; idim < 3; idim++ ) {
+        max_displacement_[idim] = idim < nDim_ ? species->split_displacement_ * params.cell_length[idim] : 0.;
+        cell_length_[idim] = idim < nDim_ ? params.cell_length[idim] : 0.;
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! Destructor for Splitting
+// -----------------------------------------------------------------------------
+Splitting::~Splitting()
+{
+}
+
+// -----------------------------------------------------------------------------
+//! Selection of the particles to split in the bin [istart, iend):
+//! the heaviest ones, as long as their children are not lighter than min_weight_.
+//! Ties are broken by the particle index so that the selection is reproducible.
+// -----------------------------------------------------------------------------
+unsigned int Splitting::selectParents( Particles &particles, int istart, int iend, unsigned int target_particles )
+{
+    unsigned int npart = iend - istart;
+    if( npart == 0 || npart >= target_particles ) {
+        return 0;
+    }
+
+    // Each split adds number_-1 particles
+    unsigned int nsplit = ( target_particles - npart + number_ - 2 ) / ( number_ - 1 );
+
+    parents_.clear();
+    double min_parent_weight = min_weight_ * number_;
+    for( int ip = istart; ip < iend; ip++ ) {
+        if( particles.weight( ip ) >= min_parent_weight && particles.weight( ip ) > 0. ) {
+            parents_.push_back( ip );
+        }
+    }
+    nsplit = std::min( nsplit, ( unsigned int ) parents_.size() );
+
+    std::partial_sort( parents_.begin(), parents_.begin() + nsplit, parents_.end(),
+        [&particles]( unsigned int a, unsigned int b ) {
+            return particles.weight( a ) > particles.weight( b )
+                || ( particles.weight( a ) == particles.weight( b ) && a < b );
+        } );
+
+    return nsplit;
+}
@@ -0,0 +1,78 @@
+// ----------------------------------------------------------------------------
+//! \file Splitting.h
+//
+//! \brief Header for the generic class Splitting
+//! dedicated to the particle splitting.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef SPLITTING_H
+#define SPLITTING_H
+
+#include "Params.h"
+#include "Particles.h"
+#include "Species.h"
+#include "Random.h"
+
+//  ----------------------------------------------------------------------------
+//! Class Splitting
+//  ----------------------------------------------------------------------------
+class Splitting
+{
+public:
+
+    //! Creator for Splitting
+    Splitting( Params &params, Species *species );
+
+    virtual ~Splitting();
+
+    //! Overloading of () operator: splits the heaviest particles of a bin
+    //! \param particles      particle object containing the particle
+    //!                       properties of the current species
+    //! \param istart         Index of the first particle of the bin
+    //! \param iend           Index of the last particle of the bin (excluded)
+    //! \param target_particles Number of particles that the bin should reach
+    //! \param new_particles  Children of the split particles (the parent itself remains one of the children)
+    //! \param box_min        Lower bounds of the patch
+    //! \param box_max        Upper bounds of the patch
+    //! \param rand           Random generator
+    virtual void operator()(
+        Particles &particles,
+        int istart,
+        int iend,
+        unsigned int target_particles,
+        Particles &new_particles,
+        double *box_min,
+        double *box_max,
+        Random *rand ) = 0;
+
+protected:
+
+    //! Selects the heaviest particles of a bin that may be split, in parents_,
+    //! and returns the number of them to split so that the bin reaches target_particles
+    unsigned int selectParents( Particles &particles, int istart, int iend, unsigned int target_particles );
+
+    //! Number of children of each split particle
+    unsigned int number_;
+
+    //! Minimum weight of the children
+    double min_weight_;
+
+    //! Maximum displacement of the children along each dimension of the grid
+    double max_displacement_[3];
+
+    //! Cell length along each dimension of the grid
+    double cell_length_[3];
+
+    //! Number of dimensions of the grid
+    unsigned int nDim_;
+
+    //! Whether the geometry is AM cylindrical (second dimension = radius)
+    bool cylindrical_;
+
+    //! Indices of the candidate parents
+    std::vector<unsigned int> parents_;
+
+};
+
+#endif
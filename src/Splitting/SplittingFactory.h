@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------------
+//! \file SplittingFactory.h
+//
+//! \brief Header for the class SplittingFactory that
+//! manages the different particle splitting algorithms.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef SPLITTINGFACTORY_H
+#define SPLITTINGFACTORY_H
+
+#include "Splitting.h"
+#include "SplittingSymmetric.h"
+
+//  ----------------------------------------------------------------------------
+//! Class SplittingFactory
+//  ----------------------------------------------------------------------------
+
+class SplittingFactory
+{
+public:
+
+    //  ------------------------------------------------------------------------
+    //! Create appropriate splitting method for the species `species`
+    //! \param species Species object
+    //! \param params Parameters
+    //  ------------------------------------------------------------------------
+    static Splitting *create( Params &params, Species *species )
+    {
+        Splitting *Split = NULL;
+
+        if( species->splitting_method_ == "symmetric" ) {
+            Split = new SplittingSymmetric( params, species );
+        }
+
+        return Split;
+    }
+};
+
+#endif
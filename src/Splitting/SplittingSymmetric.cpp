@@ -0,0 +1,130 @@
+// ----------------------------------------------------------------------------
+//! \file SplittingSymmetric.cpp
+//
+//! \brief Functions of the class SplittingSymmetric
+//! Particle splitting in children displaced by symmetric pairs
+//
+// ----------------------------------------------------------------------------
+
+#include "SplittingSymmetric.h"
+
+#include <cmath>
+#include <algorithm>
+
+// -----------------------------------------------------------------------------
+//! Constructor for SplittingSymmetric
+// -----------------------------------------------------------------------------
+SplittingSymmetric::SplittingSymmetric( Params &params, Species *species )
+    : Splitting( params, species )
+{
+}
+
+// -----------------------------------------------------------------------------
+//! Destructor for SplittingSymmetric
+// -----------------------------------------------------------------------------
+SplittingSymmetric::~SplittingSymmetric()
+{
+}
+
+// ---------------------------------------------------------------------
+//! Overloading of () operator: perform the particle splitting
+//! \param particles      particle object containing the particle
+//!                       properties
+//! \param istart         Index of the first particle of the bin
+//! \param iend           Index of the last particle of the bin (excluded)
+//! \param target_particles Number of particles that the bin should reach
+//! \param new_particles  Children of the split particles
+//! \param box_min        Lower bounds of the patch
+//! \param box_max        Upper bounds of the patch
+//! \param rand           Random generator
+// ---------------------------------------------------------------------
+void SplittingSymmetric::operator()(
+    Particles &particles,
+    int istart,
+    int iend,
+    unsigned int target_particles,
+    Particles &new_particles,
+    double *box_min,
+    double *box_max,
+    Random *rand )
+{
+    unsigned int nsplit = selectParents( particles, istart, iend, target_particles );
+    if( nsplit == 0 ) {
+        return;
+    }
+
+    double inv_number = 1./( double )number_;
+    unsigned int npairs = number_/2;
+    bool keep_position_old = particles.Position_old.size() > 0;
+
+    for( unsigned int isplit = 0; isplit < nsplit; isplit++ ) {
+        unsigned int ip = parents_[isplit];
+
+        // The parent becomes the first child, the others are appended to new_particles
+        particles.weight( ip ) *= inv_number;
+        unsigned int first_child = new_particles.size();
+        for( unsigned int ichild = 1; ichild < number_; ichild++ ) {
+            particles.copyParticle( ip, new_particles );
+            // New identifiers are given when the children are imported
+            if( new_particles.tracked ) {
+                new_particles.id( first_child+ichild-1 ) = 0;
+            }
+        }
+
+        // Position of the parent in the grid coordinates
+        double delta[3];
+        double position[3];
+        double r = 0., y = 0., z = 0.;
+        if( cylindrical_ ) {
+            y = particles.position( 1, ip );
+            z = particles.position( 2, ip );
+            r = sqrt( y*y + z*z );
+            position[0] = particles.position( 0, ip );
+            position[1] = r;
+        } else {
+            for( unsigned int idim = 0; idim < nDim_; idim++ ) {
+                position[idim] = particles.position( idim, ip );
+            }
+        }
+
+        // Largest displacement along each dimension so that the children remain strictly
+        // inside the cell of the parent (cells are centered on the primal nodes), and in the patch
+        for( unsigned int idim = 0; idim < nDim_; idim++ ) {
+            double cell_center = round( position[idim] / cell_length_[idim] ) * cell_length_[idim];
+            double lower = std::max( box_min[idim], cell_center - 0.5*cell_length_[idim] );
+            double upper = std::min( box_max[idim], cell_center + 0.5*cell_length_[idim] );
+            delta[idim] = std::min( max_displacement_[idim],
+                          0.99 * std::min( position[idim] - lower, upper - position[idim] ) );
+            delta[idim] = std::max( delta[idim], 0. );
+        }
+
+        // Pairs of children (a, b): a is displaced by +u, b by -u
+        for( unsigned int ipair = 0; ipair < npairs; ipair++ ) {
+            Particles *pa = ipair == 0 ? &particles : &new_particles;
+            unsigned int ia = ipair == 0 ? ip : first_child + 2*ipair - 1;
+            unsigned int ib = first_child + 2*ipair;
+
+            // Displacement in the particle coordinates
+            double u[3] = { 0., 0., 0. };
+            for( unsigned int idim = 0; idim < nDim_; idim++ ) {
+                u[idim] = delta[idim] * rand->uniform2();
+            }
+            if( cylindrical_ ) {
+                // Radial displacement along the direction of the parent
+                double ur = u[1];
+                u[1] = r > 0. ? ur * y / r : 0.;
+                u[2] = r > 0. ? ur * z / r : 0.;
+            }
+
+            unsigned int nDim_particle = particles.dimension();
+            for( unsigned int idim = 0; idim < nDim_particle; idim++ ) {
+                pa->position( idim, ia ) += u[idim];
+                new_particles.position( idim, ib ) -= u[idim];
+                if( keep_position_old ) {
+                    pa->position_old( idim, ia ) += u[idim];
+                    new_particles.position_old( idim, ib ) -= u[idim];
+                }
+            }
+        }
+    }
+}
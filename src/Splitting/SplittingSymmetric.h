@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------
+//! \file SplittingSymmetric.h
+//
+//! \brief Header for the class SplittingSymmetric
+//! Particle splitting in children displaced by symmetric pairs
+//
+// ----------------------------------------------------------------------------
+
+#ifndef SPLITTINGSYMMETRIC_H
+#define SPLITTINGSYMMETRIC_H
+
+#include "Splitting.h"
+
+//------------------------------------------------------------------------------
+//! SplittingSymmetric class: each split particle gives `number_` children of
+//! equal weights and of the same momentum. The children are displaced by pairs,
+//! symmetrically with respect to the parent position (with an odd number of
+//! children, one of them stays at the parent position), without leaving the
+//! cell of the parent.
+//! Charge, current and kinetic energy are exactly conserved, as well as the
+//! center of charge of the parent.
+//------------------------------------------------------------------------------
+class SplittingSymmetric : public Splitting
+{
+
+public:
+
+    //! Constructor for SplittingSymmetric
+    SplittingSymmetric( Params &params, Species *species );
+
+    //! Destructor for SplittingSymmetric
+    ~SplittingSymmetric();
+
+    // ---------------------------------------------------------------------
+    //! Overloading of () operator: perform the particle splitting
+    //! \param particles      particle object containing the particle
+    //!                       properties
+    //! \param istart         Index of the first particle of the bin
+    //! \param iend           Index of the last particle of the bin (excluded)
+    //! \param target_particles Number of particles that the bin should reach
+    //! \param new_particles  Children of the split particles
+    //! \param box_min        Lower bounds of the patch
+    //! \param box_max        Upper bounds of the patch
+    //! \param rand           Random generator
+    // ---------------------------------------------------------------------
+    virtual void operator()(
+        Particles &particles,
+        int istart,
+        int iend,
+        unsigned int target_particles,
+        Particles &new_particles,
+        double *box_min,
+        double *box_max,
+        Random *rand );
+
+};
+
+#endif
@@ -2,13 +2,14 @@
 #include <iomanip>
 
 //! Open HDF5 file + location
-H5::H5( std::string file, unsigned access, MPI_Comm * comm, bool _raise )
+H5::H5( std::string file, unsigned access, MPI_Comm * comm, bool _raise, MPI_Info info )
 {
-    init( file, access, comm, _raise );
+    init( file, access, comm, _raise, info );
 }
 
-void H5::init( std::string file, unsigned access, MPI_Comm * comm, bool _raise )
+void H5::init( std::string file, unsigned access, MPI_Comm * comm, bool _raise, MPI_Info info )
 {
+    image_ = NULL;
     
     // Analyse file string : separate file name and tree inside hdf5 file
     size_t l = file.length();
@@ -39,8 +40,11 @@ void H5::init( std::string file, unsigned access, MPI_Comm * comm, bool _raise )
     // Open or create
     hid_t fapl = H5Pcreate( H5P_FILE_ACCESS );
     if( comm ) {
-        H5Pset_fapl_mpio( fapl, *comm, MPI_INFO_NULL );
+        H5Pset_fapl_mpio( fapl, *comm, info );
     }
+    // Files reached through external links (incremental checkpoints) stay open until this one
+    // is closed, instead of being reopened for each linked dataset
+    H5Pset_elink_file_cache_size( fapl, 64 );
     if( access == H5F_ACC_RDWR ) {
         fid_ = H5Fcreate( filepath_.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl );
     } else {
@@ -83,8 +87,34 @@ void H5::init( std::string file, unsigned access, MPI_Comm * comm, bool _raise )
 }
 
 
+//! Open a file in memory
+void H5::initInMemory( std::string name, std::vector<char> *image, const char *data, size_t size )
+{
+    filepath_ = name;
+    image_ = data ? NULL : image;
+    
+    // Core driver without backing store: nothing touches the disk
+    hid_t fapl = H5Pcreate( H5P_FILE_ACCESS );
+    H5Pset_fapl_core( fapl, 1048576, 0 );
+    if( data ) {
+        H5Pset_file_image( fapl, const_cast<char *>( data ), size );
+        fid_ = H5Fopen( filepath_.c_str(), H5F_ACC_RDONLY, fapl );
+    } else {
+        fid_ = H5Fcreate( filepath_.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl );
+    }
+    H5Pclose( fapl );
+    
+    if( fid_ < 0 ) {
+        ERROR( "Cannot open file " << filepath_ << " in memory" );
+    }
+    id_ = fid_;
+    dxpl_ = H5Pcreate( H5P_DATASET_XFER );
+    dcr_ = H5Pcreate( H5P_DATASET_CREATE );
+}
+
+
 //! Location already opened
-H5::H5( hid_t id, hid_t dcr, hid_t dxpl ) : fid_( -1 ), id_( id ), dcr_( dcr ), dxpl_( dxpl )
+H5::H5( hid_t id, hid_t dcr, hid_t dxpl ) : fid_( -1 ), id_( id ), dcr_( dcr ), dxpl_( dxpl ), image_( NULL )
 {
 }
 
@@ -96,6 +126,16 @@ H5::~H5()
         H5Dclose( id_ );
     }
     if( fid_ >= 0 ) {
+        // Copy the content of a file in memory before it disappears
+        if( image_ ) {
+            H5Fflush( fid_, H5F_SCOPE_LOCAL );
+            ssize_t size = H5Fget_file_image( fid_, NULL, 0 );
+            if( size > 0 ) {
+                size_t start = image_->size();
+                image_->resize( start + size );
+                H5Fget_file_image( fid_, &( *image_ )[start], size );
+            }
+        }
         H5Pclose( dxpl_ );
         H5Pclose( dcr_ );
         herr_t err = H5Fclose( fid_ );
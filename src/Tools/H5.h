@@ -72,14 +72,18 @@ public:
         id_ = -1;
         dxpl_ = -1;
         dcr_ = -1;
+        image_ = NULL;
     };
     
     //! Open HDF5 file + location
-    H5( std::string file, unsigned access, MPI_Comm * comm, bool _raise );
+    H5( std::string file, unsigned access, MPI_Comm * comm, bool _raise, MPI_Info info = MPI_INFO_NULL );
     
     ~H5();
     
-    void init( std::string file, unsigned access, MPI_Comm * comm, bool _raise );
+    void init( std::string file, unsigned access, MPI_Comm * comm, bool _raise, MPI_Info info = MPI_INFO_NULL );
+    
+    //! Open a file in memory: new if `data` is NULL (its content is appended to `image` when closed), or a copy of `data`
+    void initInMemory( std::string name, std::vector<char> *image, const char *data, size_t size );
     
     bool valid() {
         return id_ >= 0;
@@ -89,6 +93,11 @@ public:
         H5Fflush( id_, H5F_SCOPE_GLOBAL );
     }
     
+    //! Use the latest file format (much smaller overhead for chunked datasets, but not readable by older HDF5 versions)
+    void latestFormat() {
+        H5Fset_libver_bounds( fid_, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST );
+    }
+    
     //! Check if group exists
     bool has( std::string group_name )
     {
@@ -101,6 +110,33 @@ public:
         return H5Aexists( id_, attribute_name.c_str() ) > 0;
     }
     
+    //! Read a whole dataset (or link to a dataset) as n doubles. Returns false if its size is not n
+    bool readDoubles( std::string name, double *data, hsize_t n )
+    {
+        hid_t did = H5Dopen( id_, name.c_str(), H5P_DEFAULT );
+        if( did < 0 ) {
+            return false;
+        }
+        hid_t sid = H5Dget_space( did );
+        bool ok = H5Sget_simple_extent_npoints( sid ) == ( hssize_t ) n
+                  && H5Dread( did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data ) >= 0;
+        H5Sclose( sid );
+        H5Dclose( did );
+        return ok;
+    }
+    
+    //! Absolute path of the current location inside the file
+    std::string path()
+    {
+        ssize_t size = H5Iget_name( id_, NULL, 0 );
+        if( size <= 0 ) {
+            return "";
+        }
+        std::vector<char> name( size+1 );
+        H5Iget_name( id_, &name[0], size+1 );
+        return std::string( &name[0] );
+    }
+    
 protected:
     //! Constructor when location already opened
     H5( hid_t ID, hid_t dcr, hid_t dxpl );
@@ -110,6 +146,7 @@ protected:
     hid_t id_;
     hid_t dcr_;
     hid_t dxpl_;
+    std::vector<char> *image_; // only defined if the file is in memory and open for writing
     
     hid_t newGroupId( std::string group_name ) {
         if( H5Lexists( id_, group_name.c_str(), H5P_DEFAULT ) > 0 ) {
@@ -133,8 +170,15 @@ class H5Write : public H5
 {
 public:
     //! Open HDF5 file + location
-    H5Write( std::string file, MPI_Comm * comm = NULL, bool _raise = true )
-     : H5( file, H5F_ACC_RDWR, comm, _raise ) {};
+    H5Write( std::string file, MPI_Comm * comm = NULL, bool _raise = true, MPI_Info info = MPI_INFO_NULL )
+     : H5( file, H5F_ACC_RDWR, comm, _raise, info ) {};
+    
+    //! Create HDF5 file in memory, appended to `image` when closed
+    H5Write( std::string name, std::vector<char> *image )
+     : H5()
+    {
+        initInMemory( name, image, NULL, 0 );
+    };
     
     //! Create group inside the given H5Write location
     H5Write( H5Write *loc, std::string group_name )
@@ -308,16 +352,19 @@ public:
     
     //! Write a portion of a vector
     template<class T>
-    H5Write vect( std::string name, T &v, int size, hid_t type, hsize_t offset=0, hsize_t npoints=0 )
+    H5Write vect( std::string name, T &v, int size, hid_t type, hsize_t offset=0, hsize_t npoints=0, int deflate=0 )
     {
         // create dataspace for 1D array with good number of elements
         hsize_t dim = size;
-//        if( deflate>0 ) {
-//            H5Pset_chunk( dcr_, 1, &dim );
-//            H5Pset_deflate( dcr_, std::min( 9, deflate ) );
-//        } else {
-//            H5Premove_filter( dcr_, H5Z_FILTER_DEFLATE );
-//        }
+        // Compression (byte shuffling + zlib) requires a chunked layout: only for whole vectors
+        hid_t dcr = dcr_;
+        if( deflate > 0 && dim > 0 && offset == 0 && ( npoints == 0 || npoints == dim ) ) {
+            dcr = H5Pcopy( dcr_ );
+            hsize_t chunk = std::min( dim, ( hsize_t ) 1048576 );
+            H5Pset_chunk( dcr, 1, &chunk );
+            H5Pset_shuffle( dcr );
+            H5Pset_deflate( dcr, std::min( 9, deflate ) );
+        }
         // Select portion
         if( npoints == 0 ) {
             npoints = dim - offset;
@@ -331,21 +378,62 @@ public:
             H5Sselect_hyperslab( filespace, H5S_SELECT_SET, &o, NULL, &c, &n );
         }
         // create dataset
-        hid_t did = H5Dcreate( id_, name.c_str(), type, filespace, H5P_DEFAULT, dcr_, H5P_DEFAULT );
+        hid_t did = H5Dcreate( id_, name.c_str(), type, filespace, H5P_DEFAULT, dcr, H5P_DEFAULT );
         // write vector in dataset
         H5Dwrite( did, type, memspace, filespace, dxpl_, &v );
         // close all
         H5Sclose( filespace );
         H5Sclose( memspace );
+        if( dcr != dcr_ ) {
+            H5Pclose( dcr );
+        }
         return H5Write( did, dcr_, dxpl_ );
     }
     
+    //! Make a hard link to an object already existing in the same file
+    void hardLink( std::string link_name, std::string target_path )
+    {
+        H5Lcreate_hard( id_, target_path.c_str(), id_, link_name.c_str(), H5P_DEFAULT, H5P_DEFAULT );
+    }
+    
+    //! Make a link to an object located in another file
+    void externalLink( std::string link_name, std::string target_file, std::string target_path )
+    {
+        H5Lcreate_external( target_file.c_str(), target_path.c_str(), id_, link_name.c_str(), H5P_DEFAULT, H5P_DEFAULT );
+    }
+    
+    //! Remove a link (the object remains if other links point to it)
+    void unlink( std::string link_name )
+    {
+        H5Ldelete( id_, link_name.c_str(), H5P_DEFAULT );
+    }
+    
     //! Create or open (not write) a dataset
     H5Write dataset( std::string name, hid_t type, H5Space *filespace )
     {
         return H5Write( this, name, type, filespace );
     }
     
+    //! Allocate the space of the datasets when they are created, without fill values,
+    //! so that their data may be written outside of HDF5
+    void allocateEarly()
+    {
+        H5Pset_alloc_time( dcr_, H5D_ALLOC_TIME_EARLY );
+        H5Pset_fill_time( dcr_, H5D_FILL_TIME_NEVER );
+    }
+    
+    //! Compress the datasets created from now on (shuffle + deflate). They must be chunked.
+    void compress( int deflate )
+    {
+        H5Pset_shuffle( dcr_ );
+        H5Pset_deflate( dcr_, deflate );
+    }
+    //! Address of the data of a contiguous dataset in the file (HADDR_UNDEF if not allocated)
+    haddr_t address()
+    {
+        return H5Dget_offset( id_ );
+    }
+    
     // Write to an open dataset
     template<class T>
     void write( T &v, hid_t type, H5Space *filespace, H5Space *memspace, bool independent = false ) {
@@ -411,8 +499,15 @@ public:
     H5Read() : H5() {};
     
     //! Open HDF5 file + location
-    H5Read( std::string file, MPI_Comm * comm = NULL, bool _raise = true )
-     : H5( file, H5F_ACC_RDONLY, comm, _raise ) {};
+    H5Read( std::string file, MPI_Comm * comm = NULL, bool _raise = true, MPI_Info info = MPI_INFO_NULL )
+     : H5( file, H5F_ACC_RDONLY, comm, _raise, info ) {};
+    
+    //! Open HDF5 file from its image in memory
+    H5Read( std::string name, const char *data, size_t size )
+     : H5()
+    {
+        initInMemory( name, NULL, data, size );
+    };
     
     //! Location already opened
     H5Read( hid_t id, hid_t dcr, hid_t dxpl ) : H5( id, dcr, dxpl ) {};
@@ -480,6 +575,31 @@ public:
         }
     }
     
+    //! retrieve a vector<string> attribute
+    void attr( std::string attribute_name, std::vector<std::string> &attribute_value )
+    {
+        if( H5Aexists( id_, attribute_name.c_str() )>0 ) {
+            hid_t aid = H5Aopen( id_, attribute_name.c_str(), H5P_DEFAULT );
+            hid_t sid = H5Aget_space( aid );
+            hssize_t npoints = H5Sget_simple_extent_npoints( sid );
+            hid_t atype = H5Tcopy( H5T_C_S1 );
+            H5Tset_size( atype, H5T_VARIABLE );
+            std::vector<char *> tmp( npoints, nullptr );
+            attribute_value.resize( 0 );
+            if( npoints > 0 && H5Aread( aid, atype, &tmp[0] ) >= 0 ) {
+                for( hssize_t i=0; i<npoints; i++ ) {
+                    attribute_value.push_back( tmp[i] ? std::string( tmp[i] ) : "" );
+                }
+                H5Dvlen_reclaim( atype, sid, H5P_DEFAULT, &tmp[0] );
+            }
+            H5Tclose( atype );
+            H5Sclose( sid );
+            H5Aclose( aid );
+        } else {
+            WARNING( "Cannot find attribute " << attribute_name );
+        }
+    }
+    
     //! retrieve anything (but string) as an attribute
     template<class T>
     void attr( std::string attribute_name, T &attribute_value, hid_t type )
@@ -0,0 +1,123 @@
+#include "HardwareCounters.h"
+
+#include <cstring>
+#include <fstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const char *HardwareCounters::event_names[HardwareCounters::n_events] = { "cycles", "instructions", "cache_misses", "fp_scalar", "fp_packed" };
+bool HardwareCounters::requested = false;
+bool HardwareCounters::available_[HardwareCounters::n_events] = { false, false, false, false, false };
+
+//! File descriptors of the events of the current thread (-1 if not opened)
+static thread_local int fd_[HardwareCounters::n_events] = { -1, -1, -1, -1, -1 };
+
+#ifdef __linux__
+//! Whether the processor is an Intel one, for which the raw floating-point events are known
+static bool isIntel()
+{
+    ifstream cpuinfo( "/proc/cpuinfo" );
+    string line;
+    while( getline( cpuinfo, line ) ) {
+        if( line.compare( 0, 9, "vendor_id" ) == 0 ) {
+            return line.find( "GenuineIntel" ) != string::npos;
+        }
+    }
+    return false;
+}
+
+//! Open one event counting the user-space activity of the calling thread, on any cpu
+static int openEvent( uint32_t type, uint64_t config )
+{
+    struct perf_event_attr attr;
+    memset( &attr, 0, sizeof( attr ) );
+    attr.size = sizeof( attr );
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // When more events than hardware counters are opened, they are multiplexed: their counts are scaled
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 );
+}
+#endif
+
+void HardwareCounters::open()
+{
+#ifdef __linux__
+    fd_[cycles]       = openEvent( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES );
+    fd_[instructions] = openEvent( PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS );
+    fd_[cache_misses] = openEvent( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES );
+    if( isIntel() ) {
+        // FP_ARITH_INST_RETIRED (event 0xC7): scalar (umask 0x03) and packed 128, 256 and 512 bits (umask 0xFC)
+        fd_[fp_scalar] = openEvent( PERF_TYPE_RAW, 0x03C7 );
+        fd_[fp_packed] = openEvent( PERF_TYPE_RAW, 0xFCC7 );
+    }
+#endif
+
+    // An event is available only if all threads could open it
+    #pragma omp single
+    for( unsigned int e=0; e<n_events; e++ ) {
+        available_[e] = true;
+    }
+    for( unsigned int e=0; e<n_events; e++ ) {
+        if( fd_[e] < 0 ) {
+            #pragma omp atomic write
+            available_[e] = false;
+        }
+    }
+    #pragma omp barrier
+#ifdef __linux__
+    for( unsigned int e=0; e<n_events; e++ ) {
+        if( ! available_[e] && fd_[e] >= 0 ) {
+            close( fd_[e] );
+            fd_[e] = -1;
+        }
+    }
+#endif
+}
+
+void HardwareCounters::read( uint64_t *values )
+{
+    for( unsigned int e=0; e<n_events; e++ ) {
+        // value, time enabled, time running
+        uint64_t *buffer = &values[3*e];
+        buffer[0] = buffer[1] = buffer[2] = 0;
+#ifdef __linux__
+        if( fd_[e] >= 0 && ::read( fd_[e], buffer, 3*sizeof( uint64_t ) ) != 3*sizeof( uint64_t ) ) {
+            buffer[0] = buffer[1] = buffer[2] = 0;
+        }
+#endif
+    }
+}
+
+double HardwareCounters::count( const uint64_t *start, const uint64_t *end, Event e )
+{
+    const uint64_t *s = &start[3*e], *n = &end[3*e];
+    // The raw values are monotonic, but a failed read returns zeros
+    if( n[0] <= s[0] || n[2] <= s[2] ) {
+        return 0.;
+    }
+    double events = ( double )( n[0] - s[0] );
+    if( n[1] - s[1] != n[2] - s[2] ) {
+        events *= ( double )( n[1] - s[1] ) / ( double )( n[2] - s[2] );
+    }
+    return events;
+}
+
+string HardwareCounters::unavailableEvents()
+{
+    string list;
+    for( unsigned int e=0; e<n_events; e++ ) {
+        if( ! available_[e] ) {
+            list += string( list.empty() ? "" : " " ) + event_names[e];
+        }
+    }
+    return list;
+}
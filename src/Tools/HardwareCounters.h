@@ -0,0 +1,54 @@
+#ifndef HARDWARECOUNTERS_H
+#define HARDWARECOUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+//! Hardware performance counters of each thread, read through the Linux perf_event_open
+//! interface (no external library). Events that cannot be opened (other systems, insufficient
+//! permissions, virtual machines without PMU, events unknown to the processor) are not counted.
+//! Activated by DiagPerformances( hardware_counters = True ), see Timer::enableHardwareCounters.
+//! The counters belong to the system thread that opened them (thread_local descriptors), while
+//! Timer stores the values at each restart by OpenMP thread number: this assumes that each OpenMP
+//! thread number is always executed by the same system thread, as with the persistent thread pool
+//! of the OpenMP runtimes, without nested parallelism nor changes of the number of threads.
+class HardwareCounters
+{
+public:
+    //! Counted events
+    enum Event { cycles = 0, instructions, cache_misses, fp_scalar, fp_packed, n_events };
+    //! Names of the events
+    static const char *event_names[n_events];
+
+    //! Whether the counters are requested
+    static bool requested;
+
+    //! Open the counters of the calling thread. Must be called by all threads of a parallel region
+    static void open();
+
+    //! Number of values of a reading: raw count, time enabled and time running of each event
+    static const unsigned int n_values = 3 * n_events;
+
+    //! Read the raw counters of the calling thread (n_values values, 0 for unavailable events)
+    static void read( uint64_t *values );
+
+    //! Events counted between two readings. Multiplexed events are scaled by the fraction of the
+    //! interval during which they were running, which is only correct on the differences: the
+    //! scaled totals are estimates that may decrease from one reading to the next.
+    static double count( const uint64_t *start, const uint64_t *end, Event e );
+
+    //! Whether an event could be opened by all threads
+    static inline bool available( Event e )
+    {
+        return available_[e];
+    }
+
+    //! Names of the events that could not be opened, separated by spaces
+    static std::string unavailableEvents();
+
+private:
+    //! Whether each event could be opened by all threads
+    static bool available_[n_events];
+};
+
+#endif
@@ -0,0 +1,9 @@
+#include "PatchProfiler.h"
+
+const char *PatchProfiler::operator_names[PatchProfiler::n_operators] = {
+    "interpolation", "push", "boundaries", "projection", "sorting"
+};
+
+bool PatchProfiler::active = false;
+bool PatchProfiler::record_events = false;
+const unsigned int PatchProfiler::max_events;
@@ -0,0 +1,124 @@
+#ifndef PATCHPROFILER_H
+#define PATCHPROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//! Runtime profiler of one patch: time spent by each species in the main particle operators,
+//! and bytes of particles sent to the neighbouring patches, since the last reset.
+//! Optionally records each timed event (for a trace timeline): each event takes 32 bytes,
+//! and at most max_events are kept per patch between two outputs (the others are only counted).
+//! Activated by DiagPerformances( patch_profiling = True ), without recompiling:
+//! when inactive, each measurement only costs a test.
+class PatchProfiler
+{
+public:
+    //! Profiled operators
+    enum Operator { interpolation = 0, push, boundaries, projection, sorting, n_operators };
+    //! Names of the operators
+    static const char *operator_names[n_operators];
+
+    //! Whether the profilers are active (for all patches)
+    static bool active;
+    //! Whether the profilers record each event
+    static bool record_events;
+    //! Maximum number of events recorded by a patch between two outputs
+    static const unsigned int max_events = 10000;
+
+    //! One timed event
+    struct Event {
+        double start, duration;
+        unsigned int species, thread;
+        Operator op;
+    };
+
+    //! Time in seconds given by a monotonic clock
+    static inline double now()
+    {
+        return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    //! Start of a measurement
+    inline double start()
+    {
+        return active ? now() : 0.;
+    }
+
+    //! End of a measurement started at t0
+    inline void stop( unsigned int ispec, Operator op, double t0 )
+    {
+        if( active ) {
+            double t = now();
+            resize( ispec );
+            time_[ispec*n_operators+op] += t - t0;
+            if( record_events ) {
+#ifdef _OPENMP
+                unsigned int thread = omp_get_thread_num();
+#else
+                unsigned int thread = 0;
+#endif
+                if( events_.size() < max_events ) {
+                    events_.push_back( { t0, t - t0, ispec, thread, op } );
+                } else {
+                    dropped_events_++;
+                }
+            }
+        }
+    }
+
+    //! Count the bytes of particles sent to the neighbours
+    inline void addExchangedBytes( unsigned int ispec, uint64_t bytes )
+    {
+        if( active ) {
+            resize( ispec );
+            exchanged_bytes_[ispec] += bytes;
+        }
+    }
+
+    //! Time spent by a species in an operator since the last reset
+    inline double time( unsigned int ispec, Operator op )
+    {
+        return ispec < exchanged_bytes_.size() ? time_[ispec*n_operators+op] : 0.;
+    }
+
+    //! Bytes of particles sent by a species since the last reset
+    inline uint64_t exchangedBytes( unsigned int ispec )
+    {
+        return ispec < exchanged_bytes_.size() ? exchanged_bytes_[ispec] : 0;
+    }
+
+    //! Clear all counters and events
+    void reset()
+    {
+        time_.clear();
+        exchanged_bytes_.clear();
+        events_.clear();
+        dropped_events_ = 0;
+    }
+
+    //! Events recorded since the last reset
+    std::vector<Event> events_;
+    //! Events not recorded since the last reset, beyond max_events
+    uint64_t dropped_events_ = 0;
+
+private:
+    inline void resize( unsigned int ispec )
+    {
+        if( ispec >= exchanged_bytes_.size() ) {
+            time_.resize( ( ispec+1 )*n_operators, 0. );
+            exchanged_bytes_.resize( ispec+1, 0 );
+        }
+    }
+
+    //! Time per species and operator
+    std::vector<double> time_;
+    //! Bytes sent per species
+    std::vector<uint64_t> exchanged_bytes_;
+};
+
+#endif
@@ -5,51 +5,83 @@
 #include <inttypes.h>
 #include <cmath>
 
+//! Counter-based random number generator Philox4x32-10
+//! (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11).
+//! Each number is a function of a key (the seed and the patch index) and of a counter.
+//! The patch index is read at each reset, as it changes when the moving window shifts the patches.
+//! The counter contains the purpose of the numbers (stream and index, for instance the species number),
+//! the timestep, and a sub-stream, so that the sequence is independent of the history of the generator:
+//! it does not depend on the distribution of patches among processes or threads.
 class Random
 {
 public:
-    Random( unsigned int seed ) {
-        // Initialize the state of the random number generator
-        xorshift32_state = seed;
-        // zero is not acceptable for xorshift
-        if( xorshift32_state==0 ) {
-            xorshift32_state = 1073741824;
-        }
+    Random( uint32_t seed, const unsigned int *patch_index = NULL ) : patch_index_( patch_index ) {
+        key_[0] = seed;
+        reset( 0, 0, 0 );
     };
-    
+
     ~Random() {};
-    
+
+    //! Streams of random numbers used for different purposes
+    static constexpr uint32_t stream_dynamics = 1;
+    static constexpr uint32_t stream_envelope_momentum = 2;
+    static constexpr uint32_t stream_envelope_position = 3;
+    static constexpr uint32_t stream_merging = 4;
+    static constexpr uint32_t stream_collisions = 5;
+    static constexpr uint32_t stream_injection = 6;
+    static constexpr uint32_t stream_moving_window = 7;
+    static constexpr uint32_t stream_splitting = 8;
+    static constexpr uint32_t stream_initialization = 9;
+
+    //! Starts the sequence of random numbers for a given stream, index in this stream (e.g. species number)
+    //! and timestep.
+    inline void reset( uint32_t stream, uint32_t index, uint32_t itime, uint32_t substream = 0 ) {
+        key_[1] = patch_index_ ? *patch_index_ : 0;
+        counter_[0] = 0;
+        counter_[1] = substream;
+        counter_[2] = ( stream << 24 ) ^ index;
+        counter_[3] = itime;
+        ibuffer_ = 4;
+        has_spare_ = false;
+    }
+
+    //! Starts an independent sub-stream of the current sequence (e.g. for another thread)
+    inline void substream( uint32_t substream ) {
+        counter_[0] = 0;
+        counter_[1] = substream;
+        ibuffer_ = 4;
+        has_spare_ = false;
+    }
+
     //! random integer
     inline uint32_t integer() {
-        return xorshift32();
+        return next();
     }
     //! Random true/false
     inline bool cointoss() {
-        return xorshift32() & 1;
+        return next() & 1;
     }
-    //! Uniform rand from xorshift32 generator, between 0 (excluded) and 1 (included)
+    //! Uniform rand, between 0 and 1 (both excluded)
     inline double uniform() {
-        return xorshift32() * xorshift32_invmax;
+        return ( next() + 0.5 ) * invmax;
     }
-    //! Uniform rand from xorshift32 generator, between 0 (excluded) and 1-10^-11
+    //! Uniform rand, between 0 (excluded) and 1-10^-11
     inline double uniform1() {
-        return xorshift32() * xorshift32_invmax1;
+        return ( next() + 0.5 ) * invmax1;
     }
-    //! Uniform rand from xorshift32 generator, between -1. (excluded) and 1. (included)
+    //! Uniform rand, between -1. and 1. (both excluded)
     inline double uniform2() {
-        return xorshift32() * xorshift32_invmax2 - 1.;
+        return ( next() + 0.5 ) * invmax2 - 1.;
     }
-    //! Uniform rand from xorshift32 generator, between 0. (excluded) and 2 pi (included)
+    //! Uniform rand, between 0. and 2 pi (both excluded)
     inline double uniform_2pi() {
-        return xorshift32() * xorshift32_invmax_2pi;
+        return ( next() + 0.5 ) * invmax_2pi;
     }
-    //! Normal rand from xorshift32 generator (std deviation = 1.)
+    //! Normal rand (std deviation = 1.)
     inline double normal() {
-        static double spare;
-        static bool has_spare = false;
-        if( has_spare ) {
-            has_spare = false;
-            return spare;
+        if( has_spare_ ) {
+            has_spare_ = false;
+            return spare_;
         } else {
             double u, v, s;
             do {
@@ -58,35 +90,110 @@ public:
                 s = u*u + v*v;
             } while( s >= 1. );
             s = std::sqrt( -2. * std::log(s) / s );
-            spare = v * s;
-            has_spare = true;
+            spare_ = v * s;
+            has_spare_ = true;
             return u * s;
         }
     }
 
-    //! State of the random number generator
-    uint32_t xorshift32_state;
+    //! Fills `out` with n uniform rands between 0 and 1 (both excluded), in a vectorized loop
+    inline void uniform( unsigned int n, double *out ) {
+        fill( n, out, invmax, 0. );
+    }
+    //! Fills `out` with n uniform rands between -1. and 1. (both excluded), in a vectorized loop
+    inline void uniform2( unsigned int n, double *out ) {
+        fill( n, out, invmax2, -1. );
+    }
+    //! Fills `out` with n normal rands (std deviation = 1.), in a vectorized loop (Box-Muller)
+    inline void normal( unsigned int n, double *out ) {
+        fill( n, out, invmax, 0. );
+        #pragma omp simd
+        for( unsigned int i=0; i<n/2; i++ ) {
+            double r = std::sqrt( -2. * std::log( out[2*i] ) );
+            double theta = 2.*M_PI * out[2*i+1];
+            out[2*i  ] = r * std::cos( theta );
+            out[2*i+1] = r * std::sin( theta );
+        }
+        if( n % 2 ) {
+            out[n-1] = normal();
+        }
+    }
+
+    //! Key of the generator (seed, patch index)
+    uint32_t key_[2];
+    //! Counter of the generator (block number, sub-stream, stream and index, timestep)
+    uint32_t counter_[4];
+    //! Index of the patch that owns the generator (NULL if none)
+    const unsigned int *patch_index_;
 
 private:
-    
-    //! Random number generator
-    inline uint32_t xorshift32()
+
+    //! Philox4x32 with 10 rounds: four 32-bit random numbers from a 128-bit counter and a 64-bit key
+    static inline void philox( uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t k0, uint32_t k1, uint32_t *out )
     {
-        /* Algorithm "xor" from p. 4 of Marsaglia, "Xorshift RNGs" */
-        xorshift32_state ^= xorshift32_state << 13;
-        xorshift32_state ^= xorshift32_state >> 17;
-        xorshift32_state ^= xorshift32_state << 5;
-        return xorshift32_state;
+        for( int r=0; r<10; r++ ) {
+            uint64_t p0 = ( uint64_t ) 0xD2511F53 * c0;
+            uint64_t p1 = ( uint64_t ) 0xCD9E8D57 * c2;
+            c0 = ( uint32_t )( p1 >> 32 ) ^ c1 ^ k0;
+            c1 = ( uint32_t ) p1;
+            c2 = ( uint32_t )( p0 >> 32 ) ^ c3 ^ k1;
+            c3 = ( uint32_t ) p0;
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+    //! Next random integer of the sequence
+    inline uint32_t next()
+    {
+        if( ibuffer_ == 4 ) {
+            philox( counter_[0], counter_[1], counter_[2], counter_[3], key_[0], key_[1], buffer_ );
+            counter_[0]++;
+            ibuffer_ = 0;
+        }
+        return buffer_[ibuffer_++];
+    }
+
+    //! Fills `out` with n numbers (x+0.5)*a+b, where x are random integers, one block of 4 per SIMD lane
+    inline void fill( unsigned int n, double *out, double a, double b )
+    {
+        unsigned int nblocks = n / 4;
+        uint32_t c0 = counter_[0], c1 = counter_[1], c2 = counter_[2], c3 = counter_[3], k0 = key_[0], k1 = key_[1];
+        #pragma omp simd
+        for( unsigned int i=0; i<nblocks; i++ ) {
+            uint32_t x[4];
+            philox( c0+i, c1, c2, c3, k0, k1, x );
+            for( unsigned int j=0; j<4; j++ ) {
+                out[4*i+j] = ( x[j] + 0.5 ) * a + b;
+            }
+        }
+        counter_[0] += nblocks;
+        for( unsigned int i=4*nblocks; i<n; i++ ) {
+            out[i] = ( next() + 0.5 ) * a + b;
+        }
     }
+
+    //! Buffer of the last four numbers generated, and index of the next one to be used
+    uint32_t buffer_[4];
+    unsigned int ibuffer_;
+
+    //! Spare number of the normal distribution
+    double spare_;
+    bool has_spare_;
+
     //! Inverse of the maximum value of the random number generator
-    static constexpr double xorshift32_invmax = 1./4294967296.;
+    static constexpr double invmax = 1./4294967296.;
     //! Almost inverse of the maximum value of the random number generator
-    static constexpr double xorshift32_invmax1 = (1.-1e-11)/4294967296.;
+    static constexpr double invmax1 = (1.-1e-11)/4294967296.;
     //! Twice inverse of the maximum value of the random number generator
-    static constexpr double xorshift32_invmax2 = 2./4294967296.;
+    static constexpr double invmax2 = 2./4294967296.;
      //! two pi * inverse of the maximum value of the random number generator
-    static constexpr double xorshift32_invmax_2pi = 2.*M_PI/4294967296.;
-    
+    static constexpr double invmax_2pi = 2.*M_PI/4294967296.;
+
 };
 
 
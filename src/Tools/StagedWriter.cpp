@@ -0,0 +1,136 @@
+#include "StagedWriter.h"
+
+#include "Tools.h"
+
+using namespace std;
+
+StagedWriter::StagedWriter( string filename, MPI_Comm comm, unsigned int nbuffers ) :
+    nbuffers_( max( nbuffers, ( unsigned int ) 1 ) ),
+    busy_( 0 ),
+    stop_( false )
+{
+    // Private communicator so that the collective writes never interfere with the main thread
+    MPI_Comm_dup( comm, &comm_ );
+    if( MPI_File_open( comm_, const_cast<char *>( filename.c_str() ), MPI_MODE_WRONLY, MPI_INFO_NULL, &file_ ) != MPI_SUCCESS ) {
+        ERROR( "Cannot open file " << filename << " for staged writing" );
+    }
+    thread_ = thread( &StagedWriter::writeLoop, this );
+}
+
+StagedWriter::~StagedWriter()
+{
+    {
+        unique_lock<mutex> lock( mutex_ );
+        stop_ = true;
+    }
+    job_added_.notify_one();
+    thread_.join();
+    MPI_File_close( &file_ );
+    MPI_Comm_free( &comm_ );
+}
+
+StagedWriter::Job &StagedWriter::addJob( vector<MPI_Offset> &offsets, vector<int> &lengths, MPI_Datatype type )
+{
+    pending_.push_back( Job() );
+    Job &job = pending_.back();
+    job.offsets.assign( offsets.begin(), offsets.end() );
+    job.lengths = lengths;
+    job.type = type;
+    busy_++;
+    return job;
+}
+
+void StagedWriter::write( vector<double> &data, vector<MPI_Offset> &offsets, vector<int> &lengths )
+{
+    unique_lock<mutex> lock( mutex_ );
+    // Back-pressure: wait for a free staging buffer
+    job_done_.wait( lock, [this] { return busy_ < nbuffers_; } );
+
+    addJob( offsets, lengths, MPI_DOUBLE ).data.swap( data );
+
+    // Give back a previously used buffer so that its memory is reused
+    if( ! recycled_.empty() ) {
+        data.swap( recycled_.back() );
+        recycled_.pop_back();
+    }
+    lock.unlock();
+    job_added_.notify_one();
+}
+
+void StagedWriter::write( vector<char> &data, vector<MPI_Offset> &offsets, vector<int> &lengths )
+{
+    unique_lock<mutex> lock( mutex_ );
+    job_done_.wait( lock, [this] { return busy_ < nbuffers_; } );
+
+    addJob( offsets, lengths, MPI_BYTE ).bytes.swap( data );
+
+    if( ! recycled_bytes_.empty() ) {
+        data.swap( recycled_bytes_.back() );
+        recycled_bytes_.pop_back();
+    }
+    lock.unlock();
+    job_added_.notify_one();
+}
+
+void StagedWriter::wait()
+{
+    unique_lock<mutex> lock( mutex_ );
+    job_done_.wait( lock, [this] { return busy_ == 0; } );
+}
+
+void StagedWriter::sync()
+{
+    wait();
+    MPI_File_sync( file_ );
+}
+
+void StagedWriter::writeLoop()
+{
+    while( true ) {
+        unique_lock<mutex> lock( mutex_ );
+        job_added_.wait( lock, [this] { return stop_ || ! pending_.empty(); } );
+        if( pending_.empty() ) {
+            return; // stop requested and nothing left to write
+        }
+        Job job;
+        job.data.swap( pending_.front().data );
+        job.bytes.swap( pending_.front().bytes );
+        job.offsets.swap( pending_.front().offsets );
+        job.lengths.swap( pending_.front().lengths );
+        job.type = pending_.front().type;
+        pending_.pop_front();
+        lock.unlock();
+
+        void *buffer = NULL;
+        int count = 0;
+        if( job.type == MPI_BYTE ) {
+            buffer = job.bytes.empty() ? NULL : &job.bytes[0];
+            count = job.bytes.size();
+        } else {
+            buffer = job.data.empty() ? NULL : &job.data[0];
+            count = job.data.size();
+        }
+
+        // Each process writes its runs of elements, aggregated by MPI-IO
+        MPI_Datatype filetype;
+        MPI_Type_create_hindexed( job.lengths.size(), job.lengths.empty() ? NULL : &job.lengths[0],
+                                  job.offsets.empty() ? NULL : &job.offsets[0], job.type, &filetype );
+        MPI_Type_commit( &filetype );
+        MPI_File_set_view( file_, 0, job.type, filetype, const_cast<char *>( "native" ), MPI_INFO_NULL );
+        MPI_Status status;
+        MPI_File_write_all( file_, buffer, count, job.type, &status );
+        MPI_Type_free( &filetype );
+
+        lock.lock();
+        if( job.type == MPI_BYTE ) {
+            recycled_bytes_.push_back( vector<char>() );
+            recycled_bytes_.back().swap( job.bytes );
+        } else {
+            recycled_.push_back( vector<double>() );
+            recycled_.back().swap( job.data );
+        }
+        busy_--;
+        lock.unlock();
+        job_done_.notify_all();
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef STAGEDWRITER_H
+#define STAGEDWRITER_H
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class StagedWriter
+//! Writes arrays of doubles (or raw bytes) to a file in a background thread (MPI-IO, collective over its own communicator).
+//! The data is staged in a ring of buffers so that the simulation continues while the file is written.
+//! All processes must stage the same sequence of writes.
+//  --------------------------------------------------------------------------------------------------------------------
+class StagedWriter
+{
+public:
+    //! Opens the (existing) file for writing, on all processes of comm
+    StagedWriter( std::string filename, MPI_Comm comm, unsigned int nbuffers );
+    //! Finishes all pending writes and closes the file
+    ~StagedWriter();
+
+    //! Stages `data` to be written at the given runs of elements (file offsets in bytes, sorted, and lengths).
+    //! The content of `data` is taken over (it is replaced by a recycled buffer).
+    //! Blocks while all the staging buffers are in use.
+    void write( std::vector<double> &data, std::vector<MPI_Offset> &offsets, std::vector<int> &lengths );
+
+    //! Same as above for raw bytes (lengths in bytes), e.g. when the runs belong to datasets of different types
+    void write( std::vector<char> &data, std::vector<MPI_Offset> &offsets, std::vector<int> &lengths );
+
+    //! Waits until all staged data has been written
+    void wait();
+
+    //! Waits, then flushes the file to the disk
+    void sync();
+
+private:
+    struct Job {
+        std::vector<double> data;
+        std::vector<char> bytes;
+        std::vector<MPI_Aint> offsets;
+        std::vector<int> lengths;
+        //! MPI_DOUBLE if the job holds `data`, MPI_BYTE if it holds `bytes`
+        MPI_Datatype type;
+    };
+
+    //! Queues a job (must be called with the lock held, after waiting for a free buffer)
+    Job &addJob( std::vector<MPI_Offset> &offsets, std::vector<int> &lengths, MPI_Datatype type );
+
+    //! Loop of the background thread
+    void writeLoop();
+
+    MPI_Comm comm_;
+    MPI_File file_;
+
+    //! Maximum number of staged jobs
+    unsigned int nbuffers_;
+
+    std::deque<Job> pending_;
+    //! Number of jobs pending or being written
+    unsigned int busy_;
+    //! Emptied buffers, to be reused
+    std::vector<std::vector<double> > recycled_;
+    std::vector<std::vector<char> > recycled_bytes_;
+    bool stop_;
+
+    std::mutex mutex_;
+    std::condition_variable job_added_, job_done_;
+    std::thread thread_;
+};
+
+#endif
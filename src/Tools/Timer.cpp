@@ -4,7 +4,11 @@
 #include <string>
 
 #include <mpi.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
+#include "HardwareCounters.h"
 #include "SmileiMPI.h"
 #include "Tools.h"
 #include "VectorPatch.h"
@@ -34,6 +38,9 @@ void Timer::init( SmileiMPI *smpi )
 //! Accumulate time couting from last init/restart
 void Timer::update( bool store )
 {
+    if( ! counters_.empty() ) {
+        updateCounters();
+    }
     #pragma omp barrier
     #pragma omp master
     {
@@ -50,6 +57,9 @@ void Timer::update( bool store )
 //!Accumulate time couting from last init/restart using patch detailed timers
 void Timer::update( VectorPatch &vecPatches, bool store )
 {
+    if( ! counters_.empty() ) {
+        updateCounters();
+    }
     #pragma omp barrier
     #pragma omp master
     {
@@ -87,6 +97,13 @@ void Timer::restart()
     {
         last_start_ = MPI_Wtime();
     }
+    if( ! counters_.empty() ) {
+#ifdef _OPENMP
+        HardwareCounters::read( &counters_start_[omp_get_thread_num()][0] );
+#else
+        HardwareCounters::read( &counters_start_[0][0] );
+#endif
+    }
 }
 
 void Timer::reboot()
@@ -95,6 +112,36 @@ void Timer::reboot()
     last_start_ =  MPI_Wtime();
     time_acc_ = 0.;
     register_timers.clear();
+    counters_.assign( counters_.size(), 0. );
+}
+
+void Timer::enableHardwareCounters()
+{
+#ifdef _OPENMP
+    unsigned int number_of_threads = omp_get_max_threads();
+#else
+    unsigned int number_of_threads = 1;
+#endif
+    counters_.assign( HardwareCounters::n_events, 0. );
+    counters_start_.assign( number_of_threads, vector<uint64_t>( HardwareCounters::n_values, 0 ) );
+}
+
+//! Each thread reads its counters before the barrier, so that the waiting time is not counted
+void Timer::updateCounters()
+{
+#ifdef _OPENMP
+    vector<uint64_t> &start = counters_start_[omp_get_thread_num()];
+#else
+    vector<uint64_t> &start = counters_start_[0];
+#endif
+    uint64_t now[HardwareCounters::n_values];
+    HardwareCounters::read( now );
+    for( unsigned int e=0; e<HardwareCounters::n_events; e++ ) {
+        double events = HardwareCounters::count( &start[0], now, ( HardwareCounters::Event ) e );
+        #pragma omp atomic
+        counters_[e] += events;
+    }
+    start.assign( now, now + HardwareCounters::n_values );
 }
 
 void Timer::print( double tot )
@@ -1,6 +1,7 @@
 #ifndef TIMER_H
 #define TIMER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,8 @@ public:
     void restart();
     //! Start a new cumulative period
     void reboot();
+    //! Count the hardware events (see HardwareCounters) in this timer's region
+    void enableHardwareCounters();
     //! Return accumulated time
     double getTime()
     {
@@ -52,6 +55,9 @@ public:
     
     std::vector<double> register_timers;
     
+    //! Hardware events accumulated in this timer's region, summed over threads (empty if not counted)
+    std::vector<double> counters_;
+    
 #ifdef __DETAILED_TIMERS
     //! Id of the associated timer in the patch timer array
     unsigned int patch_timer_id;
@@ -62,6 +68,11 @@ private:
     double last_start_;
     //! MPI process timer synchronized through MPI
     SmileiMPI *smpi_;
+    //! Raw hardware counters of each thread at the last restart, by OpenMP thread number
+    //! (each number must keep the same system thread, see HardwareCounters)
+    std::vector<std::vector<uint64_t> > counters_start_;
+    //! Accumulate the hardware events of the calling thread since the last restart
+    void updateCounters();
     
 };
 
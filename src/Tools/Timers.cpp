@@ -3,6 +3,7 @@
 
 #include "Timers.h"
 
+#include "HardwareCounters.h"
 #include "SmileiMPI.h"
 #include "Tools.h"
 
@@ -21,13 +22,15 @@ Timers::Timers( SmileiMPI *smpi ) :
     syncField( "Sync Fields" ),             // Call sumRhoJ(s), exchangeB (MPI & Patch sync)
     syncDens( "Sync Densities" ),           // If necessary the following timers can be reintroduced
     particleMerging( "Part Merging" ),      // Particle merging
+    particleSplitting( "Part Splitting" ),  // Particle splitting
     particleInjection( "Part Injection" ),  // Particle injection
     diagsNEW( "DiagnosticsNEW" ),           // Diags.runAllDiags + MPI & Patch sync
     reconfiguration( "Reconfiguration" ),   // Patch reconfiguration
     envelope( "Envelope" ),
     susceptibility( "Sync_Susceptibility" ),
     grids("Grids"),
-    densitiesCorrection("Dens Correction")
+    densitiesCorrection("Dens Correction"),
+    initialization( "Initialization" )
 #ifdef __DETAILED_TIMERS
     // Details of Dynamic
     , interpolator( "Interpolator" ),
@@ -61,6 +64,7 @@ Timers::Timers( SmileiMPI *smpi ) :
     timers.push_back( &syncField );
     timers.push_back( &syncDens );
     timers.push_back( &particleMerging );
+    timers.push_back( &particleSplitting );
     timers.push_back( &particleInjection );
     timers.push_back( &diagsNEW );
     timers.push_back( &reconfiguration );
@@ -107,6 +111,7 @@ Timers::Timers( SmileiMPI *smpi ) :
     for( unsigned int i=0; i<timers.size(); i++ ) {
         timers[i]->init( smpi );
     }
+    initialization.init( smpi );
     
     if( smpi->getRank()==0 && ! smpi->test_mode ) {
         remove( "profil.txt" );
@@ -128,6 +133,25 @@ void Timers::reboot()
     }
 }
 
+void Timers::enableHardwareCounters()
+{
+    #pragma omp parallel
+    {
+        HardwareCounters::open();
+    }
+    string unavailable = HardwareCounters::unavailableEvents();
+    if( ! unavailable.empty() ) {
+        WARNING( "Hardware counters not available (check /proc/sys/kernel/perf_event_paranoid): " << unavailable );
+    }
+    
+    particles.enableHardwareCounters();
+    maxwell  .enableHardwareCounters();
+    densities.enableHardwareCounters();
+    syncPart .enableHardwareCounters();
+    syncField.enableHardwareCounters();
+    syncDens .enableHardwareCounters();
+}
+
 //! Output the timer profile
 void Timers::profile( SmileiMPI *smpi )
 {
@@ -141,6 +165,7 @@ void Timers::profile( SmileiMPI *smpi )
             coverage += timers[i]->getTime();
         }
         
+        MESSAGE( "Time_in_initialization\t" << initialization.getTime() );
         MESSAGE( "Time_in_time_loop\t" << global.getTime() << "\t"<<coverage/global.getTime()*100.<< "% coverage" );
         
 #ifdef __DETAILED_TIMERS
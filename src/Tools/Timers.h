@@ -31,6 +31,7 @@ public:
     Timer syncField ;
     Timer syncDens  ;
     Timer particleMerging;
+    Timer particleSplitting;
     Timer particleInjection;
     Timer diagsNEW  ;
     Timer reconfiguration  ;
@@ -38,6 +39,8 @@ public:
     Timer susceptibility ;
     Timer grids ;
     Timer densitiesCorrection ;
+    //! Time before the time loop (not part of the profile of the time loop)
+    Timer initialization ;
 #ifdef __DETAILED_TIMERS
     Timer interpolator  ;
     Timer pusher  ;
@@ -69,6 +72,10 @@ public:
     
     void reboot();
     
+    //! Open the hardware counters and count them in the regions of the time loop
+    //! (particles, maxwell, densities and synchronizations)
+    void enableHardwareCounters();
+    
 private:
     std::vector<Timer *> timers;
     
@@ -0,0 +1,58 @@
+import os, re, numpy as np
+import happi
+from subprocess import Popen, PIPE, STDOUT
+
+S = happi.Open(["./restart*"], verbose=False)
+
+# Each string filter gives the same histogram as the equivalent python condition
+for i, (expression, condition) in enumerate(S.namelist.filters):
+	a = S.ParticleBinning(2*i  , timesteps=0).getData()[0]
+	b = S.ParticleBinning(2*i+1, timesteps=0).getData()[0]
+	Validate("Filter `"+expression+"` matches python", np.allclose(a, b, rtol=1e-12, atol=0.) and a.sum()>0.)
+
+# Automatic limits of filtered particles
+n = 2*len(S.namelist.filters)
+px = S.ParticleBinning(n, timesteps=0).getAxis("px")
+Validate("Auto limits within the filter", px.min() > -0.1 and px.max() < 0.1)
+px = S.ParticleBinning(n+1, timesteps=0).getAxis("px")
+Validate("Auto max within the filter, fixed min", px.min() < -0.45 and px.max() < 0.2)
+
+# Tracked particles pass the filter
+track = S.TrackParticles("electron", axes=["x","px"], timesteps=0).getData()
+Validate("Tracked particles pass the filter",
+	len(track["px"][0]) > 0
+	and np.all(np.abs(track["px"][0]) < 0.1)
+	and np.all(track["x"][0] < 8.)
+)
+
+# Malformed filters stop the simulation with an explicit message
+smilei = os.path.abspath("../../../smilei")
+namelist = """
+Main( geometry="1Dcartesian", interpolation_order=2, cell_length=[0.25], grid_length=[4.],
+	number_of_patches=[2], timestep=0.2, simulation_time=0.2, EM_boundary_conditions=[['periodic']] )
+Species( name="electron", position_initialization="regular", momentum_initialization="cold",
+	particles_per_cell=1, mass=1., charge=-1., number_density=1., boundary_conditions=[["periodic"]] )
+DiagParticleBinning( deposited_quantity="weight", every=1, species=["electron"],
+	axes=[["x", 0., 4., 4]], filter=%s )
+"""
+errors = [
+	["px >"             , "syntax error at ``"                 ],
+	["(px > 0"          , "missing `)`"                        ],
+	["px > 0)"          , "unexpected `)`"                     ],
+	["px >> 0"          , "syntax error at `> 0`"              ],
+	["y > 0"            , "unknown quantity `y`"               ],
+	["energy > 0"       , "unknown quantity `energy`"          ],
+	["chi > 0"          , "filter uses `chi`"                  ],
+	["1+("*20+"px"+")"*20+" > 0", "too deeply nested"          ],
+]
+for i, (expression, message) in enumerate(errors):
+	directory = "filter_error%02d" % i
+	if not os.path.isdir(directory):
+		os.mkdir(directory)
+	with open(directory+os.sep+"namelist.py", "w") as f:
+		f.write(namelist % repr(expression))
+	process = Popen([smilei, "namelist.py"], cwd=directory, stdout=PIPE, stderr=STDOUT)
+	output = process.communicate()[0].decode(errors="replace")
+	Validate("Error message for filter `"+expression+"`",
+		process.returncode != 0 and ("DiagParticleBinning #0" in output) and (message in output)
+	)
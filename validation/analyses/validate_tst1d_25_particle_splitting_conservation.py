@@ -0,0 +1,23 @@
+import os, re, numpy as np
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+quantities = S.namelist.quantities
+n = len(quantities) + 1
+
+# Totals of the split species and of the reference species
+def totals(idiag):
+	return np.array(S.ParticleBinning(idiag).getData()).sum(axis=1)
+
+for i, quantity in enumerate(quantities):
+	split = totals(i)
+	reference = totals(n+i)
+	error = np.abs(split-reference).max() / np.abs(reference).max()
+	Validate("Total "+quantity+" conserved by splitting", error < 1e-10)
+
+# The number of macro-particles increases with the splitting only
+split = totals(n-1)
+reference = totals(2*n-1)
+Validate("Number of macro-particles of the reference", np.all(reference == reference[0]))
+Validate("Splitting increases the number of macro-particles", np.all(np.diff(split) >= 0) and split[-1] > 2.*reference[-1])
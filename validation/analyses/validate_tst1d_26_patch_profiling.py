@@ -0,0 +1,40 @@
+import os, re, json, numpy as np, h5py
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+npatches = S.namelist.Main.number_of_patches[0]
+quantities = ["time_interpolation", "time_push", "time_boundaries", "time_projection", "time_sorting", "exchanged_bytes", "macro_particles"]
+
+# Datasets patches/<species>/<quantity> of each output
+with h5py.File("./restart000/Performances.h5", "r") as f:
+	iterations = sorted(f.keys(), key=int)
+	found = all(
+		all(
+			q in f[it]["patches"][species] and f[it]["patches"][species][q].shape == (npatches,)
+			for species in ["electron", "ion"] for q in quantities
+		)
+		for it in iterations
+	)
+Validate("Patch profiler datasets", found)
+Validate("Number of outputs", len(iterations) >= 4)
+
+# Read by happi, for each species or summed over species
+for species in ["electron", "ion"]:
+	time_push = np.array(S.Performances(raw="time_push", species=species).getData())
+	Validate("Push time of "+species+" in each patch", time_push.shape[1:] == (npatches,) and np.all(time_push >= 0.) and np.all(time_push[1:].sum(axis=1) > 0.))
+	macro_particles = np.array(S.Performances(raw="macro_particles", species=species).getData()).sum(axis=1)
+	Ntot = np.array(S.Scalar("Ntot_"+species).getData())
+	Validate("Macro-particles of "+species, np.all(macro_particles == Ntot))
+total = np.array(S.Performances(raw="time_push").getData())
+electron = np.array(S.Performances(raw="time_push", species="electron").getData())
+ion = np.array(S.Performances(raw="time_push", species="ion").getData())
+Validate("Push time summed over species", np.allclose(total, electron+ion))
+
+# The trace is a JSON array of events of the profiled operators
+with open("./restart000/Performances_trace_00000.json") as f:
+	trace = json.load(f)
+events = [e for e in trace if e["ph"] == "X"]
+Validate("Trace events", len(events) > 0 and all(e["name"] in ["interpolation", "push", "boundaries", "projection", "sorting"] for e in events))
+Validate("Trace species", sorted(set(e["cat"] for e in events)) == ["electron", "ion"])
+Validate("Trace not truncated", all(e["name"] != "dropped_events" for e in trace))
@@ -0,0 +1,32 @@
+import os, re, numpy as np
+from scipy.special import kn
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+temperatures = S.namelist.temperatures
+nmoments = len(S.namelist.moments)
+
+def moment(i, j):
+	return np.array(S.ParticleBinning(i*nmoments+j, timesteps=0).getData()[0]).sum()
+
+for i, T in enumerate(temperatures):
+	if T < 0.1:
+		# Maxwell-Boltzmann kinetic energies E: <E> = 3T/2 and <p^2> = <2E+E^2> = 3T + 15T^2/4
+		gamma = 1. + 1.5 * T
+		p2 = 3. * T + 3.75 * T**2
+	else:
+		# Maxwell-Juttner moments: <gamma> = K3/K2 - T and <p^2> = 3 T K3/K2, with K at 1/T
+		ratio = kn(3, 1./T) / kn(2, 1./T)
+		gamma = ratio - T
+		p2 = 3. * T * ratio
+	
+	w = moment(i, 0)
+	sampled_gamma = 1. + moment(i, 1) / w
+	sampled_p2 = moment(i, 2) / w
+	sampled_px2 = moment(i, 3) / w
+	sampled_px = moment(i, 4) / w
+	
+	Validate("Mean gamma-1 at T=%g" % T, abs(sampled_gamma-gamma) < 0.01*(gamma-1.))
+	Validate("Mean p^2 at T=%g" % T, abs(sampled_p2-p2) < 0.02*p2)
+	Validate("Isotropy at T=%g" % T, abs(3.*sampled_px2-sampled_p2) < 0.03*p2 and abs(sampled_px) < 0.01*np.sqrt(p2))
@@ -0,0 +1,25 @@
+import os, re, numpy as np, h5py
+from glob import glob
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+# The last dump of the first run must be incremental (linked to earlier dump files)
+last_step = -1
+linked_files = []
+for dump in glob("./restart000/checkpoints/dump-*.h5"):
+	with h5py.File(dump, "r") as f:
+		if f.attrs["dump_step"] > last_step:
+			last_step = f.attrs["dump_step"]
+			linked_files = list(f.attrs["linked_dump_files"]) if "linked_dump_files" in f.attrs else []
+Validate("Step of the last dump", last_step)
+Validate("Last dump links to earlier files", len(linked_files) > 0)
+
+# Compared to an uninterrupted run (the reference), with or without restarts
+for name in ['Utot', 'Uelm', 'Ukin_eon', 'Ukin_ion', 'Ntot_eon', 'Ntot_ion']:
+	data = np.array(S.Scalar(name).getData())
+	Validate("Scalar "+name, data, 1e-6*np.abs(data).max())
+
+for field in ['Ex', 'Ey', 'Bz', 'Rho_eon']:
+	F = S.Field.Field0(field, timesteps=S.Field.Field0(field).getTimesteps()[-1]).getData()[0]
+	Validate("Final "+field+" field", F[::4,::4], 1e-8)
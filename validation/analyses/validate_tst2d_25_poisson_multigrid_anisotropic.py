@@ -0,0 +1,20 @@
+import os, re, numpy as np
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+dx, dy = S.namelist.Main.cell_length
+
+# Fields after the initial Poisson solver: Ex is dual along x and Ey dual along y,
+# the node i of a dual field being at (i-1/2) times the cell length
+Ex  = S.Field.Field0("Ex" , timesteps=0).getData()[0]
+Ey  = S.Field.Field0("Ey" , timesteps=0).getData()[0]
+Rho = S.Field.Field0("Rho", timesteps=0).getData()[0]
+
+# Gauss's law at the primal nodes
+divE = (Ex[1:,:-1]-Ex[:-1,:-1])/dx + (Ey[:-1,1:]-Ey[:-1,:-1])/dy
+error = np.abs(divE - Rho[:-1,:-1]).max() / np.abs(Rho).max()
+Validate("Gauss's law verified", error < 1e-4)
+
+# The field is not trivial
+Validate("Ex does not vanish", np.abs(Ex).max() > 1.)
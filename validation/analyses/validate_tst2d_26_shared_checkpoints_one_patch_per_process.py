@@ -0,0 +1,13 @@
+import os, re, numpy as np
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+# Periodic plasma: no particle is lost across the restarts
+Ntot_eon = np.array(S.Scalar("Ntot_eon").getData())
+Validate("Number of electrons constant", bool((Ntot_eon == Ntot_eon[0]).all()))
+
+# Tracked particles: all present at all times, with unique IDs
+Id = S.TrackParticles("eon", axes=["Id"]).getData()["Id"]
+Validate("All particles tracked at all times", bool((Id > 0).all()) and Id.shape[1] == Ntot_eon[0])
+Validate("Unique IDs", bool(all(len(np.unique(ids)) == len(ids) for ids in Id)))
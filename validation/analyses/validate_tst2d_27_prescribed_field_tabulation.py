@@ -0,0 +1,22 @@
+import os, re, numpy as np
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+dx, dy = S.namelist.Main.cell_length
+dt = S.namelist.Main.timestep
+profile = np.vectorize(S.namelist.Ex_profile)
+
+# Ex is dual along x: the node i is at x_moved + (i-1/2) dx
+Ex = S.Field.Field0("Ex")
+error = 0.
+for t in Ex.getTimesteps():
+	data = Ex.getData(timesteps=t)[0]
+	x = Ex.getXmoved(t) + (np.arange(data.shape[0])-0.5)*dx
+	y = np.arange(data.shape[1])*dy
+	X, Y = np.meshgrid(x, y, indexing="ij")
+	error = max(error, np.abs(data - profile(X, Y, t*dt)).max())
+Validate("Tabulated profile matches the python function", error < 1e-3)
+
+# The window has moved beyond the initial box
+Validate("Window moved", Ex.getXmoved(Ex.getTimesteps()[-1]) > 8.)
@@ -0,0 +1,26 @@
+import os, re, numpy as np
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+dx, dy = S.namelist.Main.cell_length
+
+# Fields after the initial Poisson solver: Ex is dual along x and Ey dual along y,
+# the node i of a dual field being at (i-1/2) times the cell length
+Ex  = S.Field.Field0("Ex" , timesteps=0).getData()[0]
+Ey  = S.Field.Field0("Ey" , timesteps=0).getData()[0]
+Rho = S.Field.Field0("Rho", timesteps=0).getData()[0]
+
+# Gauss's law at the primal nodes
+divE = (Ex[1:,:-1]-Ex[:-1,:-1])/dx + (Ey[:-1,1:]-Ey[:-1,:-1])/dy
+error = np.abs(divE - Rho[:-1,:-1]).max() / np.abs(Rho).max()
+Validate("Gauss's law verified", error < 1e-4)
+
+# Radial field of the disk at its edge: E = R rho / 2 with rho = 1 - background
+Lx, Ly = S.namelist.Lx, S.namelist.Ly
+R = S.namelist.R
+i = int((Lx/2.+R)/dx)
+j = int(Ly/2./dy)
+E_edge = np.abs(Ex[i, j])
+E_theory = R * (1. - np.pi*R**2/(Lx*Ly)) / 2.
+Validate("Field at the edge of the disk", abs(E_edge/E_theory - 1.) < 0.05)
@@ -0,0 +1,47 @@
+import os, re, numpy as np, h5py
+from glob import glob
+from subprocess import Popen, PIPE, STDOUT
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+# The fields and particle arrays of the dumps are compressed, and positions are stored with the XOR predictor
+arrays = re.compile(r"/(E[xyz]|B[xyz](_m)?|Position-\d|Momentum-\d|Weight|Charge)$")
+def compressed_datasets(name, obj):
+	if isinstance(obj, h5py.Dataset) and obj.size > 1 and arrays.search(name):
+		compressed.append( (obj.compression == "gzip" and obj.shuffle, "predictor" in obj.attrs) )
+compressed = []
+with h5py.File(sorted(glob("./restart000/checkpoints/dump-*.h5"))[-1], "r") as f:
+	f.visititems(compressed_datasets)
+Validate("All dumped arrays are deflated", len(compressed) > 0 and all(c for c,p in compressed))
+Validate("Positions use the predictor", any(p for c,p in compressed))
+
+# Run the same namelist without interruption, and with a restart from the first (compressed) dump
+smilei = os.path.abspath("../../../smilei")
+namelist = os.path.abspath("./restart000/smilei.py")
+env = dict(os.environ, OMP_NUM_THREADS="1")
+runs = {
+	"uninterrupted": "Checkpoints.exit_after_dump=False; Checkpoints.restart_dir=None",
+	"stopped"      : "Checkpoints.exit_after_dump=True;  Checkpoints.restart_dir=None",
+	"restarted"    : "Checkpoints.exit_after_dump=False; Checkpoints.restart_dir='%s'" % os.path.abspath("stopped"),
+}
+for directory in ["uninterrupted", "stopped", "restarted"]:
+	if not os.path.isdir(directory):
+		os.mkdir(directory)
+	arguments = "Checkpoints.dump_step=48; Checkpoints.keep_n_dumps=2; Checkpoints.dump_deflate=2; " + runs[directory]
+	process = Popen([smilei, namelist, arguments], cwd=directory, stdout=PIPE, stderr=STDOUT, env=env)
+	output = process.communicate()[0].decode(errors="replace")
+	Validate("Run "+directory+" succeeds", process.returncode == 0)
+
+# The restarted run matches the uninterrupted one
+A = happi.Open("uninterrupted", verbose=False)
+B = happi.Open("restarted", verbose=False)
+last = A.Field.Field0("Ex").getTimesteps()[-1]
+for field in ['Ex', 'Ey', 'Bz', 'Rho_eon', 'Jx_eon']:
+	a = A.Field.Field0(field, timesteps=last).getData()[0]
+	b = B.Field.Field0(field, timesteps=last).getData()[0]
+	Validate("Restarted "+field+" identical", np.array_equal(a, b) and np.abs(a).max() > 0.)
+for name in ['Utot', 'Uelm', 'Ukin_eon', 'Ukin_ion', 'Ntot_eon']:
+	a = A.Scalar(name).getData()[-1]
+	b = B.Scalar(name).getData()[-1]
+	Validate("Restarted scalar "+name+" identical", a == b)
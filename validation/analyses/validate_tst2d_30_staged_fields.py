@@ -0,0 +1,27 @@
+import numpy as np, h5py
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+# Staged fields are identical to those written synchronously, including their attributes
+def read(file):
+	data = {}
+	def collect(name, obj):
+		if isinstance(obj, h5py.Dataset):
+			data[name] = (obj[()], dict(obj.attrs))
+	with h5py.File(file, "r") as f:
+		f.visititems(collect)
+	return data
+
+def same_attributes(a, b):
+	return sorted(a.keys()) == sorted(b.keys()) and all(np.array_equal(a[k], b[k]) for k in a)
+
+for synchronous, staged in [(0, 1), (0, 2), (3, 4)]:
+	A = read("./restart000/Fields%d.h5"%synchronous)
+	B = read("./restart000/Fields%d.h5"%staged)
+	Validate("Fields%d has datasets"%staged, len(A) > 5 and sorted(A.keys()) == sorted(B.keys()))
+	Validate("Fields%d data identical to Fields%d"%(staged, synchronous), all(np.array_equal(A[k][0], B[k][0]) for k in A if k in B))
+	Validate("Fields%d attributes identical to Fields%d"%(staged, synchronous), all(same_attributes(A[k][1], B[k][1]) for k in A if k in B))
+
+# The happi reader sees the same timesteps
+Validate("Staged timesteps", list(S.Field(1, "Ex").getTimesteps()) == list(S.Field(0, "Ex").getTimesteps()))
@@ -0,0 +1,49 @@
+import os, numpy as np, h5py
+from subprocess import Popen, PIPE, STDOUT
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+def read(file):
+	data = {}
+	def collect(name, obj):
+		if isinstance(obj, h5py.Dataset):
+			data[name] = (obj[()], dict(obj.attrs))
+	with h5py.File(file, "r") as f:
+		f.visititems(collect)
+	return data
+
+def same_attributes(a, b):
+	return sorted(a.keys()) == sorted(b.keys()) and all(np.array_equal(a[k], b[k]) for k in a)
+
+def compare(name, A, B):
+	Validate(name+" has datasets", len(A) > 1 and sorted(A.keys()) == sorted(B.keys()))
+	Validate(name+" data identical", all(np.array_equal(A[k][0], B[k][0]) for k in A if k in B))
+	Validate(name+" attributes identical", all(same_attributes(A[k][1], B[k][1]) for k in A if k in B))
+
+# Staged probes are identical to those written synchronously
+for synchronous, staged in [(0, 1), (2, 3)]:
+	compare("Probes%d"%staged, read("./restart000/Probes%d.h5"%synchronous), read("./restart000/Probes%d.h5"%staged))
+
+# The order of tracked particles in the file depends on the decomposition: compare two runs
+# of this namelist on a single process, with staged and synchronous tracks
+smilei = os.path.abspath("../../../smilei")
+namelist = os.path.abspath("./restart000/smilei.py")
+env = dict(os.environ, OMP_NUM_THREADS="1")
+runs = {
+	"synchronous": "DiagTrackParticles[0].staging_buffers = 0",
+	"staged"     : "DiagTrackParticles[0].staging_buffers = 2",
+}
+for directory in ["synchronous", "staged"]:
+	if not os.path.isdir(directory):
+		os.mkdir(directory)
+	process = Popen([smilei, namelist, runs[directory]], cwd=directory, stdout=PIPE, stderr=STDOUT, env=env)
+	output = process.communicate()[0].decode(errors="replace")
+	Validate("Run "+directory+" succeeds", process.returncode == 0)
+
+compare("TrackParticles", read("synchronous/TrackParticlesDisordered_eon.h5"), read("staged/TrackParticlesDisordered_eon.h5"))
+
+# Sorted by happi, the tracked particles of the staged run are those of the synchronous run
+A = happi.Open("synchronous", verbose=False).TrackParticles("eon", axes=["x", "px", "Ex"]).getData()
+B = happi.Open("staged", verbose=False).TrackParticles("eon", axes=["x", "px", "Ex"]).getData()
+Validate("Sorted tracks identical", all(np.array_equal(A[k], B[k], equal_nan=True) for k in ["x", "px", "Ex", "times"]))
@@ -0,0 +1,20 @@
+import numpy as np, h5py
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+# Chunks do not straddle patches (or groups of patches): with the subgrid s_[4:30:1, 5:32:2, 8:29:3]
+# and patches of 8 cells, the first output patch has 5, 2 and 1 points, hence chunks of 4, 2 and 3 points
+expected_chunks = {1: (4, 2, 3), 3: (16, 16, 16)}
+fields = ["Ex", "Ey", "Ez", "Bz", "Rho_electron"]
+for contiguous, chunked in [(0, 1), (2, 3)]:
+	with h5py.File("./restart000/Fields%d.h5"%contiguous, "r") as f0, h5py.File("./restart000/Fields%d.h5"%chunked, "r") as f1:
+		timesteps = sorted(f0["data"].keys())
+		Validate("Fields%d has all timesteps"%chunked, len(timesteps) > 1 and sorted(f1["data"].keys()) == timesteps)
+		for field in fields:
+			d0 = [f0["data"][t][field] for t in timesteps]
+			d1 = [f1["data"][t][field] for t in timesteps]
+			Validate("Fields%d is contiguous"%contiguous, all(d.chunks is None for d in d0))
+			Validate("Fields%d chunks of %s"%(chunked, field), all(d.chunks == expected_chunks[chunked] for d in d1))
+			Validate("Fields%d compression of %s"%(chunked, field), all((d.compression == "gzip") == (chunked == 1) for d in d1))
+			Validate("Fields%d %s equals the contiguous output"%(chunked, field), all(np.array_equal(a[()], b[()]) for a, b in zip(d0, d1)))
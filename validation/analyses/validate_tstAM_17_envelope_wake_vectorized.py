@@ -0,0 +1,36 @@
+import os, re, numpy as np, math, h5py, pickle
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+# Reference of tstAM_06_envelope_wake, the same case computed with the scalar operators
+reference_file = os.path.join("..", "..", "..", "..", "references", "tstAM_06_envelope_wake.py.txt")
+with open(reference_file, "rb") as f:
+	try:
+		scalar = pickle.load(f, encoding="latin1")
+	except TypeError:
+		scalar = pickle.load(f)
+
+def matches_scalar(name, data, precision=1e-2):
+	reference = np.array(scalar[name])
+	return data.shape == reference.shape and np.abs(data-reference).max() <= precision*np.abs(reference).max()
+
+# COMPARE THE FIELDS TO THE SCALAR VERSION
+Env_A_abs = S.Field(0, "Env_A_abs", theta=0, timesteps=1700.).getData()[0][::2,::2]
+Validate("Env_A_abs field at iteration 1700 matches the scalar operators", matches_scalar("Env_A_abs field at iteration 1700", Env_A_abs))
+
+El = S.Field(1, "El", theta=0, timesteps=1700.).getData()[0][::2,::2]
+Validate("El field at iteration 1700 matches the scalar operators", matches_scalar("El field at iteration 1700", El))
+
+Env_Chi = S.Field(0, "Env_Chi", theta=0, timesteps=1700.).getData()[0][::2,::2]
+Validate("Env_Chi field at iteration 1700 matches the scalar operators", matches_scalar("Env_Chi field at iteration 1700", Env_Chi))
+
+# 1-D PROBE IN AM
+Env_A_abs = S.Probe.Probe0.Env_A_abs(timesteps=1700).getData()[0][::2]
+Validate("1-D probe Env_A_abs at iteration 1700 matches the scalar operators", matches_scalar("1-D probe Env_A_abs at iteration 1700", Env_A_abs))
+
+Ex = S.Probe.Probe0.Ex(timesteps=1700).getData()[0][::2]
+Validate("1-D probe Ex at iteration 1700 matches the scalar operators", matches_scalar("1-D probe Ex at iteration 1700", Ex))
+
+Env_Chi = S.Probe.Probe0.Env_Chi(timesteps=1700).getData()[0][::2]
+Validate("1-D probe Env_Chi at iteration 1700 matches the scalar operators", matches_scalar("1-D probe Env_Chi at iteration 1700", Env_Chi))
@@ -0,0 +1,28 @@
+import os, re, numpy as np
+import happi
+
+S = happi.Open(["./restart*"], verbose=False)
+
+Te = S.namelist.Te
+Ti = S.namelist.Ti
+cases = S.namelist.cases
+
+# Temperatures from the kinetic energies (constant numbers of particles, no drift)
+def temperatures(i):
+	Ue = np.array(S.Scalar("Ukin_eon"+str(i)).getData())
+	Ui = np.array(S.Scalar("Ukin_ion"+str(i)).getData())
+	return Te*Ue/Ue[0], Ti*Ui/Ui[0], Ue+Ui
+
+for i, (cells_per_bin, coulomb_log) in enumerate(cases):
+	te, ti, U = temperatures(i)
+	# Collisions conserve the energy, whatever the bins
+	Validate("Energy conserved, case "+str(i), np.abs(U/U[0]-1.).max() < 1e-6)
+	# The temperatures relax significantly
+	Validate("Thermalization, case "+str(i), te[-1]-ti[-1] < 0.7*(Te-Ti) and te[-1]-ti[-1] > 0.)
+
+# Coarse bins give the same relaxation as bins of one cell, within the statistical noise
+for fine, coarse in [[0, 1], [2, 3]]:
+	te1, ti1, _ = temperatures(fine)
+	te3, ti3, _ = temperatures(coarse)
+	difference = np.abs((te3-ti3) - (te1-ti1)).max() / (Te-Ti)
+	Validate("cells_per_bin=3 matches cells_per_bin=1 (coulomb_log="+str(cases[fine][1])+")", difference < 0.1)